@@ -0,0 +1,400 @@
+#include "AnalysisScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+struct CancellationToken::State {
+    std::mutex mutex;              // Held while callbacks run
+    std::atomic<bool> cancelled{false};
+    std::map<uint64_t, std::function<void()>> callbacks;
+    uint64_t nextCallback = 1;
+};
+
+namespace {
+
+// Worker identity of the current thread, for fan-out and helping waits
+thread_local const AnalysisScheduler* tls_scheduler = nullptr;
+thread_local size_t tls_workerIndex = 0;
+// Token of the job running on this thread, inherited by its fan-out
+thread_local const CancellationToken* tls_currentToken = nullptr;
+
+} // namespace
+
+CancellationToken::CancellationToken()
+    : m_state(std::make_shared<State>())
+{
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return m_state->cancelled.load();
+}
+
+uint64_t CancellationToken::onCancel(std::function<void()> fn) const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (m_state->cancelled.load()) {
+        fn();
+        return 0;
+    }
+    const uint64_t id = m_state->nextCallback++;
+    m_state->callbacks.emplace(id, std::move(fn));
+    return id;
+}
+
+void CancellationToken::removeCallback(uint64_t id) const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->callbacks.erase(id);
+}
+
+void CancellationToken::cancel() const
+{
+    // Callbacks run under the lock, so removeCallback() waits them out
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (m_state->cancelled.exchange(true)) {
+        return;
+    }
+    for (const auto& [id, callback] : m_state->callbacks) {
+        callback();
+    }
+    m_state->callbacks.clear();
+}
+
+void AnalysisScheduler::FairQueue::push(Task task)
+{
+    std::deque<Task>& queue = byOwner[task.owner];
+    if (queue.empty()) {
+        rotation.push_back(task.owner);
+    }
+    queue.push_back(std::move(task));
+    ++size;
+}
+
+bool AnalysisScheduler::FairQueue::pop(Task& outTask)
+{
+    if (rotation.empty()) {
+        return false;
+    }
+    const OwnerId owner = rotation.front();
+    rotation.pop_front();
+    auto it = byOwner.find(owner);
+    outTask = std::move(it->second.front());
+    it->second.pop_front();
+    --size;
+
+    // The owner goes to the back of the line if it has more
+    if (it->second.empty()) {
+        byOwner.erase(it);
+    } else {
+        rotation.push_back(owner);
+    }
+    return true;
+}
+
+void AnalysisScheduler::FairQueue::dropOwner(OwnerId owner, std::vector<Task>& outDropped)
+{
+    auto it = byOwner.find(owner);
+    if (it == byOwner.end()) {
+        return;
+    }
+    size -= it->second.size();
+    for (Task& task : it->second) {
+        outDropped.push_back(std::move(task));
+    }
+    byOwner.erase(it);
+    rotation.erase(std::remove(rotation.begin(), rotation.end(), owner), rotation.end());
+}
+
+AnalysisScheduler::AnalysisScheduler(size_t threads)
+{
+    if (threads == 0) {
+        threads = std::max<size_t>(2, std::thread::hardware_concurrency());
+    }
+    m_workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    // Start only once every Worker exists: workers steal from each other
+    for (size_t i = 0; i < threads; ++i) {
+        m_workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+}
+
+AnalysisScheduler::~AnalysisScheduler()
+{
+    // Queued jobs never run; running ones are asked to stop, then joined
+    std::vector<Task> dropped;
+    std::vector<CancellationToken> tokens;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        for (const auto& [owner, state] : m_owners) {
+            tokens.push_back(state->token);
+        }
+        for (FairQueue* queue : {&m_interactive, &m_batch}) {
+            Task task;
+            while (queue->pop(task)) {
+                dropped.push_back(std::move(task));
+            }
+        }
+    }
+    for (const CancellationToken& token : tokens) {
+        token.cancel();
+    }
+    // Before joining: a running job may be waiting on one of these
+    for (Task& task : dropped) {
+        task.done->set_value(false);
+    }
+    m_workAvailable.notify_all();
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+    for (auto& worker : m_workers) {
+        for (Task& task : worker->local) {
+            task.done->set_value(false);
+        }
+    }
+}
+
+AnalysisScheduler& AnalysisScheduler::instance()
+{
+    static AnalysisScheduler scheduler;
+    return scheduler;
+}
+
+std::future<bool> AnalysisScheduler::submit(OwnerId owner, JobPriority priority, Job job)
+{
+    Task task;
+    task.owner = owner;
+    task.job = std::move(job);
+    task.done = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = task.done->get_future();
+
+    // Fan-out from one of our workers stays with that worker (others steal)
+    // and shares the running job's token
+    if (tls_scheduler == this && tls_currentToken) {
+        task.token = *tls_currentToken;
+        Worker& worker = *m_workers[tls_workerIndex];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.local.push_back(std::move(task));
+        }
+        m_localQueued.fetch_add(1);
+        {
+            // Pairs with the wait predicate: no sleeping worker misses the count
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_workAvailable.notify_one();
+        return future;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            task.done->set_value(false);
+            return future;
+        }
+        std::shared_ptr<OwnerState>& state = m_owners[owner];
+        if (!state) {
+            state = std::make_shared<OwnerState>();
+        }
+        ++state->jobs;
+        task.state = state;
+        task.token = state->token;
+        (priority == JobPriority::Interactive ? m_interactive : m_batch).push(std::move(task));
+    }
+    m_workAvailable.notify_one();
+    return future;
+}
+
+CancellationToken AnalysisScheduler::token(OwnerId owner)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_owners.find(owner);
+    return it != m_owners.end() ? it->second->token : CancellationToken();
+}
+
+void AnalysisScheduler::cancelOwner(OwnerId owner)
+{
+    std::vector<Task> dropped;
+    CancellationToken cancelled;
+    bool hadToken = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_owners.find(owner);
+        if (it != m_owners.end()) {
+            cancelled = it->second->token;
+            hadToken = true;
+            // The next submission starts with a fresh token; running jobs
+            // keep the old state alive until they finish
+            m_owners.erase(it);
+        }
+        m_interactive.dropOwner(owner, dropped);
+        m_batch.dropOwner(owner, dropped);
+    }
+
+    // Outside the lock: callbacks may call back into the scheduler
+    if (hadToken) {
+        cancelled.cancel();
+    }
+    for (Task& task : dropped) {
+        releaseOwner(task);
+        task.done->set_value(false);
+    }
+}
+
+bool AnalysisScheduler::wait(std::future<bool>& future)
+{
+    if (tls_scheduler == this) {
+        // Help with fan-out meanwhile, never with queued jobs: those belong to
+        // any window and may block for long (remote runs), and each one could
+        // nest another wait. Without fan-out left, what is awaited is already
+        // running elsewhere.
+        const size_t index = tls_workerIndex;
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            Task task;
+            if (!popLocal(index, task) && !stealTask(index, task)) {
+                break;
+            }
+            runTask(task);
+        }
+    }
+    return future.get();
+}
+
+size_t AnalysisScheduler::queued() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_interactive.size + m_batch.size + m_localQueued.load();
+}
+
+size_t AnalysisScheduler::owners() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_owners.size();
+}
+
+void AnalysisScheduler::workerLoop(size_t index)
+{
+    tls_scheduler = this;
+    tls_workerIndex = index;
+    for (;;) {
+        Task task;
+        if (takeTask(index, task)) {
+            runTask(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_workAvailable.wait(lock, [this]() {
+            return m_stopping || m_interactive.size > 0 || m_batch.size > 0 || m_localQueued.load() > 0;
+        });
+        if (m_stopping) {
+            return;
+        }
+    }
+}
+
+bool AnalysisScheduler::takeTask(size_t index, Task& outTask)
+{
+    // Own fan-out first (newest first: its data is still warm)
+    if (popLocal(index, outTask)) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_stopping) {
+            const bool batchTurn = (++m_picks % BATCH_SHARE) == 0;
+            if (batchTurn && m_batch.pop(outTask)) {
+                return true;
+            }
+            if (m_interactive.pop(outTask) || m_batch.pop(outTask)) {
+                return true;
+            }
+        }
+    }
+    // Fan-out stays reachable while stopping: a helping wait() may need it
+    return stealTask(index, outTask);
+}
+
+bool AnalysisScheduler::popLocal(size_t index, Task& outTask)
+{
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.local.empty()) {
+        return false;
+    }
+    outTask = std::move(worker.local.back());
+    worker.local.pop_back();
+    m_localQueued.fetch_sub(1);
+    return true;
+}
+
+bool AnalysisScheduler::stealTask(size_t thief, Task& outTask)
+{
+    if (m_localQueued.load() == 0) {
+        return false;
+    }
+    // Oldest first: the victim keeps working on what it pushed last
+    for (size_t i = 1; i < m_workers.size(); ++i) {
+        // Blocking: deque operations are short, and skipping a busy victim
+        // would leave a queued task unseen while the count says otherwise
+        // (workerLoop would spin on it)
+        Worker& victim = *m_workers[(thief + i) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.local.empty()) {
+            continue;
+        }
+        outTask = std::move(victim.local.front());
+        victim.local.pop_front();
+        m_localQueued.fetch_sub(1);
+        m_stolen.fetch_add(1);
+        return true;
+    }
+    return false;
+}
+
+void AnalysisScheduler::runTask(Task& task)
+{
+    if (task.token.isCancelled()) {
+        releaseOwner(task);
+        task.done->set_value(false);
+        return;
+    }
+    // A throwing job must not take the worker down, nor leave its waiter
+    // hanging: the exception surfaces from the future instead
+    const CancellationToken* outer = tls_currentToken;  // Set inside a helping wait()
+    tls_currentToken = &task.token;
+    std::exception_ptr error;
+    try {
+        task.job(task.token);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    tls_currentToken = outer;
+    releaseOwner(task);
+    if (error) {
+        task.done->set_exception(error);
+        return;
+    }
+    m_completed.fetch_add(1);
+    task.done->set_value(true);
+}
+
+void AnalysisScheduler::releaseOwner(Task& task)
+{
+    if (!task.state) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--task.state->jobs == 0) {
+        // Only if cancelOwner() has not replaced it meanwhile
+        auto it = m_owners.find(task.owner);
+        if (it != m_owners.end() && it->second == task.state) {
+            m_owners.erase(it);
+        }
+    }
+    task.state.reset();
+}
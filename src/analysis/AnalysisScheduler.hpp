@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Priority class of a scheduled job
+enum class JobPriority {
+    Interactive,  // Run clicks, previews, viewport refinements
+    Batch         // Sweeps, studies; yield to interactive work
+};
+
+// Cancellation flag shared by the jobs of one owner (see
+// AnalysisScheduler::cancelOwner). Copies share the flag.
+class CancellationToken {
+public:
+    CancellationToken();
+
+    bool isCancelled() const;
+
+    // Run fn once when the token is cancelled (at once, on this thread, if it
+    // already is). fn runs on the cancelling thread, must not block and must
+    // not touch the token. Returns an id for removeCallback().
+    uint64_t onCancel(std::function<void()> fn) const;
+    // Once this returns, the callback is not running and never will; call it
+    // before whatever the callback touches goes away
+    void removeCallback(uint64_t id) const;
+
+    void cancel() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> m_state;
+};
+
+// Application-wide pool for analysis jobs, replacing a QThread per run.
+//
+// A fixed set of worker threads (sized to the hardware) serves every window.
+// Each owner (usually a window) has a queue per priority class; workers take
+// interactive jobs before batch jobs and go round-robin across owners within
+// a class, so one window queueing many jobs cannot starve the others. Batch
+// jobs still get one pick in BATCH_SHARE while interactive work waits.
+//
+// Jobs submitted from inside a running job (fan-out) go to that worker's own
+// deque; it runs them newest first, and idle workers steal them oldest first.
+//
+// Nothing here blocks the caller: submit() returns at once, results reach
+// the caller through the returned future or through the job's own signals.
+class AnalysisScheduler {
+public:
+    using OwnerId = uintptr_t;
+    // Job body; the token is the owner's at submission time
+    using Job = std::function<void(const CancellationToken& token)>;
+
+    // threads = 0: one per hardware thread (at least 2)
+    explicit AnalysisScheduler(size_t threads = 0);
+    ~AnalysisScheduler();
+
+    AnalysisScheduler(const AnalysisScheduler&) = delete;
+    AnalysisScheduler& operator=(const AnalysisScheduler&) = delete;
+
+    // Process-wide scheduler (shared by every analysis window)
+    static AnalysisScheduler& instance();
+
+    // Owner key of an object (e.g. a window)
+    static OwnerId ownerOf(const void* object) { return reinterpret_cast<OwnerId>(object); }
+
+    /**
+     * Queue job for owner.
+     *
+     * Fan-out (submitted from inside a running job) runs under the parent
+     * job's token, whatever owner it names, so cancelling the parent's owner
+     * stops it too.
+     *
+     * @return Future that becomes true once the job has run, or false if it
+     *         was cancelled before it started (it then never runs). If the
+     *         job throws, the future holds the exception.
+     */
+    std::future<bool> submit(OwnerId owner, JobPriority priority, Job job);
+
+    // Token of owner's queued and running jobs: cancelled by the next
+    // cancelOwner(owner). An owner without jobs has no token of its own; it
+    // gets a fresh one that nothing will cancel.
+    CancellationToken token(OwnerId owner);
+
+    // Cancel every queued and running job of owner. Queued jobs are dropped;
+    // running ones see their token cancelled and should return soon. Jobs
+    // submitted afterwards get a fresh token. Never waits; call it when an
+    // owner goes away, too.
+    void cancelOwner(OwnerId owner);
+
+    // Wait for a job's future (blocks: not for the GUI thread); rethrows what
+    // the job threw. Inside a job this runs fan-out meanwhile (its own first,
+    // then other workers'), so a job may wait on jobs it submitted without
+    // tying up the pool; queued jobs of other owners are left to the pool.
+    bool wait(std::future<bool>& future);
+
+    size_t threadCount() const { return m_workers.size(); }
+    // Jobs queued but not started (all owners)
+    size_t queued() const;
+    // Owners with queued or running jobs
+    size_t owners() const;
+    // Jobs run to completion, and jobs taken from another worker's deque
+    uint64_t completed() const { return m_completed.load(); }
+    uint64_t stolen() const { return m_stolen.load(); }
+
+    // While interactive jobs wait, every BATCH_SHARE-th pick takes a batch job
+    static constexpr unsigned BATCH_SHARE = 4;
+
+private:
+    // Token and job count of an owner; dropped once it has no jobs left
+    struct OwnerState {
+        CancellationToken token;
+        size_t jobs = 0;  // Queued and running
+    };
+
+    struct Task {
+        OwnerId owner = 0;
+        CancellationToken token;
+        Job job;
+        std::shared_ptr<std::promise<bool>> done;
+        std::shared_ptr<OwnerState> state;  // Unset for fan-out
+    };
+
+    // Round-robin queues of one priority class
+    struct FairQueue {
+        std::map<OwnerId, std::deque<Task>> byOwner;
+        std::deque<OwnerId> rotation;  // Owners with queued jobs, next first
+        size_t size = 0;
+
+        void push(Task task);
+        bool pop(Task& outTask);
+        void dropOwner(OwnerId owner, std::vector<Task>& outDropped);
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;          // Guards local
+        std::deque<Task> local;    // Fan-out of this worker's jobs
+    };
+
+    void workerLoop(size_t index);
+    bool takeTask(size_t index, Task& outTask);
+    bool popLocal(size_t index, Task& outTask);
+    bool stealTask(size_t thief, Task& outTask);
+    void runTask(Task& task);
+    // Drop task's hold on its owner's state (and the state with the last one)
+    void releaseOwner(Task& task);
+
+    mutable std::mutex m_mutex;  // Guards everything below but the workers' deques
+    std::condition_variable m_workAvailable;
+    FairQueue m_interactive;
+    FairQueue m_batch;
+    unsigned m_picks = 0;
+    std::map<OwnerId, std::shared_ptr<OwnerState>> m_owners;  // Owners with jobs
+    bool m_stopping = false;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<size_t> m_localQueued{0};  // Tasks in the workers' deques
+    std::atomic<uint64_t> m_completed{0};
+    std::atomic<uint64_t> m_stolen{0};
+};
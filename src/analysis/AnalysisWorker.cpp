@@ -1,7 +1,11 @@
 #include "AnalysisWorker.hpp"
 #include "analysis/demo/XYSineDemo.hpp"
+#include "analysis/AutoExecutor.hpp"
 #include "analysis/LocalExecutor.hpp"
 #include "analysis/RemoteExecutor.hpp"
+#include "analysis/SweepDataset.hpp"
+#include "analysis/SweepEngine.hpp"
+#include "analysis/SweepPlan.hpp"
 // TODO(Phase 3+): Re-enable license checks when LicenseManager is available
 // #include "app/LicenseManager.h"
 #include <QDebug>
@@ -13,6 +17,11 @@ AnalysisWorker::AnalysisWorker(QObject* parent)
     , m_localExecutor(std::make_unique<LocalExecutor>())
     , m_remoteExecutor(std::make_unique<RemoteExecutor>())
 {
+    RemoteExecutor* remoteExecutor = m_remoteExecutor.get();
+    m_autoExecutor = std::make_unique<AutoExecutor>(
+        m_localExecutor.get(), remoteExecutor,
+        [remoteExecutor](const QString& featureId) { return remoteExecutor->probeLink(featureId); });
+
     // Register XYSineResult meta-type for signal/slot passing
     qRegisterMetaType<XYSineResult>("XYSineResult");
     qRegisterMetaType<XYSineResult>("XYSineResult&");
@@ -31,6 +40,22 @@ void AnalysisWorker::setRunMode(AnalysisRunMode mode)
     m_runMode = mode;
 }
 
+void AnalysisWorker::setDeltaBaseSlot(std::shared_ptr<DeltaBaseSlot> slot)
+{
+    m_remoteExecutor->setDeltaBaseSlot(std::move(slot));
+}
+
+void AnalysisWorker::setCacheResults(bool cache)
+{
+    m_localExecutor->setStoreResults(cache);
+}
+
+void AnalysisWorker::setSweep(std::shared_ptr<const SweepPlan> plan, std::shared_ptr<SweepDataset> dataset)
+{
+    m_sweepPlan = std::move(plan);
+    m_sweepDataset = std::move(dataset);
+}
+
 void AnalysisWorker::run()
 {
     emit started();
@@ -42,8 +67,14 @@ void AnalysisWorker::run()
         return;
     }
     
+    if (m_sweepPlan && m_sweepDataset) {
+        executeSweep();
+        return;
+    }
+    
     // WP1: Use executor pattern if enabled, otherwise fall back to legacy path
-    if (m_runMode == AnalysisRunMode::LocalOnly || m_runMode == AnalysisRunMode::RemoteOnly) {
+    if (m_runMode == AnalysisRunMode::LocalOnly || m_runMode == AnalysisRunMode::RemoteOnly
+        || m_runMode == AnalysisRunMode::Auto) {
         executeWithExecutor();
     } else {
         // Fallback to legacy executeCompute (should not happen with current enum)
@@ -59,35 +90,54 @@ void AnalysisWorker::requestCancel()
         m_localExecutor->cancel();
     }
     if (m_remoteExecutor) {
+        // Abandons the in-flight Bedrock request, unblocking run()
         m_remoteExecutor->cancel();
     }
-    // Actual cancellation logic will be implemented in WP3.5.2
+    if (m_autoExecutor) {
+        // Keeps a cancelled remote run from falling back to a local one
+        m_autoExecutor->cancel();
+    }
+    std::lock_guard<std::mutex> lock(m_sweepMutex);
+    if (m_sweepEngine) {
+        m_sweepEngine->cancel();
+    }
 }
 
-void AnalysisWorker::executeWithExecutor()
+IAnalysisExecutor* AnalysisWorker::selectedExecutor() const
 {
-    // Select executor based on run mode
-    IAnalysisExecutor* executor = nullptr;
     if (m_runMode == AnalysisRunMode::LocalOnly) {
-        executor = m_localExecutor.get();
-    } else if (m_runMode == AnalysisRunMode::RemoteOnly) {
-        executor = m_remoteExecutor.get();
+        return m_localExecutor.get();
     }
-    
+    if (m_runMode == AnalysisRunMode::RemoteOnly) {
+        return m_remoteExecutor.get();
+    }
+    if (m_runMode == AnalysisRunMode::Auto) {
+        return m_autoExecutor.get();
+    }
+    return nullptr;
+}
+
+void AnalysisWorker::executeWithExecutor()
+{
+    // Select executor based on run mode
+    IAnalysisExecutor* executor = selectedExecutor();
     if (!executor) {
         emit finished(false, QVariant(), QString("No executor available"));
         return;
     }
     
+    // Forward streamed slices so the plot can draw before the transfer ends
+    executor->setPartialResultCallback([this](const XYSineResult& chunk, size_t offset, size_t totalSamples) {
+        emit partialResult(QVariant::fromValue(chunk), offset, totalSamples);
+    });
+    
     // Execute with callbacks
     executor->execute(
         m_featureId,
         m_params,
-        // Progress callback
-        [this](double progress) {
-            // WP1: No progress reporting yet
-            // Future: emit progress signal
-            Q_UNUSED(progress);
+        // Progress callback (may run on the transport I/O thread)
+        [this](double fraction) {
+            emit progress(fraction);
         },
         // Result callback
         [this](const XYSineResult& result) {
@@ -95,11 +145,54 @@ void AnalysisWorker::executeWithExecutor()
         },
         // Error callback
         [this](const QString& error) {
+            // A cancelled run is not a failure
+            if (m_cancelRequested.load()) {
+                emit cancelled();
+                emit finished(false, QVariant(), QString());
+                return;
+            }
             emit finished(false, QVariant(), error);
         }
     );
 }
 
+void AnalysisWorker::executeSweep()
+{
+    IAnalysisExecutor* executor = selectedExecutor();
+    if (!executor) {
+        emit finished(false, QVariant(), QString("No executor available"));
+        return;
+    }
+    
+    SweepEngine engine(executor);
+    {
+        std::lock_guard<std::mutex> lock(m_sweepMutex);
+        m_sweepEngine = &engine;
+    }
+    QString error;
+    const bool ok = engine.run(
+        *m_sweepPlan, *m_sweepDataset,
+        [this](double fraction) { emit progress(fraction); },
+        [this, &engine](size_t, const XYSineResult*, const QString&) {
+            // run() clears a cancel that came in before it started
+            if (m_cancelRequested.load()) {
+                engine.cancel();
+            }
+        },
+        &error);
+    {
+        std::lock_guard<std::mutex> lock(m_sweepMutex);
+        m_sweepEngine = nullptr;
+    }
+    
+    if (!ok && m_cancelRequested.load()) {
+        emit cancelled();
+        emit finished(false, QVariant(), QString());
+        return;
+    }
+    emit finished(ok, QVariant(), ok ? QString() : error);
+}
+
 void AnalysisWorker::executeCompute()
 {
     // Handle "noop" feature for tests
@@ -6,14 +6,22 @@
 #include <QMap>
 #include <atomic>
 #include <memory>
+#include <mutex>
 
-// Forward declaration
+// Forward declarations
+class DeltaBaseSlot;
 class IAnalysisExecutor;
+class LocalExecutor;
+class RemoteExecutor;
+class SweepDataset;
+class SweepEngine;
+class SweepPlan;
 
 // Analysis run mode (Strategy pattern selection)
 enum class AnalysisRunMode {
     LocalOnly,   // Use LocalExecutor (existing local compute path)
-    RemoteOnly   // Use RemoteExecutor (future Bedrock communication)
+    RemoteOnly,  // Use RemoteExecutor (future Bedrock communication)
+    Auto         // Use AutoExecutor: local or remote per request, by measured cost
 };
 
 class AnalysisWorker : public QObject {
@@ -29,18 +37,38 @@ public:
     void setRunMode(AnalysisRunMode mode);
     AnalysisRunMode runMode() const { return m_runMode; }
 
+    // Previous result of the caller's runs, for delta requests of the
+    // remote path (see RemoteExecutor::setDeltaBaseSlot)
+    void setDeltaBaseSlot(std::shared_ptr<DeltaBaseSlot> slot);
+
+    // Whether local results go into the result cache (off for previews;
+    // see LocalExecutor::setStoreResults)
+    void setCacheResults(bool cache);
+
+    // Run plan into dataset (SweepEngine on the run mode's executor) instead
+    // of a single run; finished() then carries no result. The dataset is
+    // written on the worker's thread until finished() is emitted.
+    void setSweep(std::shared_ptr<const SweepPlan> plan, std::shared_ptr<SweepDataset> dataset);
+
 public slots:
     void run();  // Executes compute in worker thread
-    void requestCancel();  // Placeholder for WP3.5.2
+    void requestCancel();  // Thread-safe; call directly while run() is busy
 
 signals:
     void started();
     void finished(bool success, const QVariant& result, const QString& error);
-    void cancelled();  // Placeholder for WP3.5.2
+    void cancelled();
+    // Fraction done (0.0-1.0) of the running computation
+    void progress(double fraction);
+    // Streamed slice of a result still in flight (XYSineResult covering
+    // samples [offset, offset + size) of totalSamples)
+    void partialResult(const QVariant& chunk, qulonglong offset, qulonglong totalSamples);
 
 private:
     void executeCompute();
     void executeWithExecutor();  // New: Uses executor pattern
+    void executeSweep();
+    IAnalysisExecutor* selectedExecutor() const;  // Of m_runMode
     
     QString m_featureId;
     QMap<QString, QVariant> m_params;
@@ -48,7 +76,13 @@ private:
     
     // WP1: Strategy pattern - executor selection
     AnalysisRunMode m_runMode;
-    std::unique_ptr<IAnalysisExecutor> m_localExecutor;
-    std::unique_ptr<IAnalysisExecutor> m_remoteExecutor;
+    std::unique_ptr<LocalExecutor> m_localExecutor;
+    std::unique_ptr<RemoteExecutor> m_remoteExecutor;  // Typed: also takes the delta base slot
+    std::unique_ptr<IAnalysisExecutor> m_autoExecutor;  // Over the two above
+    
+    std::shared_ptr<const SweepPlan> m_sweepPlan;  // Set: run() runs a sweep
+    std::shared_ptr<SweepDataset> m_sweepDataset;
+    std::mutex m_sweepMutex;                       // Guards m_sweepEngine
+    SweepEngine* m_sweepEngine = nullptr;          // Of the running sweep
 };
 
@@ -0,0 +1,247 @@
+#include "AutoExecutor.hpp"
+#include "AnalysisScheduler.hpp"
+#include "LocalExecutor.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Path = ExecutionCostModel::Path;
+
+// Work of one request for the cost model
+size_t samplesOf(const QMap<QString, QVariant>& params)
+{
+    return static_cast<size_t>(XYSineDemo::parseParams(params).samples);
+}
+
+} // namespace
+
+AutoExecutor::AutoExecutor(IAnalysisExecutor* local, IAnalysisExecutor* remote, LinkProbe probe,
+                           ExecutionCostModel* model)
+    : m_local(local)
+    , m_remote(remote)
+    , m_probe(std::move(probe))
+    , m_model(model)
+    , m_cancelled(false)
+{
+}
+
+bool AutoExecutor::runSingle(Path path,
+                             const QString& featureId,
+                             const QMap<QString, QVariant>& params,
+                             const ProgressCallback& onProgress,
+                             const ResultCallback& onResult,
+                             const ErrorCallback& onError,
+                             double rttMs)
+{
+    IAnalysisExecutor* executor = path == Path::Local ? m_local : m_remote;
+    bool delivered = false;
+    bool cached = false;  // Answered from a cache: not a measurement
+    executor->setCacheHitCallback([&cached](size_t) { cached = true; });
+    m_model->runStarted(path);
+    const auto start = Clock::now();
+    executor->execute(
+        featureId, params, onProgress,
+        [&](const XYSineResult& result) {
+            // Timed before the consumer runs
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+            delivered = true;
+            if (!cached && path == Path::Local) {
+                m_model->recordLocal(featureId, samplesOf(params), elapsed);
+            } else if (!cached) {
+                m_model->recordRemote(featureId, samplesOf(params), elapsed, rttMs);
+            }
+            if (onResult) {
+                onResult(result);
+            }
+        },
+        onError);
+    m_model->runFinished(path);
+    executor->setCacheHitCallback(nullptr);
+    return delivered;
+}
+
+void AutoExecutor::execute(
+    const QString& featureId,
+    const QMap<QString, QVariant>& params,
+    ProgressCallback onProgress,
+    ResultCallback onResult,
+    ErrorCallback onError)
+{
+    m_cancelled.store(false);
+
+    const bool localSupported = LocalExecutor::supports(featureId);
+    const ExecutionCostModel::RemoteLink link = m_probe ? m_probe(featureId) : ExecutionCostModel::RemoteLink();
+    const ExecutionCostModel::Decision decision =
+        m_model->decide(featureId, samplesOf(params), 1, localSupported, link);
+
+    if (decision.path == Path::Local) {
+        runSingle(Path::Local, featureId, params, onProgress, onResult, onError, link.rttMs);
+        return;
+    }
+
+    // Remote; its error is held back while a local run can still answer
+    QString remoteError;
+    const bool delivered = runSingle(Path::Remote, featureId, params, onProgress, onResult,
+                                     [&remoteError](const QString& error) { remoteError = error; },
+                                     link.rttMs);
+    if (delivered) {
+        return;
+    }
+    if (!m_cancelled.load() && localSupported) {
+        qCInfo(phxAutoRun).noquote()
+            << QString("%1: remote run failed (%2), running locally").arg(featureId, remoteError);
+        runSingle(Path::Local, featureId, params, onProgress, onResult, onError, link.rttMs);
+        return;
+    }
+    if (onError) {
+        onError(remoteError);
+    }
+}
+
+void AutoExecutor::executeBatch(
+    const QString& featureId,
+    const std::vector<QMap<QString, QVariant>>& paramSets,
+    ProgressCallback onProgress,
+    BatchItemCallback onItem)
+{
+    m_cancelled.store(false);
+
+    const size_t total = paramSets.size();
+    if (total == 0) {
+        return;
+    }
+
+    size_t totalSamples = 0;
+    for (const QMap<QString, QVariant>& params : paramSets) {
+        totalSamples += samplesOf(params);
+    }
+    const bool localSupported = LocalExecutor::supports(featureId);
+    const ExecutionCostModel::RemoteLink link = m_probe ? m_probe(featureId) : ExecutionCostModel::RemoteLink();
+    const ExecutionCostModel::Decision decision =
+        m_model->decide(featureId, totalSamples / total, total, localSupported, link);
+
+    // The first localItems items run locally, the rest remotely
+    std::vector<size_t> localItems;
+    std::vector<size_t> remoteItems;
+    for (size_t index = 0; index < total; ++index) {
+        (index < decision.localItems ? localItems : remoteItems).push_back(index);
+    }
+
+    // Items are reported one at a time, whichever path finished them
+    std::mutex reportMutex;
+    size_t done = 0;
+    std::vector<size_t> retryLocally;  // Remote failures the local path gets another go at
+    auto report = [&](size_t index, const XYSineResult* result, const QString& error) {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        if (onItem) {
+            onItem(index, result, error);
+        }
+        ++done;
+        if (onProgress) {
+            onProgress(static_cast<double>(done) / total);
+        }
+    };
+
+    // Run items on one path as one batch, timing the ones that succeed
+    auto runPart = [&](Path path, const std::vector<size_t>& items) {
+        if (items.empty()) {
+            return;
+        }
+        IAnalysisExecutor* executor = path == Path::Local ? m_local : m_remote;
+        const bool holdFailures = path == Path::Remote && localSupported;
+        std::vector<QMap<QString, QVariant>> sets;
+        sets.reserve(items.size());
+        for (size_t index : items) {
+            sets.push_back(paramSets[index]);
+        }
+        std::atomic<size_t> succeededSamples(0);  // Computed, not answered from a cache
+        std::vector<char> cached(items.size(), 0);
+        executor->setCacheHitCallback([&cached](size_t item) { cached[item] = 1; });
+        m_model->runStarted(path);
+        const auto start = Clock::now();
+        executor->executeBatch(featureId, sets, nullptr,
+                               [&](size_t item, const XYSineResult* result, const QString& error) {
+                                   if (result) {
+                                       if (!cached[item]) {
+                                           succeededSamples += samplesOf(sets[item]);
+                                       }
+                                   } else if (holdFailures && !m_cancelled.load()) {
+                                       std::lock_guard<std::mutex> lock(reportMutex);
+                                       retryLocally.push_back(items[item]);
+                                       return;
+                                   }
+                                   report(items[item], result, error);
+                               });
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+        m_model->runFinished(path);
+        executor->setCacheHitCallback(nullptr);
+        if (path == Path::Local) {
+            m_model->recordLocal(featureId, succeededSamples.load(), elapsed);
+        } else {
+            m_model->recordRemote(featureId, succeededSamples.load(), elapsed, link.rttMs);
+        }
+    };
+
+    // Both paths at once: the local half is a scheduler job (its items fan
+    // out from there), the remote half runs here, waiting on the wire
+    if (!localItems.empty() && !remoteItems.empty()) {
+        AnalysisScheduler& scheduler = AnalysisScheduler::instance();
+        std::future<bool> localPart = scheduler.submit(AnalysisScheduler::ownerOf(this), JobPriority::Batch,
+                                                       [&](const CancellationToken&) {
+                                                           runPart(Path::Local, localItems);
+                                                       });
+        runPart(Path::Remote, remoteItems);
+        // Must be waited for: it uses this frame. Dropped unstarted only
+        // when its owner (or the parent job) was cancelled.
+        if (!scheduler.wait(localPart)) {
+            for (size_t index : localItems) {
+                report(index, nullptr, QString("Computation cancelled"));
+            }
+        }
+    } else {
+        runPart(Path::Local, localItems);
+        runPart(Path::Remote, remoteItems);
+    }
+
+    if (!retryLocally.empty() && m_cancelled.load()) {
+        for (size_t index : retryLocally) {
+            report(index, nullptr, QString("Computation cancelled"));
+        }
+        return;
+    }
+    if (!retryLocally.empty()) {
+        qCInfo(phxAutoRun).noquote()
+            << QString("%1: %2 remote item(s) failed, running them locally").arg(featureId).arg(retryLocally.size());
+        std::sort(retryLocally.begin(), retryLocally.end());
+        runPart(Path::Local, retryLocally);
+    }
+}
+
+void AutoExecutor::cancel()
+{
+    m_cancelled.store(true);
+    if (m_local) {
+        m_local->cancel();
+    }
+    if (m_remote) {
+        m_remote->cancel();
+    }
+}
+
+void AutoExecutor::setPartialResultCallback(PartialResultCallback onPartial)
+{
+    // Only remote runs stream; local ones ignore it
+    if (m_local) {
+        m_local->setPartialResultCallback(onPartial);
+    }
+    if (m_remote) {
+        m_remote->setPartialResultCallback(std::move(onPartial));
+    }
+}
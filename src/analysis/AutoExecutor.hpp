@@ -0,0 +1,61 @@
+#pragma once
+
+#include "IAnalysisExecutor.hpp"
+#include "ExecutionCostModel.hpp"
+#include <atomic>
+#include <functional>
+
+// Executor of the Auto run mode: asks the ExecutionCostModel where each
+// request should run, then hands it to the local or the remote executor.
+//
+// execute() takes one path. A remote run that fails before delivering a
+// result falls back to the local path when the feature has one.
+// executeBatch() may split the items between both paths, running them at
+// the same time (the local half on the AnalysisScheduler, the remote half on
+// the calling thread); remote items that fail are retried locally the same way.
+// Every finished run is timed and fed back into the model.
+class AutoExecutor : public IAnalysisExecutor {
+public:
+    // Reports the remote path's state before each decision
+    using LinkProbe = std::function<ExecutionCostModel::RemoteLink(const QString& featureId)>;
+
+    // local and remote are not owned and must outlive this executor
+    AutoExecutor(IAnalysisExecutor* local, IAnalysisExecutor* remote, LinkProbe probe,
+                 ExecutionCostModel* model = &ExecutionCostModel::instance());
+    ~AutoExecutor() override = default;
+
+    // IAnalysisExecutor interface
+    void execute(
+        const QString& featureId,
+        const QMap<QString, QVariant>& params,
+        ProgressCallback onProgress,
+        ResultCallback onResult,
+        ErrorCallback onError
+    ) override;
+
+    void executeBatch(
+        const QString& featureId,
+        const std::vector<QMap<QString, QVariant>>& paramSets,
+        ProgressCallback onProgress,
+        BatchItemCallback onItem
+    ) override;
+
+    void cancel() override;
+    void setPartialResultCallback(PartialResultCallback onPartial) override;
+
+private:
+    // Run on one executor, timing it for the model; true if a result arrived
+    bool runSingle(ExecutionCostModel::Path path,
+                   const QString& featureId,
+                   const QMap<QString, QVariant>& params,
+                   const ProgressCallback& onProgress,
+                   const ResultCallback& onResult,
+                   const ErrorCallback& onError,
+                   double rttMs);
+
+    IAnalysisExecutor* m_local;   // Not owned
+    IAnalysisExecutor* m_remote;  // Not owned
+    LinkProbe m_probe;
+    ExecutionCostModel* m_model;  // Not owned
+    std::atomic<bool> m_cancelled;
+};
@@ -0,0 +1,241 @@
+// Viewport decimation for XY results
+// Shared by local plotting and the remote range-query fallback
+
+#include "Decimation.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Decimation {
+
+const char* methodName(Method method)
+{
+    switch (method) {
+        case Method::MinMax:
+            return "minmax";
+        case Method::Lttb:
+            return "lttb";
+    }
+    return "minmax";
+}
+
+std::optional<Method> parseMethod(const QString& name)
+{
+    if (name == "minmax") {
+        return Method::MinMax;
+    }
+    if (name == "lttb") {
+        return Method::Lttb;
+    }
+    return std::nullopt;
+}
+
+std::optional<Viewport> viewportFromParams(const QMap<QString, QVariant>& params,
+                                           double fullXMin, double fullXMax)
+{
+    bool ok = false;
+    const int pixelWidth = params.value(kViewPixelsParam).toInt(&ok);
+    if (!ok || pixelWidth <= 0) {
+        return std::nullopt;
+    }
+
+    Viewport viewport;
+    viewport.pixelWidth = pixelWidth;
+    viewport.xMin = fullXMin;
+    viewport.xMax = fullXMax;
+
+    bool minOk = false;
+    bool maxOk = false;
+    const double xMin = params.value(kViewXMinParam).toDouble(&minOk);
+    const double xMax = params.value(kViewXMaxParam).toDouble(&maxOk);
+    if (minOk && maxOk && xMax > xMin) {
+        viewport.xMin = xMin;
+        viewport.xMax = xMax;
+    }
+
+    if (auto method = parseMethod(params.value(kDecimationParam).toString())) {
+        viewport.method = *method;
+    }
+    return viewport;
+}
+
+size_t pointBudget(int pixelWidth)
+{
+    // Two points (min and max) per pixel column
+    return pixelWidth > 0 ? static_cast<size_t>(pixelWidth) * 2 : 0;
+}
+
+void minMaxPerPixel(const double* x, const double* y, size_t count,
+                    double xMin, double xMax, int pixelWidth, XYSineResult& outResult)
+{
+    outResult.x.clear();
+    outResult.y.clear();
+    if (count == 0 || pixelWidth <= 0 || !(xMax > xMin)) {
+        return;
+    }
+    outResult.x.reserve(pointBudget(pixelWidth));
+    outResult.y.reserve(pointBudget(pixelWidth));
+
+    const double pixelsPerUnit = pixelWidth / (xMax - xMin);
+    auto column = [&](double value) {
+        const double pixel = std::floor((value - xMin) * pixelsPerUnit);
+        return static_cast<int>(std::clamp(pixel, 0.0, static_cast<double>(pixelWidth - 1)));
+    };
+
+    size_t start = 0;
+    while (start < count) {
+        // One pixel column: [start, end)
+        const int current = column(x[start]);
+        size_t end = start + 1;
+        size_t minIndex = start;
+        size_t maxIndex = start;
+        while (end < count && column(x[end]) == current) {
+            if (y[end] < y[minIndex]) {
+                minIndex = end;
+            }
+            if (y[end] > y[maxIndex]) {
+                maxIndex = end;
+            }
+            ++end;
+        }
+
+        const size_t first = std::min(minIndex, maxIndex);
+        const size_t second = std::max(minIndex, maxIndex);
+        outResult.x.push_back(x[first]);
+        outResult.y.push_back(y[first]);
+        if (second != first) {
+            outResult.x.push_back(x[second]);
+            outResult.y.push_back(y[second]);
+        }
+        start = end;
+    }
+}
+
+void lttb(const double* x, const double* y, size_t count, size_t threshold, XYSineResult& outResult)
+{
+    outResult.x.clear();
+    outResult.y.clear();
+    if (threshold >= count) {
+        outResult.x.assign(x, x + count);
+        outResult.y.assign(y, y + count);
+        return;
+    }
+    if (threshold < 3) {
+        // No room for buckets: endpoints only
+        for (size_t i : {size_t(0), count - 1}) {
+            if (outResult.x.size() < threshold) {
+                outResult.x.push_back(x[i]);
+                outResult.y.push_back(y[i]);
+            }
+        }
+        return;
+    }
+    outResult.x.reserve(threshold);
+    outResult.y.reserve(threshold);
+
+    // First and last samples are fixed; the rest are split into
+    // threshold - 2 buckets, each contributing the sample forming the
+    // largest triangle with the previous pick and the next bucket's average
+    const double bucketSize = static_cast<double>(count - 2) / (threshold - 2);
+    size_t previous = 0;
+    outResult.x.push_back(x[0]);
+    outResult.y.push_back(y[0]);
+
+    for (size_t bucket = 0; bucket < threshold - 2; ++bucket) {
+        const size_t begin = static_cast<size_t>(std::floor(bucket * bucketSize)) + 1;
+        const size_t end = std::min(static_cast<size_t>(std::floor((bucket + 1) * bucketSize)) + 1, count - 1);
+
+        const size_t nextBegin = end;
+        const size_t nextEnd = std::min(static_cast<size_t>(std::floor((bucket + 2) * bucketSize)) + 1, count);
+        double averageX = 0.0;
+        double averageY = 0.0;
+        for (size_t i = nextBegin; i < nextEnd; ++i) {
+            averageX += x[i];
+            averageY += y[i];
+        }
+        const size_t nextCount = std::max<size_t>(nextEnd - nextBegin, 1);
+        averageX /= nextCount;
+        averageY /= nextCount;
+
+        size_t picked = begin;
+        double largestArea = -1.0;
+        for (size_t i = begin; i < end; ++i) {
+            const double area = std::abs((x[previous] - averageX) * (y[i] - y[previous])
+                                         - (x[previous] - x[i]) * (averageY - y[previous]));
+            if (area > largestArea) {
+                largestArea = area;
+                picked = i;
+            }
+        }
+        outResult.x.push_back(x[picked]);
+        outResult.y.push_back(y[picked]);
+        previous = picked;
+    }
+
+    outResult.x.push_back(x[count - 1]);
+    outResult.y.push_back(y[count - 1]);
+}
+
+bool decimate(const XYSineResult& input, const Viewport& viewport, XYSineResult& outResult)
+{
+    outResult.x.clear();
+    outResult.y.clear();
+    if (!viewport.isValid() || input.x.size() != input.y.size()) {
+        return false;
+    }
+
+    // Samples in range, widened by one on each side
+    auto lower = std::lower_bound(input.x.begin(), input.x.end(), viewport.xMin);
+    auto upper = std::upper_bound(input.x.begin(), input.x.end(), viewport.xMax);
+    size_t begin = static_cast<size_t>(lower - input.x.begin());
+    size_t end = static_cast<size_t>(upper - input.x.begin());
+    if (begin > 0) {
+        --begin;
+    }
+    if (end < input.x.size()) {
+        ++end;
+    }
+    if (begin >= end) {
+        return true;
+    }
+
+    const double* x = input.x.data() + begin;
+    const double* y = input.y.data() + begin;
+    const size_t count = end - begin;
+    const size_t budget = pointBudget(viewport.pixelWidth);
+    if (count <= budget) {
+        outResult.x.assign(x, x + count);
+        outResult.y.assign(y, y + count);
+        return true;
+    }
+
+    if (viewport.method == Method::Lttb) {
+        lttb(x, y, count, budget, outResult);
+        return true;
+    }
+
+    // Edge samples outside the range stay as-is; the inside is reduced
+    const bool leadingEdge = x[0] < viewport.xMin;
+    const bool trailingEdge = x[count - 1] > viewport.xMax;
+    const size_t innerBegin = leadingEdge ? 1 : 0;
+    const size_t innerEnd = trailingEdge ? count - 1 : count;
+
+    XYSineResult inner;
+    minMaxPerPixel(x + innerBegin, y + innerBegin, innerEnd - innerBegin,
+                   viewport.xMin, viewport.xMax, viewport.pixelWidth, inner);
+
+    outResult.x.reserve(inner.x.size() + 2);
+    outResult.y.reserve(inner.y.size() + 2);
+    if (leadingEdge) {
+        outResult.x.push_back(x[0]);
+        outResult.y.push_back(y[0]);
+    }
+    outResult.x.insert(outResult.x.end(), inner.x.begin(), inner.x.end());
+    outResult.y.insert(outResult.y.end(), inner.y.begin(), inner.y.end());
+    if (trailingEdge) {
+        outResult.x.push_back(x[count - 1]);
+        outResult.y.push_back(y[count - 1]);
+    }
+    return true;
+}
+
+} // namespace Decimation
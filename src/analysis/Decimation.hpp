@@ -0,0 +1,61 @@
+#pragma once
+
+#include "analysis/demo/XYSineDemo.hpp"
+#include <QString>
+#include <cstddef>
+#include <optional>
+
+// Viewport decimation for XY results (x ascending)
+// Reduces the samples inside a visible x-range to a few points per pixel so
+// transfer size and render cost depend on the plot width, not the result
+// size. Bedrock applies the same reduction server-side for range queries;
+// Phoenix uses it for local results and for servers without range support.
+namespace Decimation {
+    // Analysis parameters describing the visible viewport (optional; a
+    // missing x-range means the full result)
+    inline constexpr const char* kViewXMinParam = "view_x_min";
+    inline constexpr const char* kViewXMaxParam = "view_x_max";
+    inline constexpr const char* kViewPixelsParam = "view_pixels";
+    inline constexpr const char* kDecimationParam = "decimation";
+
+    enum class Method {
+        MinMax,  // Min and max per pixel column: exact line envelope
+        Lttb     // Largest-Triangle-Three-Buckets: smoother, same budget
+    };
+
+    const char* methodName(Method method);  // "minmax", "lttb"
+    std::optional<Method> parseMethod(const QString& name);
+
+    // Viewport requested for one result
+    struct Viewport {
+        double xMin = 0.0;
+        double xMax = 0.0;
+        int pixelWidth = 0;
+        Method method = Method::MinMax;
+
+        bool isValid() const { return pixelWidth > 0 && xMax > xMin; }
+    };
+
+    // Viewport from analysis parameters, if kViewPixelsParam is set. Without
+    // an x-range, fullXMin/fullXMax are used.
+    std::optional<Viewport> viewportFromParams(const QMap<QString, QVariant>& params,
+                                               double fullXMin, double fullXMax);
+
+    // Point budget for a viewport: ranges with at most this many samples are
+    // returned unreduced
+    size_t pointBudget(int pixelWidth);
+
+    // Min/max per pixel column of [xMin, xMax] mapped onto pixelWidth
+    // columns; each column's extremes are emitted in sample order.
+    void minMaxPerPixel(const double* x, const double* y, size_t count,
+                        double xMin, double xMax, int pixelWidth, XYSineResult& outResult);
+
+    // Largest-Triangle-Three-Buckets down to threshold points (first and
+    // last sample always kept)
+    void lttb(const double* x, const double* y, size_t count, size_t threshold, XYSineResult& outResult);
+
+    // Samples of input inside the viewport, reduced with its method. The
+    // nearest sample outside each end is kept so lines reach the plot edges.
+    // Returns false for an invalid viewport or mismatched input.
+    bool decimate(const XYSineResult& input, const Viewport& viewport, XYSineResult& outResult);
+}
@@ -0,0 +1,24 @@
+#include "DeltaBaseSlot.hpp"
+
+DeltaBaseSlot::Base DeltaBaseSlot::get(const QString& featureId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (featureId != m_featureId) {
+        return {};
+    }
+    return m_base;
+}
+
+void DeltaBaseSlot::set(const QString& featureId, Base base)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_featureId = featureId;
+    m_base = std::move(base);
+}
+
+void DeltaBaseSlot::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_featureId.clear();
+    m_base = {};
+}
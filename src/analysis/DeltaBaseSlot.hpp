@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+struct XYSineResult;
+
+// The last full-precision result of one feature, offered to Bedrock as the
+// base of the next run so it sends only the columns that changed (see
+// transport/DeltaResponse.hpp).
+//
+// Executors come and go with every run, so the slot lives with whoever
+// re-runs the feature (an analysis window) and is handed to each new
+// RemoteExecutor. Bedrock keeps no per-client state, so the base is valid
+// on any endpoint. Thread-safe.
+class DeltaBaseSlot {
+public:
+    using SharedResult = std::shared_ptr<const XYSineResult>;
+
+    struct Base {
+        SharedResult result;  // nullptr: none yet
+        uint64_t xHash = 0;   // columnHash() of result->x
+        uint64_t yHash = 0;   // columnHash() of result->y
+    };
+
+    // Base for featureId; empty if the slot holds another feature's result
+    Base get(const QString& featureId) const;
+
+    // Replace the base with a newer result of featureId
+    void set(const QString& featureId, Base base);
+
+    void clear();
+
+private:
+    mutable std::mutex m_mutex;
+    QString m_featureId;
+    Base m_base;
+};
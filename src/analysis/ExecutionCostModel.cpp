@@ -0,0 +1,221 @@
+#include "ExecutionCostModel.hpp"
+#include "AnalysisScheduler.hpp"
+#include <algorithm>
+#include <cmath>
+
+Q_LOGGING_CATEGORY(phxAutoRun, "phx.analysis.autorun")
+
+namespace {
+
+double toMs(std::chrono::nanoseconds elapsed)
+{
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+// Moving average; the first measurement replaces the starting estimate
+void smooth(double& average, uint64_t& runs, double sample)
+{
+    average = runs == 0 ? sample
+                        : ExecutionCostModel::SMOOTHING * sample + (1.0 - ExecutionCostModel::SMOOTHING) * average;
+    ++runs;
+}
+
+} // namespace
+
+ExecutionCostModel& ExecutionCostModel::instance()
+{
+    static ExecutionCostModel model;
+    return model;
+}
+
+const char* ExecutionCostModel::pathName(Path path)
+{
+    switch (path) {
+        case Path::Local:
+            return "local";
+        case Path::Remote:
+            return "remote";
+        case Path::Split:
+            return "split";
+    }
+    return "?";
+}
+
+ExecutionCostModel::Decision ExecutionCostModel::decide(const QString& featureId, size_t samples, size_t items,
+                                                        bool localSupported, const RemoteLink& link)
+{
+    // Jobs waiting for a local worker, per worker (read before taking m_mutex)
+    AnalysisScheduler& scheduler = AnalysisScheduler::instance();
+    const double localQueue = static_cast<double>(scheduler.queued())
+        / static_cast<double>(std::max<size_t>(1, scheduler.threadCount()));
+
+    Decision decision;
+    decision.featureId = featureId;
+    decision.samples = samples;
+    decision.items = std::max<size_t>(1, items);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Rates& rates = ratesLocked(featureId);
+    const double rttMs = link.rttMs > 0.0 ? link.rttMs : DEFAULT_RTT_MS;
+    const double localItemMs = rates.localNs * static_cast<double>(samples) / 1e6
+        * (localBacklogLocked() + localQueue);
+    const double remoteItemMs = rates.remoteNs * static_cast<double>(samples) / 1e6 * remoteBacklogLocked(link);
+    const double itemCount = static_cast<double>(decision.items);
+    if (localSupported) {
+        decision.localMs = localItemMs * itemCount;
+    }
+    if (link.available) {
+        decision.remoteMs = rttMs + remoteItemMs * itemCount;
+    }
+
+    if (!localSupported) {
+        decision.path = Path::Remote;
+        decision.reason = link.available ? QString("no local implementation")
+                                         : QString("no local implementation, remote unavailable");
+    } else if (!link.available) {
+        decision.path = Path::Local;
+        decision.reason = QString("remote unavailable");
+    } else {
+        decision.path = decision.localMs <= decision.remoteMs ? Path::Local : Path::Remote;
+        decision.reason = decision.path == Path::Local ? QString("local faster") : QString("remote faster");
+
+        // Items in proportion to each path's speed, so both end together
+        if (decision.items >= 2 && localItemMs + remoteItemMs > 0.0) {
+            const double localShare = remoteItemMs / (localItemMs + remoteItemMs);
+            const size_t localItems = std::clamp<size_t>(
+                static_cast<size_t>(std::llround(itemCount * localShare)), 1, decision.items - 1);
+            decision.splitMs = std::max(localItemMs * static_cast<double>(localItems),
+                                        rttMs + remoteItemMs * static_cast<double>(decision.items - localItems));
+            if (decision.splitMs < SPLIT_GAIN * std::min(decision.localMs, decision.remoteMs)) {
+                decision.path = Path::Split;
+                decision.localItems = localItems;
+                decision.reason = QString("split faster");
+            }
+        }
+    }
+    if (decision.path == Path::Local) {
+        decision.localItems = decision.items;
+    }
+
+    qCInfo(phxAutoRun).noquote()
+        << QString("%1: %2 x %3 samples -> %4 (local %5 ms, remote %6 ms, split %7 ms; "
+                   "%8 local / %9 remote running, rtt %10 ms; %11)")
+               .arg(featureId)
+               .arg(decision.items)
+               .arg(samples)
+               .arg(QLatin1String(pathName(decision.path)))
+               .arg(decision.localMs, 0, 'f', 2)
+               .arg(decision.remoteMs, 0, 'f', 2)
+               .arg(decision.splitMs, 0, 'f', 2)
+               .arg(m_localRunning)
+               .arg(std::max(link.inFlight, m_remoteRunning))
+               .arg(rttMs, 0, 'f', 2)
+               .arg(decision.reason);
+
+    m_decisions.push_back(decision);
+    while (m_decisions.size() > KEPT_DECISIONS) {
+        m_decisions.pop_front();
+    }
+    return decision;
+}
+
+void ExecutionCostModel::recordLocal(const QString& featureId, size_t samples, std::chrono::nanoseconds elapsed)
+{
+    if (samples == 0) {
+        return;
+    }
+    const double nsPerSample = std::max(MIN_NS_PER_SAMPLE,
+                                        static_cast<double>(elapsed.count()) / static_cast<double>(samples));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Rates& rates = ratesLocked(featureId);
+    smooth(rates.localNs, rates.localRuns, nsPerSample);
+    qCInfo(phxAutoRun).noquote()
+        << QString("%1: local run of %2 samples took %3 ms (%4 ns/sample, estimate now %5)")
+               .arg(featureId)
+               .arg(samples)
+               .arg(toMs(elapsed), 0, 'f', 2)
+               .arg(nsPerSample, 0, 'f', 3)
+               .arg(rates.localNs, 0, 'f', 3);
+}
+
+void ExecutionCostModel::recordRemote(const QString& featureId, size_t samples, std::chrono::nanoseconds elapsed,
+                                      double rttMs)
+{
+    if (samples == 0) {
+        return;
+    }
+    const double elapsedMs = toMs(elapsed);
+    const double nsPerSample = std::max(MIN_NS_PER_SAMPLE, (elapsedMs - rttMs) * 1e6 / static_cast<double>(samples));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Rates& rates = ratesLocked(featureId);
+    smooth(rates.remoteNs, rates.remoteRuns, nsPerSample);
+    qCInfo(phxAutoRun).noquote()
+        << QString("%1: remote run of %2 samples took %3 ms (rtt %4 ms, %5 ns/sample, estimate now %6)")
+               .arg(featureId)
+               .arg(samples)
+               .arg(elapsedMs, 0, 'f', 2)
+               .arg(rttMs, 0, 'f', 2)
+               .arg(nsPerSample, 0, 'f', 3)
+               .arg(rates.remoteNs, 0, 'f', 3);
+}
+
+void ExecutionCostModel::runStarted(Path path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (path != Path::Remote) {
+        ++m_localRunning;
+    }
+    if (path != Path::Local) {
+        ++m_remoteRunning;
+    }
+}
+
+void ExecutionCostModel::runFinished(Path path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (path != Path::Remote) {
+        m_localRunning = std::max(0, m_localRunning - 1);
+    }
+    if (path != Path::Local) {
+        m_remoteRunning = std::max(0, m_remoteRunning - 1);
+    }
+}
+
+double ExecutionCostModel::localNsPerSample(const QString& featureId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_rates.find(featureId);
+    return it == m_rates.end() ? DEFAULT_LOCAL_NS_PER_SAMPLE : it->second.localNs;
+}
+
+double ExecutionCostModel::remoteNsPerSample(const QString& featureId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_rates.find(featureId);
+    return it == m_rates.end() ? DEFAULT_REMOTE_NS_PER_SAMPLE : it->second.remoteNs;
+}
+
+std::vector<ExecutionCostModel::Decision> ExecutionCostModel::recentDecisions() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::vector<Decision>(m_decisions.begin(), m_decisions.end());
+}
+
+ExecutionCostModel::Rates& ExecutionCostModel::ratesLocked(const QString& featureId)
+{
+    return m_rates[featureId];
+}
+
+double ExecutionCostModel::localBacklogLocked() const
+{
+    // Concurrent local runs share the cores
+    return 1.0 + static_cast<double>(m_localRunning);
+}
+
+double ExecutionCostModel::remoteBacklogLocked(const RemoteLink& link) const
+{
+    // The pool reports every request on its endpoints; otherwise count ours
+    return 1.0 + static_cast<double>(std::max(link.inFlight, m_remoteRunning));
+}
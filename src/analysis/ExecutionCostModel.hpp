@@ -0,0 +1,119 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <QString>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Decisions of the Auto run mode (qCInfo, one line per decision and outcome)
+Q_DECLARE_LOGGING_CATEGORY(phxAutoRun)
+
+// Running estimate of how long a run takes locally and on Bedrock, used by
+// the Auto run mode (see AutoExecutor) to send each request to whichever path
+// should finish first.
+//
+// Per feature it keeps moving averages of local and remote nanoseconds per
+// sample, measured from finished runs (remote time net of the link's
+// round-trip time, which comes from the live connection). Estimates scale
+// with the work already in flight on each path, so a busy path loses
+// requests to the idle one. Batches can be split across both paths in
+// proportion to their speeds.
+//
+// Every decision is logged to phxAutoRun and kept in recentDecisions() for
+// auditing. Thread-safe.
+class ExecutionCostModel {
+public:
+    enum class Path {
+        Local,
+        Remote,
+        Split  // Batch items divided between both
+    };
+
+    // State of the remote path, as probed before each decision
+    struct RemoteLink {
+        bool available = false;  // Connected, and the server offers the feature
+        double rttMs = 0.0;      // 0: not measured yet
+        int inFlight = 0;        // Requests already waiting on the endpoint(s)
+    };
+
+    struct Decision {
+        QString featureId;
+        size_t samples = 0;       // Per item
+        size_t items = 1;
+        Path path = Path::Local;
+        double localMs = 0.0;     // Estimated time of the whole job on each path
+        double remoteMs = 0.0;    // (0 when the path is unavailable)
+        double splitMs = 0.0;
+        size_t localItems = 0;    // Items sent to the local path
+        QString reason;
+    };
+
+    ExecutionCostModel() = default;
+
+    // Process-wide model shared by every Auto executor
+    static ExecutionCostModel& instance();
+
+    // Choose a path for items runs of samples each, log it and keep it in
+    // recentDecisions(). localSupported: a local implementation exists.
+    Decision decide(const QString& featureId, size_t samples, size_t items,
+                    bool localSupported, const RemoteLink& link);
+
+    // Feed a computed run back. Results answered from a result cache are not
+    // measurements; executors report them (IAnalysisExecutor::setCacheHitCallback)
+    // and callers leave them out.
+    void recordLocal(const QString& featureId, size_t samples, std::chrono::nanoseconds elapsed);
+    void recordRemote(const QString& featureId, size_t samples, std::chrono::nanoseconds elapsed,
+                      double rttMs);
+
+    // Work running on each path right now (decide() weighs it in); call
+    // runStarted() before a run and runFinished() after it
+    void runStarted(Path path);
+    void runFinished(Path path);
+
+    // Current estimates (the defaults until something was measured)
+    double localNsPerSample(const QString& featureId) const;
+    double remoteNsPerSample(const QString& featureId) const;
+
+    // Newest last
+    std::vector<Decision> recentDecisions() const;
+
+    static const char* pathName(Path path);  // "local", "remote", "split"
+
+    // Starting estimates: the SIMD kernel on one core, and a remote transfer
+    // of 16 bytes per sample on a local socket
+    static constexpr double DEFAULT_LOCAL_NS_PER_SAMPLE = 10.0;
+    static constexpr double DEFAULT_REMOTE_NS_PER_SAMPLE = 20.0;
+    static constexpr double DEFAULT_RTT_MS = 1.0;
+    // Weight of the newest measurement in the moving averages
+    static constexpr double SMOOTHING = 0.2;
+    // A split must beat the better single path by this factor to be worth
+    // the coordination
+    static constexpr double SPLIT_GAIN = 0.8;
+    // Floor of a measured rate (a remote run may beat the probed RTT)
+    static constexpr double MIN_NS_PER_SAMPLE = 0.02;
+    static constexpr size_t KEPT_DECISIONS = 256;
+
+private:
+    struct Rates {
+        double localNs = DEFAULT_LOCAL_NS_PER_SAMPLE;
+        double remoteNs = DEFAULT_REMOTE_NS_PER_SAMPLE;
+        uint64_t localRuns = 0;
+        uint64_t remoteRuns = 0;
+    };
+
+    // Need m_mutex held
+    Rates& ratesLocked(const QString& featureId);
+    double localBacklogLocked() const;
+    double remoteBacklogLocked(const RemoteLink& link) const;
+
+    mutable std::mutex m_mutex;  // Guards everything below
+    std::map<QString, Rates> m_rates;
+    int m_localRunning = 0;
+    int m_remoteRunning = 0;
+    std::deque<Decision> m_decisions;
+};
@@ -3,7 +3,9 @@
 #include <QMap>
 #include <QVariant>
 #include <QString>
+#include <cstddef>
 #include <functional>
+#include <vector>
 
 // Forward declaration
 struct XYSineResult;
@@ -13,9 +15,23 @@ struct XYSineResult;
 // Future: Will expand with progress reporting, cancellation, etc.
 class IAnalysisExecutor {
 public:
-    using ProgressCallback = std::function<void(double)>;  // progress 0.0-1.0
+    // Progress 0.0-1.0; may be invoked from a transport thread, must not block
+    using ProgressCallback = std::function<void(double)>;
     using ResultCallback = std::function<void(const XYSineResult&)>;
     using ErrorCallback = std::function<void(const QString&)>;
+    // Slice of a result that is still arriving: samples [offset, offset + chunk.x.size())
+    // of totalSamples. May be invoked from a transport thread; must not block.
+    using PartialResultCallback = std::function<void(const XYSineResult& chunk,
+                                                     size_t offset, size_t totalSamples)>;
+    // One finished item of executeBatch(): result on success, nullptr and the
+    // error otherwise. May be invoked from worker or transport threads, never
+    // concurrently; must not block.
+    using BatchItemCallback = std::function<void(size_t index, const XYSineResult* result,
+                                                 const QString& error)>;
+    // The run (index 0) or batch item about to be delivered was answered
+    // from a result cache, not computed. Called on the thread that delivers
+    // it, just before; batch items may be reported concurrently.
+    using CacheHitCallback = std::function<void(size_t index)>;
 
     virtual ~IAnalysisExecutor() = default;
 
@@ -34,8 +50,29 @@ public:
         ErrorCallback onError
     ) = 0;
 
-    // Cancel ongoing execution
-    // WP1: Placeholder - actual cancellation in later sprints
+    // Execute featureId once per parameter set (parameter studies, sweeps)
+    // Items run concurrently where the executor can; onItem is called once
+    // per item as it finishes, in any order, and onProgress with the fraction
+    // of items done. Returns when every item has been reported. After
+    // cancel(), items not finished yet fail with "Computation cancelled".
+    virtual void executeBatch(
+        const QString& featureId,
+        const std::vector<QMap<QString, QVariant>>& paramSets,
+        ProgressCallback onProgress,
+        BatchItemCallback onItem
+    ) = 0;
+
+    // Cancel ongoing execution. Called from another thread while execute()
+    // (or executeBatch()) runs; execute() then ends with a "Computation
+    // cancelled" error.
     virtual void cancel() = 0;
+
+    // Receive partial results while execute() runs (e.g. streamed remote
+    // chunks). Executors that produce results in one piece ignore it.
+    virtual void setPartialResultCallback(PartialResultCallback onPartial) { (void)onPartial; }
+
+    // Learn which results came from a cache (e.g. so they are not timed as
+    // runs). Executors without a cache ignore it.
+    virtual void setCacheHitCallback(CacheHitCallback onHit) { (void)onHit; }
 };
 
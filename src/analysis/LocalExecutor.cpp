@@ -1,13 +1,37 @@
 #include "LocalExecutor.hpp"
+#include "AnalysisScheduler.hpp"
+#include "ResultCache.hpp"
 #include "analysis/demo/XYSineDemo.hpp"
+#include <algorithm>
 #include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
 #include <QDebug>
 
 LocalExecutor::LocalExecutor()
-    : m_cancelled(false)
+    : m_cache(&ResultCache::instance())
+    , m_storeResults(true)
 {
 }
 
+void LocalExecutor::setResultCache(ResultCache* cache)
+{
+    m_cache = cache;
+}
+
+void LocalExecutor::setStoreResults(bool store)
+{
+    m_storeResults = store;
+}
+
+bool LocalExecutor::supports(const QString& featureId)
+{
+    return featureId == "xy_sine" || featureId == "noop";
+}
+
 void LocalExecutor::execute(
     const QString& featureId,
     const QMap<QString, QVariant>& params,
@@ -15,8 +39,7 @@ void LocalExecutor::execute(
     ResultCallback onResult,
     ErrorCallback onError)
 {
-    // Reset cancellation flag
-    m_cancelled.store(false);
+    const CancellationToken token = beginRun();
 
     // Handle "noop" feature for tests
     if (featureId == "noop") {
@@ -31,7 +54,7 @@ void LocalExecutor::execute(
     // Handle "xy_sine" feature
     if (featureId == "xy_sine") {
         // Check for cancellation
-        if (m_cancelled.load()) {
+        if (token.isCancelled()) {
             if (onError) {
                 onError(QString("Computation cancelled"));
             }
@@ -43,20 +66,31 @@ void LocalExecutor::execute(
             onProgress(0.0);
         }
 
-        // Compute XY Sine locally using XYSineDemo
-        XYSineResult result;
-        if (!XYSineDemo::compute(params, result)) {
-            if (onError) {
-                onError(QString("XY Sine computation failed.\n\n"
-                               "Please check the parameters and try again."));
+        // Same parameters computed before: answer from the cache
+        const QByteArray cacheKey = m_cache ? ResultCache::key(featureId, params, COMPUTE_VERSION) : QByteArray();
+        if (m_cache) {
+            if (ResultCache::SharedResult cached = m_cache->lookup(cacheKey)) {
+                if (onProgress) {
+                    onProgress(1.0);
+                }
+                if (m_onCacheHit) {
+                    m_onCacheHit(0);
+                }
+                if (onResult) {
+                    onResult(*cached);
+                }
+                return;
             }
-            return;
         }
 
-        // Check for cancellation after compute
-        if (m_cancelled.load()) {
+        // Compute XY Sine locally using XYSineDemo; cancel() stops it part way
+        XYSineResult result;
+        if (!XYSineDemo::compute(XYSineDemo::parseParams(params), result, token)) {
             if (onError) {
-                onError(QString("Computation cancelled"));
+                onError(token.isCancelled()
+                            ? QString("Computation cancelled")
+                            : QString("XY Sine computation failed.\n\n"
+                                      "Please check the parameters and try again."));
             }
             return;
         }
@@ -74,9 +108,18 @@ void LocalExecutor::execute(
             onProgress(1.0);
         }
 
-        // Emit success with result
+        if (!m_cache || !m_storeResults) {
+            if (onResult) {
+                onResult(result);
+            }
+            return;
+        }
+
+        // Emit success with the cached object (moved, not copied)
+        auto shared = std::make_shared<const XYSineResult>(std::move(result));
+        m_cache->insert(cacheKey, shared);
         if (onResult) {
-            onResult(result);
+            onResult(*shared);
         }
         return;
     }
@@ -87,10 +130,109 @@ void LocalExecutor::execute(
     }
 }
 
+void LocalExecutor::executeBatch(
+    const QString& featureId,
+    const std::vector<QMap<QString, QVariant>>& paramSets,
+    ProgressCallback onProgress,
+    BatchItemCallback onItem)
+{
+    const CancellationToken token = beginRun();
+
+    const size_t total = paramSets.size();
+    if (total == 0) {
+        return;
+    }
+
+    // Items are reported one at a time, whichever worker finished them
+    std::mutex reportMutex;
+    size_t done = 0;
+    auto report = [&](size_t index, const XYSineResult* result, const QString& error) {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        if (onItem) {
+            onItem(index, result, error);
+        }
+        ++done;
+        if (onProgress) {
+            onProgress(static_cast<double>(done) / total);
+        }
+    };
+
+    // Workers pull the next item index until the batch is exhausted
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t index = next.fetch_add(1); index < total; index = next.fetch_add(1)) {
+            if (token.isCancelled()) {
+                report(index, nullptr, QString("Computation cancelled"));
+                continue;
+            }
+            if (featureId != "xy_sine") {
+                report(index, nullptr, QString("Unknown feature: %1").arg(featureId));
+                continue;
+            }
+            const QByteArray cacheKey =
+                m_cache ? ResultCache::key(featureId, paramSets[index], COMPUTE_VERSION) : QByteArray();
+            if (m_cache) {
+                if (ResultCache::SharedResult cached = m_cache->lookup(cacheKey)) {
+                    if (m_onCacheHit) {
+                        m_onCacheHit(index);
+                    }
+                    report(index, cached.get(), QString());
+                    continue;
+                }
+            }
+            // Helpers must not throw: the batch waits for every one of them
+            auto result = std::make_shared<XYSineResult>();
+            try {
+                if (!XYSineDemo::compute(XYSineDemo::parseParams(paramSets[index]), *result, token)) {
+                    report(index, nullptr, token.isCancelled() ? QString("Computation cancelled")
+                                                               : QString("XY Sine computation failed."));
+                    continue;
+                }
+            } catch (const std::bad_alloc&) {
+                report(index, nullptr, QString("Not enough memory for the result."));
+                continue;
+            }
+            if (m_cache && m_storeResults) {
+                m_cache->insert(cacheKey, result);
+            }
+            report(index, result.get(), QString());
+        }
+    };
+
+    // Helpers come from the analysis scheduler (from inside an analysis job
+    // they stay with this worker and idle ones steal them); the calling
+    // thread is one of the workers. A helper that is dropped unstarted
+    // leaves its items to the others.
+    AnalysisScheduler& scheduler = AnalysisScheduler::instance();
+    const AnalysisScheduler::OwnerId owner = AnalysisScheduler::ownerOf(this);
+    std::vector<std::future<bool>> helpers;
+    for (size_t i = 1; i < std::min(scheduler.threadCount(), total); ++i) {
+        helpers.push_back(scheduler.submit(owner, JobPriority::Batch, [&work](const CancellationToken&) { work(); }));
+    }
+    work();
+
+    // Every helper must be waited for: they use this frame
+    for (std::future<bool>& helper : helpers) {
+        scheduler.wait(helper);
+    }
+}
+
 void LocalExecutor::cancel()
 {
-    // WP1: Simple flag-based cancellation
-    // Future: May need to interrupt XYSineDemo if it supports cancellation
-    m_cancelled.store(true);
+    // The kernel checks the token between blocks of samples
+    std::lock_guard<std::mutex> lock(m_runMutex);
+    m_run.cancel();
+}
+
+void LocalExecutor::setCacheHitCallback(CacheHitCallback onHit)
+{
+    m_onCacheHit = std::move(onHit);
+}
+
+CancellationToken LocalExecutor::beginRun()
+{
+    std::lock_guard<std::mutex> lock(m_runMutex);
+    m_run = CancellationToken();
+    return m_run;
 }
 
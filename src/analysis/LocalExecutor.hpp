@@ -1,16 +1,37 @@
 #pragma once
 
 #include "IAnalysisExecutor.hpp"
+#include "AnalysisScheduler.hpp"
+#include <mutex>
+
+class ResultCache;
 
 // Local analysis executor - uses XYSineDemo for local-only compute
 // Provides local XY Sine computation without requiring Bedrock server
 // WP1: Simple wrapper around existing local compute path
 // Does NOT modify XYSineDemo or existing worker logic
+// Finished results are kept in a ResultCache, so repeated runs on the same
+// parameters are not computed again
 class LocalExecutor : public IAnalysisExecutor {
 public:
     LocalExecutor();
     ~LocalExecutor() override = default;
 
+    // Cache to consult and fill (default: the process-wide one); nullptr
+    // computes every run
+    void setResultCache(ResultCache* cache);
+
+    // Whether computed results are added to the cache (lookups happen either
+    // way); off for throwaway runs such as live previews
+    void setStoreResults(bool store);
+
+    // Names the local kernel in result cache keys; bump it whenever
+    // XYSineDemo::compute() changes its output
+    static constexpr const char* COMPUTE_VERSION = "phoenix-local/xy_sine-2";
+
+    // Features with a local implementation
+    static bool supports(const QString& featureId);
+
     // IAnalysisExecutor interface
     void execute(
         const QString& featureId,
@@ -20,9 +41,25 @@ public:
         ErrorCallback onError
     ) override;
 
+    // Items are spread over the AnalysisScheduler's workers
+    void executeBatch(
+        const QString& featureId,
+        const std::vector<QMap<QString, QVariant>>& paramSets,
+        ProgressCallback onProgress,
+        BatchItemCallback onItem
+    ) override;
+
     void cancel() override;
+    void setCacheHitCallback(CacheHitCallback onHit) override;
 
 private:
-    std::atomic<bool> m_cancelled;
+    // Fresh token for a run starting now; cancel() cancels it
+    CancellationToken beginRun();
+
+    std::mutex m_runMutex;     // Guards m_run
+    CancellationToken m_run;   // Token of the current run, passed to the kernel
+    ResultCache* m_cache;  // Not owned; nullptr disables caching
+    bool m_storeResults;
+    CacheHitCallback m_onCacheHit;
 };
 
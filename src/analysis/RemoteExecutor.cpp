@@ -1,30 +1,144 @@
 #include "RemoteExecutor.hpp"
+#include "DeltaBaseSlot.hpp"
+#include "RequestCoalescer.hpp"
+#include "ResultCache.hpp"
+#include "ResultStore.hpp"
 
 // Include transport client (only when PHX_WITH_TRANSPORT_DEPS=ON)
 #ifdef PHX_WITH_TRANSPORT_DEPS
-#include "transport/TransportFactory.hpp"
-#include "transport/TransportClient.hpp"
+#include "transport/ConnectionManager.hpp"
 #include "transport/LocalSocketChannel.hpp"
+#include "transport/PooledTransport.hpp"
+#include "transport/BatchRpc.hpp"
+#include "transport/BulkData.hpp"
+#include "transport/DeltaResponse.hpp"
+#include "transport/RangeQuery.hpp"
 // Proto header is in generated directory, included via CMake include paths
-#include "palantir/capabilities.pb.h"
 #include "palantir/xysine.pb.h"
-#include "analysis/demo/XYSineDemo.hpp"
+#include "analysis/Decimation.hpp"
 #endif
 
+#include "analysis/demo/XYSineDemo.hpp"
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cmath>
+#include <new>
+#include <optional>
+#include <set>
+#include <vector>
 #include <QDebug>
 
 RemoteExecutor::RemoteExecutor()
     : m_cancelled(false)
+    , m_coalescer(&RequestCoalescer::instance())
+    , m_cache(&ResultCache::instance())
+    , m_store(nullptr)
+    , m_connections(nullptr)
+    , m_defaultStore(true)
+    , m_defaultTransport(true)
+{
+}
+
+RemoteExecutor::RemoteExecutor(phoenix::transport::ConnectionManager* connections)
+    : m_cancelled(false)
+    , m_coalescer(&RequestCoalescer::instance())
+    , m_cache(&ResultCache::instance())
+    , m_store(nullptr)
+    , m_connections(connections)
+    , m_defaultStore(true)
+    , m_defaultTransport(false)
+{
+}
+
+RemoteExecutor::RemoteExecutor(std::shared_ptr<phoenix::transport::PooledTransport> pool)
+    : m_cancelled(false)
+    , m_coalescer(&RequestCoalescer::instance())
+    , m_cache(&ResultCache::instance())
+    , m_store(nullptr)
+    , m_connections(nullptr)
+    , m_pool(std::move(pool))
+    , m_defaultStore(true)
+    , m_defaultTransport(false)
+{
+}
+
+RemoteExecutor::~RemoteExecutor() = default;
+
+void RemoteExecutor::setCoalescer(RequestCoalescer* coalescer)
+{
+    m_coalescer = coalescer;
+}
+
+void RemoteExecutor::setResultCache(ResultCache* cache)
+{
+    m_cache = cache;
+}
+
+void RemoteExecutor::setResultStore(ResultStore* store)
+{
+    m_store = store;
+    m_defaultStore = false;
+}
+
+void RemoteExecutor::setDeltaBaseSlot(std::shared_ptr<DeltaBaseSlot> slot)
+{
+    m_deltaBase = std::move(slot);
+}
+
+void RemoteExecutor::resolveDefaults()
+{
+    // The process-wide store (directory, eviction, lock file) and connection
+    // (keepalive thread) come up on the first run, on its worker thread;
+    // executors are made on the GUI thread, one per run, and most never run
+    // remotely
+    std::call_once(m_defaultsOnce, [this]() {
+        if (m_defaultStore) {
+            m_store = &ResultStore::instance();
+        }
 #ifdef PHX_WITH_TRANSPORT_DEPS
-    , m_transport(TransportFactory::makeTransportClient(TransportBackend::Auto))
-#else
-    , m_transport(nullptr)
+        if (m_defaultTransport) {
+            // Several Bedrock endpoints configured (PALANTIR_SOCKET_PATHS): spread runs across them
+            if (phoenix::transport::PooledTransport::socketPathsFromEnvironment().size() > 1) {
+                m_pool = phoenix::transport::PooledTransport::shared();
+            } else {
+                m_connections = &phoenix::transport::ConnectionManager::instance();
+            }
+        }
 #endif
+    });
+}
+
+RemoteExecutor::SharedResult RemoteExecutor::lookupResult(const QByteArray& key)
 {
+    if (m_cache) {
+        if (SharedResult cached = m_cache->lookup(key)) {
+            return cached;
+        }
+    }
+    if (!m_store) {
+        return nullptr;
+    }
+    // From an earlier session (or another Phoenix instance)
+    SharedResult stored = m_store->get(key);
+    if (stored && m_cache) {
+        m_cache->insert(key, stored);
+    }
+    return stored;
 }
 
-RemoteExecutor::~RemoteExecutor() = default;
+void RemoteExecutor::storeResult(const QByteArray& key, const SharedResult& result)
+{
+    if (m_cache) {
+        m_cache->insert(key, result);
+    }
+    if (m_store) {
+        QString error;
+        if (!m_store->put(key, *result, &error)) {
+            qWarning() << "RemoteExecutor: Result not stored on disk:" << error;
+        }
+    }
+}
 
 void RemoteExecutor::execute(
     const QString& featureId,
@@ -35,20 +149,67 @@ void RemoteExecutor::execute(
 {
     // Reset cancellation flag
     m_cancelled.store(false);
+    resolveDefaults();
+
+    if (!m_coalescer) {
+        executeUncoalesced(featureId, params, onProgress,
+                           [&onResult](const SharedResult& result) {
+                               if (onResult) {
+                                   onResult(*result);
+                               }
+                           },
+                           onError);
+        return;
+    }
+
+    // Identical requests already in flight (other windows, a re-clicked Run)
+    // share one round trip; every waiter gets the same result object
+    auto compute = [&](const ProgressCallback& sharedProgress) {
+        RequestCoalescer::Outcome outcome;
+        executeUncoalesced(featureId, params, sharedProgress,
+                           [&outcome](const SharedResult& result) { outcome.result = result; },
+                           [&outcome](const QString& error) { outcome.error = error; });
+        // A cancelled leader must not fail the other waiters
+        outcome.abandoned = !outcome.result && m_cancelled.load();
+        return outcome;
+    };
+    const RequestCoalescer::Outcome outcome =
+        m_coalescer->run(RequestCoalescer::key(featureId, params), compute, onProgress, m_cancelled);
+    if (outcome.result) {
+        if (onResult) {
+            onResult(*outcome.result);
+        }
+    } else if (onError) {
+        onError(outcome.error);
+    }
+}
 
+void RemoteExecutor::executeUncoalesced(
+    const QString& featureId,
+    const QMap<QString, QVariant>& params,
+    const ProgressCallback& onProgress,
+    const SharedResultCallback& onResult,
+    const ErrorCallback& onError)
+{
 #ifdef PHX_WITH_TRANSPORT_DEPS
-    if (!m_transport) {
+    if (m_pool) {
+        executePooled(featureId, params, onProgress, onResult, onError);
+        return;
+    }
+
+    if (!m_connections) {
         if (onError) {
             onError(QString("Transport client not available"));
         }
         return;
     }
     
-    // Connect to remote service
-    if (!m_transport->connect()) {
-        QString errorMsg = "Unable to connect to remote analysis service";
+    // Reuse the persistent connection (connects or reconnects as needed)
+    QString errorMsg;
+    auto channel = m_connections->channel(&errorMsg);
+    if (!channel) {
         if (onError) {
-            onError(errorMsg);
+            onError(errorMsg.isEmpty() ? QString("Unable to connect to remote analysis service") : errorMsg);
         }
         return;
     }
@@ -61,37 +222,137 @@ void RemoteExecutor::execute(
         return;
     }
     
-    // Fetch capabilities from remote server
-    QString errorMsg;
-    auto capabilities = m_transport->getCapabilities(&errorMsg);
+    // Capabilities are cached per connection; only the first run after a
+    // (re)connect pays for the RPC
+    auto capabilities = m_connections->capabilities(&errorMsg);
     
-    if (!capabilities.has_value()) {
+    if (!capabilities) {
         if (onError) {
             onError(errorMsg.isEmpty() ? QString("Failed to fetch capabilities") : errorMsg);
         }
         return;
     }
-    
-    // Log capabilities for debugging
-    qDebug() << "Capabilities fetched: server_version=" 
-             << QString::fromStdString(capabilities->capabilities().server_version())
-             << "features=" << capabilities->capabilities().supported_features_size();
-    
-    // Check if requested feature is supported
-    QString requestedFeature = featureId;
-    bool featureSupported = false;
-    for (int i = 0; i < capabilities->capabilities().supported_features_size(); ++i) {
-        if (QString::fromStdString(capabilities->capabilities().supported_features(i)) == requestedFeature) {
-            featureSupported = true;
-            break;
+
+    QString lostError;
+    if (run(channel, *capabilities, featureId, params, onProgress, onResult, onError, &lostError)
+            == RunStatus::EndpointLost
+        && onError) {
+        onError(lostError);
+    }
+#else
+    // Transport deps not available
+    if (onError) {
+        onError(QString("Transport dependencies not enabled (PHX_WITH_TRANSPORT_DEPS=OFF)"));
+    }
+#endif
+}
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+// XYSineRequest of parsed parameters (XYSineDemo::parseParams: same defaults,
+// aliases and sample clamping as the local path and Bedrock)
+static palantir::XYSineRequest xySineRequest(const XYSineDemo::Params& parsed)
+{
+    palantir::XYSineRequest request;
+    request.set_frequency(parsed.frequency);
+    request.set_amplitude(parsed.amplitude);
+    request.set_phase(parsed.phase);
+    request.set_samples(parsed.samples);
+    return request;
+}
+
+// Result cache key: results are only reused from the same Bedrock build
+static QByteArray resultCacheKey(const phoenix::transport::ConnectionManager::ServerCapabilities& capabilities,
+                                 const QString& featureId,
+                                 const QMap<QString, QVariant>& params)
+{
+    return ResultCache::key(featureId, params,
+                            QString("bedrock/%1").arg(QString::fromStdString(capabilities.serverVersion)));
+}
+
+// Enable the optional transport features the endpoint offers
+static void configureChannel(LocalSocketChannel& channel,
+                             const phoenix::transport::ConnectionManager::ServerCapabilities& capabilities)
+{
+    // Bulk arrays travel through shared memory when Bedrock offers it,
+    // otherwise large payloads may come compressed
+    channel.setBulkSharedMemoryEnabled(capabilities.supports(phoenix::transport::kBulkSharedMemoryFeature));
+    channel.setCompressionEnabled(capabilities.supports(phoenix::transport::kCompressionFeature));
+    // Protocol v2 ships x/y as packed columns; older Bedrock builds stay on v1
+    channel.setProtocolVersion(capabilities.supports(phoenix::transport::kProtocolV2Feature)
+                                   ? phoenix::transport::PROTOCOL_VERSION_V2
+                                   : phoenix::transport::PROTOCOL_VERSION);
+    // Cancelling stops Bedrock too when it understands CANCEL_REQUEST;
+    // otherwise only this call is abandoned
+    channel.setCancelEnabled(capabilities.supports(phoenix::transport::kCancelFeature));
+}
+
+void RemoteExecutor::executePooled(
+    const QString& featureId,
+    const QMap<QString, QVariant>& params,
+    const ProgressCallback& onProgress,
+    const SharedResultCallback& onResult,
+    const ErrorCallback& onError)
+{
+    using phoenix::transport::PooledTransport;
+
+    // Each endpoint is tried at most once per run
+    std::set<size_t> tried;
+    QString lostError;
+    for (;;) {
+        if (m_cancelled.load()) {
+            if (onError) {
+                onError(QString("Computation cancelled"));
+            }
+            return;
         }
+
+        QString errorMsg;
+        auto lease = m_pool->acquire(&errorMsg, tried);
+        if (!lease) {
+            if (onError) {
+                onError(lostError.isEmpty() ? errorMsg
+                                            : QString("%1 (no other endpoint available)").arg(lostError));
+            }
+            return;
+        }
+        tried.insert(lease->endpoint);
+
+        const auto start = std::chrono::steady_clock::now();
+        const RunStatus status = run(lease->channel, *lease->capabilities, featureId, params,
+                                     onProgress, onResult, onError, &lostError);
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+        m_pool->release(*lease,
+                        status == RunStatus::Done     ? PooledTransport::Outcome::Success
+                        : status == RunStatus::Failed ? PooledTransport::Outcome::Failed
+                                                      : PooledTransport::Outcome::EndpointDown,
+                        latency);
+        if (status != RunStatus::EndpointLost) {
+            return;
+        }
+        qWarning() << "RemoteExecutor: Endpoint" << lease->socketPath << "lost, retrying elsewhere:" << lostError;
     }
+}
+
+RemoteExecutor::RunStatus RemoteExecutor::run(
+    const std::shared_ptr<LocalSocketChannel>& channel,
+    const phoenix::transport::ConnectionManager::ServerCapabilities& capabilities,
+    const QString& featureId,
+    const QMap<QString, QVariant>& params,
+    const ProgressCallback& onProgress,
+    const SharedResultCallback& onResult,
+    const ErrorCallback& onError,
+    QString* outLostError)
+{
+    // Check if requested feature is supported
+    QString requestedFeature = featureId;
+    const bool featureSupported = capabilities.supports(requestedFeature.toStdString());
     
     if (!featureSupported) {
         if (onError) {
             onError(QString("Feature '%1' not supported by server").arg(requestedFeature));
         }
-        return;
+        return RunStatus::Failed;
     }
     
     // Execute remote computation based on featureId
@@ -101,7 +362,7 @@ void RemoteExecutor::execute(
             if (onError) {
                 onError(QString("Computation cancelled"));
             }
-            return;
+            return RunStatus::Failed;
         }
         
         // Report progress start
@@ -109,99 +370,225 @@ void RemoteExecutor::execute(
             onProgress(0.0);
         }
         
+        // Answered before by this Bedrock build: nothing to send
+        const bool cacheable = m_cache || m_store;
+        const QByteArray cacheKey = cacheable ? resultCacheKey(capabilities, featureId, params) : QByteArray();
+        if (cacheable) {
+            if (SharedResult cached = lookupResult(cacheKey)) {
+                if (onProgress) {
+                    onProgress(1.0);
+                }
+                if (m_onCacheHit) {
+                    m_onCacheHit(0);
+                }
+                if (onResult) {
+                    onResult(cached);
+                }
+                return RunStatus::Done;
+            }
+        }
+        
         // Build XYSineRequest from params
-        palantir::XYSineRequest request;
+        palantir::XYSineRequest request = xySineRequest(XYSineDemo::parseParams(params));
         
-        // Parse parameters with defaults matching XYSineDemo
-        double frequency = 1.0;
-        double amplitude = 1.0;
-        double phase = 0.0;
-        int samples = 1000;
+        // Plot-only runs may ask for reduced-precision samples; full
+        // precision unless the caller opts in
+        phoenix::transport::ReducedPrecision precision;
+        double errorBound = 0.0;
         
         for (auto it = params.begin(); it != params.end(); ++it) {
             QString key = it.key();
             QVariant value = it.value();
             
-            if (key == "frequency") {
-                bool ok;
-                double val = value.toDouble(&ok);
-                if (ok) {
-                    frequency = val;
+            if (key == "transfer_precision") {
+                const QString name = value.toString().toLower();
+                if (name == "float32") {
+                    precision.mode = phoenix::transport::TransferPrecision::Float32;
+                } else if (name == "int16") {
+                    precision.mode = phoenix::transport::TransferPrecision::DeltaInt16;
+                } else if (auto parsed = phoenix::transport::parsePrecision(name.toStdString())) {
+                    precision.mode = *parsed;
                 }
-            } else if (key == "amplitude") {
+            } else if (key == "error_bound") {
                 bool ok;
                 double val = value.toDouble(&ok);
-                if (ok) {
-                    amplitude = val;
-                }
-            } else if (key == "phase") {
-                bool ok;
-                double val = value.toDouble(&ok);
-                if (ok) {
-                    phase = val;
-                }
-            } else if (key == "samples" || key == "n_samples") {
-                bool ok;
-                int val = value.toInt(&ok);
-                if (ok && val > 0) {
-                    samples = val;
+                if (ok && val > 0.0) {
+                    errorBound = val;
                 }
             }
         }
+        if (!precision.isFull()) {
+            // Default bound: well below a pixel at any sensible plot height
+            precision.errorBound = errorBound > 0.0 ? errorBound : std::abs(request.amplitude()) * 1e-4;
+        }
         
-        // Set request fields
-        request.set_frequency(frequency);
-        request.set_amplitude(amplitude);
-        request.set_phase(phase);
-        request.set_samples(samples);
+        // Viewport queries: Bedrock decimates to the visible x-range when it
+        // supports range queries; otherwise the full result is reduced here.
+        // XY Sine spans x in [0, 2π] (see XYSineDemo).
+        const auto viewport = Decimation::viewportFromParams(params, 0.0, 2.0 * M_PI);
+        const bool rangeSupported = capabilities.supports(phoenix::transport::kRangeQueryFeature);
+        std::optional<phoenix::transport::ViewportRange> range;
+        if (viewport && rangeSupported) {
+            range = phoenix::transport::ViewportRange{viewport->xMin, viewport->xMax,
+                                                      static_cast<uint32_t>(viewport->pixelWidth),
+                                                      Decimation::methodName(viewport->method)};
+        }
         
-        // Send XY Sine request via transport
-        // Note: We need to cast to LocalSocketChannel to access sendXYSineRequest
-        // This is acceptable since TransportFactory currently only returns LocalSocketChannel
-        auto* localChannel = dynamic_cast<LocalSocketChannel*>(m_transport.get());
-        if (!localChannel) {
-            if (onError) {
-                onError(QString("Transport client does not support XY Sine RPC"));
-            }
-            return;
+        // Interactive re-runs: offer the previous full result so Bedrock can
+        // skip the columns that did not change (x, while samples stays put)
+        const bool deltaEligible = m_deltaBase && capabilities.supports(phoenix::transport::kDeltaFeature) &&
+                                   precision.isFull() && !viewport;
+        SharedResult baseResult;  // Keeps the base alive while the request runs
+        phoenix::transport::DeltaBase base;
+        if (deltaEligible) {
+            const DeltaBaseSlot::Base held = m_deltaBase->get(featureId);
+            baseResult = held.result;
+            base.xHash = held.xHash;
+            base.yHash = held.yHash;
         }
+        if (baseResult) {
+            base.x = baseResult->x.data();
+            base.y = baseResult->y.data();
+            base.count = baseResult->x.size();
+        }
+        
+        // Send XY Sine request over the persistent channel
+        LocalSocketChannel* localChannel = channel.get();
+        
+        // Results may arrive as several chunks (large sample counts exceed the
+        // per-envelope limit); each slice is copied straight into the
+        // preallocated result and forwarded for progressive plotting.
+        //
+        // The server's totals are not trusted: the first chunk fixes the
+        // total (no more than the request asked for; range answers add at
+        // most the two edge samples), later chunks must agree with it and
+        // continue where the previous one ended. Intermediate chunks run on
+        // the I/O thread, so nothing here may throw.
+        const uint64_t maxSamples = static_cast<uint64_t>(std::max(request.samples(), 0)) + (range ? 2 : 0);
+        auto result = std::make_shared<XYSineResult>();
+        std::optional<uint64_t> expectedTotal;
+        uint64_t received = 0;
+        QString chunkError;
+        auto onChunk = [this, &result, &onProgress, &expectedTotal, &received, &chunkError,
+                        maxSamples](const LocalSocketChannel::XYSineSlice& slice) {
+            const phoenix::transport::ChunkInfo& info = slice.info;
+            if (!chunkError.isEmpty()) {
+                return;
+            }
+            if (!expectedTotal) {
+                if (info.totalSamples > maxSamples) {
+                    chunkError = QString("Bedrock announced %1 samples for a request of %2")
+                                     .arg(info.totalSamples)
+                                     .arg(maxSamples);
+                    return;
+                }
+                try {
+                    result->x.resize(info.totalSamples);
+                    result->y.resize(info.totalSamples);
+                } catch (const std::bad_alloc&) {
+                    chunkError = QString("Out of memory for %1 samples").arg(info.totalSamples);
+                    return;
+                }
+                expectedTotal = info.totalSamples;
+            } else if (info.totalSamples != *expectedTotal) {
+                chunkError = QString("XYSineResponse chunk %1 announces %2 samples, earlier chunks %3")
+                                 .arg(info.index)
+                                 .arg(info.totalSamples)
+                                 .arg(*expectedTotal);
+                return;
+            }
+            if (info.offset != received) {
+                chunkError = QString("XYSineResponse chunk %1 starts at sample %2, expected %3")
+                                 .arg(info.index)
+                                 .arg(info.offset)
+                                 .arg(received);
+                return;
+            }
+            std::copy(slice.x, slice.x + slice.count, result->x.begin() + info.offset);
+            std::copy(slice.y, slice.y + slice.count, result->y.begin() + info.offset);
+            received += slice.count;
+
+            if (info.count > 1) {
+                if (m_onPartial) {
+                    XYSineResult partial;
+                    partial.x.assign(slice.x, slice.x + slice.count);
+                    partial.y.assign(slice.y, slice.y + slice.count);
+                    m_onPartial(partial, info.offset, info.totalSamples);
+                }
+                if (onProgress) {
+                    onProgress(static_cast<double>(info.index + 1) / info.count);
+                }
+            }
+        };
+
+        configureChannel(*localChannel, capabilities);
+        
+        // Bedrock reports progress while it computes; chunk arrival (above)
+        // covers the transfer
+        LocalSocketChannel::RequestControl control;
+        control.onProgress = [&onProgress](double fraction) {
+            if (onProgress) {
+                onProgress(fraction);
+            }
+        };
+        control.onSent = [this, &channel](uint64_t correlationId) {
+            setActiveRequest(channel, correlationId);
+        };
         
         QString rpcError;
-        auto response = localChannel->sendXYSineRequest(request, &rpcError);
+        auto status = localChannel->streamXYSineRequest(request, onChunk, &rpcError, precision, range, control,
+                                                        baseResult ? &base : nullptr);
+        clearActiveRequest();
         
         // Check for cancellation after RPC
         if (m_cancelled.load()) {
             if (onError) {
                 onError(QString("Computation cancelled"));
             }
-            return;
+            return RunStatus::Failed;
         }
         
-        if (!response.has_value()) {
+        if (!status.has_value()) {
+            // A dead endpoint that delivered nothing yet can be retried elsewhere
+            if (!channel->isConnected() && received == 0 && outLostError) {
+                *outLostError = rpcError.isEmpty() ? QString("Connection to Bedrock lost") : rpcError;
+                return RunStatus::EndpointLost;
+            }
             if (onError) {
                 onError(rpcError.isEmpty() ? QString("XY Sine RPC failed") : rpcError);
             }
-            return;
+            return RunStatus::Failed;
         }
         
-        // Convert XYSineResponse to XYSineResult
-        XYSineResult result;
-        result.x.reserve(response->x_size());
-        result.y.reserve(response->y_size());
+        // A result with gaps must not reach the plot, the cache or the store
+        if (chunkError.isEmpty() && received != expectedTotal.value_or(0)) {
+            chunkError = QString("XYSineResponse ended after %1 of %2 samples")
+                             .arg(received)
+                             .arg(expectedTotal.value_or(0));
+        }
+        if (!chunkError.isEmpty()) {
+            if (onError) {
+                onError(chunkError);
+            }
+            return RunStatus::Failed;
+        }
         
-        for (int i = 0; i < response->x_size(); ++i) {
-            result.x.push_back(response->x(i));
+        if (viewport && !rangeSupported) {
+            XYSineResult reduced;
+            Decimation::decimate(*result, *viewport, reduced);
+            *result = std::move(reduced);
         }
-        for (int i = 0; i < response->y_size(); ++i) {
-            result.y.push_back(response->y(i));
+        
+        if (deltaEligible) {
+            DeltaBaseSlot::Base next;
+            next.result = result;
+            next.xHash = phoenix::transport::columnHash(result->x.data(), result->x.size());
+            next.yHash = phoenix::transport::columnHash(result->y.data(), result->y.size());
+            m_deltaBase->set(featureId, std::move(next));
         }
         
-        // Validate result
-        if (result.x.size() != result.y.size()) {
-            if (onError) {
-                onError(QString("Invalid response: x and y arrays have different sizes"));
-            }
-            return;
+        if (cacheable) {
+            storeResult(cacheKey, result);
         }
         
         // Report progress complete
@@ -211,27 +598,298 @@ void RemoteExecutor::execute(
         
         // Emit success with result
         if (onResult) {
-            onResult(result);
+            onResult(std::move(result));
         }
-        return;
+        return RunStatus::Done;
     }
     
     // Unknown feature
     if (onError) {
         onError(QString("Remote execution for '%1' not yet implemented").arg(requestedFeature));
     }
+    return RunStatus::Failed;
+}
+
+bool RemoteExecutor::runBatch(
+    const std::shared_ptr<LocalSocketChannel>& channel,
+    const phoenix::transport::ConnectionManager::ServerCapabilities& capabilities,
+    const QString& featureId,
+    const std::vector<QMap<QString, QVariant>>& paramSets,
+    const BatchItemCallback& report)
+{
+    using namespace phoenix::transport;
+
+    const size_t total = paramSets.size();
+    if (featureId != "xy_sine" || !capabilities.supports(featureId.toStdString())) {
+        const QString error = capabilities.supports(featureId.toStdString())
+            ? QString("Remote execution for '%1' not yet implemented").arg(featureId)
+            : QString("Feature '%1' not supported by server").arg(featureId);
+        for (size_t index = 0; index < total; ++index) {
+            report(index, nullptr, error);
+        }
+        return true;
+    }
+    configureChannel(*channel, capabilities);
+
+    // Batch items come back inline, one envelope each: only plain results
+    // well under the message size limit qualify. Items answered before by
+    // this Bedrock build come from the cache.
+    const bool batchSupported = capabilities.supports(kBatchFeature);
+    std::vector<size_t> batched;
+    std::vector<size_t> single;
+    for (size_t index = 0; index < total; ++index) {
+        const QMap<QString, QVariant>& params = paramSets[index];
+        if (m_cache || m_store) {
+            if (SharedResult cached = lookupResult(resultCacheKey(capabilities, featureId, params))) {
+                if (m_onCacheHit) {
+                    m_onCacheHit(index);
+                }
+                report(index, cached.get(), QString());
+                continue;
+            }
+        }
+        const size_t bytes = static_cast<size_t>(XYSineDemo::parseParams(params).samples) * 2 * sizeof(double);
+        const bool plain = !params.contains("transfer_precision")
+                           && !Decimation::viewportFromParams(params, 0.0, 2.0 * M_PI);
+        if (batchSupported && plain && bytes <= DEFAULT_MAX_CHUNK_BYTES) {
+            batched.push_back(index);
+        } else {
+            single.push_back(index);
+        }
+    }
+
+    QString lostError;
+    for (size_t first = 0; first < batched.size() && lostError.isEmpty() && !m_cancelled.load();
+         first += MAX_BATCH_ITEMS) {
+        const size_t count = std::min(MAX_BATCH_ITEMS, batched.size() - first);
+        std::vector<palantir::XYSineRequest> requests;
+        requests.reserve(count);
+        for (size_t item = 0; item < count; ++item) {
+            requests.push_back(xySineRequest(XYSineDemo::parseParams(paramSets[batched[first + item]])));
+        }
+
+        LocalSocketChannel::RequestControl control;
+        control.onSent = [this, &channel](uint64_t correlationId) {
+            setActiveRequest(channel, correlationId);
+        };
+        // Filed once the batch is back: items may arrive on the transport
+        // thread, which must not wait for the disk
+        std::vector<std::pair<size_t, SharedResult>> arrived;
+        auto onItem = [&](size_t item, const palantir::XYSineResponse* response, const QString& error) {
+            const size_t index = batched[first + item];
+            if (!response) {
+                report(index, nullptr, error);
+                return;
+            }
+            auto result = std::make_shared<XYSineResult>();
+            result->x.assign(response->x().begin(), response->x().end());
+            result->y.assign(response->y().begin(), response->y().end());
+            report(index, result.get(), QString());
+            if (m_cache || m_store) {
+                arrived.emplace_back(index, std::move(result));
+            }
+        };
+        QString batchError;
+        const bool ok = channel->sendXYSineBatch(requests, onItem, &batchError, control);
+        clearActiveRequest();
+        for (const auto& [index, result] : arrived) {
+            storeResult(resultCacheKey(capabilities, featureId, paramSets[index]), result);
+        }
+        if (!ok && !channel->isConnected()) {
+            lostError = batchError.isEmpty() ? QString("Connection to Bedrock lost") : batchError;
+        } else if (!ok && !m_cancelled.load()) {
+            for (size_t item = 0; item < count; ++item) {
+                report(batched[first + item], nullptr, batchError);
+            }
+        }
+    }
+
+    // The rest go one by one (same path as execute(), without coalescing)
+    for (size_t index : single) {
+        if (!lostError.isEmpty() || m_cancelled.load()) {
+            break;
+        }
+        const RunStatus status = run(channel, capabilities, featureId, paramSets[index], nullptr,
+                                     [&](const SharedResult& result) { report(index, result.get(), QString()); },
+                                     [&](const QString& error) { report(index, nullptr, error); },
+                                     &lostError);
+        if (status == RunStatus::EndpointLost) {
+            break;
+        }
+    }
+
+    // Whatever is left was cancelled or lost with the endpoint (report
+    // skips items that already have their answer)
+    const QString leftover = m_cancelled.load() ? QString("Computation cancelled")
+                             : !lostError.isEmpty() ? lostError
+                                                    : QString("Bedrock did not answer the batch item");
+    for (size_t index = 0; index < total; ++index) {
+        report(index, nullptr, leftover);
+    }
+    return lostError.isEmpty();
+}
+#endif
+
+void RemoteExecutor::executeBatch(
+    const QString& featureId,
+    const std::vector<QMap<QString, QVariant>>& paramSets,
+    ProgressCallback onProgress,
+    BatchItemCallback onItem)
+{
+    m_cancelled.store(false);
+    resolveDefaults();
+
+    // Every item is reported exactly once, whichever path it took; calls come
+    // from the transport thread or this one, never both at once
+    const size_t total = paramSets.size();
+    std::vector<bool> reported(total, false);
+    size_t done = 0;
+    auto report = [&](size_t index, const XYSineResult* result, const QString& error) {
+        if (reported[index]) {
+            return;
+        }
+        reported[index] = true;
+        if (onItem) {
+            onItem(index, result, error);
+        }
+        ++done;
+        if (onProgress) {
+            onProgress(static_cast<double>(done) / total);
+        }
+    };
+    auto failAll = [&](const QString& error) {
+        for (size_t index = 0; index < total; ++index) {
+            report(index, nullptr, error);
+        }
+    };
+    if (total == 0) {
+        return;
+    }
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+    if (m_pool) {
+        using phoenix::transport::PooledTransport;
+
+        QString errorMsg;
+        auto lease = m_pool->acquire(&errorMsg);
+        if (!lease) {
+            failAll(errorMsg);
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const bool alive = runBatch(lease->channel, *lease->capabilities, featureId, paramSets, report);
+        // Per-item latency keeps the endpoint comparable with single runs
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start) / static_cast<int64_t>(total);
+        m_pool->release(*lease, alive ? PooledTransport::Outcome::Success : PooledTransport::Outcome::EndpointDown,
+                        latency);
+        return;
+    }
+
+    if (!m_connections) {
+        failAll(QString("Transport client not available"));
+        return;
+    }
+
+    QString errorMsg;
+    auto channel = m_connections->channel(&errorMsg);
+    if (!channel) {
+        failAll(errorMsg.isEmpty() ? QString("Unable to connect to remote analysis service") : errorMsg);
+        return;
+    }
+    auto capabilities = m_connections->capabilities(&errorMsg);
+    if (!capabilities) {
+        failAll(errorMsg.isEmpty() ? QString("Failed to fetch capabilities") : errorMsg);
+        return;
+    }
+    runBatch(channel, *capabilities, featureId, paramSets, report);
 #else
-    // Transport deps not available
-    if (onError) {
-        onError(QString("Transport dependencies not enabled (PHX_WITH_TRANSPORT_DEPS=OFF)"));
+    failAll(QString("Transport dependencies not enabled (PHX_WITH_TRANSPORT_DEPS=OFF)"));
+#endif
+}
+
+void RemoteExecutor::setPartialResultCallback(PartialResultCallback onPartial)
+{
+    m_onPartial = std::move(onPartial);
+}
+
+void RemoteExecutor::setCacheHitCallback(CacheHitCallback onHit)
+{
+    m_onCacheHit = std::move(onHit);
+}
+
+ExecutionCostModel::RemoteLink RemoteExecutor::probeLink(const QString& featureId)
+{
+    resolveDefaults();
+    ExecutionCostModel::RemoteLink link;
+#ifdef PHX_WITH_TRANSPORT_DEPS
+    if (m_pool) {
+        // Healthy endpoints count; their request latency stands in for the RTT
+        for (const auto& endpoint : m_pool->stats()) {
+            if (!endpoint.healthy) {
+                continue;
+            }
+            link.available = true;
+            link.inFlight += endpoint.inFlight;
+            if (endpoint.latencyMs > 0.0 && (link.rttMs == 0.0 || endpoint.latencyMs < link.rttMs)) {
+                link.rttMs = endpoint.latencyMs;
+            }
+        }
+        return link;
     }
+    if (m_connections) {
+        auto capabilities = m_connections->capabilities();
+        link.available = capabilities && capabilities->supports(featureId.toStdString());
+        link.rttMs = static_cast<double>(m_connections->rttMicros()) / 1000.0;
+    }
+#else
+    (void)featureId;
 #endif
+    return link;
 }
 
 void RemoteExecutor::cancel()
 {
-    // WP1: Simple flag-based cancellation
-    // Future: Cancel ongoing Bedrock requests
     m_cancelled.store(true);
+    
+#ifdef PHX_WITH_TRANSPORT_DEPS
+    // Unblocks execute() at once and frees Bedrock from the computation
+    std::shared_ptr<LocalSocketChannel> channel;
+    uint64_t correlationId = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_activeMutex);
+        channel = m_activeChannel;
+        correlationId = m_activeRequestId;
+    }
+    if (channel && correlationId != 0) {
+        channel->cancelRequest(correlationId);
+    }
+#endif
+}
+
+void RemoteExecutor::setActiveRequest(const std::shared_ptr<LocalSocketChannel>& channel,
+                                      uint64_t correlationId)
+{
+#ifdef PHX_WITH_TRANSPORT_DEPS
+    {
+        std::lock_guard<std::mutex> lock(m_activeMutex);
+        m_activeChannel = channel;
+        m_activeRequestId = correlationId;
+    }
+    // cancel() may have run before the request was queued
+    if (m_cancelled.load()) {
+        channel->cancelRequest(correlationId);
+    }
+#else
+    Q_UNUSED(channel);
+    Q_UNUSED(correlationId);
+#endif
+}
+
+void RemoteExecutor::clearActiveRequest()
+{
+    std::lock_guard<std::mutex> lock(m_activeMutex);
+    m_activeChannel.reset();
+    m_activeRequestId = 0;
 }
 
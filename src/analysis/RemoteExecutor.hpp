@@ -1,20 +1,73 @@
 #pragma once
 
 #include "IAnalysisExecutor.hpp"
+#include "ExecutionCostModel.hpp"
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <vector>
 
-// Include TransportClient header (interface only, no proto deps in header)
-// TransportClient uses forward declarations for proto types
-#include "transport/TransportClient.hpp"
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "transport/ConnectionManager.hpp"
+#endif
 
-// Remote analysis executor - uses TransportClient for Bedrock communication
-// WP1: Skeleton implementation - returns immediate error
-// Future: Will implement actual Bedrock communication, progress, cancellation
+namespace phoenix::transport {
+class ConnectionManager;
+class PooledTransport;
+}
+class DeltaBaseSlot;
+class LocalSocketChannel;
+class RequestCoalescer;
+class ResultCache;
+class ResultStore;
+
+// Remote analysis executor - runs features on Bedrock over the shared
+// persistent connection (see transport/ConnectionManager.hpp)
+// Cheap to construct: the process-wide connection and result store are
+// taken up by the first run, on the thread that runs it
+// Progress comes from Bedrock's PROGRESS_UPDATE messages and chunk arrival;
+// cancel() abandons the in-flight request on the wire (see
+// LocalSocketChannel::cancelRequest)
+// With a PooledTransport every run goes to the least-loaded Bedrock
+// endpoint and is retried on another one if its endpoint dies before any
+// result arrived
+// Identical requests running at the same time are coalesced (see
+// RequestCoalescer): one round trip, one result shared by every caller
+// executeBatch() ships parameter sets to Bedrock in batch envelopes (see
+// transport/BatchRpc.hpp) when it supports them
+// With a DeltaBaseSlot, each full-precision result is offered as the base
+// of the next run through the same slot, so Bedrock sends only the columns
+// that changed (see transport/DeltaResponse.hpp)
+// Finished results are kept in a ResultCache keyed on the endpoint's server
+// version, so repeated requests never reach the wire, and in a ResultStore
+// on disk, so they outlive the session
 class RemoteExecutor : public IAnalysisExecutor {
 public:
     RemoteExecutor();
+    // Uses the given connection manager instead of the process-wide one
+    explicit RemoteExecutor(phoenix::transport::ConnectionManager* connections);
+    // Spreads runs across the pool's endpoints
+    explicit RemoteExecutor(std::shared_ptr<phoenix::transport::PooledTransport> pool);
     ~RemoteExecutor() override;
 
+    // Coalescer to join identical in-flight requests in (default: the
+    // process-wide one); nullptr sends every request on its own
+    void setCoalescer(RequestCoalescer* coalescer);
+
+    // Cache to consult and fill (default: the process-wide one); nullptr
+    // sends every request
+    void setResultCache(ResultCache* cache);
+
+    // On-disk store behind the cache (default: the process-wide one, opened
+    // by the first run); nullptr keeps results in memory only
+    void setResultStore(ResultStore* store);
+
+    // Where the previous result of the caller's runs is kept (default: none,
+    // no base is offered). Executors are made per run, so callers that
+    // re-run a feature keep one slot and hand it to each executor.
+    void setDeltaBaseSlot(std::shared_ptr<DeltaBaseSlot> slot);
+
     // IAnalysisExecutor interface
     void execute(
         const QString& featureId,
@@ -24,10 +77,94 @@ public:
         ErrorCallback onError
     ) override;
 
+    // Items that need chunking, a viewport or reduced precision, and every
+    // item on Bedrock builds without batches, run as single requests.
+    // Batches are not coalesced.
+    void executeBatch(
+        const QString& featureId,
+        const std::vector<QMap<QString, QVariant>>& paramSets,
+        ProgressCallback onProgress,
+        BatchItemCallback onItem
+    ) override;
+
     void cancel() override;
+    void setPartialResultCallback(PartialResultCallback onPartial) override;
+    void setCacheHitCallback(CacheHitCallback onHit) override;
+
+    // State of the remote path for the Auto run mode (see AutoExecutor):
+    // reachable, offering featureId, its round-trip time and load. Connects
+    // first if no connection was made yet, so it may block briefly.
+    ExecutionCostModel::RemoteLink probeLink(const QString& featureId);
 
 private:
-    std::unique_ptr<TransportClient> m_transport;
+    // Results travel as one shared object so coalesced callers need no copies
+    using SharedResult = std::shared_ptr<const XYSineResult>;
+    using SharedResultCallback = std::function<void(const SharedResult&)>;
+
+    enum class RunStatus {
+        Done,          // onResult was called
+        Failed,        // onError was called
+        EndpointLost   // Connection dropped before any result; neither callback called
+    };
+
+    void executeUncoalesced(const QString& featureId,
+                            const QMap<QString, QVariant>& params,
+                            const ProgressCallback& onProgress,
+                            const SharedResultCallback& onResult,
+                            const ErrorCallback& onError);
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+    // Run featureId on one connected endpoint
+    RunStatus run(const std::shared_ptr<LocalSocketChannel>& channel,
+                  const phoenix::transport::ConnectionManager::ServerCapabilities& capabilities,
+                  const QString& featureId,
+                  const QMap<QString, QVariant>& params,
+                  const ProgressCallback& onProgress,
+                  const SharedResultCallback& onResult,
+                  const ErrorCallback& onError,
+                  QString* outLostError);
+    void executePooled(const QString& featureId,
+                       const QMap<QString, QVariant>& params,
+                       const ProgressCallback& onProgress,
+                       const SharedResultCallback& onResult,
+                       const ErrorCallback& onError);
+    // Run every item of a batch on one connected endpoint; report is called
+    // once per item. Returns false if the endpoint was lost on the way.
+    bool runBatch(const std::shared_ptr<LocalSocketChannel>& channel,
+                  const phoenix::transport::ConnectionManager::ServerCapabilities& capabilities,
+                  const QString& featureId,
+                  const std::vector<QMap<QString, QVariant>>& paramSets,
+                  const BatchItemCallback& report);
+#endif
+
+    // Result of an earlier identical request (memory first, then disk), or
+    // nullptr; storeResult() files a new one in both
+    SharedResult lookupResult(const QByteArray& key);
+    void storeResult(const QByteArray& key, const SharedResult& result);
+
+    // Pick up the process-wide store and transport the constructor deferred
+    void resolveDefaults();
+
+    // Track the request cancel() must abandon (called on the executing thread)
+    void setActiveRequest(const std::shared_ptr<LocalSocketChannel>& channel, uint64_t correlationId);
+    void clearActiveRequest();
+
     std::atomic<bool> m_cancelled;
+    RequestCoalescer* m_coalescer;  // Not owned; nullptr disables coalescing
+    ResultCache* m_cache;  // Not owned; nullptr disables caching
+    ResultStore* m_store;  // Not owned; nullptr disables the disk tier
+    phoenix::transport::ConnectionManager* m_connections;  // Not owned
+    std::shared_ptr<phoenix::transport::PooledTransport> m_pool;  // Used instead of m_connections when set
+    bool m_defaultStore;      // m_store is the process-wide one, not resolved yet
+    bool m_defaultTransport;  // Likewise m_connections / m_pool
+    std::once_flag m_defaultsOnce;
+    PartialResultCallback m_onPartial;
+    CacheHitCallback m_onCacheHit;
+
+    std::mutex m_activeMutex;  // Guards the in-flight request below
+    std::shared_ptr<LocalSocketChannel> m_activeChannel;
+    uint64_t m_activeRequestId = 0;
+
+    std::shared_ptr<DeltaBaseSlot> m_deltaBase;  // nullptr: no delta requests
 };
 
@@ -0,0 +1,124 @@
+#include "RequestCoalescer.hpp"
+#include "ResultCache.hpp"
+
+#include <condition_variable>
+#include <vector>
+
+struct RequestCoalescer::Flight {
+    std::mutex mutex;
+    std::condition_variable finishedChanged;
+    bool finished = false;
+    Outcome outcome;
+    // Progress callbacks of the waiters. The leader calls copies of them
+    // outside mutex; a waiter that leaves waits out those calls
+    // (notifying == 0), so it is never called again once gone.
+    std::map<uint64_t, IAnalysisExecutor::ProgressCallback> listeners;
+    uint64_t nextListener = 0;
+    int notifying = 0;
+    std::condition_variable notified;
+};
+
+RequestCoalescer& RequestCoalescer::instance()
+{
+    static RequestCoalescer coalescer;
+    return coalescer;
+}
+
+QByteArray RequestCoalescer::key(const QString& featureId, const QMap<QString, QVariant>& params)
+{
+    // Same canonical form as the result cache; no version, since the
+    // executor running the flight is the same for every waiter
+    return ResultCache::key(featureId, params, QString());
+}
+
+RequestCoalescer::Outcome RequestCoalescer::run(const QByteArray& key,
+                                                const Compute& compute,
+                                                const IAnalysisExecutor::ProgressCallback& onProgress,
+                                                const std::atomic<bool>& cancelled)
+{
+    for (;;) {
+        std::shared_ptr<Flight> flight;
+        bool leader = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_flights.find(key);
+            if (it == m_flights.end()) {
+                flight = std::make_shared<Flight>();
+                m_flights.emplace(key, flight);
+                leader = true;
+                ++m_computations;
+            } else {
+                flight = it->second;
+                ++m_coalesced;
+            }
+        }
+
+        if (leader) {
+            Outcome outcome = compute([&flight, &onProgress](double fraction) {
+                if (onProgress) {
+                    onProgress(fraction);
+                }
+                std::vector<IAnalysisExecutor::ProgressCallback> listeners;
+                {
+                    std::lock_guard<std::mutex> lock(flight->mutex);
+                    if (flight->listeners.empty()) {
+                        return;
+                    }
+                    listeners.reserve(flight->listeners.size());
+                    for (const auto& listener : flight->listeners) {
+                        listeners.push_back(listener.second);
+                    }
+                    ++flight->notifying;
+                }
+                for (const auto& listener : listeners) {
+                    listener(fraction);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(flight->mutex);
+                    --flight->notifying;
+                }
+                flight->notified.notify_all();
+            });
+
+            // Requests made from here on start a computation of their own
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_flights.erase(key);
+            }
+            {
+                std::lock_guard<std::mutex> lock(flight->mutex);
+                flight->outcome = outcome;
+                flight->finished = true;
+                flight->listeners.clear();
+            }
+            flight->finishedChanged.notify_all();
+            return outcome;
+        }
+
+        std::unique_lock<std::mutex> lock(flight->mutex);
+        const uint64_t listener = flight->nextListener++;
+        if (onProgress) {
+            flight->listeners.emplace(listener, onProgress);
+        }
+        while (!flight->finished) {
+            if (cancelled.load()) {
+                flight->listeners.erase(listener);
+                flight->notified.wait(lock, [&flight]() { return flight->notifying == 0; });
+                Outcome outcome;
+                outcome.error = QString("Computation cancelled");
+                return outcome;
+            }
+            flight->finishedChanged.wait_for(lock, CANCEL_POLL_INTERVAL);
+        }
+        if (!flight->outcome.abandoned) {
+            return flight->outcome;
+        }
+        // The leader gave up; run it again (one of the waiters leads)
+    }
+}
+
+size_t RequestCoalescer::inFlight() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_flights.size();
+}
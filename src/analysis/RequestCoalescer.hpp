@@ -0,0 +1,73 @@
+#pragma once
+
+#include "IAnalysisExecutor.hpp"
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+#include <QVariant>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+struct XYSineResult;
+
+// Joins identical analysis requests that are in flight at the same time
+// (several windows on the same parameters, a re-clicked Run). The first
+// caller for a key runs the computation; callers arriving while it runs
+// wait for it, see its progress and receive the very same result object.
+// The coalescer itself keeps nothing: once a computation has finished, the
+// next identical request runs again unless a ResultCache answers it first.
+class RequestCoalescer {
+public:
+    // Result of a (possibly shared) computation: result on success, else error
+    struct Outcome {
+        std::shared_ptr<const XYSineResult> result;
+        QString error;
+        // Set by a leader that gave up for its own reasons (cancelled): the
+        // waiters start over instead of inheriting the error
+        bool abandoned = false;
+    };
+
+    // Runs the computation; onProgress reaches the leader and every waiter
+    using Compute = std::function<Outcome(const IAnalysisExecutor::ProgressCallback& onProgress)>;
+
+    RequestCoalescer() = default;
+    RequestCoalescer(const RequestCoalescer&) = delete;
+    RequestCoalescer& operator=(const RequestCoalescer&) = delete;
+
+    // Process-wide coalescer (shared by every RemoteExecutor)
+    static RequestCoalescer& instance();
+
+    // ResultCache::key() of (featureId, params) without a version:
+    // independent of parameter insertion order, numbers compare by value
+    // (samples=250 == 250.0)
+    static QByteArray key(const QString& featureId, const QMap<QString, QVariant>& params);
+
+    // Run compute for key, or wait for the identical computation already in
+    // flight. A waiter whose cancelled flag is set leaves at once (within
+    // CANCEL_POLL_INTERVAL) without affecting the others.
+    Outcome run(const QByteArray& key,
+                const Compute& compute,
+                const IAnalysisExecutor::ProgressCallback& onProgress,
+                const std::atomic<bool>& cancelled);
+
+    // Counters: computations started, requests that joined one in flight
+    uint64_t computations() const { return m_computations.load(); }
+    uint64_t coalesced() const { return m_coalesced.load(); }
+    size_t inFlight() const;
+
+    static constexpr std::chrono::milliseconds CANCEL_POLL_INTERVAL{10};
+
+private:
+    struct Flight;
+
+    mutable std::mutex m_mutex;  // Guards m_flights
+    std::map<QByteArray, std::shared_ptr<Flight>> m_flights;
+    std::atomic<uint64_t> m_computations{0};
+    std::atomic<uint64_t> m_coalesced{0};
+};
@@ -0,0 +1,190 @@
+#include "ResultCache.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include "common/canonical_json.hpp"
+
+#include <QCryptographicHash>
+#include <QMetaType>
+#include <QVariantList>
+#include <QVariantMap>
+
+#ifdef PHX_WITH_LIBSODIUM
+#include <sodium.h>
+#endif
+
+namespace {
+
+using phoenix::json::CanonicalValue;
+
+constexpr size_t KEY_BYTES = 32;
+
+// Numbers as doubles so 250 and 250.0 (or "samples" typed as int by one
+// window and double by another) give the same key
+CanonicalValue canonicalValue(const QVariant& value)
+{
+    switch (value.typeId()) {
+        case QMetaType::UnknownType:
+            return nullptr;
+        case QMetaType::Bool:
+            return value.toBool();
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Float:
+        case QMetaType::Double:
+            return value.toDouble();
+        case QMetaType::QString:
+            return value.toString().toStdString();
+        case QMetaType::QVariantList: {
+            std::vector<CanonicalValue> items;
+            for (const QVariant& item : value.toList()) {
+                items.push_back(canonicalValue(item));
+            }
+            return items;
+        }
+        case QMetaType::QVariantMap: {
+            std::map<std::string, CanonicalValue> fields;
+            const QVariantMap map = value.toMap();
+            for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+                fields.emplace(it.key().toStdString(), canonicalValue(it.value()));
+            }
+            return fields;
+        }
+        default:
+            // Type-tagged text, so another type with the same text differs
+            return std::string(value.metaType().name()) + ':' + value.toString().toStdString();
+    }
+}
+
+QByteArray blake2b(const std::string& bytes)
+{
+#ifdef PHX_WITH_LIBSODIUM
+    static_assert(crypto_generichash_BYTES == KEY_BYTES, "Unkeyed BLAKE2b-256");
+    static const bool initialized = sodium_init() >= 0;
+    if (initialized) {
+        QByteArray digest(KEY_BYTES, Qt::Uninitialized);
+        crypto_generichash(reinterpret_cast<unsigned char*>(digest.data()), KEY_BYTES,
+                           reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size(), nullptr, 0);
+        return digest;
+    }
+#endif
+    // Same digest, for builds without libsodium
+    return QCryptographicHash::hash(QByteArray::fromRawData(bytes.data(), static_cast<qsizetype>(bytes.size())),
+                                    QCryptographicHash::Blake2b_256);
+}
+
+} // namespace
+
+ResultCache::ResultCache(size_t budgetBytes)
+    : m_budget(budgetBytes)
+{
+}
+
+ResultCache& ResultCache::instance()
+{
+    static ResultCache cache([]() {
+        bool ok = false;
+        const qulonglong megabytes = qEnvironmentVariable("PHOENIX_RESULT_CACHE_MB").toULongLong(&ok);
+        return ok ? static_cast<size_t>(megabytes) * 1024 * 1024 : DEFAULT_BUDGET_BYTES;
+    }());
+    return cache;
+}
+
+QByteArray ResultCache::key(const QString& featureId, const QMap<QString, QVariant>& params,
+                            const QString& version)
+{
+    std::map<std::string, CanonicalValue> fields;
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        fields.emplace(it.key().toStdString(), canonicalValue(it.value()));
+    }
+    std::map<std::string, CanonicalValue> request;
+    request.emplace("feature", featureId.toStdString());
+    request.emplace("params", std::move(fields));
+    request.emplace("version", version.toStdString());
+    return blake2b(phoenix::json::to_canonical_json(CanonicalValue(std::move(request))));
+}
+
+ResultCache::SharedResult ResultCache::lookup(const QByteArray& key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        ++m_counters.misses;
+        return nullptr;
+    }
+    ++m_counters.hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->result;
+}
+
+void ResultCache::insert(const QByteArray& key, SharedResult result)
+{
+    if (!result) {
+        return;
+    }
+    const size_t bytes = resultBytes(*result) + static_cast<size_t>(key.size());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        // Same key, same content: keep the stored object, just refresh it
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return;
+    }
+    if (bytes > m_budget) {
+        return;
+    }
+    evictTo(m_budget - bytes);
+    m_lru.push_front(Entry{key, std::move(result), bytes});
+    m_index.emplace(key, m_lru.begin());
+    m_bytes += bytes;
+    ++m_counters.insertions;
+}
+
+void ResultCache::setBudget(size_t budgetBytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budgetBytes;
+    evictTo(m_budget);
+}
+
+size_t ResultCache::budget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget;
+}
+
+void ResultCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lru.clear();
+    m_index.clear();
+    m_bytes = 0;
+    m_counters = Stats();
+}
+
+ResultCache::Stats ResultCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_counters;
+    stats.entries = m_lru.size();
+    stats.bytes = m_bytes;
+    stats.budget = m_budget;
+    return stats;
+}
+
+size_t ResultCache::resultBytes(const XYSineResult& result)
+{
+    return sizeof(XYSineResult) + (result.x.size() + result.y.size()) * sizeof(double);
+}
+
+void ResultCache::evictTo(size_t budget)
+{
+    while (m_bytes > budget && !m_lru.empty()) {
+        const Entry& oldest = m_lru.back();
+        m_bytes -= oldest.bytes;
+        m_index.erase(oldest.key);
+        m_lru.pop_back();
+        ++m_counters.evictions;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+#include <QVariant>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+struct XYSineResult;
+
+// Finished analysis results, kept in memory so that a repeated run (a
+// re-clicked Run, a window opened again on the same parameters) is answered
+// at once instead of being computed again.
+//
+// Entries are content-addressed: the key is a BLAKE2b-256 hash of the
+// canonical JSON of (featureId, params, version), where version names what
+// computed the result (see LocalExecutor, RemoteExecutor), so a new Bedrock
+// build or a changed local kernel never serves stale results.
+//
+// The cache holds up to budget() bytes of result data; least recently used
+// entries go first. Results are shared, not copied: an evicted result stays
+// alive for as long as a caller still holds it.
+class ResultCache {
+public:
+    using SharedResult = std::shared_ptr<const XYSineResult>;
+
+    // Counters since construction (or the last clear())
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t budget = 0;
+    };
+
+    explicit ResultCache(size_t budgetBytes = DEFAULT_BUDGET_BYTES);
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // Process-wide cache (shared by every executor); the budget comes from
+    // PHOENIX_RESULT_CACHE_MB when set
+    static ResultCache& instance();
+
+    // BLAKE2b-256 of the canonical JSON of (featureId, params, version):
+    // independent of parameter insertion order, numbers compare by value
+    // (samples=250 == 250.0)
+    static QByteArray key(const QString& featureId, const QMap<QString, QVariant>& params,
+                          const QString& version);
+
+    // Cached result for key (counted as a hit), or nullptr (a miss)
+    SharedResult lookup(const QByteArray& key);
+
+    // Remember result under key, evicting the least recently used entries
+    // to stay within the budget. Results larger than the whole budget are
+    // not kept.
+    void insert(const QByteArray& key, SharedResult result);
+
+    // Memory budget in bytes; 0 disables caching. Shrinking evicts at once.
+    void setBudget(size_t budgetBytes);
+    size_t budget() const;
+
+    void clear();
+    Stats stats() const;
+
+    // Bytes a result accounts for
+    static size_t resultBytes(const XYSineResult& result);
+
+    static constexpr size_t DEFAULT_BUDGET_BYTES = size_t(256) * 1024 * 1024;
+
+private:
+    struct Entry {
+        QByteArray key;
+        SharedResult result;
+        size_t bytes = 0;
+    };
+
+    // Drop least recently used entries until m_bytes <= budget (m_mutex held)
+    void evictTo(size_t budget);
+
+    mutable std::mutex m_mutex;  // Guards everything below
+    std::list<Entry> m_lru;      // Most recently used first
+    std::map<QByteArray, std::list<Entry>::iterator> m_index;
+    size_t m_bytes = 0;
+    size_t m_budget;
+    Stats m_counters;
+};
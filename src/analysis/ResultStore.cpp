@@ -0,0 +1,435 @@
+#include "ResultStore.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+#include <set>
+
+namespace {
+
+// On-disk layouts, in native byte order (a store belongs to one machine)
+constexpr char kRecordMagic[8] = {'P', 'H', 'X', 'R', 'E', 'C', '0', '1'};
+constexpr char kIndexMagic[8] = {'P', 'H', 'X', 'I', 'D', 'X', '0', '1'};
+constexpr qint64 KEY_BYTES = 32;
+constexpr qint64 RECORD_HEADER_BYTES = 64;  // Magic, key, count, created, reserved
+constexpr qint64 INDEX_HEADER_BYTES = 16;   // Magic, generation
+constexpr qint64 INDEX_ENTRY_BYTES = 64;    // Key, segment, reserved, offset, count, created
+
+constexpr int LOCK_TIMEOUT_MS = 5000;
+
+QString indexPath(const QString& directory)
+{
+    return QDir(directory).filePath(QStringLiteral("index"));
+}
+
+// Segment ids present in directory, and each one's size and last write
+struct SegmentInfo {
+    uint64_t bytes = 0;
+    int64_t modifiedMs = 0;
+};
+
+std::map<uint32_t, SegmentInfo> listSegments(const QString& directory)
+{
+    std::map<uint32_t, SegmentInfo> segments;
+    const QFileInfoList files = QDir(directory).entryInfoList({QStringLiteral("segment-*.dat")}, QDir::Files);
+    for (const QFileInfo& file : files) {
+        bool ok = false;
+        const uint32_t id = file.completeBaseName().mid(8).toUInt(&ok);
+        if (ok) {
+            segments[id] = SegmentInfo{static_cast<uint64_t>(file.size()),
+                                       file.lastModified().toMSecsSinceEpoch()};
+        }
+    }
+    return segments;
+}
+
+QByteArray indexHeader(uint64_t generation)
+{
+    QByteArray header(INDEX_HEADER_BYTES, '\0');
+    std::memcpy(header.data(), kIndexMagic, sizeof(kIndexMagic));
+    std::memcpy(header.data() + 8, &generation, sizeof(generation));
+    return header;
+}
+
+template<typename Location>
+QByteArray indexEntry(const QByteArray& key, const Location& location)
+{
+    QByteArray entry(INDEX_ENTRY_BYTES, '\0');
+    char* out = entry.data();
+    std::memcpy(out, key.constData(), KEY_BYTES);
+    std::memcpy(out + 32, &location.segment, sizeof(location.segment));
+    std::memcpy(out + 40, &location.offset, sizeof(location.offset));
+    std::memcpy(out + 48, &location.count, sizeof(location.count));
+    std::memcpy(out + 56, &location.createdMs, sizeof(location.createdMs));
+    return entry;
+}
+
+} // namespace
+
+ResultStore::ResultStore(const QString& directory)
+    : ResultStore(directory, Limits())
+{
+}
+
+ResultStore::ResultStore(const QString& directory, const Limits& limits)
+    : m_directory(directory)
+    , m_lockFile(QDir(directory).filePath(QStringLiteral("lock")))
+    , m_limits(limits)
+{
+    m_open = !directory.isEmpty() && QDir().mkpath(directory);
+    if (!m_open) {
+        qWarning() << "ResultStore: Cannot use" << directory << "- results are not kept on disk";
+        return;
+    }
+    // Whatever aged out since the last session goes now
+    evict();
+}
+
+ResultStore::~ResultStore() = default;
+
+ResultStore& ResultStore::instance()
+{
+    static ResultStore store(defaultDirectory(), []() {
+        Limits limits;
+        bool ok = false;
+        const qulonglong megabytes = qEnvironmentVariable("PHOENIX_RESULT_STORE_MB").toULongLong(&ok);
+        if (ok) {
+            limits.maxBytes = static_cast<uint64_t>(megabytes) * 1024 * 1024;
+        }
+        return limits;
+    }());
+    return store;
+}
+
+QString ResultStore::defaultDirectory()
+{
+    const QString overridden = qEnvironmentVariable("PHOENIX_RESULT_STORE_DIR");
+    if (!overridden.isEmpty()) {
+        return overridden;
+    }
+    const QString appData = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return appData.isEmpty() ? QString() : QDir(appData).filePath(QStringLiteral("results"));
+}
+
+ResultStore::SharedResult ResultStore::get(const QByteArray& key)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_open || key.size() != KEY_BYTES) {
+        return nullptr;
+    }
+    Location location;
+    bool found = false;
+    if (lockStore(nullptr)) {
+        refreshIndex();
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            location = it->second;
+            found = true;
+        }
+        unlockStore();
+    }
+    const QString path = segmentPath(location.segment);
+    lock.unlock();
+
+    // Indexed records never change; a segment evicted meanwhile is a miss
+    SharedResult loaded;
+    QFile file(path);
+    const qint64 recordBytes = RECORD_HEADER_BYTES + static_cast<qint64>(location.count) * 2 * qint64(sizeof(double));
+    if (found && file.open(QIODevice::ReadOnly)
+        && static_cast<qint64>(location.offset) + recordBytes <= file.size()) {
+        if (uchar* mapped = file.map(static_cast<qint64>(location.offset), recordBytes)) {
+            uint64_t count = 0;
+            std::memcpy(&count, mapped + 40, sizeof(count));
+            if (std::memcmp(mapped, kRecordMagic, sizeof(kRecordMagic)) == 0
+                && std::memcmp(mapped + 8, key.constData(), KEY_BYTES) == 0 && count == location.count) {
+                auto result = std::make_shared<XYSineResult>();
+                result->x.resize(count);
+                result->y.resize(count);
+                const uchar* columns = mapped + RECORD_HEADER_BYTES;
+                std::memcpy(result->x.data(), columns, count * sizeof(double));
+                std::memcpy(result->y.data(), columns + count * sizeof(double), count * sizeof(double));
+                loaded = std::move(result);
+            }
+            file.unmap(mapped);
+        }
+    }
+
+    lock.lock();
+    ++(loaded ? m_counters.hits : m_counters.misses);
+    return loaded;
+}
+
+bool ResultStore::put(const QByteArray& key, const XYSineResult& result, QString* outError)
+{
+    auto fail = [outError](const QString& error) {
+        if (outError) {
+            *outError = error;
+        }
+        return false;
+    };
+    if (!m_open) {
+        return fail(QString("Result store is not available"));
+    }
+    if (key.size() != KEY_BYTES || result.x.size() != result.y.size()) {
+        return fail(QString("Invalid result store entry"));
+    }
+    const uint64_t count = result.x.size();
+    const qint64 columnBytes = static_cast<qint64>(count * sizeof(double));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (RECORD_HEADER_BYTES + 2 * static_cast<uint64_t>(columnBytes) > m_limits.maxBytes) {
+        return fail(QString("Result is larger than the result store"));
+    }
+    if (!lockStore(outError)) {
+        return false;
+    }
+    refreshIndex();
+    if (m_index.count(key) > 0) {
+        // Another instance stored it already
+        unlockStore();
+        return true;
+    }
+
+    // Append to the newest segment, or start one once it is full
+    const std::map<uint32_t, SegmentInfo> segments = listSegments(m_directory);
+    uint32_t segment = segments.empty() ? 1 : segments.rbegin()->first;
+    if (!segments.empty() && segments.rbegin()->second.bytes >= m_limits.segmentBytes) {
+        ++segment;
+    }
+
+    QFile file(segmentPath(segment));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        const QString error = QString("Cannot open %1: %2").arg(file.fileName(), file.errorString());
+        unlockStore();
+        return fail(error);
+    }
+    Location location;
+    location.segment = segment;
+    location.offset = static_cast<uint64_t>(file.size());
+    location.count = count;
+    location.createdMs = QDateTime::currentMSecsSinceEpoch();
+
+    char header[RECORD_HEADER_BYTES] = {};
+    std::memcpy(header, kRecordMagic, sizeof(kRecordMagic));
+    std::memcpy(header + 8, key.constData(), KEY_BYTES);
+    std::memcpy(header + 40, &location.count, sizeof(location.count));
+    std::memcpy(header + 48, &location.createdMs, sizeof(location.createdMs));
+    const bool written = file.write(header, RECORD_HEADER_BYTES) == RECORD_HEADER_BYTES
+                         && file.write(reinterpret_cast<const char*>(result.x.data()), columnBytes) == columnBytes
+                         && file.write(reinterpret_cast<const char*>(result.y.data()), columnBytes) == columnBytes
+                         && file.flush();
+    if (!written) {
+        // Leave no partial record behind (nothing indexes it either way)
+        const QString error = QString("Cannot write %1: %2").arg(file.fileName(), file.errorString());
+        file.resize(static_cast<qint64>(location.offset));
+        unlockStore();
+        return fail(error);
+    }
+    file.close();
+
+    // Data first, index second: an indexed record is always complete
+    const bool indexed = appendIndex(key, location, outError);
+    if (indexed) {
+        ++m_counters.writes;
+        evictLocked();
+    }
+    unlockStore();
+    return indexed;
+}
+
+void ResultStore::setLimits(const Limits& limits)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_limits = limits;
+    }
+    evict();
+}
+
+ResultStore::Limits ResultStore::limits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limits;
+}
+
+void ResultStore::evict()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open || !lockStore(nullptr)) {
+        return;
+    }
+    refreshIndex();
+    evictLocked();
+    unlockStore();
+}
+
+ResultStore::Stats ResultStore::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_counters;
+    stats.entries = m_index.size();
+    stats.bytes = m_diskBytes;
+    return stats;
+}
+
+bool ResultStore::lockStore(QString* outError)
+{
+    if (m_lockFile.tryLock(LOCK_TIMEOUT_MS)) {
+        return true;
+    }
+    if (outError) {
+        *outError = QString("Result store %1 is locked by another process").arg(m_directory);
+    }
+    return false;
+}
+
+void ResultStore::unlockStore()
+{
+    m_lockFile.unlock();
+}
+
+void ResultStore::refreshIndex()
+{
+    QFile file(indexPath(m_directory));
+    char header[INDEX_HEADER_BYTES];
+    if (!file.open(QIODevice::ReadOnly) || file.read(header, INDEX_HEADER_BYTES) != INDEX_HEADER_BYTES
+        || std::memcmp(header, kIndexMagic, sizeof(kIndexMagic)) != 0) {
+        m_index.clear();
+        m_generation = 0;
+        m_indexOffset = 0;
+        return;
+    }
+
+    // A new generation means segments were evicted: read it from the start
+    uint64_t generation = 0;
+    std::memcpy(&generation, header + 8, sizeof(generation));
+    if (generation != m_generation || m_indexOffset < INDEX_HEADER_BYTES) {
+        m_index.clear();
+        m_generation = generation;
+        m_indexOffset = INDEX_HEADER_BYTES;
+    }
+
+    // Only what was appended since the last read, in whole entries
+    const qint64 available = file.size() - static_cast<qint64>(m_indexOffset);
+    if (available < INDEX_ENTRY_BYTES || !file.seek(static_cast<qint64>(m_indexOffset))) {
+        return;
+    }
+    const QByteArray entries = file.read(available - available % INDEX_ENTRY_BYTES);
+    for (qint64 at = 0; at + INDEX_ENTRY_BYTES <= entries.size(); at += INDEX_ENTRY_BYTES) {
+        const char* in = entries.constData() + at;
+        Location location;
+        std::memcpy(&location.segment, in + 32, sizeof(location.segment));
+        std::memcpy(&location.offset, in + 40, sizeof(location.offset));
+        std::memcpy(&location.count, in + 48, sizeof(location.count));
+        std::memcpy(&location.createdMs, in + 56, sizeof(location.createdMs));
+        m_index[QByteArray(in, KEY_BYTES)] = location;
+    }
+    m_indexOffset += static_cast<uint64_t>(entries.size());
+}
+
+bool ResultStore::appendIndex(const QByteArray& key, const Location& location, QString* outError)
+{
+    QFile file(indexPath(m_directory));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (outError) {
+            *outError = QString("Cannot open %1: %2").arg(file.fileName(), file.errorString());
+        }
+        return false;
+    }
+    // refreshIndex() found no valid index: start generation 1
+    if (m_generation == 0) {
+        file.resize(0);
+        m_generation = 1;
+        m_indexOffset = INDEX_HEADER_BYTES;
+        if (file.write(indexHeader(m_generation)) != INDEX_HEADER_BYTES) {
+            if (outError) {
+                *outError = QString("Cannot write %1: %2").arg(file.fileName(), file.errorString());
+            }
+            return false;
+        }
+    }
+    // refreshIndex() read every whole entry: anything past m_indexOffset is
+    // the torn tail of a writer that died mid-entry. Appending after it
+    // would misalign every later entry.
+    if (file.size() > static_cast<qint64>(m_indexOffset) && !file.resize(static_cast<qint64>(m_indexOffset))) {
+        if (outError) {
+            *outError = QString("Cannot repair %1: %2").arg(file.fileName(), file.errorString());
+        }
+        return false;
+    }
+    if (file.write(indexEntry(key, location)) != INDEX_ENTRY_BYTES || !file.flush()) {
+        if (outError) {
+            *outError = QString("Cannot write %1: %2").arg(file.fileName(), file.errorString());
+        }
+        // Leave no torn entry behind either
+        file.resize(static_cast<qint64>(m_indexOffset));
+        return false;
+    }
+    m_index[key] = location;
+    m_indexOffset += INDEX_ENTRY_BYTES;
+    return true;
+}
+
+void ResultStore::evictLocked()
+{
+    // A segment's last write is its newest record
+    const std::map<uint32_t, SegmentInfo> segments = listSegments(m_directory);
+    uint64_t total = 0;
+    for (const auto& [id, info] : segments) {
+        total += info.bytes;
+    }
+    const int64_t now = QDateTime::currentMSecsSinceEpoch();
+    std::set<uint32_t> dropped;
+    uint64_t remaining = total;
+    for (const auto& [id, info] : segments) {
+        if (remaining > m_limits.maxBytes || now - info.modifiedMs > m_limits.maxAge.count()) {
+            dropped.insert(id);
+            remaining -= info.bytes;
+        }
+    }
+    if (dropped.empty()) {
+        m_diskBytes = total;
+        return;
+    }
+
+    // The index goes first: a new generation without the dropped segments
+    std::map<QByteArray, Location> kept;
+    for (const auto& [key, location] : m_index) {
+        if (dropped.count(location.segment) == 0) {
+            kept.emplace(key, location);
+        }
+    }
+    QSaveFile file(indexPath(m_directory));
+    const uint64_t generation = m_generation + 1;
+    bool written = file.open(QIODevice::WriteOnly) && file.write(indexHeader(generation)) == INDEX_HEADER_BYTES;
+    for (auto it = kept.begin(); written && it != kept.end(); ++it) {
+        written = file.write(indexEntry(it->first, it->second)) == INDEX_ENTRY_BYTES;
+    }
+    if (!written || !file.commit()) {
+        qWarning() << "ResultStore: Cannot rewrite the index, keeping every segment:" << file.errorString();
+        m_diskBytes = total;
+        return;
+    }
+    m_index = std::move(kept);
+    m_generation = generation;
+    m_indexOffset = INDEX_HEADER_BYTES + INDEX_ENTRY_BYTES * static_cast<uint64_t>(m_index.size());
+
+    // Readers that looked a record up before this keep their open segment
+    // (POSIX); anything else now misses
+    for (uint32_t id : dropped) {
+        QFile::remove(segmentPath(id));
+    }
+    m_counters.evictedSegments += dropped.size();
+    m_diskBytes = remaining;
+}
+
+QString ResultStore::segmentPath(uint32_t segment) const
+{
+    return QDir(m_directory).filePath(QString("segment-%1.dat").arg(segment, 8, 10, QChar('0')));
+}
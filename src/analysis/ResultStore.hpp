@@ -0,0 +1,120 @@
+#pragma once
+
+#include <QByteArray>
+#include <QLockFile>
+#include <QString>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+struct XYSineResult;
+
+// Finished analysis results on disk, so they outlive the session: reopening
+// yesterday's remote analysis reads it back instead of asking Bedrock again.
+// Keys are ResultCache keys (the canonical hash of feature, parameters and
+// version); ResultCache stays the in-memory tier in front of this one.
+//
+// Layout of the store directory:
+//   segment-NNNNNNNN.dat  Append-only data files. Each record is a 64-byte
+//                         header (magic, key, sample count, creation time)
+//                         followed by the x and y columns as raw doubles.
+//   index                 Append-only list of (key, segment, offset, count,
+//                         creation time); rewritten only when segments are
+//                         evicted, which bumps its generation.
+//   lock                  QLockFile serialising writers and index reads.
+//
+// Several Phoenix instances may share one directory: the index and the
+// segment tails only change under the lock, and records never change once
+// indexed. Reads map the record and copy the columns out, with no parsing.
+//
+// Eviction drops whole segments, oldest first, once the store exceeds
+// maxBytes or a segment's newest record is older than maxAge.
+class ResultStore {
+public:
+    using SharedResult = std::shared_ptr<const XYSineResult>;
+
+    struct Limits {
+        uint64_t maxBytes = DEFAULT_MAX_BYTES;
+        std::chrono::milliseconds maxAge = DEFAULT_MAX_AGE;
+        // A segment takes no new records once it reaches this size
+        uint64_t segmentBytes = DEFAULT_SEGMENT_BYTES;
+    };
+
+    // Counters of this instance; entries and bytes cover the whole store
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t writes = 0;
+        uint64_t evictedSegments = 0;
+        size_t entries = 0;
+        uint64_t bytes = 0;
+    };
+
+    explicit ResultStore(const QString& directory);
+    ResultStore(const QString& directory, const Limits& limits);
+    ~ResultStore();
+
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    // Process-wide store in defaultDirectory(); PHOENIX_RESULT_STORE_MB
+    // overrides maxBytes
+    static ResultStore& instance();
+
+    // <app data>/results, or PHOENIX_RESULT_STORE_DIR when set
+    static QString defaultDirectory();
+
+    // False if the directory cannot be used (every call is then a no-op)
+    bool isOpen() const { return m_open; }
+    QString directory() const { return m_directory; }
+
+    // Stored result for key, or nullptr
+    SharedResult get(const QByteArray& key);
+
+    // Append result under key, then evict beyond the limits. Results larger
+    // than maxBytes are not stored.
+    bool put(const QByteArray& key, const XYSineResult& result, QString* outError = nullptr);
+
+    void setLimits(const Limits& limits);
+    Limits limits() const;
+
+    // Drop segments beyond the limits (put() does this too)
+    void evict();
+
+    Stats stats() const;
+
+    static constexpr uint64_t DEFAULT_MAX_BYTES = uint64_t(2) * 1024 * 1024 * 1024;
+    static constexpr std::chrono::milliseconds DEFAULT_MAX_AGE = std::chrono::hours(24 * 30);
+    static constexpr uint64_t DEFAULT_SEGMENT_BYTES = uint64_t(64) * 1024 * 1024;
+
+private:
+    struct Location {
+        uint32_t segment = 0;
+        uint64_t offset = 0;
+        uint64_t count = 0;
+        int64_t createdMs = 0;
+    };
+
+    // All below need m_mutex and the lock file held
+    bool lockStore(QString* outError);
+    void unlockStore();
+    void refreshIndex();
+    bool appendIndex(const QByteArray& key, const Location& location, QString* outError);
+    void evictLocked();
+    QString segmentPath(uint32_t segment) const;
+
+    QString m_directory;
+    bool m_open = false;
+
+    mutable std::mutex m_mutex;  // Guards everything below
+    QLockFile m_lockFile;
+    Limits m_limits;
+    std::map<QByteArray, Location> m_index;
+    uint64_t m_generation = 0;     // Of the index file m_index was read from
+    uint64_t m_indexOffset = 0;    // Bytes of the index file read so far
+    uint64_t m_diskBytes = 0;      // Segment bytes as of the last write or eviction
+    Stats m_counters;
+};
@@ -0,0 +1,149 @@
+#include "SweepDataset.hpp"
+#include "SweepPlan.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include <QIODevice>
+#include <algorithm>
+#include <cstddef>
+
+SweepDataset::SweepDataset(const SweepPlan& plan)
+    : m_featureId(plan.featureId())
+    , m_fixedParams(plan.fixedParams())
+{
+    const size_t points = plan.pointCount();
+    for (size_t axis = 0; axis < plan.axes().size(); ++axis) {
+        m_axisNames.append(plan.axes()[axis].param);
+        std::vector<double> column(points);
+        for (size_t point = 0; point < points; ++point) {
+            column[point] = plan.axisValue(axis, point);
+        }
+        m_axisColumns.push_back(std::move(column));
+    }
+    m_status.assign(points, PointStatus::Pending);
+    m_sampleOffset.assign(points, 0);
+    m_sampleCount.assign(points, 0);
+}
+
+bool SweepDataset::matches(const SweepPlan& plan) const
+{
+    if (m_featureId != plan.featureId() || m_fixedParams != plan.fixedParams()
+        || pointCount() != plan.pointCount() || static_cast<size_t>(m_axisNames.size()) != plan.axes().size()) {
+        return false;
+    }
+    for (size_t axis = 0; axis < plan.axes().size(); ++axis) {
+        if (m_axisNames[static_cast<qsizetype>(axis)] != plan.axes()[axis].param) {
+            return false;
+        }
+        for (size_t point = 0; point < pointCount(); ++point) {
+            if (m_axisColumns[axis][point] != plan.axisValue(axis, point)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QString SweepDataset::error(size_t point) const
+{
+    auto it = m_errors.find(point);
+    return it == m_errors.end() ? QString() : it->second;
+}
+
+const double* SweepDataset::x(size_t point) const
+{
+    return m_status[point] == PointStatus::Done ? m_x.data() + m_sampleOffset[point] : nullptr;
+}
+
+const double* SweepDataset::y(size_t point) const
+{
+    return m_status[point] == PointStatus::Done ? m_y.data() + m_sampleOffset[point] : nullptr;
+}
+
+XYSineResult SweepDataset::result(size_t point) const
+{
+    XYSineResult result;
+    if (m_status[point] == PointStatus::Done) {
+        const auto begin = static_cast<std::ptrdiff_t>(m_sampleOffset[point]);
+        const auto end = begin + static_cast<std::ptrdiff_t>(m_sampleCount[point]);
+        result.x.assign(m_x.begin() + begin, m_x.begin() + end);
+        result.y.assign(m_y.begin() + begin, m_y.begin() + end);
+    }
+    return result;
+}
+
+void SweepDataset::setResult(size_t point, const XYSineResult& result)
+{
+    if (m_status[point] == PointStatus::Done) {
+        return;
+    }
+    const size_t count = std::min(result.x.size(), result.y.size());
+    m_sampleOffset[point] = m_x.size();
+    m_sampleCount[point] = count;
+    m_x.insert(m_x.end(), result.x.begin(), result.x.begin() + static_cast<std::ptrdiff_t>(count));
+    m_y.insert(m_y.end(), result.y.begin(), result.y.begin() + static_cast<std::ptrdiff_t>(count));
+    m_errors.erase(point);
+    m_status[point] = PointStatus::Done;
+    ++m_done;
+}
+
+void SweepDataset::setFailed(size_t point, const QString& error)
+{
+    if (m_status[point] == PointStatus::Done) {
+        return;
+    }
+    m_status[point] = PointStatus::Failed;
+    m_errors[point] = error;
+}
+
+bool SweepDataset::exportCsv(QIODevice* device, QString* outError) const
+{
+    if (!device || !device->isWritable()) {
+        if (outError) {
+            *outError = QString("Export target is not writable");
+        }
+        return false;
+    }
+
+    QByteArray block = "point";
+    for (const QString& name : m_axisNames) {
+        block += ',' + name.toUtf8();
+    }
+    block += ",x,y\n";
+
+    // Written in blocks; doubles with 17 digits read back exactly
+    constexpr qsizetype BLOCK_BYTES = 1 << 20;
+    auto flush = [&]() {
+        if (device->write(block) != block.size()) {
+            if (outError) {
+                *outError = QString("Export failed: %1").arg(device->errorString());
+            }
+            return false;
+        }
+        block.clear();
+        return true;
+    };
+
+    for (size_t point = 0; point < pointCount(); ++point) {
+        if (m_status[point] != PointStatus::Done) {
+            continue;
+        }
+        QByteArray prefix = QByteArray::number(static_cast<qulonglong>(point));
+        for (const std::vector<double>& column : m_axisColumns) {
+            prefix += ',' + QByteArray::number(column[point], 'g', 17);
+        }
+        prefix += ',';
+
+        const double* xs = x(point);
+        const double* ys = y(point);
+        for (size_t i = 0; i < sampleCount(point); ++i) {
+            block += prefix;
+            block += QByteArray::number(xs[i], 'g', 17);
+            block += ',';
+            block += QByteArray::number(ys[i], 'g', 17);
+            block += '\n';
+            if (block.size() >= BLOCK_BYTES && !flush()) {
+                return false;
+            }
+        }
+    }
+    return flush();
+}
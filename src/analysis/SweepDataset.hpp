@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class QIODevice;
+class SweepPlan;
+struct XYSineResult;
+
+// Results of a sweep, column by column.
+//
+// Per point: the value of every axis, a status, and the range of its samples
+// in two flat x/y columns (appended in completion order, so points streamed
+// in any order cost no reshuffling). Failed points keep their error.
+//
+// A dataset remembers the plan it was made for; SweepEngine::run() resumes
+// into it, running only the points not done yet.
+//
+// Not thread-safe: SweepEngine fills it on the reporting thread; read it
+// from the engine's point callback or once run() has returned.
+class SweepDataset {
+public:
+    enum class PointStatus : uint8_t {
+        Pending,  // Not run yet, or cancelled before it finished
+        Done,
+        Failed
+    };
+
+    SweepDataset() = default;
+    // Every point of plan, pending
+    explicit SweepDataset(const SweepPlan& plan);
+
+    // Same feature, fixed parameters and axis values: this dataset holds
+    // (part of) plan's results
+    bool matches(const SweepPlan& plan) const;
+
+    QString featureId() const { return m_featureId; }
+    size_t pointCount() const { return m_status.size(); }
+    size_t doneCount() const { return m_done; }
+    size_t failedCount() const { return m_errors.size(); }
+
+    QStringList axisNames() const { return m_axisNames; }
+    // Value of the axis at every point (plot column)
+    const std::vector<double>& axisColumn(size_t axis) const { return m_axisColumns[axis]; }
+
+    PointStatus status(size_t point) const { return m_status[point]; }
+    QString error(size_t point) const;
+
+    // Samples of a done point (0 / nullptr otherwise); x and y are
+    // contiguous sampleCount(point) doubles
+    size_t sampleCount(size_t point) const { return static_cast<size_t>(m_sampleCount[point]); }
+    const double* x(size_t point) const;
+    const double* y(size_t point) const;
+    // Copy of a done point's samples, e.g. for a plot view
+    XYSineResult result(size_t point) const;
+
+    void setResult(size_t point, const XYSineResult& result);
+    void setFailed(size_t point, const QString& error);
+
+    // One row per sample of every done point, in point order:
+    //   point,<axis names...>,x,y
+    bool exportCsv(QIODevice* device, QString* outError = nullptr) const;
+
+private:
+    QString m_featureId;
+    QMap<QString, QVariant> m_fixedParams;
+    QStringList m_axisNames;
+    std::vector<std::vector<double>> m_axisColumns;
+
+    std::vector<PointStatus> m_status;
+    std::vector<uint64_t> m_sampleOffset;  // Into m_x/m_y
+    std::vector<uint64_t> m_sampleCount;
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::map<size_t, QString> m_errors;  // Failed points only
+    size_t m_done = 0;
+};
@@ -0,0 +1,101 @@
+#include "SweepEngine.hpp"
+#include "SweepDataset.hpp"
+#include "SweepPlan.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include <algorithm>
+#include <vector>
+
+SweepEngine::SweepEngine(IAnalysisExecutor* executor)
+    : m_executor(executor)
+{
+}
+
+void SweepEngine::setChunkPoints(size_t points)
+{
+    m_chunkPoints = std::max<size_t>(1, points);
+}
+
+bool SweepEngine::run(const SweepPlan& plan,
+                      SweepDataset& dataset,
+                      IAnalysisExecutor::ProgressCallback onProgress,
+                      IAnalysisExecutor::BatchItemCallback onPoint,
+                      QString* outError)
+{
+    m_cancelled.store(false);
+
+    auto fail = [outError](const QString& error) {
+        if (outError) {
+            *outError = error;
+        }
+        return false;
+    };
+
+    if (!m_executor) {
+        return fail(QString("No analysis executor"));
+    }
+    QString planError;
+    if (!plan.validate(&planError)) {
+        return fail(planError);
+    }
+    if (!dataset.matches(plan)) {
+        dataset = SweepDataset(plan);
+    }
+
+    // Resuming: everything not done, failures included
+    const size_t total = dataset.pointCount();
+    std::vector<size_t> pending;
+    for (size_t point = 0; point < total; ++point) {
+        if (dataset.status(point) != SweepDataset::PointStatus::Done) {
+            pending.push_back(point);
+        }
+    }
+
+    // Failed points retried in this run count again only once they finish
+    size_t finished = dataset.doneCount();
+    auto report = [&](size_t point, const XYSineResult* result, const QString& error) {
+        if (result) {
+            dataset.setResult(point, *result);
+        } else if (m_cancelled.load()) {
+            // Cut short by cancel(): not a failure, left for the next run
+            return;
+        } else {
+            dataset.setFailed(point, error);
+        }
+        ++finished;
+        if (onPoint) {
+            onPoint(point, result, error);
+        }
+        if (onProgress) {
+            onProgress(static_cast<double>(finished) / total);
+        }
+    };
+
+    for (size_t begin = 0; begin < pending.size() && !m_cancelled.load(); begin += m_chunkPoints) {
+        const size_t end = std::min(pending.size(), begin + m_chunkPoints);
+        std::vector<QMap<QString, QVariant>> paramSets;
+        paramSets.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            paramSets.push_back(plan.paramsAt(pending[i]));
+        }
+        m_executor->executeBatch(plan.featureId(), paramSets, nullptr,
+                                 [&](size_t index, const XYSineResult* result, const QString& error) {
+                                     report(pending[begin + index], result, error);
+                                 });
+    }
+
+    if (dataset.doneCount() == total) {
+        return true;
+    }
+    if (m_cancelled.load()) {
+        return fail(QString("Sweep cancelled (%1 of %2 points done)").arg(dataset.doneCount()).arg(total));
+    }
+    return fail(QString("%1 of %2 sweep points failed").arg(dataset.failedCount()).arg(total));
+}
+
+void SweepEngine::cancel()
+{
+    m_cancelled.store(true);
+    if (m_executor) {
+        m_executor->cancel();
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "IAnalysisExecutor.hpp"
+#include <QString>
+#include <atomic>
+#include <cstddef>
+
+class SweepDataset;
+class SweepPlan;
+
+// Runs a SweepPlan on an executor and collects the points in a SweepDataset.
+//
+// Points go to IAnalysisExecutor::executeBatch() CHUNK_POINTS at a time, so
+// LocalExecutor spreads them over its workers and RemoteExecutor ships them
+// in batch envelopes; caching and coalescing apply per point as usual. Each
+// finished point is written to the dataset and then streamed to onPoint
+// while the rest still run.
+//
+// cancel() stops the sweep: points already running finish, the rest stay
+// pending. Calling run() again with the same dataset resumes, running only
+// the points that are not done (failed points are retried).
+class SweepEngine {
+public:
+    // executor is not owned and must outlive the engine
+    explicit SweepEngine(IAnalysisExecutor* executor);
+
+    // Points per executeBatch() call; smaller chunks stop sooner on cancel()
+    void setChunkPoints(size_t points);
+    size_t chunkPoints() const { return m_chunkPoints; }
+
+    /**
+     * Run every point of plan not done in dataset (which is reset first if it
+     * was made for another plan). Blocks until the sweep ends or is
+     * cancelled: call it on the AnalysisScheduler (JobPriority::Batch) or a
+     * worker thread, never the GUI thread.
+     *
+     * @param onProgress Fraction of the sweep's points finished (done or failed)
+     * @param onPoint Called once per point that finished in this run, after
+     *                the dataset has it; result is nullptr for a failed point.
+     *                Never called concurrently; must not block.
+     * @return True if every point of the sweep is done
+     */
+    bool run(const SweepPlan& plan,
+             SweepDataset& dataset,
+             IAnalysisExecutor::ProgressCallback onProgress,
+             IAnalysisExecutor::BatchItemCallback onPoint,
+             QString* outError = nullptr);
+
+    // Thread-safe; run() returns soon after
+    void cancel();
+
+    static constexpr size_t CHUNK_POINTS = 256;
+
+private:
+    IAnalysisExecutor* m_executor;
+    size_t m_chunkPoints = CHUNK_POINTS;
+    std::atomic<bool> m_cancelled{false};
+};
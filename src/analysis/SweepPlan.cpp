@@ -0,0 +1,153 @@
+#include "SweepPlan.hpp"
+#include <cmath>
+#include <set>
+
+SweepAxis SweepAxis::range(const QString& param, double first, double last, size_t steps)
+{
+    SweepAxis axis;
+    axis.param = param;
+    if (steps == 1) {
+        axis.values.push_back(first);
+    } else if (steps > 1) {
+        axis.values.reserve(steps);
+        const double step = (last - first) / static_cast<double>(steps - 1);
+        for (size_t i = 0; i + 1 < steps; ++i) {
+            axis.values.push_back(first + step * static_cast<double>(i));
+        }
+        // Exactly last, whatever the rounding of the steps
+        axis.values.push_back(last);
+    }
+    return axis;
+}
+
+SweepAxis SweepAxis::list(const QString& param, std::vector<double> values)
+{
+    SweepAxis axis;
+    axis.param = param;
+    axis.values = std::move(values);
+    return axis;
+}
+
+SweepPlan::SweepPlan(const FeatureDescriptor& feature, const QMap<QString, QVariant>& fixedParams)
+    : m_feature(feature)
+    , m_fixedParams(fixedParams)
+{
+}
+
+SweepPlan& SweepPlan::addAxis(const SweepAxis& axis)
+{
+    m_axes.push_back(axis);
+    return *this;
+}
+
+size_t SweepPlan::pointCount() const
+{
+    if (m_axes.empty()) {
+        return 0;
+    }
+    size_t count = 1;
+    for (const SweepAxis& axis : m_axes) {
+        if (axis.values.empty()) {
+            return 0;
+        }
+        // Saturate: validate() rejects anything this large anyway
+        if (count > MAX_POINTS) {
+            return count;
+        }
+        count *= axis.values.size();
+    }
+    return count;
+}
+
+size_t SweepPlan::axisIndex(size_t axis, size_t point) const
+{
+    for (size_t later = m_axes.size() - 1; later > axis; --later) {
+        point /= m_axes[later].values.size();
+    }
+    return point % m_axes[axis].values.size();
+}
+
+double SweepPlan::axisValue(size_t axis, size_t point) const
+{
+    return m_axes[axis].values[axisIndex(axis, point)];
+}
+
+QMap<QString, QVariant> SweepPlan::paramsAt(size_t point) const
+{
+    QMap<QString, QVariant> params;
+    for (const ParamSpec& spec : m_feature.params()) {
+        if (spec.defaultValue().isValid()) {
+            params.insert(spec.name(), spec.defaultValue());
+        }
+    }
+    for (auto it = m_fixedParams.constBegin(); it != m_fixedParams.constEnd(); ++it) {
+        params.insert(it.key(), it.value());
+    }
+    for (size_t axis = 0; axis < m_axes.size(); ++axis) {
+        const double value = axisValue(axis, point);
+        const ParamSpec* spec = m_feature.findParam(m_axes[axis].param);
+        if (spec && spec->type() == ParamSpec::Type::Int) {
+            params.insert(m_axes[axis].param, static_cast<int>(std::lround(value)));
+        } else {
+            params.insert(m_axes[axis].param, value);
+        }
+    }
+    return params;
+}
+
+bool SweepPlan::validate(QString* outError) const
+{
+    auto fail = [outError](const QString& error) {
+        if (outError) {
+            *outError = error;
+        }
+        return false;
+    };
+
+    if (m_feature.id().isEmpty()) {
+        return fail(QString("Sweep has no feature"));
+    }
+    if (m_axes.empty()) {
+        return fail(QString("Sweep has no parameter axes"));
+    }
+
+    const QStringList fixedErrors = m_feature.validationErrors(m_fixedParams);
+    if (!fixedErrors.isEmpty()) {
+        return fail(fixedErrors.join('\n'));
+    }
+
+    std::set<QString> seen;
+    for (const SweepAxis& axis : m_axes) {
+        const ParamSpec* spec = m_feature.findParam(axis.param);
+        if (!spec) {
+            return fail(QString("Unknown parameter: '%1'").arg(axis.param));
+        }
+        if (spec->type() != ParamSpec::Type::Int && spec->type() != ParamSpec::Type::Double) {
+            return fail(QString("Parameter '%1' is not numeric and cannot be swept").arg(spec->displayName()));
+        }
+        if (!seen.insert(axis.param).second) {
+            return fail(QString("Parameter '%1' is swept twice").arg(spec->displayName()));
+        }
+        if (axis.values.empty()) {
+            return fail(QString("Parameter '%1' has no sweep values").arg(spec->displayName()));
+        }
+        for (double value : axis.values) {
+            if (!std::isfinite(value)) {
+                return fail(QString("Invalid value for parameter '%1'").arg(spec->displayName()));
+            }
+            // As paramsAt() will pass it
+            const QVariant variant = spec->type() == ParamSpec::Type::Int
+                ? QVariant(static_cast<int>(std::lround(value)))
+                : QVariant(value);
+            const QString error = spec->validationError(variant);
+            if (!error.isEmpty()) {
+                return fail(error);
+            }
+        }
+    }
+
+    if (pointCount() > MAX_POINTS) {
+        return fail(QString("Sweep has more than %1 points").arg(MAX_POINTS));
+    }
+    return true;
+}
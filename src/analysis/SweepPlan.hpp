@@ -0,0 +1,60 @@
+#pragma once
+
+#include "features/FeatureDescriptor.hpp"
+#include <QMap>
+#include <QString>
+#include <QVariant>
+#include <cstddef>
+#include <vector>
+
+// Values one parameter takes in a sweep
+struct SweepAxis {
+    QString param;
+    std::vector<double> values;
+
+    // steps evenly spaced values from first to last, both included
+    static SweepAxis range(const QString& param, double first, double last, size_t steps);
+    static SweepAxis list(const QString& param, std::vector<double> values);
+};
+
+// A feature run over the grid of its axes (frequency × phase, ...).
+//
+// Point i is one parameter set: the feature's defaults, overridden by the
+// fixed parameters, overridden by one value of every axis. Points are
+// numbered row-major, the last axis varying fastest.
+class SweepPlan {
+public:
+    SweepPlan() = default;
+    explicit SweepPlan(const FeatureDescriptor& feature,
+                       const QMap<QString, QVariant>& fixedParams = QMap<QString, QVariant>());
+
+    // Fluent, like FeatureDescriptor
+    SweepPlan& addAxis(const SweepAxis& axis);
+
+    const FeatureDescriptor& feature() const { return m_feature; }
+    QString featureId() const { return m_feature.id(); }
+    const QMap<QString, QVariant>& fixedParams() const { return m_fixedParams; }
+    const std::vector<SweepAxis>& axes() const { return m_axes; }
+
+    // Product of the axis sizes (0 without axes)
+    size_t pointCount() const;
+    // Value of axis at point
+    double axisValue(size_t axis, size_t point) const;
+    // Full parameter set of point
+    QMap<QString, QVariant> paramsAt(size_t point) const;
+
+    // Axes name distinct numeric parameters of the feature, every value is
+    // within its ParamSpec, the fixed parameters are valid and the grid has
+    // at most MAX_POINTS points
+    bool validate(QString* outError = nullptr) const;
+
+    static constexpr size_t MAX_POINTS = 1000000;
+
+private:
+    // Position of point along axis
+    size_t axisIndex(size_t axis, size_t point) const;
+
+    FeatureDescriptor m_feature;
+    QMap<QString, QVariant> m_fixedParams;
+    std::vector<SweepAxis> m_axes;
+};
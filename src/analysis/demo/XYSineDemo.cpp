@@ -3,50 +3,155 @@
 // Used by LocalExecutor for local-only XY Sine computation
 
 #include "XYSineDemo.hpp"
+#include "analysis/AnalysisScheduler.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <vector>
 #include <QDebug>
 
+namespace {
+
+// sin() for the kernel: Cody-Waite reduction by π/2 to [-π/4, π/4], then
+// the fdlibm minimax polynomials. Error within 1 ulp of std::sin for
+// |argument| < 2^20 (XY Sine arguments stay below 100).
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+constexpr double PIO2_HI = 1.57079632673412561417e+00;  // First 33 bits of π/2
+constexpr double PIO2_LO = 6.07710050650619224932e-11;  // π/2 - PIO2_HI
+constexpr double ROUND_MAGIC = 6755399441055744.0;      // 1.5 * 2^52: rounds to integer
+constexpr double S1 = -1.66666666666666324348e-01;
+constexpr double S2 = 8.33333333332248946124e-03;
+constexpr double S3 = -1.98412698298579493134e-04;
+constexpr double S4 = 2.75573137070700676789e-06;
+constexpr double S5 = -2.50507602534068634195e-08;
+constexpr double S6 = 1.58969099521155010221e-10;
+constexpr double C1 = 4.16666666666666019037e-02;
+constexpr double C2 = -1.38888888888741095749e-03;
+constexpr double C3 = 2.48015872894767294178e-05;
+constexpr double C4 = -2.75573143513906633035e-07;
+constexpr double C5 = 2.08757232129817482790e-09;
+constexpr double C6 = -1.13596475577881948265e-11;
+
+// Branch-free, so the same code serves one double (D = double, U =
+// uint64_t) and a SIMD vector of them (D = Lanes, U = LaneBits)
+template<typename D, typename U>
+inline void sinInPlace(D& a)
+{
+    // Nearest multiple of π/2; the quadrant is the low bits of the rounded sum
+    const D shifted = a * TWO_OVER_PI + ROUND_MAGIC;
+    const D q = shifted - ROUND_MAGIC;
+    U quadrant;
+    std::memcpy(&quadrant, &shifted, sizeof(quadrant));
+
+    const D r = (a - q * PIO2_HI) - q * PIO2_LO;
+    const D z = r * r;
+    const D s = r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+    const D c = (1.0 - 0.5 * z) + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+
+    // Odd quadrants take the cosine, quadrants 2 and 3 flip the sign
+    U sBits;
+    U cBits;
+    std::memcpy(&sBits, &s, sizeof(sBits));
+    std::memcpy(&cBits, &c, sizeof(cBits));
+    const U odd = -(quadrant & 1);
+    U bits = (cBits & odd) | (sBits & ~odd);
+    bits ^= (quadrant & 2) << 62;
+    std::memcpy(&a, &bits, sizeof(a));
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+// Four doubles: two SSE2 registers on baseline x86-64, one with AVX, two
+// NEON registers on ARM
+typedef double Lanes __attribute__((vector_size(32)));
+typedef uint64_t LaneBits __attribute__((vector_size(32)));
+constexpr size_t LANE_COUNT = sizeof(Lanes) / sizeof(double);
+#endif
+
+// Samples [begin, end) of x and y; same expressions as computeReference()
+void fill(const XYSineDemo::Params& params, double* x, double* y, size_t begin, size_t end)
+{
+    const double denominator = params.samples - 1.0;
+    const double omega = 2.0 * M_PI * params.frequency;
+    size_t i = begin;
+
+#if defined(__GNUC__) || defined(__clang__)
+    const Lanes offsets = {0.0, 1.0, 2.0, 3.0};
+    for (; i + LANE_COUNT <= end; i += LANE_COUNT) {
+        const Lanes t = (static_cast<double>(i) + offsets) / denominator;
+        const Lanes xs = t * 2.0 * M_PI;
+        Lanes ys = omega * t + params.phase;
+        sinInPlace<Lanes, LaneBits>(ys);
+        ys *= params.amplitude;
+        std::memcpy(x + i, &xs, sizeof(xs));
+        std::memcpy(y + i, &ys, sizeof(ys));
+    }
+#endif
+
+    for (; i < end; ++i) {
+        const double t = static_cast<double>(i) / denominator;
+        double value = omega * t + params.phase;
+        sinInPlace<double, uint64_t>(value);
+        x[i] = t * 2.0 * M_PI;
+        y[i] = params.amplitude * value;
+    }
+}
+
+// fill() in blocks, giving up once token is cancelled
+bool fillCancellable(const XYSineDemo::Params& params, double* x, double* y, size_t begin, size_t end,
+                     const CancellationToken& token)
+{
+    for (size_t block = begin; block < end; block += XYSineDemo::CANCEL_CHECK_SAMPLES) {
+        if (token.isCancelled()) {
+            return false;
+        }
+        fill(params, x, y, block, std::min(end, block + XYSineDemo::CANCEL_CHECK_SAMPLES));
+    }
+    return true;
+}
+
+} // namespace
+
 namespace XYSineDemo {
 
-bool compute(const QMap<QString, QVariant>& params, XYSineResult& outResult)
+Params parseParams(const QMap<QString, QVariant>& params)
 {
     // Parse parameters with Phoenix-compatible names
     // Defaults match Phoenix FeatureRegistry defaults (same as Bedrock)
-    double frequency = 1.0;
-    double amplitude = 1.0;
-    double phase = 0.0;
-    int samples = 1000;
+    Params parsed;
     bool explicitSamplesSet = false;
-    
+
     // Parse parameters from QMap<QString, QVariant>
     for (auto it = params.begin(); it != params.end(); ++it) {
         QString key = it.key();
         QVariant value = it.value();
-        
+
         if (key == "frequency") {
             bool ok;
             double val = value.toDouble(&ok);
             if (ok) {
-                frequency = val;
+                parsed.frequency = val;
             }
         } else if (key == "amplitude") {
             bool ok;
             double val = value.toDouble(&ok);
             if (ok) {
-                amplitude = val;
+                parsed.amplitude = val;
             }
         } else if (key == "phase") {
             bool ok;
             double val = value.toDouble(&ok);
             if (ok) {
-                phase = val;
+                parsed.phase = val;
             }
         } else if (key == "samples") {
             // Canonical parameter name (Phoenix standard)
             bool ok;
             int val = value.toInt(&ok);
             if (ok) {
-                samples = val;
+                parsed.samples = val;
                 explicitSamplesSet = true;
             }
         } else if (key == "n_samples") {
@@ -55,17 +160,87 @@ bool compute(const QMap<QString, QVariant>& params, XYSineResult& outResult)
                 bool ok;
                 int val = value.toInt(&ok);
                 if (ok) {
-                    samples = val;
+                    parsed.samples = val;
                 }
             }
         }
     }
-    
+
     // Validate samples (minimum 2) - matches Bedrock behavior
-    if (samples < 2) {
-        samples = 2;
+    if (parsed.samples < 2) {
+        parsed.samples = 2;
     }
-    
+    return parsed;
+}
+
+bool compute(const QMap<QString, QVariant>& params, XYSineResult& outResult)
+{
+    return compute(parseParams(params), outResult);
+}
+
+bool compute(const Params& params, XYSineResult& outResult)
+{
+    return compute(params, outResult, CancellationToken());
+}
+
+bool compute(const Params& params, XYSineResult& outResult, const CancellationToken& token)
+{
+    Params clamped = params;
+    clamped.samples = std::max(params.samples, 2);
+    const size_t samples = static_cast<size_t>(clamped.samples);
+    outResult.x.resize(samples);
+    outResult.y.resize(samples);
+    double* x = outResult.x.data();
+    double* y = outResult.y.data();
+
+    AnalysisScheduler& scheduler = AnalysisScheduler::instance();
+    const size_t chunks = samples < PARALLEL_MIN_SAMPLES
+        ? 1
+        : std::min(scheduler.threadCount(), samples / PARALLEL_MIN_CHUNK);
+    if (chunks <= 1) {
+        return fillCancellable(clamped, x, y, 0, samples, token);
+    }
+
+    // Chunk 0 runs here, the rest on the scheduler (from inside an analysis
+    // job they stay with this worker and idle ones steal them, under that
+    // job's token). Every chunk also checks token, which the caller cancels.
+    // Chunk starts fall on cache lines, so no two threads write one.
+    const size_t chunkSize = ((samples + chunks - 1) / chunks + 7) & ~size_t(7);
+    const AnalysisScheduler::OwnerId owner = AnalysisScheduler::ownerOf(x);
+    std::atomic<bool> cut(false);  // A chunk stopped part way
+    std::vector<std::future<bool>> pending;
+    for (size_t begin = chunkSize; begin < samples; begin += chunkSize) {
+        const size_t end = std::min(samples, begin + chunkSize);
+        pending.push_back(scheduler.submit(owner, JobPriority::Interactive,
+                                           [clamped, x, y, begin, end, &token, &cut](const CancellationToken& job) {
+                                               if (job.isCancelled()
+                                                   || !fillCancellable(clamped, x, y, begin, end, token)) {
+                                                   cut.store(true);
+                                               }
+                                           }));
+    }
+    if (!fillCancellable(clamped, x, y, 0, std::min(samples, chunkSize), token)) {
+        cut.store(true);
+    }
+
+    // Every chunk must be waited for: they write into outResult
+    bool complete = true;
+    for (std::future<bool>& chunk : pending) {
+        complete = scheduler.wait(chunk) && complete;
+    }
+    if (cut.load()) {
+        return false;
+    }
+    if (!complete) {
+        qWarning() << "XYSineDemo: Scheduler dropped part of the computation";
+    }
+    return complete;
+}
+
+void computeReference(const Params& params, XYSineResult& outResult)
+{
+    const int samples = std::max(params.samples, 2);
+
     // Compute sine wave using Bedrock's exact algorithm
     // t = i / (samples - 1) from 0 to 1
     // x = t * 2π (0..2π domain)
@@ -74,18 +249,15 @@ bool compute(const QMap<QString, QVariant>& params, XYSineResult& outResult)
     outResult.y.clear();
     outResult.x.reserve(samples);
     outResult.y.reserve(samples);
-    
+
     for (int i = 0; i < samples; ++i) {
         double t = static_cast<double>(i) / (samples - 1.0);  // 0 to 1
         double x = t * 2.0 * M_PI;  // Scale to 0..2π domain
-        double y = amplitude * std::sin(2.0 * M_PI * frequency * t + phase);
-        
+        double y = params.amplitude * std::sin(2.0 * M_PI * params.frequency * t + params.phase);
+
         outResult.x.push_back(x);
         outResult.y.push_back(y);
     }
-    
-    return true;
 }
 
 } // namespace XYSineDemo
-
@@ -4,6 +4,9 @@
 #include <QVariant>
 #include <vector>
 #include <QMetaType>
+#include <cstddef>
+
+class CancellationToken;
 
 // Result structure for XY Sine computation (Phoenix-only, Phase 2B)
 struct XYSineResult {
@@ -18,15 +21,43 @@ Q_DECLARE_METATYPE(XYSineResult)
 // Provides local compute path without transport dependencies
 // Used by LocalExecutor for local-only XY Sine computation
 namespace XYSineDemo {
-    // Compute XY Sine locally (matches Bedrock's math exactly)
-    // Returns true on success, false on failure
-    // Validates samples >= 2 (clamps to 2 if less)
-    // 
+    // Parsed XY Sine parameters (defaults match Bedrock)
+    struct Params {
+        double frequency = 1.0;
+        double amplitude = 1.0;
+        double phase = 0.0;
+        int samples = 1000;
+    };
+
     // Parameters:
     //   - frequency (double, default 1.0)
     //   - amplitude (double, default 1.0)
     //   - phase (double, default 0.0)
     //   - samples (int, default 1000) - also accepts "n_samples" alias
+    // Clamps samples to at least 2 (matches Bedrock)
+    Params parseParams(const QMap<QString, QVariant>& params);
+
+    // Compute XY Sine locally (matches Bedrock's math to within 2e-15 of
+    // the amplitude; see computeReference)
+    // Returns true on success, false on failure
+    //
+    // Uses a vectorized sine and fills preallocated columns; from
+    // PARALLEL_MIN_SAMPLES on, the samples are split across the
+    // AnalysisScheduler's workers
     bool compute(const QMap<QString, QVariant>& params, XYSineResult& outResult);
+    bool compute(const Params& params, XYSineResult& outResult);
+    // Cancellable: every chunk checks token each CANCEL_CHECK_SAMPLES
+    // samples; returns false (outResult incomplete) once it is cancelled
+    bool compute(const Params& params, XYSineResult& outResult, const CancellationToken& token);
+
+    // Scalar std::sin loop with Bedrock's exact expressions: the accuracy
+    // reference for compute()
+    void computeReference(const Params& params, XYSineResult& outResult);
+
+    constexpr size_t PARALLEL_MIN_SAMPLES = size_t(1) << 18;
+    // Smallest share of the samples worth handing to another worker
+    constexpr size_t PARALLEL_MIN_CHUNK = size_t(1) << 16;
+    // Samples filled between two cancellation checks
+    constexpr size_t CANCEL_CHECK_SAMPLES = size_t(1) << 16;
 }
 
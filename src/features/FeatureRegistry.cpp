@@ -89,7 +89,7 @@ void FeatureRegistry::registerDefaultFeatures()
     xySine.addParam(ParamSpec("samples", "Number of Samples", ParamSpec::Type::Int)
                     .setDefaultValue(1000)
                     .setMinValue(10)
-                    .setMaxValue(100000));
+                    .setMaxValue(50000000));  // Local previews run the SIMD kernel
     
     registerFeature(xySine);
 }
@@ -228,6 +228,7 @@ XYPlotViewGraphs::XYPlotViewGraphs()
     // Connect timer to clampZoom via lambda
     QObject::connect(m_zoomCheckTimer, &QTimer::timeout, [this]() {
         this->clampZoom();
+        this->checkViewport();
     });
     
     // Start timer after a short delay to allow QML to initialize
@@ -331,6 +332,73 @@ void XYPlotViewGraphs::setData(const std::vector<QPointF>& points) {
     initializeAxisRanges(points);
 }
 
+void XYPlotViewGraphs::setVisibleData(const std::vector<QPointF>& points) {
+    // Lightweight guards: silent returns if QML not ready
+    if (m_quickWidget->status() != QQuickWidget::Ready || !m_mainSeries) {
+        return;
+    }
+    
+    QList<QPointF> pointList(points.begin(), points.end());
+    QMetaObject::invokeMethod(m_mainSeries, "replace",
+                               Q_ARG(QList<QPointF>, pointList));
+}
+
+bool XYPlotViewGraphs::visibleXRange(double& xMin, double& xMax) const {
+    if (!m_axisX || m_baseSpanX <= 0.0) {
+        return false;
+    }
+    
+    const double axisMin = m_axisX->property("min").isValid()
+        ? m_axisX->property("min").toDouble() : m_axisX->property("minimum").toDouble();
+    const double axisMax = m_axisX->property("max").isValid()
+        ? m_axisX->property("max").toDouble() : m_axisX->property("maximum").toDouble();
+    
+    // QtGraphs zoom shrinks the span around the axis center; pan shifts the
+    // center in axis units
+    const double zoom = m_axisX->property("zoom").isValid() ? m_axisX->property("zoom").toDouble() : 1.0;
+    const double pan = m_axisX->property("pan").isValid() ? m_axisX->property("pan").toDouble() : 0.0;
+    const double center = 0.5 * (axisMin + axisMax) + pan;
+    const double halfSpan = 0.5 * (axisMax - axisMin) / (zoom > 0.0 ? zoom : 1.0);
+    
+    xMin = center - halfSpan;
+    xMax = center + halfSpan;
+    return xMax > xMin;
+}
+
+int XYPlotViewGraphs::plotPixelWidth() const {
+    return m_quickWidget ? m_quickWidget->width() : 0;
+}
+
+void XYPlotViewGraphs::setViewportChangedCallback(ViewportCallback callback) {
+    m_onViewportChanged = std::move(callback);
+}
+
+void XYPlotViewGraphs::checkViewport() {
+    double xMin = 0.0;
+    double xMax = 0.0;
+    if (!m_onViewportChanged || !visibleXRange(xMin, xMax)) {
+        return;
+    }
+    const int pixels = plotPixelWidth();
+    
+    // Wait until zoom/pan settles: report only a viewport seen on two
+    // consecutive ticks, and only once
+    const bool settled = xMin == m_pendingXMin && xMax == m_pendingXMax && pixels == m_pendingPixels;
+    m_pendingXMin = xMin;
+    m_pendingXMax = xMax;
+    m_pendingPixels = pixels;
+    if (!settled || pixels <= 0) {
+        return;
+    }
+    if (xMin == m_reportedXMin && xMax == m_reportedXMax && pixels == m_reportedPixels) {
+        return;
+    }
+    m_reportedXMin = xMin;
+    m_reportedXMax = xMax;
+    m_reportedPixels = pixels;
+    m_onViewportChanged(xMin, xMax, pixels);
+}
+
 void XYPlotViewGraphs::initializeAxisRanges(const std::vector<QPointF>& points) {
     // Lightweight guards: silent returns if QML not ready
     if (m_quickWidget->status() != QQuickWidget::Ready) {
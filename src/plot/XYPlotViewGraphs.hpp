@@ -3,6 +3,7 @@
 #include "ui/analysis/IAnalysisView.hpp"
 #include <QString>
 #include <QPointF>
+#include <functional>
 #include <vector>
 
 class QWidget;
@@ -26,10 +27,25 @@ public:
     // Public API for setting XY data (for tests and future data integration)
     void setData(const std::vector<QPointF>& points);
 
+    // Replace the plotted points without touching axes, zoom or pan (used
+    // for data refined to the current viewport)
+    void setVisibleData(const std::vector<QPointF>& points);
+
+    // Visible x-range after zoom/pan; false before data has been set
+    bool visibleXRange(double& xMin, double& xMax) const;
+    // Plot width in device-independent pixels
+    int plotPixelWidth() const;
+
+    // Called (on the GUI thread) once the visible x-range or plot width has
+    // changed and then stayed put for one zoom-check tick
+    using ViewportCallback = std::function<void(double xMin, double xMax, int pixelWidth)>;
+    void setViewportChangedCallback(ViewportCallback callback);
+
 private:
     void updateAxisRanges(const std::vector<QPointF>& points);
     void initializeAxisRanges(const std::vector<QPointF>& points);
     void clampZoom();  // Clamp zoom values to limits
+    void checkViewport();  // Report settled viewport changes
     
     QString m_title;
     QWidget* m_container;   // parent widget container
@@ -49,5 +65,14 @@ private:
     double m_baseSpanY = 0.0;  // Padded span used for zoom limit calculation
     double m_minZoom = 0.5;     // Minimum zoom (allows 2x zoom-out from base)
     double m_maxZoom = 100.0;   // Maximum zoom (reasonable upper bound)
+
+    // Viewport change tracking (polled with the zoom check)
+    ViewportCallback m_onViewportChanged;
+    double m_pendingXMin = 0.0;
+    double m_pendingXMax = 0.0;
+    int m_pendingPixels = 0;
+    double m_reportedXMin = 0.0;
+    double m_reportedXMax = 0.0;
+    int m_reportedPixels = 0;
 };
 
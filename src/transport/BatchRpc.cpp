@@ -0,0 +1,83 @@
+#include "BatchRpc.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/unknown_field_set.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <QByteArray>
+
+namespace phoenix::transport {
+
+using google::protobuf::internal::WireFormatLite;
+
+static constexpr int kItemsField = 1;
+
+google::protobuf::Empty makeXYSineBatch(const std::vector<palantir::XYSineRequest>& items)
+{
+    google::protobuf::Empty batch;
+    google::protobuf::UnknownFieldSet* fields = batch.GetReflection()->MutableUnknownFields(&batch);
+    for (const palantir::XYSineRequest& item : items) {
+        item.SerializeToString(fields->AddLengthDelimited(kItemsField));
+    }
+    return batch;
+}
+
+bool parseXYSineBatch(const std::string& payload, std::vector<palantir::XYSineRequest>& outItems,
+                      QString* outError)
+{
+    auto fail = [outError](const QString& error) {
+        if (outError) {
+            *outError = error;
+        }
+        return false;
+    };
+
+    outItems.clear();
+    std::string item;
+    google::protobuf::io::CodedInputStream input(reinterpret_cast<const uint8_t*>(payload.data()),
+                                                 static_cast<int>(payload.size()));
+    while (const uint32_t tag = input.ReadTag()) {
+        if (WireFormatLite::GetTagFieldNumber(tag) != kItemsField
+            || WireFormatLite::GetTagWireType(tag) != WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+            // Fields a later contract may add are skipped
+            if (!WireFormatLite::SkipField(&input, tag)) {
+                return fail(QString("Malformed batch request"));
+            }
+            continue;
+        }
+        if (outItems.size() >= MAX_BATCH_ITEMS) {
+            return fail(QString("Batch exceeds %1 items").arg(MAX_BATCH_ITEMS));
+        }
+        // Items are a few scalars each, so copying them out is cheap
+        uint32_t length = 0;
+        if (!input.ReadVarint32(&length) || !input.ReadString(&item, static_cast<int>(length))) {
+            return fail(QString("Malformed batch request"));
+        }
+        if (!outItems.emplace_back().ParseFromString(item)) {
+            return fail(QString("Malformed XYSineRequest in batch item %1").arg(outItems.size() - 1));
+        }
+    }
+    if (!input.ConsumedEntireMessage()) {
+        return fail(QString("Malformed batch request"));
+    }
+    return true;
+}
+
+std::optional<uint32_t> batchIndex(const palantir::MessageEnvelope& envelope)
+{
+    auto it = envelope.metadata().find(kBatchIndexKey);
+    if (it == envelope.metadata().end()) {
+        return std::nullopt;
+    }
+    bool ok = false;
+    const uint index = QByteArray::fromStdString(it->second).toUInt(&ok);
+    if (!ok) {
+        return std::nullopt;
+    }
+    return static_cast<uint32_t>(index);
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
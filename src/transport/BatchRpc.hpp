@@ -0,0 +1,64 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "palantir/envelope.pb.h"
+#include "palantir/xysine.pb.h"
+#include <google/protobuf/empty.pb.h>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace phoenix::transport {
+
+// Batch RPC: many XY Sine parameter sets in one envelope.
+//
+// Bedrock lists kBatchFeature in its capabilities. XY_SINE_BATCH_REQUEST
+// carries the items as repeated field 1 of XYSineRequest messages (the wire
+// format of `message XYSineBatchRequest { repeated XYSineRequest items = 1; }`,
+// which the contracts do not define yet). Bedrock answers every item with
+// its own XY_SINE_RESPONSE or ERROR_RESPONSE envelope, in the order the items
+// finish, tagged with kBatchIndexKey and the batch's correlation ID; then
+// XY_SINE_BATCH_RESPONSE (empty payload, kBatchCountKey = number of items)
+// ends the batch. Items are never chunked; an item whose result exceeds the
+// message size limit gets an error. An ERROR_RESPONSE without kBatchIndexKey
+// fails the batch as a whole.
+//
+// The MessageType values are the next reserved ones after PROGRESS_UPDATE.
+static constexpr palantir::MessageType XY_SINE_BATCH_REQUEST = static_cast<palantir::MessageType>(14);
+static constexpr palantir::MessageType XY_SINE_BATCH_RESPONSE = static_cast<palantir::MessageType>(15);
+static constexpr const char* kBatchFeature = "xy_sine.batch";
+static constexpr const char* kBatchIndexKey = "batch_index";
+static constexpr const char* kBatchCountKey = "batch_count";
+
+// Upper bound on the items of one batch (larger sweeps are split)
+static constexpr size_t MAX_BATCH_ITEMS = 4096;
+
+/**
+ * Build the payload of an XY_SINE_BATCH_REQUEST.
+ *
+ * The items are stored as unknown field 1 of an Empty message, which
+ * serializes them exactly as the repeated field would.
+ */
+google::protobuf::Empty makeXYSineBatch(const std::vector<palantir::XYSineRequest>& items);
+
+/**
+ * Parse the items of an XY_SINE_BATCH_REQUEST payload (server side / tests).
+ *
+ * @return false on malformed payloads or more than MAX_BATCH_ITEMS items
+ */
+bool parseXYSineBatch(const std::string& payload, std::vector<palantir::XYSineRequest>& outItems,
+                      QString* outError = nullptr);
+
+/**
+ * Read the batch item index of a response envelope.
+ *
+ * @return Index, or empty optional if absent or malformed
+ */
+std::optional<uint32_t> batchIndex(const palantir::MessageEnvelope& envelope);
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
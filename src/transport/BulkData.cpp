@@ -0,0 +1,349 @@
+#include "BulkData.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include <QByteArray>
+#include <QList>
+#include <QRandomGenerator>
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace phoenix::transport {
+
+const char* precisionName(TransferPrecision precision)
+{
+    switch (precision) {
+        case TransferPrecision::Full:
+            return "f64";
+        case TransferPrecision::Float32:
+            return "f32";
+        case TransferPrecision::DeltaInt16:
+            return "dq16";
+    }
+    return "unknown";
+}
+
+std::optional<TransferPrecision> parsePrecision(std::string_view name)
+{
+    if (name == "f64") {
+        return TransferPrecision::Full;
+    }
+    if (name == "f32") {
+        return TransferPrecision::Float32;
+    }
+    if (name == "dq16") {
+        return TransferPrecision::DeltaInt16;
+    }
+    return std::nullopt;
+}
+
+void setPrecisionMetadata(std::map<std::string, std::string>& metadata, const ReducedPrecision& precision)
+{
+    if (precision.isFull()) {
+        return;
+    }
+    metadata[kPrecisionKey] = precisionName(precision.mode);
+    metadata[kErrorBoundKey] = QByteArray::number(precision.errorBound, 'g', 17).toStdString();
+}
+
+const char* dtypeName(BulkDType dtype)
+{
+    switch (dtype) {
+        case BulkDType::Float64:
+            return "f64";
+        case BulkDType::Float32:
+            return "f32";
+        case BulkDType::DeltaInt16:
+            return "dq16";
+    }
+    return "unknown";
+}
+
+std::optional<BulkDType> parseDType(std::string_view name)
+{
+    if (name == "f64") {
+        return BulkDType::Float64;
+    }
+    if (name == "f32") {
+        return BulkDType::Float32;
+    }
+    if (name == "dq16") {
+        return BulkDType::DeltaInt16;
+    }
+    return std::nullopt;
+}
+
+size_t dtypeSize(BulkDType dtype)
+{
+    switch (dtype) {
+        case BulkDType::Float64:
+            return sizeof(double);
+        case BulkDType::Float32:
+            return sizeof(float);
+        case BulkDType::DeltaInt16:
+            return sizeof(int16_t);
+    }
+    return 1;
+}
+
+// Copy count elements of width bytes between little-endian and host order
+static void copyLittleEndian(const char* src, size_t count, size_t width, char* dst)
+{
+    if (Q_BYTE_ORDER == Q_LITTLE_ENDIAN) {
+        std::memcpy(dst, src, count * width);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        std::reverse_copy(src + i * width, src + (i + 1) * width, dst + i * width);
+    }
+}
+
+std::string formatBulkColumns(const std::vector<BulkColumn>& columns)
+{
+    std::string text;
+    for (const BulkColumn& column : columns) {
+        if (!text.empty()) {
+            text += ';';
+        }
+        text += column.name;
+        text += ':';
+        text += dtypeName(column.dtype);
+        text += ':';
+        text += std::to_string(column.offset);
+        text += ':';
+        text += std::to_string(column.length);
+    }
+    return text;
+}
+
+bool parseBulkColumns(const std::string& text, std::vector<BulkColumn>& outColumns, QString* outError)
+{
+    outColumns.clear();
+    const QList<QByteArray> entries = QByteArray::fromStdString(text).split(';');
+    for (const QByteArray& entry : entries) {
+        const QList<QByteArray> fields = entry.split(':');
+        bool offsetOk = false;
+        bool lengthOk = false;
+        BulkColumn column;
+        if (fields.size() == 4) {
+            column.name = fields[0].toStdString();
+            column.offset = fields[2].toULongLong(&offsetOk);
+            column.length = fields[3].toULongLong(&lengthOk);
+        }
+        const auto dtype = fields.size() == 4 ? parseDType(fields[1].toStdString()) : std::nullopt;
+        if (column.name.empty() || !dtype.has_value() || !offsetOk || !lengthOk) {
+            if (outError) {
+                *outError = QString("Malformed bulk column descriptor: %1").arg(QString::fromUtf8(entry));
+            }
+            outColumns.clear();
+            return false;
+        }
+        column.dtype = *dtype;
+        outColumns.push_back(std::move(column));
+    }
+    return true;
+}
+
+std::string makeBulkShmPrefix()
+{
+    return QString("/phx_bulk_%1_")
+        .arg(QRandomGenerator::system()->generate64(), 16, 16, QLatin1Char('0'))
+        .toStdString();
+}
+
+bool isAcceptedBulkShmName(std::string_view name, std::string_view prefix)
+{
+    // POSIX shm names: one leading slash, at most NAME_MAX (255) characters
+    constexpr size_t maxNameLength = 255;
+    if (prefix.empty() || name.size() <= prefix.size() || name.size() > maxNameLength
+        || name.substr(0, prefix.size()) != prefix) {
+        return false;
+    }
+    return std::all_of(name.begin() + static_cast<std::ptrdiff_t>(prefix.size()), name.end(), [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    });
+}
+
+const BulkColumn* findBulkColumn(const std::vector<BulkColumn>& columns, std::string_view name)
+{
+    for (const BulkColumn& column : columns) {
+        if (column.name == name) {
+            return &column;
+        }
+    }
+    return nullptr;
+}
+
+bool validateBulkColumn(const BulkColumn& column, size_t regionSize, QString* outError)
+{
+    const size_t elementSize = dtypeSize(column.dtype);
+    if (column.offset > regionSize || column.length > regionSize - column.offset) {
+        if (outError) {
+            *outError = QString("Bulk column '%1' exceeds shared memory region (%2 bytes)")
+                        .arg(QString::fromStdString(column.name))
+                        .arg(regionSize);
+        }
+        return false;
+    }
+    if (column.offset % elementSize != 0 || column.length % elementSize != 0) {
+        if (outError) {
+            *outError = QString("Bulk column '%1' is not aligned to its element size")
+                        .arg(QString::fromStdString(column.name));
+        }
+        return false;
+    }
+    return true;
+}
+
+std::string formatQuantization(const QuantizationMap& quantization)
+{
+    std::string text;
+    for (const auto& [name, entry] : quantization) {
+        if (!text.empty()) {
+            text += ';';
+        }
+        text += name;
+        text += ':';
+        text += QByteArray::number(entry.base, 'g', 17).toStdString();
+        text += ':';
+        text += QByteArray::number(entry.scale, 'g', 17).toStdString();
+    }
+    return text;
+}
+
+bool parseQuantization(const std::string& text, QuantizationMap& outQuantization, QString* outError)
+{
+    outQuantization.clear();
+    const QList<QByteArray> entries = QByteArray::fromStdString(text).split(';');
+    for (const QByteArray& entry : entries) {
+        const QList<QByteArray> fields = entry.split(':');
+        bool baseOk = false;
+        bool scaleOk = false;
+        Quantization quantization;
+        if (fields.size() == 3) {
+            quantization.base = fields[1].toDouble(&baseOk);
+            quantization.scale = fields[2].toDouble(&scaleOk);
+        }
+        if (fields.size() != 3 || fields[0].isEmpty() || !baseOk || !scaleOk ||
+            !std::isfinite(quantization.base) || !std::isfinite(quantization.scale) ||
+            !(quantization.scale > 0.0)) {
+            if (outError) {
+                *outError = QString("Malformed quantization entry: %1").arg(QString::fromUtf8(entry));
+            }
+            outQuantization.clear();
+            return false;
+        }
+        outQuantization[fields[0].toStdString()] = quantization;
+    }
+    return true;
+}
+
+bool decodeColumn(const char* data, const BulkColumn& column, const QuantizationMap& quantization,
+                  double* dst, QString* outError)
+{
+    const size_t count = column.elementCount();
+    switch (column.dtype) {
+        case BulkDType::Float64:
+            copyLittleEndian(data, count, sizeof(double), reinterpret_cast<char*>(dst));
+            return true;
+        case BulkDType::Float32:
+            for (size_t i = 0; i < count; ++i) {
+                float value;
+                copyLittleEndian(data + i * sizeof(float), 1, sizeof(float), reinterpret_cast<char*>(&value));
+                dst[i] = value;
+            }
+            return true;
+        case BulkDType::DeltaInt16: {
+            auto it = quantization.find(column.name);
+            if (it == quantization.end()) {
+                if (outError) {
+                    *outError = QString("Quantized column '%1' has no quantization parameters")
+                                .arg(QString::fromStdString(column.name));
+                }
+                return false;
+            }
+            // Same accumulation as the encoder, so reconstruction errors do not drift
+            double value = it->second.base;
+            for (size_t i = 0; i < count; ++i) {
+                int16_t step;
+                copyLittleEndian(data + i * sizeof(int16_t), 1, sizeof(int16_t), reinterpret_cast<char*>(&step));
+                value += static_cast<double>(step) * it->second.scale;
+                dst[i] = value;
+            }
+            return true;
+        }
+    }
+    if (outError) {
+        *outError = QString("Unsupported column dtype");
+    }
+    return false;
+}
+
+const double* columnDoubles(const char* data, const BulkColumn& column, const QuantizationMap& quantization,
+                            std::vector<double>& scratch, QString* outError)
+{
+    if (column.dtype == BulkDType::Float64 && Q_BYTE_ORDER == Q_LITTLE_ENDIAN &&
+        reinterpret_cast<uintptr_t>(data) % alignof(double) == 0) {
+        return reinterpret_cast<const double*>(data);
+    }
+    scratch.resize(column.elementCount());
+    if (!decodeColumn(data, column, quantization, scratch.data(), outError)) {
+        return nullptr;
+    }
+    return scratch.data();
+}
+
+bool encodeColumn(const double* values, size_t count, BulkDType dtype, double errorBound,
+                  std::string& outBytes, Quantization* outQuantization)
+{
+    outBytes.resize(count * dtypeSize(dtype));
+    char* out = outBytes.data();
+    switch (dtype) {
+        case BulkDType::Float64:
+            copyLittleEndian(reinterpret_cast<const char*>(values), count, sizeof(double), out);
+            return true;
+        case BulkDType::Float32:
+            for (size_t i = 0; i < count; ++i) {
+                const float value = static_cast<float>(values[i]);
+                // A non-positive bound accepts plain float rounding
+                if (errorBound > 0.0 && !(std::abs(static_cast<double>(value) - values[i]) <= errorBound)) {
+                    return false;
+                }
+                copyLittleEndian(reinterpret_cast<const char*>(&value), 1, sizeof(float), out + i * sizeof(float));
+            }
+            return true;
+        case BulkDType::DeltaInt16: {
+            if (!(errorBound > 0.0) || !outQuantization) {
+                return false;
+            }
+            // Rounding each step to scale = 2 * errorBound keeps every
+            // reconstructed sample within errorBound; steps are taken from
+            // the reconstructed (not the true) previous value so errors
+            // never accumulate
+            Quantization quantization;
+            quantization.base = count > 0 ? values[0] : 0.0;
+            quantization.scale = 2.0 * errorBound;
+            double reconstructed = quantization.base;
+            for (size_t i = 0; i < count; ++i) {
+                const double step = std::nearbyint((values[i] - reconstructed) / quantization.scale);
+                if (!(std::abs(step) <= std::numeric_limits<int16_t>::max())) {
+                    return false;  // Jump too large (or NaN) for int16 steps
+                }
+                const int16_t quantized = static_cast<int16_t>(step);
+                reconstructed += static_cast<double>(quantized) * quantization.scale;
+                copyLittleEndian(reinterpret_cast<const char*>(&quantized), 1, sizeof(int16_t),
+                                 out + i * sizeof(int16_t));
+            }
+            *outQuantization = quantization;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
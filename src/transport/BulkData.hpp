@@ -0,0 +1,154 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace phoenix::transport {
+
+// Shared-memory bulk side channel (same-host only).
+//
+// Bedrock advertises kBulkSharedMemoryFeature in its capabilities; Phoenix
+// then sets kAcceptBulkShmKey on requests, its value being the region-name
+// prefix of the connection. The response envelope may carry the numeric
+// arrays in a POSIX shared-memory region instead of the payload:
+// kBulkShmNameKey names the region and kBulkColumnsKey describes where each
+// column lives in it. The consumer unlinks the region once mapped, so it
+// only accepts names made of the prefix and a suffix of [A-Za-z0-9_]
+// (see isAcceptedBulkShmName): a server cannot make it unlink anything else.
+static constexpr const char* kBulkSharedMemoryFeature = "transport.shm";
+static constexpr const char* kAcceptBulkShmKey = "accept_bulk_shm";
+static constexpr const char* kBulkShmNameKey = "bulk_shm_name";
+static constexpr const char* kBulkColumnsKey = "bulk_columns";
+
+// Reduced-precision transfer (plot-only results).
+//
+// Phoenix sets kPrecisionKey ("f32" or "dq16") and kErrorBoundKey (absolute
+// error allowed per sample) on requests whose result only feeds a plot.
+// Bedrock may then send columns as Float32, or as DeltaInt16: int16 steps
+// with v[i] = v[i-1] + q[i] * scale and v[-1] = base, where kQuantizationKey
+// lists base and scale per column ("y:base:scale;..."). Columns it cannot
+// reduce within the bound stay f64. Requests without kPrecisionKey always
+// receive full precision.
+static constexpr const char* kPrecisionKey = "precision";
+static constexpr const char* kErrorBoundKey = "error_bound";
+static constexpr const char* kQuantizationKey = "quantization";
+
+enum class TransferPrecision {
+    Full,
+    Float32,     // Half the bytes of f64
+    DeltaInt16   // A quarter of the bytes, error bounded by the request
+};
+
+const char* precisionName(TransferPrecision precision);
+std::optional<TransferPrecision> parsePrecision(std::string_view name);
+
+// Requested transfer precision for one RPC
+struct ReducedPrecision {
+    TransferPrecision mode = TransferPrecision::Full;
+    double errorBound = 0.0;  // Absolute; required for DeltaInt16
+
+    bool isFull() const { return mode == TransferPrecision::Full; }
+};
+
+// Add kPrecisionKey/kErrorBoundKey to request metadata (nothing for Full)
+void setPrecisionMetadata(std::map<std::string, std::string>& metadata, const ReducedPrecision& precision);
+
+// Random per-connection region-name prefix ("/phx_bulk_<16 hex digits>_")
+std::string makeBulkShmPrefix();
+
+// name is prefix followed by 1..NAME_MAX characters of [A-Za-z0-9_] in total
+bool isAcceptedBulkShmName(std::string_view name, std::string_view prefix);
+
+// Element type of a bulk column
+enum class BulkDType {
+    Float64,
+    Float32,
+    DeltaInt16
+};
+
+const char* dtypeName(BulkDType dtype);
+std::optional<BulkDType> parseDType(std::string_view name);
+size_t dtypeSize(BulkDType dtype);
+
+// Location of one column inside a bulk region
+struct BulkColumn {
+    std::string name;       // e.g. "x", "y"
+    BulkDType dtype = BulkDType::Float64;
+    uint64_t offset = 0;    // Byte offset from the start of the region
+    uint64_t length = 0;    // Byte length
+
+    size_t elementCount() const { return static_cast<size_t>(length / dtypeSize(dtype)); }
+};
+
+/**
+ * Encode columns as kBulkColumnsKey metadata: "name:dtype:offset:length;..."
+ * (offset/length in bytes, e.g. "x:f64:0:8000;y:f64:8000:8000").
+ */
+std::string formatBulkColumns(const std::vector<BulkColumn>& columns);
+
+/**
+ * Decode kBulkColumnsKey metadata.
+ *
+ * @return true on success, false if any column is malformed
+ */
+bool parseBulkColumns(const std::string& text, std::vector<BulkColumn>& outColumns, QString* outError = nullptr);
+
+// Column with the given name, or nullptr
+const BulkColumn* findBulkColumn(const std::vector<BulkColumn>& columns, std::string_view name);
+
+/**
+ * Check a column fits in a region of regionSize bytes, is aligned for its
+ * dtype and holds a whole number of elements.
+ */
+bool validateBulkColumn(const BulkColumn& column, size_t regionSize, QString* outError = nullptr);
+
+// Reconstruction parameters of a DeltaInt16 column
+struct Quantization {
+    double base = 0.0;
+    double scale = 1.0;
+};
+using QuantizationMap = std::map<std::string, Quantization>;
+
+// kQuantizationKey metadata: "name:base:scale;..." (round-trips doubles exactly)
+std::string formatQuantization(const QuantizationMap& quantization);
+bool parseQuantization(const std::string& text, QuantizationMap& outQuantization, QString* outError = nullptr);
+
+/**
+ * Decode a column stored at data (little-endian, any dtype) into
+ * column.elementCount() doubles at dst. DeltaInt16 columns need their entry
+ * in quantization.
+ */
+bool decodeColumn(const char* data, const BulkColumn& column, const QuantizationMap& quantization,
+                  double* dst, QString* outError = nullptr);
+
+/**
+ * Doubles of a column stored at data.
+ *
+ * Aligned f64 on a little-endian host is returned in place; anything else is
+ * decoded (upcast, dequantized or byte-swapped) into scratch.
+ *
+ * @return Pointer to column.elementCount() doubles, or nullptr on error
+ */
+const double* columnDoubles(const char* data, const BulkColumn& column, const QuantizationMap& quantization,
+                            std::vector<double>& scratch, QString* outError = nullptr);
+
+/**
+ * Encode values as little-endian bytes of dtype (server side / tests).
+ *
+ * Float32 and DeltaInt16 fail when a sample would be off by more than
+ * errorBound (or a delta overflows int16); the caller then sends f64.
+ * DeltaInt16 fills outQuantization.
+ */
+bool encodeColumn(const double* values, size_t count, BulkDType dtype, double errorBound,
+                  std::string& outBytes, Quantization* outQuantization = nullptr);
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
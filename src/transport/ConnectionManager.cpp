@@ -0,0 +1,320 @@
+#include "ConnectionManager.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include "app/PhxConstants.h"
+#include "palantir/capabilities.pb.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <algorithm>
+
+namespace phoenix::transport {
+
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+// The default factory is LocalSocketChannel, not TransportFactory: RemoteExecutor
+// needs its full API (EpollChannel is a benchmark backend)
+ConnectionManager::ConnectionManager(ChannelFactory factory, int keepaliveIntervalMs)
+    : m_factory(factory ? std::move(factory)
+                        : ChannelFactory([]() { return std::make_unique<LocalSocketChannel>(); }))
+    , m_keepaliveInterval(keepaliveIntervalMs)
+    , m_nextAttempt(Clock::now())
+    , m_backoffMs(phx::backoff::kFirstMs)
+    , m_everConnected(false)
+    , m_shutdown(false)
+    , m_generation(0)
+    , m_connectCount(0)
+    , m_capabilitiesFetchCount(0)
+    , m_rttMicros(0)
+    , m_stopKeepalive(false)
+    , m_keepaliveFailed(false)
+{
+}
+
+ConnectionManager::~ConnectionManager()
+{
+    shutdown();
+}
+
+ConnectionManager& ConnectionManager::instance()
+{
+    static ConnectionManager manager;
+    static std::once_flag quitHook;
+    std::call_once(quitHook, []() {
+        // Close the connection while the application is still fully alive
+        if (QCoreApplication* app = QCoreApplication::instance()) {
+            QObject::connect(app, &QCoreApplication::aboutToQuit, []() {
+                ConnectionManager::instance().shutdown();
+            });
+        }
+    });
+    return manager;
+}
+
+std::shared_ptr<LocalSocketChannel> ConnectionManager::channel(QString* outError)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_shutdown) {
+        if (outError) {
+            *outError = QString("Transport connection is shut down");
+        }
+        return nullptr;
+    }
+
+    if (m_channel && m_channel->isConnected()) {
+        return m_channel;
+    }
+
+    const auto now = Clock::now();
+    if (now < m_nextAttempt) {
+        if (outError) {
+            *outError = QString("Unable to connect to remote analysis service (retrying in %1 ms)")
+                        .arg(duration_cast<milliseconds>(m_nextAttempt - now).count());
+        }
+        return nullptr;
+    }
+
+    if (!m_channel) {
+        m_channel = std::shared_ptr<LocalSocketChannel>(m_factory());
+    }
+
+    if (!m_channel->connect()) {
+        m_nextAttempt = now + milliseconds(m_backoffMs);
+        qWarning() << "ConnectionManager: Connect failed, next attempt in" << m_backoffMs << "ms";
+        m_backoffMs = std::min(m_backoffMs * 2, phx::backoff::kMaxMs);
+        if (outError) {
+            *outError = QString("Unable to connect to remote analysis service");
+        }
+        return nullptr;
+    }
+
+    m_backoffMs = phx::backoff::kFirstMs;
+    m_nextAttempt = now;
+    m_everConnected = true;
+    m_connectCount.fetch_add(1);
+
+    // Nothing to keep alive before the first connection, so the thread
+    // starts here rather than with the (process-wide) instance
+    if (!m_keepaliveThread.joinable()) {
+        m_keepaliveThread = std::thread([this]() { keepaliveLoop(); });
+    }
+
+    // New connection: the server may have restarted or been upgraded
+    m_generation.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> capabilitiesLock(m_capabilitiesMutex);
+        m_capabilities.reset();
+    }
+
+    return m_channel;
+}
+
+std::shared_ptr<const ConnectionManager::ServerCapabilities> ConnectionManager::capabilities(QString* outError)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_capabilitiesMutex);
+        if (m_capabilities) {
+            return m_capabilities;
+        }
+    }
+
+    // Only one fetch at a time; later callers pick up its result
+    std::lock_guard<std::mutex> fetchLock(m_fetchMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_capabilitiesMutex);
+        if (m_capabilities) {
+            return m_capabilities;
+        }
+    }
+
+    auto connection = channel(outError);
+    if (!connection) {
+        return nullptr;
+    }
+
+    const uint64_t generation = m_generation.load();
+    const auto sent = Clock::now();
+    auto response = connection->getCapabilities(outError);
+    if (!response.has_value()) {
+        return nullptr;
+    }
+    recordRtt(Clock::now() - sent);
+    m_capabilitiesFetchCount.fetch_add(1);
+
+    auto fetched = toServerCapabilities(*response);
+    qDebug() << "Capabilities fetched: server_version=" << QString::fromStdString(fetched->serverVersion)
+             << "features=" << fetched->features.size();
+    storeCapabilities(generation, fetched);
+    return fetched;
+}
+
+std::shared_ptr<const ConnectionManager::ServerCapabilities> ConnectionManager::cachedCapabilities() const
+{
+    std::lock_guard<std::mutex> lock(m_capabilitiesMutex);
+    return m_capabilities;
+}
+
+void ConnectionManager::invalidateCapabilities()
+{
+    std::lock_guard<std::mutex> lock(m_capabilitiesMutex);
+    m_capabilities.reset();
+}
+
+void ConnectionManager::shutdown()
+{
+    // Shut down first: channel() starts no keepalive thread from here on
+    std::shared_ptr<LocalSocketChannel> closing;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+        closing.swap(m_channel);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_keepaliveMutex);
+        m_stopKeepalive = true;
+    }
+    m_keepaliveWake.notify_all();
+    if (m_keepaliveThread.joinable()) {
+        m_keepaliveThread.join();
+    }
+
+    // Closes the socket unless a run still holds the channel (it closes when that run ends)
+    closing.reset();
+    invalidateCapabilities();
+}
+
+void ConnectionManager::recordRtt(Clock::duration elapsed)
+{
+    const int64_t sample = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    int64_t current = m_rttMicros.load();
+    for (;;) {
+        const int64_t next = current == 0
+            ? sample
+            : static_cast<int64_t>(RTT_SMOOTHING * sample + (1.0 - RTT_SMOOTHING) * current);
+        if (m_rttMicros.compare_exchange_weak(current, next)) {
+            return;
+        }
+    }
+}
+
+int ConnectionManager::currentBackoffMs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_backoffMs;
+}
+
+milliseconds ConnectionManager::nextKeepaliveWait() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    milliseconds wait = m_keepaliveInterval;
+    const bool disconnected = !(m_channel && m_channel->isConnected());
+    if (m_everConnected && !m_shutdown && disconnected) {
+        // Wake for the next reconnect attempt instead of a full interval
+        wait = std::min(wait, duration_cast<milliseconds>(m_nextAttempt - Clock::now()));
+    }
+    return std::max(wait, milliseconds(10));
+}
+
+void ConnectionManager::keepaliveLoop()
+{
+    for (;;) {
+        const milliseconds wait = nextKeepaliveWait();
+        {
+            std::unique_lock<std::mutex> lock(m_keepaliveMutex);
+            if (m_keepaliveWake.wait_for(lock, wait, [this]() { return m_stopKeepalive; })) {
+                return;
+            }
+        }
+
+        std::shared_ptr<LocalSocketChannel> current;
+        bool everConnected = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            current = m_channel;
+            everConnected = m_everConnected;
+        }
+
+        // An unanswered keepalive means the server is wedged: drop the connection
+        if (m_keepaliveFailed.exchange(false) && current && current->isConnected()) {
+            qWarning() << "ConnectionManager: Keepalive timed out, dropping connection";
+            current->disconnect();
+        }
+
+        if (current && current->isConnected()) {
+            // Busy connections are evidently alive
+            if (current->pendingRequestCount() == 0) {
+                sendKeepalive(current, m_generation.load());
+            }
+        } else if (everConnected) {
+            QString error;
+            if (channel(&error)) {
+                qDebug() << "ConnectionManager: Reconnected to Bedrock";
+            }
+        }
+    }
+}
+
+void ConnectionManager::sendKeepalive(const std::shared_ptr<LocalSocketChannel>& channel, uint64_t generation)
+{
+    const int timeoutMs = static_cast<int>(std::min<milliseconds::rep>(
+        m_keepaliveInterval.count(), LocalSocketChannel::DEFAULT_TIMEOUT_MS));
+
+    palantir::CapabilitiesRequest request;
+    const auto sent = Clock::now();
+    channel->sendRequest(
+        palantir::MessageType::CAPABILITIES_REQUEST, request,
+        [this, generation, sent](LocalSocketChannel::Reply reply) {
+            // Runs on the channel's I/O thread: must not take m_mutex or
+            // release the last channel reference here
+            if (!reply.envelope.has_value()) {
+                if (reply.error.startsWith(QLatin1String("Timeout"))) {
+                    m_keepaliveFailed.store(true);
+                }
+                return;
+            }
+            if (reply.envelope->type() != palantir::MessageType::CAPABILITIES_RESPONSE) {
+                return;
+            }
+            recordRtt(Clock::now() - sent);
+            palantir::CapabilitiesResponse response;
+            const std::string& payload = reply.envelope->payload();
+            if (!response.ParseFromArray(payload.data(), static_cast<int>(payload.size()))) {
+                return;
+            }
+            // Keepalives double as cache refreshes (and catch server upgrades)
+            storeCapabilities(generation, toServerCapabilities(response));
+        },
+        {}, timeoutMs);
+}
+
+void ConnectionManager::storeCapabilities(uint64_t generation,
+                                          std::shared_ptr<const ServerCapabilities> capabilities)
+{
+    std::lock_guard<std::mutex> lock(m_capabilitiesMutex);
+    if (generation != m_generation.load()) {
+        return;  // Fetched over a connection that has since been replaced
+    }
+    if (m_capabilities && m_capabilities->serverVersion != capabilities->serverVersion) {
+        qInfo() << "ConnectionManager: Bedrock version changed from"
+                << QString::fromStdString(m_capabilities->serverVersion) << "to"
+                << QString::fromStdString(capabilities->serverVersion);
+    }
+    m_capabilities = std::move(capabilities);
+}
+
+std::shared_ptr<const ConnectionManager::ServerCapabilities>
+ConnectionManager::toServerCapabilities(const palantir::CapabilitiesResponse& response)
+{
+    auto capabilities = std::make_shared<ServerCapabilities>();
+    capabilities->serverVersion = response.capabilities().server_version();
+    for (int i = 0; i < response.capabilities().supported_features_size(); ++i) {
+        capabilities->features.insert(response.capabilities().supported_features(i));
+    }
+    return capabilities;
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,139 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "LocalSocketChannel.hpp"
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+namespace phoenix::transport {
+
+/**
+ * Process-wide persistent connection to Bedrock.
+ *
+ * Keeps one LocalSocketChannel open across analysis runs instead of
+ * connecting per run, and caches the server's capabilities so feature checks
+ * are a hash lookup rather than an extra round trip.
+ *
+ * - Reconnects lazily with exponential backoff (phx::backoff::kFirstMs up to
+ *   kMaxMs); while a backoff window is open, channel() fails fast.
+ * - A keepalive thread, started by the first successful connect, sends a
+ *   CAPABILITIES_REQUEST on idle connections; a reply with a different
+ *   server_version replaces the cache, a dropped connection is
+ *   re-established in the background.
+ * - The capabilities cache is invalidated on every (re)connect.
+ *
+ * Thread-safe. The channel's I/O thread never takes the connection lock, so
+ * blocking RPCs may be issued while other threads (re)connect.
+ */
+class ConnectionManager {
+public:
+    struct ServerCapabilities {
+        std::string serverVersion;
+        std::unordered_set<std::string> features;
+
+        bool supports(const std::string& feature) const { return features.count(feature) > 0; }
+    };
+
+    using ChannelFactory = std::function<std::unique_ptr<LocalSocketChannel>()>;
+
+    // factory defaults to LocalSocketChannel on the standard socket path
+    explicit ConnectionManager(ChannelFactory factory = nullptr,
+                               int keepaliveIntervalMs = DEFAULT_KEEPALIVE_INTERVAL_MS);
+    ~ConnectionManager();
+
+    ConnectionManager(const ConnectionManager&) = delete;
+    ConnectionManager& operator=(const ConnectionManager&) = delete;
+
+    // Shared instance used by RemoteExecutor (shut down on application quit)
+    static ConnectionManager& instance();
+
+    /**
+     * Connected channel, connecting or reconnecting if needed.
+     *
+     * @return Channel on success, nullptr on failure (outError describes why,
+     *         including an open backoff window)
+     */
+    std::shared_ptr<LocalSocketChannel> channel(QString* outError = nullptr);
+
+    /**
+     * Server capabilities for the current connection (cached after the first
+     * call; fetched with one RPC after a reconnect or invalidation).
+     *
+     * Must not be called from the channel's I/O thread.
+     */
+    std::shared_ptr<const ServerCapabilities> capabilities(QString* outError = nullptr);
+
+    // Cached capabilities without fetching (nullptr if none yet)
+    std::shared_ptr<const ServerCapabilities> cachedCapabilities() const;
+
+    // Drop cached capabilities (next capabilities() call refetches)
+    void invalidateCapabilities();
+
+    // Stop keepalives and close the connection (idempotent)
+    void shutdown();
+
+    // Diagnostics
+    int connectCount() const { return m_connectCount.load(); }
+    int capabilitiesFetchCount() const { return m_capabilitiesFetchCount.load(); }
+    int currentBackoffMs() const;
+
+    // Smoothed round-trip time of capabilities requests and keepalives
+    // (microseconds; 0 until one was answered). Neither does work on the
+    // server, so this is the link's latency alone.
+    int64_t rttMicros() const { return m_rttMicros.load(); }
+
+    static constexpr int DEFAULT_KEEPALIVE_INTERVAL_MS = 15000;
+    // Weight of the newest sample in rttMicros()
+    static constexpr double RTT_SMOOTHING = 0.2;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void keepaliveLoop();
+    std::chrono::milliseconds nextKeepaliveWait() const;
+    void sendKeepalive(const std::shared_ptr<LocalSocketChannel>& channel, uint64_t generation);
+    void storeCapabilities(uint64_t generation, std::shared_ptr<const ServerCapabilities> capabilities);
+    void recordRtt(Clock::duration elapsed);  // Any thread, including the I/O thread
+    static std::shared_ptr<const ServerCapabilities>
+        toServerCapabilities(const palantir::CapabilitiesResponse& response);
+
+    ChannelFactory m_factory;
+    const std::chrono::milliseconds m_keepaliveInterval;
+
+    // Connection state (never locked from the channel's I/O thread)
+    mutable std::mutex m_mutex;
+    std::shared_ptr<LocalSocketChannel> m_channel;
+    Clock::time_point m_nextAttempt;   // Earliest reconnect attempt
+    int m_backoffMs;                   // Delay applied after the next failure
+    bool m_everConnected;              // Reconnect in background only after a first success
+    bool m_shutdown;
+
+    // Capabilities cache, tagged with the connection generation it belongs to
+    mutable std::mutex m_capabilitiesMutex;
+    std::mutex m_fetchMutex;           // One capabilities fetch at a time
+    std::shared_ptr<const ServerCapabilities> m_capabilities;
+    std::atomic<uint64_t> m_generation;
+
+    std::atomic<int> m_connectCount;
+    std::atomic<int> m_capabilitiesFetchCount;
+    std::atomic<int64_t> m_rttMicros;
+
+    // Keepalive thread
+    std::mutex m_keepaliveMutex;
+    std::condition_variable m_keepaliveWake;
+    bool m_stopKeepalive;
+    std::atomic<bool> m_keepaliveFailed;  // Set on the I/O thread, handled by the keepalive thread
+    std::thread m_keepaliveThread;     // Started under m_mutex by the first connect
+};
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
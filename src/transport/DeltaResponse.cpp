@@ -0,0 +1,104 @@
+#include "DeltaResponse.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include <QByteArray>
+#include <cstring>
+
+namespace phoenix::transport {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+
+inline uint64_t rotl(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t mixWord(uint64_t lane, const double* value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, value, sizeof(bits));
+    return rotl(lane + bits * kPrime2, 31) * kPrime1;
+}
+
+} // namespace
+
+uint64_t columnHash(const double* data, size_t count)
+{
+    // XXH64-style: the lanes have no dependency on each other, so the
+    // multiplies overlap
+    uint64_t lanes[4] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        lanes[0] = mixWord(lanes[0], data + i);
+        lanes[1] = mixWord(lanes[1], data + i + 1);
+        lanes[2] = mixWord(lanes[2], data + i + 2);
+        lanes[3] = mixWord(lanes[3], data + i + 3);
+    }
+    for (; i < count; ++i) {
+        lanes[i % 4] = mixWord(lanes[i % 4], data + i);
+    }
+
+    uint64_t hash = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+    hash ^= static_cast<uint64_t>(count) * kPrime3;
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void setBaseColumnsMetadata(std::map<std::string, std::string>& metadata, const DeltaBase& base)
+{
+    auto hex = [](uint64_t hash) {
+        return QByteArray::number(static_cast<qulonglong>(hash), 16).rightJustified(16, '0').toStdString();
+    };
+    metadata[kBaseColumnsKey] = "x:" + hex(base.xHash) + ";y:" + hex(base.yHash);
+}
+
+std::optional<ColumnHashes> baseColumnsFromEnvelope(const palantir::MessageEnvelope& envelope,
+                                                    QString* outError)
+{
+    auto it = envelope.metadata().find(kBaseColumnsKey);
+    if (it == envelope.metadata().end()) {
+        return std::nullopt;
+    }
+
+    ColumnHashes hashes;
+    for (const QByteArray& entry : QByteArray::fromStdString(it->second).split(';')) {
+        const int colon = entry.indexOf(':');
+        bool ok = false;
+        const uint64_t hash = colon > 0 ? entry.mid(colon + 1).toULongLong(&ok, 16) : 0;
+        if (!ok) {
+            if (outError) {
+                *outError = QString("Malformed base column entry: %1").arg(QString::fromUtf8(entry));
+            }
+            return std::nullopt;
+        }
+        hashes[entry.left(colon).toStdString()] = hash;
+    }
+    return hashes;
+}
+
+std::set<std::string> reusedColumns(const palantir::MessageEnvelope& envelope)
+{
+    std::set<std::string> names;
+    auto it = envelope.metadata().find(kReusedColumnsKey);
+    if (it != envelope.metadata().end()) {
+        for (const QByteArray& name : QByteArray::fromStdString(it->second).split(',')) {
+            if (!name.isEmpty()) {
+                names.insert(name.toStdString());
+            }
+        }
+    }
+    return names;
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
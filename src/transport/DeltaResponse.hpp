@@ -0,0 +1,69 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "palantir/envelope.pb.h"
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+
+namespace phoenix::transport {
+
+// Delta responses (interactive re-runs).
+//
+// Bedrock lists kDeltaFeature in its capabilities. A client that still holds
+// the result of an earlier run names its columns in kBaseColumnsKey
+// ("x:<hash>;y:<hash>", columnHash() as 16 hex digits). Bedrock hashes the
+// columns of the new result the same way and leaves out every column whose
+// hash matches, listing it in kReusedColumnsKey ("x,y"); the client takes
+// those columns from its own copy. The remaining columns travel as usual
+// (repeated fields, packed, shared memory, compressed), in every chunk of a
+// chunked response. A response that reuses every column is never chunked.
+//
+// Bedrock keeps no per-client state: the hashes say everything, so a delta
+// request may go to any endpoint.
+static constexpr const char* kDeltaFeature = "xy_sine.delta";
+static constexpr const char* kBaseColumnsKey = "base_columns";
+static constexpr const char* kReusedColumnsKey = "reused_columns";
+
+// Column name -> columnHash()
+using ColumnHashes = std::map<std::string, uint64_t>;
+
+// Result the client already holds. x/y must stay valid for the whole request.
+struct DeltaBase {
+    const double* x = nullptr;
+    const double* y = nullptr;
+    size_t count = 0;
+    uint64_t xHash = 0;  // columnHash(x, count)
+    uint64_t yHash = 0;  // columnHash(y, count)
+};
+
+/**
+ * Content hash of a float64 column (not cryptographic).
+ *
+ * Covers the element count and the exact bit patterns, so 0.0 and -0.0
+ * differ. Four independent lanes keep it at memory speed.
+ */
+uint64_t columnHash(const double* data, size_t count);
+
+// Add kBaseColumnsKey for base to request metadata
+void setBaseColumnsMetadata(std::map<std::string, std::string>& metadata, const DeltaBase& base);
+
+/**
+ * Read kBaseColumnsKey of a request (server side / tests).
+ *
+ * @return Hashes, or empty optional if the request names no base or the key
+ *         is malformed (outError set only in the latter case)
+ */
+std::optional<ColumnHashes> baseColumnsFromEnvelope(const palantir::MessageEnvelope& envelope,
+                                                    QString* outError = nullptr);
+
+// Columns a response left out (kReusedColumnsKey; empty when absent)
+std::set<std::string> reusedColumns(const palantir::MessageEnvelope& envelope);
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
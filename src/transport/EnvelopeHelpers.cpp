@@ -2,6 +2,9 @@
 
 #ifdef PHX_WITH_TRANSPORT_DEPS
 
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
 #include <optional>
 #include <string>
 
@@ -13,21 +16,19 @@ std::optional<palantir::MessageEnvelope> makeEnvelope(
     const std::map<std::string, std::string>& metadata,
     QString* outError)
 {
-    // Serialize inner message
-    std::string serializedPayload;
-    if (!innerMessage.SerializeToString(&serializedPayload)) {
+    // Create envelope
+    palantir::MessageEnvelope envelope;
+    envelope.set_version(PROTOCOL_VERSION);
+    envelope.set_type(type);
+    
+    // Serialize inner message straight into the payload field (no temporary copy)
+    if (!innerMessage.SerializeToString(envelope.mutable_payload())) {
         if (outError) {
             *outError = "Failed to serialize inner message";
         }
         return std::nullopt;
     }
     
-    // Create envelope
-    palantir::MessageEnvelope envelope;
-    envelope.set_version(PROTOCOL_VERSION);
-    envelope.set_type(type);
-    envelope.set_payload(serializedPayload);
-    
     // Set metadata
     for (const auto& [key, value] : metadata) {
         (*envelope.mutable_metadata())[key] = value;
@@ -36,12 +37,35 @@ std::optional<palantir::MessageEnvelope> makeEnvelope(
     return envelope;
 }
 
+std::optional<palantir::MessageEnvelope> makeEnvelope(
+    palantir::MessageType type,
+    const google::protobuf::Message& innerMessage,
+    const std::map<std::string, std::string>& metadata,
+    const CompressionOptions& compression,
+    QString* outError)
+{
+    auto envelope = makeEnvelope(type, innerMessage, metadata, outError);
+    if (envelope.has_value() && !compressPayload(*envelope, compression, outError)) {
+        return std::nullopt;
+    }
+    return envelope;
+}
+
 bool parseEnvelope(
     const QByteArray& buffer,
     palantir::MessageEnvelope& outEnvelope,
     QString* outError)
 {
-    if (buffer.isEmpty()) {
+    return parseEnvelope(buffer.constData(), static_cast<size_t>(buffer.size()), outEnvelope, outError);
+}
+
+bool parseEnvelope(
+    const char* data,
+    size_t size,
+    palantir::MessageEnvelope& outEnvelope,
+    QString* outError)
+{
+    if (size == 0) {
         if (outError) {
             *outError = "Empty buffer";
         }
@@ -49,26 +73,37 @@ bool parseEnvelope(
     }
     
     // Parse envelope from buffer
-    if (!outEnvelope.ParseFromArray(buffer.data(), buffer.size())) {
+    if (!outEnvelope.ParseFromArray(data, static_cast<int>(size))) {
         if (outError) {
             *outError = "Failed to parse MessageEnvelope";
         }
         return false;
     }
     
-    // Validate version
-    if (outEnvelope.version() != PROTOCOL_VERSION) {
+    if (!validateEnvelopeHeader(outEnvelope.version(), static_cast<int>(outEnvelope.type()), outError)) {
+        return false;
+    }
+    
+    return decompressPayload(outEnvelope, outError);
+}
+
+bool validateEnvelopeHeader(uint32_t version, int typeValue, QString* outError)
+{
+    // Validate version (v1 and v2 are supported side by side)
+    if (version < PROTOCOL_VERSION || version > MAX_PROTOCOL_VERSION) {
         if (outError) {
-            *outError = QString("Invalid protocol version: %1 (expected %2)")
-                       .arg(outEnvelope.version())
-                       .arg(PROTOCOL_VERSION);
+            *outError = QString("Invalid protocol version: %1 (expected %2-%3)")
+                       .arg(version)
+                       .arg(PROTOCOL_VERSION)
+                       .arg(MAX_PROTOCOL_VERSION);
         }
         return false;
     }
     
     // Validate type (check if it's in valid enum range)
     // MessageType enum values: 0-11 are defined, 12-255 are reserved
-    int typeValue = static_cast<int>(outEnvelope.type());
+    // (12/13 carry CANCEL_REQUEST/PROGRESS_UPDATE, see EnvelopeHelpers.hpp;
+    // 14/15 the XY Sine batch messages, see BatchRpc.hpp)
     if (typeValue < 0 || typeValue > 255) {
         if (outError) {
             *outError = QString("Invalid MessageType value: %1").arg(typeValue);
@@ -77,7 +112,7 @@ bool parseEnvelope(
     }
     
     // Check for UNSPECIFIED type (0) - this is reserved and should not be used
-    if (outEnvelope.type() == palantir::MessageType::MESSAGE_TYPE_UNSPECIFIED) {
+    if (typeValue == palantir::MessageType::MESSAGE_TYPE_UNSPECIFIED) {
         if (outError) {
             *outError = "MessageType is UNSPECIFIED (invalid)";
         }
@@ -90,6 +125,198 @@ bool parseEnvelope(
     return true;
 }
 
+const char* encodingName(PayloadEncoding encoding)
+{
+    switch (encoding) {
+        case PayloadEncoding::Identity:
+            return "identity";
+        case PayloadEncoding::Zlib:
+            return "zlib";
+    }
+    return "unknown";
+}
+
+std::optional<PayloadEncoding> parseEncoding(std::string_view name)
+{
+    if (name == "identity") {
+        return PayloadEncoding::Identity;
+    }
+    if (name == "zlib") {
+        return PayloadEncoding::Zlib;
+    }
+    return std::nullopt;
+}
+
+bool compressPayload(palantir::MessageEnvelope& envelope, const CompressionOptions& options, QString* outError)
+{
+    if (envelope.metadata().count(kPayloadEncodingKey) > 0) {
+        if (outError) {
+            *outError = "Payload is already encoded";
+        }
+        return false;
+    }
+    
+    const std::string& payload = envelope.payload();
+    if (options.encoding == PayloadEncoding::Identity || payload.empty() ||
+        payload.size() < options.threshold) {
+        return true;
+    }
+    
+    const QByteArray compressed = qCompress(reinterpret_cast<const uchar*>(payload.data()),
+                                            static_cast<qsizetype>(payload.size()), options.level);
+    // Incompressible data (e.g. noisy doubles) goes out as-is
+    if (compressed.isEmpty() || static_cast<size_t>(compressed.size()) >= payload.size()) {
+        return true;
+    }
+    
+    envelope.set_payload(compressed.constData(), static_cast<size_t>(compressed.size()));
+    (*envelope.mutable_metadata())[kPayloadEncodingKey] = encodingName(options.encoding);
+    return true;
+}
+
+bool decompressBytes(PayloadEncoding encoding, const char* data, size_t size, std::string& out, QString* outError)
+{
+    if (encoding == PayloadEncoding::Identity) {
+        out.assign(data, size);
+        return true;
+    }
+    
+    // qCompress() prefixes the uncompressed size (big-endian); check it
+    // before inflating anything
+    if (size < 4) {
+        if (outError) {
+            *outError = "Compressed payload is truncated";
+        }
+        return false;
+    }
+    const auto* bytes = reinterpret_cast<const uchar*>(data);
+    const size_t expected = (size_t(bytes[0]) << 24) | (size_t(bytes[1]) << 16) |
+                            (size_t(bytes[2]) << 8) | size_t(bytes[3]);
+    if (expected > MAX_DECOMPRESSED_PAYLOAD_SIZE) {
+        if (outError) {
+            *outError = QString("Decompressed payload too large: %1 bytes (max %2)")
+                        .arg(expected)
+                        .arg(MAX_DECOMPRESSED_PAYLOAD_SIZE);
+        }
+        return false;
+    }
+    
+    const QByteArray inflated = qUncompress(bytes, static_cast<qsizetype>(size));
+    if (static_cast<size_t>(inflated.size()) != expected) {
+        if (outError) {
+            *outError = "Failed to decompress payload";
+        }
+        return false;
+    }
+    out.assign(inflated.constData(), static_cast<size_t>(inflated.size()));
+    return true;
+}
+
+bool decompressPayload(palantir::MessageEnvelope& envelope, QString* outError)
+{
+    auto it = envelope.metadata().find(kPayloadEncodingKey);
+    if (it == envelope.metadata().end()) {
+        return true;
+    }
+    
+    const auto encoding = parseEncoding(it->second);
+    if (!encoding.has_value()) {
+        if (outError) {
+            *outError = QString("Unsupported payload encoding: %1").arg(QString::fromStdString(it->second));
+        }
+        return false;
+    }
+    
+    std::string plain;
+    if (!decompressBytes(*encoding, envelope.payload().data(), envelope.payload().size(), plain, outError)) {
+        return false;
+    }
+    envelope.set_payload(std::move(plain));
+    envelope.mutable_metadata()->erase(kPayloadEncodingKey);
+    return true;
+}
+
+std::optional<uint64_t> correlationId(const palantir::MessageEnvelope& envelope)
+{
+    auto it = envelope.metadata().find(kCorrelationIdKey);
+    if (it == envelope.metadata().end() || it->second.empty()) {
+        return std::nullopt;
+    }
+    
+    bool ok = false;
+    const qulonglong id = QByteArray::fromStdString(it->second).toULongLong(&ok);
+    if (!ok) {
+        return std::nullopt;
+    }
+    return static_cast<uint64_t>(id);
+}
+
+void setCorrelationId(palantir::MessageEnvelope& envelope, uint64_t id)
+{
+    (*envelope.mutable_metadata())[kCorrelationIdKey] = std::to_string(id);
+}
+
+// Parse an unsigned metadata value; false if absent or malformed
+static bool metadataUInt(const palantir::MessageEnvelope& envelope, const char* key, uint64_t& out)
+{
+    auto it = envelope.metadata().find(key);
+    if (it == envelope.metadata().end()) {
+        return false;
+    }
+    bool ok = false;
+    out = QByteArray::fromStdString(it->second).toULongLong(&ok);
+    return ok;
+}
+
+std::optional<ChunkInfo> chunkInfo(const palantir::MessageEnvelope& envelope)
+{
+    uint64_t index = 0;
+    uint64_t count = 0;
+    if (!metadataUInt(envelope, kChunkIndexKey, index) ||
+        !metadataUInt(envelope, kChunkCountKey, count)) {
+        return std::nullopt;
+    }
+    
+    ChunkInfo info;
+    info.index = static_cast<uint32_t>(index);
+    info.count = static_cast<uint32_t>(count);
+    metadataUInt(envelope, kChunkOffsetKey, info.offset);
+    metadataUInt(envelope, kTotalSamplesKey, info.totalSamples);
+    
+    if (info.count == 0 || info.index >= info.count) {
+        return std::nullopt;
+    }
+    return info;
+}
+
+void setChunkInfo(palantir::MessageEnvelope& envelope, const ChunkInfo& info)
+{
+    auto& metadata = *envelope.mutable_metadata();
+    metadata[kChunkIndexKey] = std::to_string(info.index);
+    metadata[kChunkCountKey] = std::to_string(info.count);
+    metadata[kChunkOffsetKey] = std::to_string(info.offset);
+    metadata[kTotalSamplesKey] = std::to_string(info.totalSamples);
+}
+
+std::optional<double> progressFraction(const palantir::MessageEnvelope& envelope)
+{
+    auto it = envelope.metadata().find(kProgressKey);
+    if (it == envelope.metadata().end()) {
+        return std::nullopt;
+    }
+    bool ok = false;
+    const double fraction = QByteArray::fromStdString(it->second).toDouble(&ok);
+    if (!ok || std::isnan(fraction)) {
+        return std::nullopt;
+    }
+    return std::clamp(fraction, 0.0, 1.0);
+}
+
+void setProgressFraction(palantir::MessageEnvelope& envelope, double fraction)
+{
+    (*envelope.mutable_metadata())[kProgressKey] = QByteArray::number(fraction, 'g', 6).toStdString();
+}
+
 } // namespace phoenix::transport
 
 #endif // PHX_WITH_TRANSPORT_DEPS
@@ -6,8 +6,10 @@
 #include <google/protobuf/message.h>
 #include <QByteArray>
 #include <QString>
+#include <cstddef>
 #include <map>
 #include <string>
+#include <string_view>
 #include <optional>
 
 namespace phoenix::transport {
@@ -15,6 +17,85 @@ namespace phoenix::transport {
 // Constants
 static constexpr uint32_t PROTOCOL_VERSION = 1;
 
+// Protocol v2: same envelope, but numeric columns may travel packed after
+// the inner message (see PackedColumns.hpp). Sent only to servers listing
+// kProtocolV2Feature; a server answers in the version of the request.
+static constexpr uint32_t PROTOCOL_VERSION_V2 = 2;
+static constexpr uint32_t MAX_PROTOCOL_VERSION = PROTOCOL_VERSION_V2;
+static constexpr const char* kProtocolV2Feature = "protocol.v2";
+
+// Metadata key carrying the request/response correlation ID.
+// The client stamps every request; the server echoes it on the response so
+// many requests can be in flight on one connection.
+static constexpr const char* kCorrelationIdKey = "correlation_id";
+
+// Chunked responses (lift the per-envelope MAX_MESSAGE_SIZE ceiling).
+// The client opts in with kAcceptChunkedKey; the server may then split a
+// logical result into sequenced envelopes of the response type, each carrying
+// a contiguous slice of samples starting at kChunkOffsetKey.
+static constexpr const char* kAcceptChunkedKey = "accept_chunked";
+static constexpr const char* kMaxChunkBytesKey = "max_chunk_bytes";
+static constexpr const char* kChunkIndexKey = "chunk_index";
+static constexpr const char* kChunkCountKey = "chunk_count";
+static constexpr const char* kChunkOffsetKey = "chunk_offset";
+static constexpr const char* kTotalSamplesKey = "total_samples";
+
+// Default chunk size requested by Phoenix (well under MAX_MESSAGE_SIZE)
+static constexpr uint32_t DEFAULT_MAX_CHUNK_BYTES = 4 * 1024 * 1024;
+
+// Position of one chunk within a chunked response
+struct ChunkInfo {
+    uint32_t index = 0;         // 0-based chunk sequence number
+    uint32_t count = 1;         // Total number of chunks
+    uint64_t offset = 0;        // First sample index carried by this chunk
+    uint64_t totalSamples = 0;  // Samples in the complete result
+
+    bool isLast() const { return index + 1 >= count; }
+};
+
+// Cancellation and server-pushed progress.
+// The contracts' MessageType enum predates these two messages, so they use
+// the first reserved values. CANCEL_REQUEST (empty payload) carries the
+// correlation ID of the request to abandon. Bedrock stops the computation,
+// skips the remaining chunks and ends the request with an ERROR_RESPONSE. It
+// is sent only when Bedrock lists kCancelFeature. A request carrying
+// kAcceptProgressKey may be followed by PROGRESS_UPDATE envelopes (same
+// correlation ID, empty payload, fraction done in kProgressKey) before its
+// response; each one also extends the request deadline.
+static constexpr palantir::MessageType CANCEL_REQUEST = static_cast<palantir::MessageType>(12);
+static constexpr palantir::MessageType PROGRESS_UPDATE = static_cast<palantir::MessageType>(13);
+static constexpr const char* kCancelFeature = "transport.cancel";
+static constexpr const char* kAcceptProgressKey = "accept_progress";
+static constexpr const char* kProgressKey = "progress";
+
+// Payload compression (negotiated).
+// Bedrock lists kCompressionFeature in its capabilities; Phoenix then sets
+// kAcceptEncodingKey (comma-separated codec names) on its requests. A sender
+// may compress any payload of at least its threshold with an accepted codec
+// and names it in kPayloadEncodingKey; without that key the payload is plain.
+static constexpr const char* kCompressionFeature = "transport.compression";
+static constexpr const char* kAcceptEncodingKey = "accept_encoding";
+static constexpr const char* kPayloadEncodingKey = "payload_encoding";
+
+// Payloads below this size are sent as-is (control messages, small results)
+static constexpr size_t DEFAULT_COMPRESSION_THRESHOLD = 64 * 1024;
+// Upper bound on a decompressed payload (guards against compression bombs)
+static constexpr size_t MAX_DECOMPRESSED_PAYLOAD_SIZE = 64 * 1024 * 1024;
+
+enum class PayloadEncoding {
+    Identity,
+    Zlib        // qCompress(): 4-byte big-endian size + zlib stream
+};
+
+const char* encodingName(PayloadEncoding encoding);
+std::optional<PayloadEncoding> parseEncoding(std::string_view name);
+
+struct CompressionOptions {
+    PayloadEncoding encoding = PayloadEncoding::Identity;
+    size_t threshold = DEFAULT_COMPRESSION_THRESHOLD;
+    int level = 1;  // zlib level: favour speed, socket copies are what we save
+};
+
 /**
  * Create a MessageEnvelope from an inner message.
  * 
@@ -30,8 +111,22 @@ std::optional<palantir::MessageEnvelope> makeEnvelope(
     const std::map<std::string, std::string>& metadata = {},
     QString* outError = nullptr);
 
+/**
+ * Same as above, compressing the payload per options when it reaches the
+ * threshold and actually shrinks.
+ */
+std::optional<palantir::MessageEnvelope> makeEnvelope(
+    palantir::MessageType type,
+    const google::protobuf::Message& innerMessage,
+    const std::map<std::string, std::string>& metadata,
+    const CompressionOptions& compression,
+    QString* outError = nullptr);
+
 /**
  * Parse a MessageEnvelope from a buffer.
+ *
+ * A compressed payload is decompressed in place and kPayloadEncodingKey
+ * removed, so callers always see the plain inner message bytes.
  * 
  * @param buffer Serialized MessageEnvelope bytes
  * @param outEnvelope Output envelope (populated on success)
@@ -43,6 +138,86 @@ bool parseEnvelope(
     palantir::MessageEnvelope& outEnvelope,
     QString* outError = nullptr);
 
+// Same as above, parsing directly from a caller-owned byte range
+bool parseEnvelope(
+    const char* data,
+    size_t size,
+    palantir::MessageEnvelope& outEnvelope,
+    QString* outError = nullptr);
+
+/**
+ * Validate the envelope header fields (protocol version and MessageType).
+ * 
+ * Versions PROTOCOL_VERSION through MAX_PROTOCOL_VERSION are accepted.
+ * 
+ * Shared by parseEnvelope() and the zero-copy frame decoder.
+ * 
+ * @return true if the header is acceptable, false otherwise
+ */
+bool validateEnvelopeHeader(uint32_t version, int typeValue, QString* outError = nullptr);
+
+/**
+ * Compress envelope's payload in place (no-op below the threshold, for
+ * Identity, or when compression would not shrink it).
+ *
+ * @return false only if the envelope is already encoded
+ */
+bool compressPayload(palantir::MessageEnvelope& envelope, const CompressionOptions& options,
+                     QString* outError = nullptr);
+
+/**
+ * Undo compressPayload() (no-op for plain payloads).
+ *
+ * @return false on unknown codecs, corrupt data or oversize output
+ */
+bool decompressPayload(palantir::MessageEnvelope& envelope, QString* outError = nullptr);
+
+/**
+ * Decompress size bytes encoded with encoding into out.
+ *
+ * Shared by decompressPayload() and the zero-copy frame decoder.
+ */
+bool decompressBytes(PayloadEncoding encoding, const char* data, size_t size, std::string& out,
+                     QString* outError = nullptr);
+
+/**
+ * Read the correlation ID from envelope metadata.
+ *
+ * @param envelope Envelope to inspect
+ * @return Correlation ID, or empty optional if absent or malformed
+ */
+std::optional<uint64_t> correlationId(const palantir::MessageEnvelope& envelope);
+
+/**
+ * Stamp a correlation ID into envelope metadata (overwrites any existing value).
+ */
+void setCorrelationId(palantir::MessageEnvelope& envelope, uint64_t id);
+
+/**
+ * Read chunk sequencing metadata from an envelope.
+ *
+ * @return ChunkInfo if the envelope is part of a chunked response, empty
+ *         optional otherwise (including when the metadata is inconsistent)
+ */
+std::optional<ChunkInfo> chunkInfo(const palantir::MessageEnvelope& envelope);
+
+/**
+ * Write chunk sequencing metadata into an envelope (server side / tests).
+ */
+void setChunkInfo(palantir::MessageEnvelope& envelope, const ChunkInfo& info);
+
+/**
+ * Read the fraction done from a PROGRESS_UPDATE envelope.
+ *
+ * @return Fraction clamped to [0, 1], or empty optional if absent or malformed
+ */
+std::optional<double> progressFraction(const palantir::MessageEnvelope& envelope);
+
+/**
+ * Write the fraction done into an envelope (server side / tests).
+ */
+void setProgressFraction(palantir::MessageEnvelope& envelope, double fraction);
+
 } // namespace phoenix::transport
 
 #endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,544 @@
+#include "EpollChannel.hpp"
+
+#if defined(PHX_WITH_TRANSPORT_DEPS) && defined(__linux__)
+
+#include "EnvelopeHelpers.hpp"
+#include "LocalSocketChannel.hpp"
+#include "palantir/error.pb.h"
+#include <QDebug>
+#include <QDir>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace phoenix::transport {
+
+namespace {
+
+QString defaultSocketPath()
+{
+    const QString envPath = qEnvironmentVariable("PALANTIR_SOCKET_PATH");
+    return envPath.isEmpty() ? QStringLiteral("palantir_bedrock") : envPath;
+}
+
+// QLocalSocket/QLocalServer place plain names in the temp directory
+std::string resolveSocketPath(const QString& name)
+{
+    if (name.startsWith('/')) {
+        return name.toStdString();
+    }
+    return QDir(QDir::tempPath()).absoluteFilePath(name).toStdString();
+}
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "futex word must be a plain 32-bit integer");
+
+void futexWait(std::atomic<uint32_t>& word, uint32_t expected)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<uint32_t>& word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// Completion slot of one blocking caller: the I/O thread fills reply, then
+// flips done and wakes the caller's futex
+struct Waiter {
+    std::atomic<uint32_t> done{0};
+    EpollChannel::Reply reply;
+};
+
+} // namespace
+
+EpollChannel::EpollChannel(const QString& socketPath)
+    : m_socketPath(socketPath.isEmpty() ? defaultSocketPath() : socketPath)
+    , m_frameDecoder(MAX_MESSAGE_SIZE)
+{
+}
+
+EpollChannel::~EpollChannel()
+{
+    disconnect();
+}
+
+bool EpollChannel::connect()
+{
+    std::lock_guard<std::mutex> lock(m_lifecycleMutex);
+    if (m_connected.load()) {
+        return true;
+    }
+    // A loop that ended on its own (Bedrock closed the connection) is reaped here
+    stopIoThread();
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = resolveSocketPath(m_socketPath);
+    if (path.size() >= sizeof(address.sun_path)) {
+        qWarning() << "EpollChannel: Socket path too long:" << QString::fromStdString(path);
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    // Blocking connect (a local connect completes or fails at once), then
+    // non-blocking I/O for the loop
+    m_socketFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_socketFd < 0 || ::connect(m_socketFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::fcntl(m_socketFd, F_SETFL, ::fcntl(m_socketFd, F_GETFL) | O_NONBLOCK) != 0) {
+        closeFds();
+        return false;
+    }
+
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event socketEvent{};
+    socketEvent.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    socketEvent.data.fd = m_socketFd;
+    epoll_event wakeEvent{};
+    wakeEvent.events = EPOLLIN;
+    wakeEvent.data.fd = m_wakeFd;
+    if (m_epollFd < 0 || m_wakeFd < 0
+        || ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_socketFd, &socketEvent) != 0
+        || ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &wakeEvent) != 0) {
+        qWarning() << "EpollChannel: Cannot set up epoll:" << std::strerror(errno);
+        closeFds();
+        return false;
+    }
+
+    m_frameDecoder.reset();
+    m_outbox.clear();
+    m_outboxOffset = 0;
+    m_writable = true;
+    m_stopping.store(false);
+    m_connected.store(true);
+    m_ioThread = std::thread([this]() { ioLoop(); });
+    return true;
+}
+
+void EpollChannel::disconnect()
+{
+    std::lock_guard<std::mutex> lock(m_lifecycleMutex);
+    stopIoThread();
+}
+
+void EpollChannel::stopIoThread()
+{
+    if (m_ioThread.joinable()) {
+        m_stopping.store(true);
+        if (std::this_thread::get_id() == m_ioThread.get_id()) {
+            // From a reply callback: the loop ends after it; reaped by the next connect()
+            return;
+        }
+        const uint64_t wake = 1;
+        [[maybe_unused]] const ssize_t written = ::write(m_wakeFd, &wake, sizeof(wake));
+        m_ioThread.join();
+    }
+    closeFds();
+}
+
+void EpollChannel::closeFds()
+{
+    for (int* fd : {&m_socketFd, &m_epollFd, &m_wakeFd}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+bool EpollChannel::isConnected() const
+{
+    return m_connected.load();
+}
+
+EpollChannel::IoStats EpollChannel::ioStats() const
+{
+    IoStats stats;
+    stats.writeCalls = m_writeCalls.load();
+    stats.framesWritten = m_framesWritten.load();
+    stats.readCalls = m_readCalls.load();
+    stats.framesRead = m_framesRead.load();
+    return stats;
+}
+
+uint64_t EpollChannel::sendRequest(palantir::MessageType type,
+                                   const google::protobuf::Message& request,
+                                   ReplyCallback onReply,
+                                   ChunkCallback onChunk,
+                                   const std::map<std::string, std::string>& metadata,
+                                   int timeoutMs)
+{
+    auto fail = [&onReply](const QString& error) {
+        if (onReply) {
+            onReply(Reply{std::nullopt, error});
+        }
+    };
+
+    const uint64_t id = m_nextCorrelationId.fetch_add(1);
+    std::map<std::string, std::string> requestMetadata = metadata;
+    requestMetadata[kCorrelationIdKey] = std::to_string(id);
+    if (onChunk) {
+        requestMetadata[kAcceptChunkedKey] = "1";
+        requestMetadata.emplace(kMaxChunkBytesKey, std::to_string(DEFAULT_MAX_CHUNK_BYTES));  // Unless the caller chose
+    }
+
+    // Encoded on the calling thread; the I/O thread only writes bytes
+    Submission submission;
+    submission.id = id;
+    QString envelopeError;
+    if (!encodeFrame(type, request, requestMetadata, submission.frame, &envelopeError)) {
+        fail(QString("Failed to create envelope: %1").arg(envelopeError));
+        return 0;
+    }
+    const size_t envelopeSize = submission.frame.size() - FRAME_HEADER_SIZE;
+    if (envelopeSize > MAX_MESSAGE_SIZE) {
+        fail(QString("Message too large: envelope size %1 exceeds limit %2 MB")
+             .arg(envelopeSize)
+             .arg(MAX_MESSAGE_SIZE / (1024 * 1024)));
+        return 0;
+    }
+    submission.call.onReply = std::move(onReply);
+    submission.call.onChunk = std::move(onChunk);
+    submission.call.timeout = std::chrono::milliseconds(timeoutMs);
+    submission.call.deadline = std::chrono::steady_clock::now() + submission.call.timeout;
+
+    // Announce the push before checking the connection so a closing loop
+    // waits for it (and fails it) instead of leaving it in the queue
+    m_submitters.fetch_add(1);
+    if (!m_connected.load()) {
+        m_submitters.fetch_sub(1);
+        if (submission.call.onReply) {
+            submission.call.onReply(Reply{std::nullopt, QStringLiteral("Not connected to Bedrock server")});
+        }
+        return 0;
+    }
+    m_submissions.push(std::move(submission));
+    // Wake the loop while still counted: the eventfd stays open until it has seen us
+    const uint64_t wake = 1;
+    [[maybe_unused]] const ssize_t written = ::write(m_wakeFd, &wake, sizeof(wake));
+    m_submitters.fetch_sub(1);
+    return id;
+}
+
+std::optional<palantir::MessageEnvelope> EpollChannel::roundTrip(palantir::MessageType type,
+                                                                 const google::protobuf::Message& request,
+                                                                 palantir::MessageType expectedType,
+                                                                 QString* outError,
+                                                                 ChunkCallback onChunk)
+{
+    if (std::this_thread::get_id() == m_ioThread.get_id()) {
+        if (outError) {
+            *outError = QString("Synchronous RPC called from the transport I/O thread");
+        }
+        return std::nullopt;
+    }
+    if (!isConnected() && !connect()) {
+        if (outError) {
+            *outError = QString("Failed to connect to Bedrock server");
+        }
+        return std::nullopt;
+    }
+
+    // The I/O thread always completes the call (reply, timeout or shutdown)
+    auto waiter = std::make_shared<Waiter>();
+    sendRequest(type, request, [waiter](Reply reply) {
+        waiter->reply = std::move(reply);
+        waiter->done.store(1, std::memory_order_release);
+        futexWakeAll(waiter->done);
+    }, std::move(onChunk));
+    while (waiter->done.load(std::memory_order_acquire) == 0) {
+        futexWait(waiter->done, 0);
+    }
+
+    Reply& reply = waiter->reply;
+    if (!reply.envelope.has_value()) {
+        if (outError) {
+            *outError = reply.error;
+        }
+        return std::nullopt;
+    }
+    if (reply.envelope->type() == palantir::MessageType::ERROR_RESPONSE) {
+        palantir::ErrorResponse errorResponse;
+        const std::string& payload = reply.envelope->payload();
+        if (outError) {
+            *outError = errorResponse.ParseFromArray(payload.data(), static_cast<int>(payload.size()))
+                ? LocalSocketChannel::mapErrorResponse(errorResponse)
+                : QString("Received ERROR_RESPONSE but failed to parse ErrorResponse");
+        }
+        return std::nullopt;
+    }
+    if (reply.envelope->type() != expectedType) {
+        if (outError) {
+            *outError = QString("Unexpected message type: %1 (expected %2)")
+                       .arg(static_cast<int>(reply.envelope->type()))
+                       .arg(static_cast<int>(expectedType));
+        }
+        return std::nullopt;
+    }
+    return std::move(reply.envelope);
+}
+
+std::optional<palantir::CapabilitiesResponse> EpollChannel::getCapabilities(QString* outError)
+{
+    palantir::CapabilitiesRequest request;
+    auto envelope = roundTrip(palantir::MessageType::CAPABILITIES_REQUEST, request,
+                              palantir::MessageType::CAPABILITIES_RESPONSE, outError);
+    if (!envelope.has_value()) {
+        return std::nullopt;
+    }
+    palantir::CapabilitiesResponse response;
+    if (!response.ParseFromString(envelope->payload())) {
+        if (outError) {
+            *outError = QString("Failed to parse CapabilitiesResponse from envelope payload");
+        }
+        return std::nullopt;
+    }
+    return response;
+}
+
+std::optional<palantir::XYSineResponse> EpollChannel::sendXYSineRequest(const palantir::XYSineRequest& request,
+                                                                        QString* outError)
+{
+    // Chunks are appended in order; the final envelope carries the last slice
+    palantir::XYSineResponse response;
+    bool parsed = true;
+    auto append = [&response, &parsed](const palantir::MessageEnvelope& chunk) {
+        palantir::XYSineResponse slice;
+        if (!slice.ParseFromString(chunk.payload())) {
+            parsed = false;
+            return;
+        }
+        response.mutable_x()->Add(slice.x().begin(), slice.x().end());
+        response.mutable_y()->Add(slice.y().begin(), slice.y().end());
+        response.set_status(slice.status());
+    };
+
+    auto envelope = roundTrip(palantir::MessageType::XY_SINE_REQUEST, request,
+                              palantir::MessageType::XY_SINE_RESPONSE, outError, append);
+    if (!envelope.has_value()) {
+        return std::nullopt;
+    }
+    append(*envelope);
+    if (!parsed) {
+        if (outError) {
+            *outError = QString("Failed to parse XYSineResponse from envelope payload");
+        }
+        return std::nullopt;
+    }
+    return response;
+}
+
+void EpollChannel::ioLoop()
+{
+    epoll_event events[8];
+    QString closeReason;
+    while (!m_stopping.load()) {
+        const int count = ::epoll_wait(m_epollFd, events, 8, m_calls.empty() ? -1 : TIMEOUT_SWEEP_MS);
+        if (count < 0 && errno != EINTR) {
+            closeReason = QString("epoll_wait failed: %1").arg(std::strerror(errno));
+            break;
+        }
+
+        bool readable = false;
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == m_wakeFd) {
+                uint64_t wakeups = 0;
+                [[maybe_unused]] const ssize_t drained = ::read(m_wakeFd, &wakeups, sizeof(wakeups));
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                readable = true;
+            }
+            if (events[i].events & EPOLLOUT) {
+                m_writable = true;
+            }
+        }
+
+        // Everything submitted since the last round goes out in one batch
+        takeSubmissions();
+        if (!flushWrites() || (readable && !readFrames())) {
+            closeReason = QStringLiteral("Connection closed");
+            break;
+        }
+        expireTimedOutCalls();
+    }
+    shutdownIo(closeReason.isEmpty() ? QStringLiteral("Disconnected") : closeReason);
+}
+
+void EpollChannel::takeSubmissions()
+{
+    while (auto submission = m_submissions.pop()) {
+        m_outbox.push_back(std::move(submission->frame));
+        m_calls.emplace(submission->id, std::move(submission->call));
+    }
+}
+
+bool EpollChannel::flushWrites()
+{
+    while (m_writable && !m_outbox.empty()) {
+        iovec iov[WRITE_BATCH];
+        int count = 0;
+        for (auto it = m_outbox.begin(); it != m_outbox.end() && count < WRITE_BATCH; ++it, ++count) {
+            const size_t skip = count == 0 ? m_outboxOffset : 0;
+            iov[count].iov_base = const_cast<char*>(it->data()) + skip;
+            iov[count].iov_len = it->size() - skip;
+        }
+
+        // sendmsg() is writev() with MSG_NOSIGNAL (no SIGPIPE if Bedrock went away)
+        msghdr message{};
+        message.msg_iov = iov;
+        message.msg_iovlen = static_cast<size_t>(count);
+        const ssize_t written = ::sendmsg(m_socketFd, &message, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                m_writable = false;  // Resumed by the next EPOLLOUT edge
+                break;
+            }
+            qWarning() << "EpollChannel: Write failed:" << std::strerror(errno);
+            return false;
+        }
+        m_writeCalls.fetch_add(1, std::memory_order_relaxed);
+
+        size_t remaining = static_cast<size_t>(written);
+        while (remaining > 0) {
+            const size_t left = m_outbox.front().size() - m_outboxOffset;
+            if (remaining < left) {
+                m_outboxOffset += remaining;
+                break;
+            }
+            remaining -= left;
+            m_outbox.pop_front();
+            m_outboxOffset = 0;
+            m_framesWritten.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+bool EpollChannel::readFrames()
+{
+    // Edge-triggered: read until the socket is drained or no event follows
+    RingBuffer& buffer = m_frameDecoder.buffer();
+    for (;;) {
+        char* target = buffer.prepareWrite(READ_SIZE);
+        const ssize_t received = ::read(m_socketFd, target, READ_SIZE);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        m_readCalls.fetch_add(1, std::memory_order_relaxed);
+        if (received == 0) {
+            return false;
+        }
+        buffer.commitWrite(static_cast<size_t>(received));
+
+        for (;;) {
+            const char* body = nullptr;
+            uint32_t length = 0;
+            const auto status = m_frameDecoder.nextFrame(&body, &length);
+            if (status == FrameDecoder::Status::NeedMoreData) {
+                break;
+            }
+            if (status == FrameDecoder::Status::FrameTooLarge) {
+                qWarning() << "EpollChannel: Frame length" << length << "exceeds limit, closing connection";
+                return false;
+            }
+            m_framesRead.fetch_add(1, std::memory_order_relaxed);
+            handleFrame(body, length);
+            m_frameDecoder.consumeFrame(length);
+        }
+    }
+}
+
+void EpollChannel::handleFrame(const char* data, size_t size)
+{
+    palantir::MessageEnvelope envelope;
+    QString parseError;
+    if (!parseEnvelope(data, size, envelope, &parseError)) {
+        qWarning() << "EpollChannel: Dropping malformed frame:" << parseError;
+        return;
+    }
+    const auto id = correlationId(envelope);
+    auto it = id ? m_calls.find(*id) : m_calls.end();
+    if (it == m_calls.end()) {
+        return;  // Late reply of a request that already timed out
+    }
+
+    if (envelope.type() == PROGRESS_UPDATE) {
+        it->second.deadline = std::chrono::steady_clock::now() + it->second.timeout;
+        return;
+    }
+    auto chunk = chunkInfo(envelope);
+    if (chunk && !chunk->isLast() && it->second.onChunk
+        && envelope.type() != palantir::MessageType::ERROR_RESPONSE) {
+        it->second.deadline = std::chrono::steady_clock::now() + it->second.timeout;
+        it->second.onChunk(envelope);
+        return;
+    }
+
+    ReplyCallback onReply = std::move(it->second.onReply);
+    m_calls.erase(it);
+    if (onReply) {
+        onReply(Reply{std::move(envelope), QString()});
+    }
+}
+
+void EpollChannel::expireTimedOutCalls()
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<ReplyCallback> expired;
+    for (auto it = m_calls.begin(); it != m_calls.end();) {
+        if (it->second.deadline <= now) {
+            expired.push_back(std::move(it->second.onReply));
+            it = m_calls.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto& callback : expired) {
+        if (callback) {
+            callback(Reply{std::nullopt, QStringLiteral("Timeout waiting for response")});
+        }
+    }
+}
+
+void EpollChannel::shutdownIo(const QString& error)
+{
+    m_connected.store(false);
+    // Submitters that saw the channel connected are about to push; fail
+    // their requests too
+    while (m_submitters.load() > 0) {
+        std::this_thread::yield();
+    }
+    takeSubmissions();
+    m_outbox.clear();
+    m_outboxOffset = 0;
+
+    std::unordered_map<uint64_t, Call> calls;
+    calls.swap(m_calls);
+    for (auto& entry : calls) {
+        if (entry.second.onReply) {
+            entry.second.onReply(Reply{std::nullopt, error});
+        }
+    }
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS && __linux__
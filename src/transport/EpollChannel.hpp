@@ -0,0 +1,181 @@
+#pragma once
+
+#if defined(PHX_WITH_TRANSPORT_DEPS) && defined(__linux__)
+#include "TransportClient.hpp"
+#include "FrameCodec.hpp"
+#include "MpscQueue.hpp"
+#include "palantir/capabilities.pb.h"
+#include "palantir/envelope.pb.h"
+#include "palantir/xysine.pb.h"
+#include <google/protobuf/message.h>
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace phoenix::transport {
+
+/**
+ * Palantir channel on a raw Unix-domain socket driven by its own epoll loop
+ * (Linux only).
+ *
+ * Same framing and correlation IDs as LocalSocketChannel, without Qt in the
+ * I/O path: a dedicated thread owns the socket, reads edge-triggered until
+ * EAGAIN and flushes queued frames with one sendmsg(), so requests
+ * submitted close together leave in one system call. Callers hand requests to the
+ * loop through a lock-free queue plus an eventfd wakeup; blocking callers
+ * then sleep on a futex of their own until the loop completes their
+ * request, so no lock is shared between callers and the I/O thread.
+ *
+ * Supports the request/response RPCs and chunked responses. Shared memory,
+ * packed columns and compression are not negotiated on this channel.
+ *
+ * Benchmark backend only: nothing under src/ runs analyses over it.
+ * RemoteExecutor goes through ConnectionManager and PooledTransport, and
+ * both need what only LocalSocketChannel offers (sessions, cancellation,
+ * progress, batches, bulk columns, deltas). Reach it through
+ * TransportFactory (TransportBackend::Epoll) or transport_bench --backend
+ * epoll.
+ *
+ * Thread-safe; the I/O thread lives from connect() to disconnect() (or
+ * until Bedrock closes the connection).
+ */
+class EpollChannel : public TransportClient {
+public:
+    // Outcome of a request: envelope on success (ERROR_RESPONSE included), error otherwise
+    struct Reply {
+        std::optional<palantir::MessageEnvelope> envelope;
+        QString error;
+    };
+    // Called once on the I/O thread; must not block
+    using ReplyCallback = std::function<void(Reply reply)>;
+    // Non-final chunks of a chunked response, in order, on the I/O thread
+    using ChunkCallback = std::function<void(const palantir::MessageEnvelope& chunk)>;
+
+    // Counters of the I/O loop (frames per write shows the batching)
+    struct IoStats {
+        uint64_t writeCalls = 0;
+        uint64_t framesWritten = 0;
+        uint64_t readCalls = 0;
+        uint64_t framesRead = 0;
+    };
+
+    // socketPath as for LocalSocketChannel: a name (resolved in the temp
+    // directory, like QLocalSocket does) or an absolute path
+    explicit EpollChannel(const QString& socketPath = QString());
+    ~EpollChannel() override;
+
+    EpollChannel(const EpollChannel&) = delete;
+    EpollChannel& operator=(const EpollChannel&) = delete;
+
+    // TransportClient interface
+    bool connect() override;
+    void disconnect() override;
+    bool isConnected() const override;
+    std::optional<palantir::CapabilitiesResponse> getCapabilities(QString* outError = nullptr) override;
+
+    // XY Sine RPC (inline x/y arrays; chunked when the result is large)
+    std::optional<palantir::XYSineResponse> sendXYSineRequest(const palantir::XYSineRequest& request,
+                                                              QString* outError = nullptr);
+
+    /**
+     * Send a request without blocking (any thread).
+     *
+     * A non-null onChunk adds accept_chunked/max_chunk_bytes; every chunk
+     * but the last goes to onChunk and extends the deadline by timeoutMs.
+     *
+     * @return Correlation ID (0 if not connected; onReply has then already
+     *         been called with the error)
+     */
+    uint64_t sendRequest(palantir::MessageType type,
+                         const google::protobuf::Message& request,
+                         ReplyCallback onReply,
+                         ChunkCallback onChunk = nullptr,
+                         const std::map<std::string, std::string>& metadata = {},
+                         int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    QString socketPath() const { return m_socketPath; }
+    IoStats ioStats() const;
+
+    static constexpr int DEFAULT_TIMEOUT_MS = 5000;
+
+private:
+    struct Call {
+        ReplyCallback onReply;
+        ChunkCallback onChunk;
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::milliseconds timeout;
+    };
+
+    // A request on its way to the I/O thread
+    struct Submission {
+        uint64_t id = 0;
+        std::string frame;
+        Call call;
+    };
+
+    // Blocking round trip; maps ERROR_RESPONSE and unexpected types to outError
+    std::optional<palantir::MessageEnvelope> roundTrip(palantir::MessageType type,
+                                                       const google::protobuf::Message& request,
+                                                       palantir::MessageType expectedType,
+                                                       QString* outError,
+                                                       ChunkCallback onChunk = nullptr);
+
+    // I/O thread
+    void ioLoop();
+    void takeSubmissions();
+    bool readFrames();    // false once the connection is gone
+    bool flushWrites();   // false on a write error
+    void handleFrame(const char* data, size_t size);
+    void expireTimedOutCalls();
+    void shutdownIo(const QString& error);
+
+    // Stop and join the I/O thread, then close the descriptors (m_lifecycleMutex held)
+    void stopIoThread();
+    void closeFds();
+
+    QString m_socketPath;
+    std::mutex m_lifecycleMutex;  // Serializes connect() / disconnect()
+    int m_socketFd = -1;
+    int m_epollFd = -1;
+    int m_wakeFd = -1;  // eventfd: submissions and stop requests
+    std::thread m_ioThread;
+    std::atomic<bool> m_connected{false};
+    std::atomic<bool> m_stopping{false};
+    // Submitters between their connected check and their push; the I/O
+    // thread waits for them before failing what is left in the queue
+    std::atomic<int> m_submitters{0};
+    std::atomic<uint64_t> m_nextCorrelationId{1};
+
+    MpscQueue<Submission> m_submissions;
+
+    // I/O thread only
+    FrameDecoder m_frameDecoder;
+    std::unordered_map<uint64_t, Call> m_calls;
+    std::deque<std::string> m_outbox;
+    size_t m_outboxOffset = 0;  // Bytes of m_outbox.front() already written
+    bool m_writable = true;
+
+    std::atomic<uint64_t> m_writeCalls{0};
+    std::atomic<uint64_t> m_framesWritten{0};
+    std::atomic<uint64_t> m_readCalls{0};
+    std::atomic<uint64_t> m_framesRead{0};
+
+    static constexpr uint32_t MAX_MESSAGE_SIZE = 10 * 1024 * 1024;  // Matches LocalSocketChannel
+    static constexpr int WRITE_BATCH = 64;         // iovecs per sendmsg()
+    static constexpr size_t READ_SIZE = 64 * 1024;  // Bytes per read()
+    static constexpr int TIMEOUT_SWEEP_MS = 50;
+};
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS && __linux__
@@ -0,0 +1,255 @@
+#include "FrameCodec.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include "EnvelopeHelpers.hpp"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <climits>
+#include <cstring>
+
+namespace phoenix::transport {
+
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::internal::WireFormatLite;
+
+// MessageEnvelope field tags (field_number << 3 | wire_type), see envelope.proto
+static constexpr uint32_t kVersionTag = (1 << 3) | WireFormatLite::WIRETYPE_VARINT;
+static constexpr uint32_t kTypeTag = (2 << 3) | WireFormatLite::WIRETYPE_VARINT;
+static constexpr uint32_t kPayloadTag = (3 << 3) | WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+static constexpr uint32_t kMetadataTag = (4 << 3) | WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+// map<string, string> entry fields
+static constexpr uint32_t kEntryKeyTag = (1 << 3) | WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+static constexpr uint32_t kEntryValueTag = (2 << 3) | WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+
+std::optional<std::string_view> EnvelopeView::metadataValue(std::string_view key) const
+{
+    for (auto it = metadata.rbegin(); it != metadata.rend(); ++it) {
+        if (it->first == key) {
+            return it->second;
+        }
+    }
+    return std::nullopt;
+}
+
+// Read a length-delimited field as a view into the source bytes
+static bool readBytesView(CodedInputStream& input, const char* data, size_t size, std::string_view& out)
+{
+    uint32_t length = 0;
+    if (!input.ReadVarint32(&length)) {
+        return false;
+    }
+    const size_t position = static_cast<size_t>(input.CurrentPosition());
+    if (length > size - position) {
+        return false;
+    }
+    out = std::string_view(data + position, length);
+    return input.Skip(static_cast<int>(length));
+}
+
+bool decodeEnvelopeView(const char* data, size_t size, EnvelopeView& view, QString* outError)
+{
+    auto fail = [outError](const char* message) {
+        if (outError) {
+            *outError = message;
+        }
+        return false;
+    };
+
+    if (size == 0) {
+        return fail("Empty buffer");
+    }
+    if (size > static_cast<size_t>(INT_MAX)) {
+        return fail("Failed to parse MessageEnvelope");
+    }
+
+    view.version = 0;
+    view.type = palantir::MessageType::MESSAGE_TYPE_UNSPECIFIED;
+    view.payload = std::string_view();
+    view.metadata.clear();
+
+    CodedInputStream input(reinterpret_cast<const uint8_t*>(data), static_cast<int>(size));
+    uint32_t typeValue = 0;
+    while (uint32_t tag = input.ReadTag()) {
+        switch (tag) {
+            case kVersionTag:
+                if (!input.ReadVarint32(&view.version)) {
+                    return fail("Failed to parse MessageEnvelope");
+                }
+                break;
+            case kTypeTag:
+                if (!input.ReadVarint32(&typeValue)) {
+                    return fail("Failed to parse MessageEnvelope");
+                }
+                break;
+            case kPayloadTag:
+                if (!readBytesView(input, data, size, view.payload)) {
+                    return fail("Failed to parse MessageEnvelope");
+                }
+                break;
+            case kMetadataTag: {
+                uint32_t length = 0;
+                if (!input.ReadVarint32(&length)) {
+                    return fail("Failed to parse MessageEnvelope");
+                }
+                const auto limit = input.PushLimit(static_cast<int>(length));
+                std::string_view key;
+                std::string_view value;
+                while (uint32_t entryTag = input.ReadTag()) {
+                    if (entryTag == kEntryKeyTag) {
+                        if (!readBytesView(input, data, size, key)) {
+                            return fail("Failed to parse MessageEnvelope");
+                        }
+                    } else if (entryTag == kEntryValueTag) {
+                        if (!readBytesView(input, data, size, value)) {
+                            return fail("Failed to parse MessageEnvelope");
+                        }
+                    } else if (!WireFormatLite::SkipField(&input, entryTag)) {
+                        return fail("Failed to parse MessageEnvelope");
+                    }
+                }
+                if (!input.ConsumedEntireMessage()) {
+                    return fail("Failed to parse MessageEnvelope");
+                }
+                input.PopLimit(limit);
+                view.metadata.emplace_back(key, value);
+                break;
+            }
+            default:
+                // Unknown fields are skipped, as protobuf would
+                if (!WireFormatLite::SkipField(&input, tag)) {
+                    return fail("Failed to parse MessageEnvelope");
+                }
+                break;
+        }
+    }
+    if (!input.ConsumedEntireMessage()) {
+        return fail("Failed to parse MessageEnvelope");
+    }
+
+    view.type = static_cast<palantir::MessageType>(typeValue);
+    return validateEnvelopeHeader(view.version, static_cast<int>(typeValue), outError);
+}
+
+std::optional<std::string_view> viewPayload(const EnvelopeView& view, std::string& scratch, QString* outError)
+{
+    const auto encodingValue = view.metadataValue(kPayloadEncodingKey);
+    if (!encodingValue.has_value()) {
+        return view.payload;
+    }
+    const auto encoding = parseEncoding(*encodingValue);
+    if (!encoding.has_value()) {
+        if (outError) {
+            *outError = QString("Unsupported payload encoding: %1")
+                        .arg(QString::fromUtf8(encodingValue->data(), static_cast<qsizetype>(encodingValue->size())));
+        }
+        return std::nullopt;
+    }
+    if (!decompressBytes(*encoding, view.payload.data(), view.payload.size(), scratch, outError)) {
+        return std::nullopt;
+    }
+    return std::string_view(scratch);
+}
+
+// Encoded size of a length-delimited field (tag + length + bytes)
+static size_t delimitedSize(size_t length)
+{
+    return 1 + CodedOutputStream::VarintSize32(static_cast<uint32_t>(length)) + length;
+}
+
+bool encodeFrame(palantir::MessageType type,
+                 const google::protobuf::Message& innerMessage,
+                 const std::map<std::string, std::string>& metadata,
+                 std::string& out,
+                 QString* outError,
+                 uint32_t version)
+{
+    // Sizes first (ByteSizeLong also caches nested sizes for serialization)
+    const size_t payloadSize = innerMessage.ByteSizeLong();
+    size_t bodySize = 1 + CodedOutputStream::VarintSize32(version)
+                    + 1 + CodedOutputStream::VarintSize32(static_cast<uint32_t>(type));
+    if (payloadSize > 0) {
+        bodySize += delimitedSize(payloadSize);
+    }
+    for (const auto& [key, value] : metadata) {
+        bodySize += delimitedSize(delimitedSize(key.size()) + delimitedSize(value.size()));
+    }
+
+    if (bodySize > static_cast<size_t>(INT_MAX) || bodySize > UINT32_MAX) {
+        if (outError) {
+            *outError = "Failed to serialize inner message";
+        }
+        return false;
+    }
+
+    out.resize(FRAME_HEADER_SIZE + bodySize);
+    uint8_t* target = reinterpret_cast<uint8_t*>(out.data());
+
+    // Length prefix (little-endian, matching the reader)
+    const uint32_t length = static_cast<uint32_t>(bodySize);
+    std::memcpy(target, &length, FRAME_HEADER_SIZE);
+    target += FRAME_HEADER_SIZE;
+
+    target = CodedOutputStream::WriteVarint32ToArray(kVersionTag, target);
+    target = CodedOutputStream::WriteVarint32ToArray(version, target);
+    target = CodedOutputStream::WriteVarint32ToArray(kTypeTag, target);
+    target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32_t>(type), target);
+
+    if (payloadSize > 0) {
+        target = CodedOutputStream::WriteVarint32ToArray(kPayloadTag, target);
+        target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32_t>(payloadSize), target);
+        uint8_t* payloadEnd = innerMessage.SerializeWithCachedSizesToArray(target);
+        if (static_cast<size_t>(payloadEnd - target) != payloadSize) {
+            if (outError) {
+                *outError = "Failed to serialize inner message";
+            }
+            out.clear();
+            return false;
+        }
+        target = payloadEnd;
+    }
+
+    for (const auto& [key, value] : metadata) {
+        const size_t entrySize = delimitedSize(key.size()) + delimitedSize(value.size());
+        target = CodedOutputStream::WriteVarint32ToArray(kMetadataTag, target);
+        target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32_t>(entrySize), target);
+        target = CodedOutputStream::WriteVarint32ToArray(kEntryKeyTag, target);
+        target = CodedOutputStream::WriteStringWithSizeToArray(key, target);
+        target = CodedOutputStream::WriteVarint32ToArray(kEntryValueTag, target);
+        target = CodedOutputStream::WriteStringWithSizeToArray(value, target);
+    }
+
+    return true;
+}
+
+FrameDecoder::FrameDecoder(uint32_t maxFrameSize, size_t initialCapacity)
+    : m_buffer(initialCapacity)
+    , m_maxFrameSize(maxFrameSize)
+{
+}
+
+FrameDecoder::Status FrameDecoder::nextFrame(const char** body, uint32_t* bodySize) const
+{
+    if (m_buffer.size() < FRAME_HEADER_SIZE) {
+        return Status::NeedMoreData;
+    }
+
+    uint32_t length;
+    std::memcpy(&length, m_buffer.data(), FRAME_HEADER_SIZE);
+    *bodySize = length;
+
+    if (length > m_maxFrameSize) {
+        return Status::FrameTooLarge;
+    }
+    if (m_buffer.size() < FRAME_HEADER_SIZE + length) {
+        return Status::NeedMoreData;
+    }
+
+    *body = m_buffer.data() + FRAME_HEADER_SIZE;
+    return Status::FrameReady;
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,132 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "palantir/envelope.pb.h"
+#include "EnvelopeHelpers.hpp"
+#include "RingBuffer.hpp"
+#include <google/protobuf/arena.h>
+#include <google/protobuf/message.h>
+#include <QString>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace phoenix::transport {
+
+// Wire framing: [4-byte little-endian length][serialized MessageEnvelope]
+static constexpr size_t FRAME_HEADER_SIZE = 4;
+
+/**
+ * Non-owning view of a MessageEnvelope decoded straight from frame bytes.
+ *
+ * Payload and metadata reference the frame; they stay valid only until the
+ * frame is consumed from its buffer.
+ */
+struct EnvelopeView {
+    uint32_t version = 0;
+    palantir::MessageType type = palantir::MessageType::MESSAGE_TYPE_UNSPECIFIED;
+    std::string_view payload;
+    std::vector<std::pair<std::string_view, std::string_view>> metadata;
+
+    // Value for key (last occurrence wins, as for a protobuf map)
+    std::optional<std::string_view> metadataValue(std::string_view key) const;
+};
+
+/**
+ * Decode an envelope without copying payload or metadata.
+ *
+ * Applies the same header validation as parseEnvelope(). The view's metadata
+ * vector is reused, so decoding into the same view does not allocate once it
+ * has grown to fit.
+ *
+ * @return true on success, false on malformed or invalid envelopes
+ */
+bool decodeEnvelopeView(const char* data, size_t size, EnvelopeView& view, QString* outError = nullptr);
+
+/**
+ * Plain payload bytes of the view.
+ *
+ * Uncompressed payloads are returned as-is (no copy); a payload carrying
+ * kPayloadEncodingKey is decompressed into scratch.
+ *
+ * @return Payload bytes, or empty optional on unknown codecs / corrupt data
+ */
+std::optional<std::string_view> viewPayload(const EnvelopeView& view, std::string& scratch,
+                                            QString* outError = nullptr);
+
+/**
+ * Parse the view's payload into a message allocated on arena.
+ *
+ * @return Arena-owned message, or nullptr if the payload does not parse
+ */
+template <typename T>
+T* parsePayload(const EnvelopeView& view, google::protobuf::Arena& arena)
+{
+    std::string scratch;  // Only filled for compressed payloads
+    const auto payload = viewPayload(view, scratch);
+    if (!payload.has_value()) {
+        return nullptr;
+    }
+    T* message = google::protobuf::Arena::Create<T>(&arena);
+    if (!message->ParseFromArray(payload->data(), static_cast<int>(payload->size()))) {
+        return nullptr;
+    }
+    return message;
+}
+
+/**
+ * Serialize a complete frame into out (cleared first, capacity reused).
+ *
+ * The length prefix is reserved up front and the inner message is serialized
+ * directly into its place inside the envelope, so the frame is built with a
+ * single buffer and no intermediate copies.
+ *
+ * @param version Envelope protocol version (PROTOCOL_VERSION unless the peer
+ *                negotiated v2)
+ * @return true on success, false if the inner message cannot be serialized
+ */
+bool encodeFrame(palantir::MessageType type,
+                 const google::protobuf::Message& innerMessage,
+                 const std::map<std::string, std::string>& metadata,
+                 std::string& out,
+                 QString* outError = nullptr,
+                 uint32_t version = PROTOCOL_VERSION);
+
+/**
+ * Incremental frame reader over a reusable RingBuffer.
+ *
+ * Usage: write socket bytes into buffer(), then call nextFrame() until it
+ * returns NeedMoreData, calling consumeFrame() after handling each frame.
+ */
+class FrameDecoder {
+public:
+    enum class Status {
+        NeedMoreData,   // No complete frame buffered yet
+        FrameReady,     // body/bodySize describe the frame at the head
+        FrameTooLarge   // Declared length exceeds maxFrameSize (bodySize holds it)
+    };
+
+    explicit FrameDecoder(uint32_t maxFrameSize, size_t initialCapacity = RingBuffer::DEFAULT_CAPACITY);
+
+    RingBuffer& buffer() { return m_buffer; }
+
+    // Locate the frame at the head of the buffer (does not consume it)
+    Status nextFrame(const char** body, uint32_t* bodySize) const;
+
+    // Drop the frame returned by nextFrame()
+    void consumeFrame(uint32_t bodySize) { m_buffer.consume(FRAME_HEADER_SIZE + bodySize); }
+
+    void reset() { m_buffer.clear(); }
+
+private:
+    RingBuffer m_buffer;
+    uint32_t m_maxFrameSize;
+};
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
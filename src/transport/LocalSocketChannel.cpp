@@ -8,15 +8,26 @@
 #include "palantir/xysine.pb.h"
 #include "palantir/error.pb.h"
 #include "EnvelopeHelpers.hpp"
+#include "FrameCodec.hpp"
+#include "BulkData.hpp"
+#include "BatchRpc.hpp"
+#include "DeltaResponse.hpp"
+#include "PackedColumns.hpp"
+#include "RangeQuery.hpp"
+#include "SessionAuth.hpp"
+#include "SharedMemoryRegion.hpp"
+#include <google/protobuf/empty.pb.h>
 #endif
 
 #include <QLocalSocket>
-#include <memory>
+#include <QThread>
+#include <QTimer>
+#include <QMetaObject>
 #include <QString>
 #include <QByteArray>
-#include <cstring>
+#include <QDebug>
+#include <vector>
 
-#ifdef PHX_WITH_TRANSPORT_DEPS
 // Helper function to get socket path from environment or use default
 static QString getSocketPath()
 {
@@ -26,38 +37,161 @@ static QString getSocketPath()
     }
     return QStringLiteral("palantir_bedrock");
 }
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+// Pinned Bedrock identity from PALANTIR_SERVER_KEY (hex Ed25519 public key)
+static std::optional<phoenix::transport::IdentityPublicKey> getServerIdentity(QString* outError)
+{
+    const QByteArray hex = qgetenv("PALANTIR_SERVER_KEY");
+    if (hex.isEmpty()) {
+        return std::nullopt;
+    }
+    phoenix::transport::IdentityPublicKey key;
+    if (!phoenix::transport::keyFromHex(hex.toStdString(), key.data(), key.size(), outError)) {
+        return std::nullopt;
+    }
+    return key;
+}
+#endif
+
+LocalSocketChannel::LocalSocketChannel(const QString& socketPath)
+    : m_socketPath(socketPath.isEmpty() ? getSocketPath() : socketPath)
+    , m_ioThread(new QThread())
+    , m_ioContext(new QObject())
+    , m_socket(nullptr)
+    , m_timeoutTimer(nullptr)
+    , m_connected(false)
+#ifdef PHX_WITH_TRANSPORT_DEPS
+    , m_frameDecoder(MAX_MESSAGE_SIZE + phoenix::transport::FRAME_MAC_BYTES)
+    , m_nextCorrelationId(1)
+    , m_bulkShmEnabled(false)
+    , m_bulkShmPrefix(phoenix::transport::makeBulkShmPrefix())
+    , m_compressionEnabled(false)
+    , m_cancelEnabled(false)
+    , m_protocolVersion(phoenix::transport::PROTOCOL_VERSION)
+    , m_authenticated(false)
+#endif
+{
+    // The socket and its timers live on a dedicated I/O thread so that no
+    // caller (GUI or worker) ever blocks on socket reads.
+    m_ioThread->setObjectName(QStringLiteral("PalantirIO"));
+    m_ioContext->moveToThread(m_ioThread);
+    m_ioThread->start();
+
+    runOnIoThread([this]() {
+        m_socket = new QLocalSocket(m_ioContext);
+        m_timeoutTimer = new QTimer(m_ioContext);
+        m_timeoutTimer->setInterval(100);
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+        QObject::connect(m_socket, &QLocalSocket::readyRead, m_ioContext, [this]() {
+            onReadyRead();
+        });
+        QObject::connect(m_socket, &QLocalSocket::disconnected, m_ioContext, [this]() {
+            m_connected.store(false);
+            m_authenticated.store(false);
+            m_session.reset();
+            m_frameDecoder.reset();
+            failAllPending(QStringLiteral("Connection closed"));
+        });
+        QObject::connect(m_timeoutTimer, &QTimer::timeout, m_ioContext, [this]() {
+            expireTimedOutRequests();
+        });
+        m_timeoutTimer->start();
+#endif
+    });
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+    m_serverIdentity = getServerIdentity(&m_identityError);
+
+    // Responses complete the pending request that carries the same correlation ID
+    auto complete = [this](const palantir::MessageEnvelope& envelope) {
+        completePending(envelope);
+    };
+    m_dispatcher.registerHandler(palantir::MessageType::CAPABILITIES_RESPONSE, complete);
+    m_dispatcher.registerHandler(palantir::MessageType::XY_SINE_RESPONSE, complete);
+    m_dispatcher.registerHandler(palantir::MessageType::ERROR_RESPONSE, complete);
+    m_dispatcher.registerHandler(phoenix::transport::XY_SINE_BATCH_RESPONSE, complete);
+    // Progress updates feed the request's progress callback without completing it
+    m_dispatcher.registerHandler(phoenix::transport::PROGRESS_UPDATE,
+                                 [this](const palantir::MessageEnvelope& envelope) {
+        reportProgress(envelope);
+    });
+#endif
+}
+
+LocalSocketChannel::~LocalSocketChannel()
+{
+    // The I/O thread cannot wait for itself to finish
+    Q_ASSERT_X(QThread::currentThread() != m_ioThread, "LocalSocketChannel",
+               "Destroyed on its own I/O thread (last reference released in a callback?)");
+
+    runOnIoThread([this]() {
+        m_timeoutTimer->stop();
+        QObject::disconnect(m_socket, nullptr, m_ioContext, nullptr);
+        m_socket->abort();
+        m_connected.store(false);
+#ifdef PHX_WITH_TRANSPORT_DEPS
+        // On the I/O thread, so no reply can race the failure
+        failAllPending(QStringLiteral("Transport channel destroyed"));
 #endif
+    });
+
+    m_ioThread->quit();
+    m_ioThread->wait();
+
+    // Thread has finished; safe to destroy its objects from here
+    delete m_ioContext;
+    delete m_ioThread;
+}
 
-LocalSocketChannel::LocalSocketChannel()
-    : m_socket(std::make_unique<QLocalSocket>())
+void LocalSocketChannel::runOnIoThread(const std::function<void()>& fn) const
 {
-    // Socket will be connected on demand
+    if (QThread::currentThread() == m_ioThread) {
+        fn();
+        return;
+    }
+    QMetaObject::invokeMethod(m_ioContext, fn, Qt::BlockingQueuedConnection);
 }
 
-LocalSocketChannel::~LocalSocketChannel() = default;
+void LocalSocketChannel::postToIoThread(std::function<void()> fn) const
+{
+    QMetaObject::invokeMethod(m_ioContext, std::move(fn), Qt::QueuedConnection);
+}
 
 bool LocalSocketChannel::connect()
 {
 #ifdef PHX_WITH_TRANSPORT_DEPS
-    if (!m_socket) {
-        m_socket = std::make_unique<QLocalSocket>();
-    }
-    
-    // If already connected, return true
-    if (m_socket->state() == QLocalSocket::ConnectedState) {
-        return true;
-    }
-    
-    // Connect to server
-    QString socketPath = getSocketPath();
-    m_socket->connectToServer(socketPath);
-    
-    // Wait for connection (5 second timeout)
-    if (!m_socket->waitForConnected(5000)) {
-        return false;
-    }
-    
-    return true;
+    bool ok = false;
+    runOnIoThread([this, &ok]() {
+        // If already connected, return true
+        if (m_socket->state() == QLocalSocket::ConnectedState) {
+            ok = true;
+            return;
+        }
+        if (m_socket->state() != QLocalSocket::UnconnectedState) {
+            m_socket->abort();
+        }
+        m_frameDecoder.reset();
+        m_session.reset();
+        m_authenticated.store(false);
+        if (!m_identityError.isEmpty()) {
+            qWarning() << "LocalSocketChannel: Not connecting, PALANTIR_SERVER_KEY is invalid:" << m_identityError;
+            return;
+        }
+
+        // Connect to server (5 second timeout); blocks only the I/O thread
+        m_socket->connectToServer(m_socketPath);
+        ok = m_socket->waitForConnected(5000);
+        if (ok && m_serverIdentity.has_value()) {
+            ok = authenticate();
+            if (!ok) {
+                m_socket->abort();
+            }
+        }
+        m_connected.store(ok);
+    });
+    return ok;
 #else
     // Transport deps not available
     return false;
@@ -67,152 +201,572 @@ bool LocalSocketChannel::connect()
 void LocalSocketChannel::disconnect()
 {
 #ifdef PHX_WITH_TRANSPORT_DEPS
-    if (m_socket) {
+    runOnIoThread([this]() {
         m_socket->disconnectFromServer();
         if (m_socket->state() != QLocalSocket::UnconnectedState) {
             m_socket->waitForDisconnected(1000);
         }
-    }
+        m_connected.store(false);
+        m_frameDecoder.reset();
+        failAllPending(QStringLiteral("Disconnected"));
+    });
 #endif
 }
 
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void LocalSocketChannel::setServerIdentity(const std::optional<phoenix::transport::IdentityPublicKey>& identity)
+{
+    runOnIoThread([this, identity]() {
+        m_serverIdentity = identity;
+        m_identityError.clear();
+    });
+}
+
+bool LocalSocketChannel::authenticate()
+{
+    using namespace phoenix::transport;
+
+    ClientHandshake handshake(*m_serverIdentity);
+    std::map<std::string, std::string> metadata;
+    std::string frame;
+    QString error;
+    if (!handshake.hello(metadata, &error) ||
+        !encodeFrame(AUTH_HELLO, google::protobuf::Empty(), metadata, frame, &error, m_protocolVersion.load())) {
+        qWarning() << "LocalSocketChannel: Cannot start authenticated session:" << error;
+        return false;
+    }
+
+    // Wait for the one reply frame here; onReadyRead() stays out of the way.
+    // Blocks only the I/O thread, like waiting for the connection does.
+    m_handshaking = true;
+    m_socket->write(frame.data(), static_cast<qint64>(frame.size()));
+    m_socket->flush();
+    std::optional<palantir::MessageEnvelope> reply;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DEFAULT_TIMEOUT_MS);
+    while (!reply.has_value()) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0 || !m_socket->waitForReadyRead(static_cast<int>(remaining.count()))) {
+            break;
+        }
+        readSocket();
+
+        const char* body = nullptr;
+        uint32_t length = 0;
+        const auto status = m_frameDecoder.nextFrame(&body, &length);
+        if (status == FrameDecoder::Status::FrameTooLarge) {
+            break;
+        }
+        if (status == FrameDecoder::Status::FrameReady) {
+            palantir::MessageEnvelope envelope;
+            if (parseEnvelope(body, length, envelope, &error)) {
+                reply = std::move(envelope);
+            }
+            m_frameDecoder.consumeFrame(length);
+            if (!reply.has_value()) {
+                break;
+            }
+        }
+    }
+    m_handshaking = false;
+
+    if (!reply.has_value()) {
+        qWarning() << "LocalSocketChannel: No valid handshake reply from Bedrock" << error;
+        return false;
+    }
+    if (reply->type() == palantir::MessageType::ERROR_RESPONSE) {
+        palantir::ErrorResponse errorResponse;
+        errorResponse.ParseFromString(reply->payload());
+        qWarning() << "LocalSocketChannel: Bedrock refused the authenticated session:"
+                   << mapErrorResponse(errorResponse);
+        return false;
+    }
+    if (reply->type() != AUTH_RESPONSE) {
+        qWarning() << "LocalSocketChannel: Unexpected handshake reply type" << static_cast<int>(reply->type());
+        return false;
+    }
+    m_session = handshake.finish(*reply, &error);
+    if (!m_session) {
+        qWarning() << "LocalSocketChannel: Authenticated session rejected:" << error;
+        return false;
+    }
+    m_authenticated.store(true);
+    return true;
+}
+
+bool LocalSocketChannel::writeFrame(std::string& frame)
+{
+    // Authenticated sessions: the frame is tagged in place and the tag follows it
+    unsigned char tag[phoenix::transport::FRAME_MAC_BYTES];
+    if (m_session) {
+        m_session->send.sign(frame.data(), frame.size(), tag);
+    }
+    const qint64 frameSize = static_cast<qint64>(frame.size());
+    if (m_socket->write(frame.data(), frameSize) != frameSize) {
+        return false;
+    }
+    if (m_session &&
+        m_socket->write(reinterpret_cast<const char*>(tag), sizeof(tag)) != static_cast<qint64>(sizeof(tag))) {
+        return false;
+    }
+    if (m_recorder) {
+        m_recorder->record(phoenix::transport::TraceDirection::Sent,
+                           frame.data() + phoenix::transport::FRAME_HEADER_SIZE,
+                           frame.size() - phoenix::transport::FRAME_HEADER_SIZE);
+    }
+    return true;
+}
+#endif
+
 bool LocalSocketChannel::isConnected() const
 {
 #ifdef PHX_WITH_TRANSPORT_DEPS
-    return m_socket && m_socket->state() == QLocalSocket::ConnectedState;
+    return m_connected.load();
 #else
     return false;
 #endif
 }
 
 #ifdef PHX_WITH_TRANSPORT_DEPS
-std::optional<palantir::CapabilitiesResponse> LocalSocketChannel::getCapabilities(QString* outError)
+uint64_t LocalSocketChannel::sendRequest(palantir::MessageType type,
+                                         const google::protobuf::Message& request,
+                                         ReplyCallback onReply,
+                                         const std::map<std::string, std::string>& metadata,
+                                         int timeoutMs)
 {
-    // Ensure connected
-    if (!isConnected() && !connect()) {
-        if (outError) {
-            *outError = QString("Failed to connect to Bedrock server");
+    return queueRequest(type, request, std::move(onReply), nullptr, nullptr, metadata, timeoutMs);
+}
+
+uint64_t LocalSocketChannel::sendStreamingRequest(palantir::MessageType type,
+                                                  const google::protobuf::Message& request,
+                                                  ChunkCallback onChunk,
+                                                  ReplyCallback onReply,
+                                                  const std::map<std::string, std::string>& metadata,
+                                                  int timeoutMs,
+                                                  ProgressCallback onProgress)
+{
+    std::map<std::string, std::string> streamingMetadata = metadata;
+    streamingMetadata[phoenix::transport::kAcceptChunkedKey] = "1";
+    streamingMetadata.emplace(phoenix::transport::kMaxChunkBytesKey,
+                              std::to_string(phoenix::transport::DEFAULT_MAX_CHUNK_BYTES));
+    return queueRequest(type, request, std::move(onReply), std::move(onChunk), std::move(onProgress),
+                        streamingMetadata, timeoutMs);
+}
+
+uint64_t LocalSocketChannel::queueRequest(palantir::MessageType type,
+                                          const google::protobuf::Message& request,
+                                          ReplyCallback onReply,
+                                          ChunkCallback onChunk,
+                                          ProgressCallback onProgress,
+                                          const std::map<std::string, std::string>& metadata,
+                                          int timeoutMs)
+{
+    // Failures are reported on the I/O thread too, never on the caller's
+    auto fail = [this, &onReply](const QString& error) {
+        if (onReply) {
+            postToIoThread([onReply = std::move(onReply), error]() {
+                onReply(Reply{std::nullopt, error});
+            });
         }
-        return std::nullopt;
+    };
+
+    if (!m_connected.load()) {
+        fail(QStringLiteral("Not connected to Bedrock server"));
+        return 0;
     }
-    
-    // Create CapabilitiesRequest and wrap in envelope
-    palantir::CapabilitiesRequest request;
+
+    // Tag the request so the response can be matched while others are in flight
+    const uint64_t id = m_nextCorrelationId.fetch_add(1);
+    std::map<std::string, std::string> requestMetadata = metadata;
+    requestMetadata[phoenix::transport::kCorrelationIdKey] = std::to_string(id);
+    if (m_compressionEnabled.load()) {
+        // parseEnvelope() inflates compressed responses before dispatch
+        requestMetadata.emplace(phoenix::transport::kAcceptEncodingKey,
+                                phoenix::transport::encodingName(phoenix::transport::PayloadEncoding::Zlib));
+    }
+    if (onProgress) {
+        requestMetadata[phoenix::transport::kAcceptProgressKey] = "1";
+    }
+
+    // Encode [4-byte little-endian length][envelope] in one buffer; the
+    // request is serialized in place, never through a temporary envelope
+    std::string frame;
     QString envelopeError;
-    auto envelope = phoenix::transport::makeEnvelope(
-        palantir::MessageType::CAPABILITIES_REQUEST,
-        request,
-        {},
-        &envelopeError
-    );
-    
-    if (!envelope.has_value()) {
-        if (outError) {
-            *outError = QString("Failed to create envelope: %1").arg(envelopeError);
+    if (!phoenix::transport::encodeFrame(type, request, requestMetadata, frame, &envelopeError,
+                                         m_protocolVersion.load())) {
+        fail(QString("Failed to create envelope: %1").arg(envelopeError));
+        return 0;
+    }
+
+    // Check size limit before sending (fail fast client-side)
+    // MAX_MESSAGE_SIZE = 10MB - matches Bedrock server limit
+    const size_t envelopeSize = frame.size() - phoenix::transport::FRAME_HEADER_SIZE;
+    if (envelopeSize > MAX_MESSAGE_SIZE) {
+        fail(QString("Message too large: envelope size %1 exceeds limit %2 MB")
+             .arg(envelopeSize)
+             .arg(MAX_MESSAGE_SIZE / (1024 * 1024)));
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending.emplace(id, PendingRequest{
+            std::move(onReply),
+            std::move(onChunk),
+            std::move(onProgress),
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs),
+            std::chrono::milliseconds(timeoutMs)});
+    }
+
+    // Writes happen on the I/O thread; the caller returns immediately
+    postToIoThread([this, id, frame = std::move(frame)]() mutable {
+        if (m_socket->state() != QLocalSocket::ConnectedState) {
+            failPending(id, QStringLiteral("Not connected to Bedrock server"));
+            return;
+        }
+        if (!writeFrame(frame)) {
+            failPending(id, QStringLiteral("Failed to send request"));
+        }
+    });
+
+    return id;
+}
+
+std::future<LocalSocketChannel::Reply> LocalSocketChannel::sendRequestAsync(
+    palantir::MessageType type,
+    const google::protobuf::Message& request,
+    const std::map<std::string, std::string>& metadata,
+    int timeoutMs)
+{
+    auto promise = std::make_shared<std::promise<Reply>>();
+    std::future<Reply> future = promise->get_future();
+    sendRequest(type, request,
+                [promise](Reply reply) { promise->set_value(std::move(reply)); },
+                metadata, timeoutMs);
+    return future;
+}
+
+void LocalSocketChannel::setTrafficRecorder(std::shared_ptr<phoenix::transport::TrafficRecorder> recorder)
+{
+    runOnIoThread([this, recorder = std::move(recorder)]() mutable {
+        m_recorder = std::move(recorder);
+    });
+}
+
+int LocalSocketChannel::pendingRequestCount() const
+{
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    return static_cast<int>(m_pending.size());
+}
+
+bool LocalSocketChannel::cancelRequest(uint64_t correlationId)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        if (m_pending.find(correlationId) == m_pending.end()) {
+            return false;
         }
-        return std::nullopt;
     }
-    
-    // Serialize envelope
-    std::string serialized;
-    if (!envelope->SerializeToString(&serialized)) {
-        if (outError) {
-            *outError = QString("Failed to serialize MessageEnvelope");
+
+    std::string frame;
+    if (m_cancelEnabled.load()) {
+        const google::protobuf::Empty empty;
+        const std::map<std::string, std::string> metadata = {
+            {phoenix::transport::kCorrelationIdKey, std::to_string(correlationId)}};
+        QString envelopeError;
+        if (!phoenix::transport::encodeFrame(phoenix::transport::CANCEL_REQUEST, empty, metadata, frame,
+                                             &envelopeError, m_protocolVersion.load())) {
+            qWarning() << "LocalSocketChannel: Failed to create cancel envelope:" << envelopeError;
+            frame.clear();
         }
-        return std::nullopt;
     }
-    
-    // Check size limit before sending (fail fast client-side)
-    // MAX_MESSAGE_SIZE = 10MB - matches Bedrock server limit
-    if (serialized.size() > MAX_MESSAGE_SIZE) {
-        if (outError) {
-            *outError = QString("Message too large: envelope size %1 exceeds limit %2 MB")
-                       .arg(serialized.size())
-                       .arg(MAX_MESSAGE_SIZE / (1024 * 1024));
+
+    // Completes on the I/O thread, so no chunk or progress callback of the
+    // request can overlap or follow the cancellation
+    postToIoThread([this, correlationId, frame = std::move(frame)]() mutable {
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            if (m_pending.find(correlationId) == m_pending.end()) {
+                return;  // Answered in the meantime
+            }
+            // Whatever Bedrock still sends for it is expected, not stray
+            m_cancelled.insert(correlationId);
         }
-        return std::nullopt;
+        failPending(correlationId, QStringLiteral("Request cancelled"));
+
+        if (!frame.empty() && m_socket->state() == QLocalSocket::ConnectedState) {
+            writeFrame(frame);
+        }
+    });
+    return true;
+}
+
+void LocalSocketChannel::readSocket()
+{
+    // Read straight into the reusable frame buffer (no per-read QByteArray)
+    phoenix::transport::RingBuffer& buffer = m_frameDecoder.buffer();
+    qint64 available = 0;
+    while ((available = m_socket->bytesAvailable()) > 0) {
+        char* target = buffer.prepareWrite(static_cast<size_t>(available));
+        const qint64 bytesRead = m_socket->read(target, available);
+        if (bytesRead <= 0) {
+            break;
+        }
+        buffer.commitWrite(static_cast<size_t>(bytesRead));
     }
-    
-    // Create length-prefixed frame (4-byte little-endian length + serialized envelope)
-    uint32_t length = static_cast<uint32_t>(serialized.size());
-    QByteArray data;
-    data.append(reinterpret_cast<const char*>(&length), 4);
-    data.append(serialized.data(), static_cast<int>(serialized.size()));
-    
-    // Send request
-    qint64 written = m_socket->write(data);
-    if (written != data.size()) {
-        if (outError) {
-            *outError = QString("Failed to send CapabilitiesRequest");
+}
+
+void LocalSocketChannel::onReadyRead()
+{
+    if (m_handshaking) {
+        return;  // authenticate() reads the handshake reply itself
+    }
+    readSocket();
+
+    // Handle every complete [4-byte length][envelope] frame in place
+    for (;;) {
+        const char* body = nullptr;
+        uint32_t length = 0;
+        const auto status = m_frameDecoder.nextFrame(&body, &length);
+        if (status == phoenix::transport::FrameDecoder::Status::NeedMoreData) {
+            break;  // Wait for the rest of the frame
         }
-        return std::nullopt;
+
+        if (status == phoenix::transport::FrameDecoder::Status::FrameTooLarge) {
+            qWarning() << "LocalSocketChannel: Frame length" << length << "exceeds limit, closing connection";
+            m_frameDecoder.reset();
+            failAllPending(QString("Message too large: envelope size %1 exceeds limit %2 MB")
+                           .arg(length)
+                           .arg(MAX_MESSAGE_SIZE / (1024 * 1024)));
+            m_socket->abort();
+            return;
+        }
+
+        // Authenticated sessions: check the tag in place, then drop it
+        uint32_t envelopeSize = length;
+        if (m_session) {
+            if (!m_session->receive.verify(body, length)) {
+                qWarning() << "LocalSocketChannel: Frame failed authentication, closing connection";
+                m_frameDecoder.reset();
+                failAllPending(QStringLiteral("Frame failed authentication"));
+                m_socket->abort();
+                return;
+            }
+            envelopeSize = length - static_cast<uint32_t>(phoenix::transport::FRAME_MAC_BYTES);
+        }
+
+        if (m_recorder) {
+            m_recorder->record(phoenix::transport::TraceDirection::Received, body, envelopeSize);
+        }
+        if (!handleFrame(body, envelopeSize)) {
+            return;  // Connection torn down
+        }
+        m_frameDecoder.consumeFrame(length);
     }
-    
-    // Wait for data to be written
-    if (!m_socket->waitForBytesWritten(5000)) {
-        if (outError) {
-            *outError = QString("Timeout writing CapabilitiesRequest");
+}
+
+bool LocalSocketChannel::handleFrame(const char* data, size_t size)
+{
+    palantir::MessageEnvelope envelope;
+    QString parseError;
+    if (!phoenix::transport::parseEnvelope(data, size, envelope, &parseError)) {
+        // An unparseable frame cannot be correlated, and its owner cannot be
+        // guessed: the stream is no longer trustworthy, so close it
+        qWarning() << "LocalSocketChannel: Malformed frame, closing connection:" << parseError;
+        m_frameDecoder.reset();
+        failAllPending(QString("Failed to parse MessageEnvelope: %1").arg(parseError));
+        m_socket->abort();
+        return false;
+    }
+
+    if (!m_dispatcher.dispatch(envelope)) {
+        qWarning() << "LocalSocketChannel: No handler for message type" << static_cast<int>(envelope.type());
+    }
+    return true;
+}
+
+void LocalSocketChannel::completePending(const palantir::MessageEnvelope& envelope)
+{
+    ReplyCallback callback;
+    ChunkCallback chunkCallback;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto it = m_pending.end();
+        const auto id = phoenix::transport::correlationId(envelope);
+        if (id) {
+            it = m_pending.find(*id);
+        } else if (!m_pending.empty()) {
+            // Servers that predate correlation IDs answer strictly in order
+            it = m_pending.begin();
+        }
+        if (it == m_pending.end() && id && m_cancelled.count(*id)) {
+            // Late output of a cancelled request; its final envelope retires the ID
+            auto chunk = phoenix::transport::chunkInfo(envelope);
+            const bool batchItem = phoenix::transport::batchIndex(envelope).has_value();
+            if (!batchItem
+                && (!chunk || chunk->isLast() || envelope.type() == palantir::MessageType::ERROR_RESPONSE)) {
+                m_cancelled.erase(*id);
+            }
+            return;
+        }
+        if (it == m_pending.end()) {
+            qWarning() << "LocalSocketChannel: Response does not match any pending request (type"
+                       << static_cast<int>(envelope.type()) << ")";
+            return;
+        }
+
+        // Intermediate chunks of a streaming response, and the items of a
+        // batch, keep the request alive
+        auto chunk = phoenix::transport::chunkInfo(envelope);
+        const bool partial = (chunk && !chunk->isLast()) || phoenix::transport::batchIndex(envelope).has_value();
+        if (partial && it->second.onChunk) {
+            it->second.deadline = std::chrono::steady_clock::now() + it->second.timeout;
+            chunkCallback = it->second.onChunk;
+        } else {
+            callback = std::move(it->second.onReply);
+            m_pending.erase(it);
         }
-        return std::nullopt;
     }
-    
-    // Wait for response
-    if (!m_socket->waitForReadyRead(5000)) {
-        if (outError) {
-            *outError = QString("Timeout waiting for CapabilitiesResponse");
+
+    if (chunkCallback) {
+        chunkCallback(envelope);
+        return;
+    }
+    if (callback) {
+        callback(Reply{envelope, QString()});
+    }
+}
+
+void LocalSocketChannel::reportProgress(const palantir::MessageEnvelope& envelope)
+{
+    const auto id = phoenix::transport::correlationId(envelope);
+    const auto fraction = phoenix::transport::progressFraction(envelope);
+    if (!id || !fraction) {
+        qWarning() << "LocalSocketChannel: Dropping malformed progress update";
+        return;
+    }
+
+    ProgressCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto it = m_pending.find(*id);
+        if (it == m_pending.end()) {
+            return;  // Already completed, timed out or cancelled
         }
-        return std::nullopt;
+        // Bedrock is still working on it: progress keeps the request alive
+        it->second.deadline = std::chrono::steady_clock::now() + it->second.timeout;
+        callback = it->second.onProgress;
     }
-    
-    // Read length prefix (4 bytes)
-    QByteArray lengthBytes = m_socket->read(4);
-    if (lengthBytes.size() != 4) {
-        if (outError) {
-            *outError = QString("Failed to read length prefix");
+
+    if (callback) {
+        callback(*fraction);
+    }
+}
+
+void LocalSocketChannel::failPending(uint64_t id, const QString& error)
+{
+    ReplyCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto it = m_pending.find(id);
+        if (it == m_pending.end()) {
+            return;
         }
-        return std::nullopt;
+        callback = std::move(it->second.onReply);
+        m_pending.erase(it);
     }
-    
-    uint32_t responseLength;
-    std::memcpy(&responseLength, lengthBytes.data(), 4);
-    
-    // Read envelope bytes (may need multiple reads)
-    QByteArray envelopeBytes;
-    while (envelopeBytes.size() < static_cast<int>(responseLength)) {
-        if (!m_socket->waitForReadyRead(5000)) {
-            if (outError) {
-                *outError = QString("Timeout reading MessageEnvelope");
+
+    if (callback) {
+        callback(Reply{std::nullopt, error});
+    }
+}
+
+void LocalSocketChannel::failAllPending(const QString& error)
+{
+    std::map<uint64_t, PendingRequest> failed;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        failed.swap(m_pending);
+        m_cancelled.clear();
+    }
+
+    for (auto& [id, pending] : failed) {
+        if (pending.onReply) {
+            pending.onReply(Reply{std::nullopt, error});
+        }
+    }
+}
+
+void LocalSocketChannel::expireTimedOutRequests()
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<ReplyCallback> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        for (auto it = m_pending.begin(); it != m_pending.end();) {
+            if (it->second.deadline <= now) {
+                expired.push_back(std::move(it->second.onReply));
+                it = m_pending.erase(it);
+            } else {
+                ++it;
             }
-            return std::nullopt;
         }
-        envelopeBytes += m_socket->read(responseLength - envelopeBytes.size());
     }
-    
-    if (envelopeBytes.size() != static_cast<int>(responseLength)) {
+
+    for (auto& callback : expired) {
+        if (callback) {
+            callback(Reply{std::nullopt, QStringLiteral("Timeout waiting for response")});
+        }
+    }
+}
+
+std::optional<palantir::MessageEnvelope> LocalSocketChannel::roundTrip(
+    palantir::MessageType type,
+    const google::protobuf::Message& request,
+    palantir::MessageType expectedType,
+    QString* outError,
+    ChunkCallback onChunk,
+    const std::map<std::string, std::string>& metadata,
+    const RequestControl& control)
+{
+    // Blocking on the I/O thread would starve the very loop that delivers the reply
+    if (QThread::currentThread() == m_ioThread) {
         if (outError) {
-            *outError = QString("Failed to read complete MessageEnvelope");
+            *outError = QString("Synchronous RPC called from the transport I/O thread");
         }
         return std::nullopt;
     }
-    
-    // Parse envelope
-    palantir::MessageEnvelope responseEnvelope;
-    QString parseError;
-    if (!phoenix::transport::parseEnvelope(envelopeBytes, responseEnvelope, &parseError)) {
+
+    // Ensure connected
+    if (!isConnected() && !connect()) {
         if (outError) {
-            *outError = QString("Failed to parse MessageEnvelope: %1").arg(parseError);
+            *outError = QString("Failed to connect to Bedrock server");
         }
         return std::nullopt;
     }
-    
-    // Validate envelope
-    if (responseEnvelope.version() != 1) {
+
+    // Only this caller waits; other requests on the channel keep flowing
+    auto promise = std::make_shared<std::promise<Reply>>();
+    std::future<Reply> future = promise->get_future();
+    auto onReply = [promise](Reply r) { promise->set_value(std::move(r)); };
+    const uint64_t id = onChunk
+        ? sendStreamingRequest(type, request, std::move(onChunk), std::move(onReply), metadata,
+                               DEFAULT_TIMEOUT_MS, control.onProgress)
+        : queueRequest(type, request, std::move(onReply), nullptr, control.onProgress, metadata,
+                       DEFAULT_TIMEOUT_MS);
+    if (id != 0 && control.onSent) {
+        control.onSent(id);
+    }
+    Reply reply = future.get();
+    if (!reply.envelope.has_value()) {
         if (outError) {
-            *outError = QString("Invalid envelope version: %1").arg(responseEnvelope.version());
+            *outError = reply.error;
         }
         return std::nullopt;
     }
-    
+
+    const palantir::MessageEnvelope& responseEnvelope = *reply.envelope;
+
     // Check for error response
     if (responseEnvelope.type() == palantir::MessageType::ERROR_RESPONSE) {
         palantir::ErrorResponse errorResponse;
@@ -228,190 +782,412 @@ std::optional<palantir::CapabilitiesResponse> LocalSocketChannel::getCapabilitie
         }
         return std::nullopt;
     }
-    
-    if (responseEnvelope.type() != palantir::MessageType::CAPABILITIES_RESPONSE) {
+
+    // Validate response type
+    if (responseEnvelope.type() != expectedType) {
         if (outError) {
-            *outError = QString("Unexpected message type: %1").arg(static_cast<int>(responseEnvelope.type()));
+            *outError = QString("Unexpected message type: %1 (expected %2)")
+                       .arg(static_cast<int>(responseEnvelope.type()))
+                       .arg(static_cast<int>(expectedType));
         }
         return std::nullopt;
     }
-    
+
+    return std::move(reply.envelope);
+}
+
+std::optional<palantir::CapabilitiesResponse> LocalSocketChannel::getCapabilities(QString* outError)
+{
+    palantir::CapabilitiesRequest request;
+    auto envelope = roundTrip(palantir::MessageType::CAPABILITIES_REQUEST,
+                              request,
+                              palantir::MessageType::CAPABILITIES_RESPONSE,
+                              outError);
+    if (!envelope.has_value()) {
+        return std::nullopt;
+    }
+
     // Parse inner CapabilitiesResponse from payload
     palantir::CapabilitiesResponse response;
-    const std::string& payload = responseEnvelope.payload();
+    const std::string& payload = envelope->payload();
     if (!response.ParseFromArray(payload.data(), static_cast<int>(payload.size()))) {
         if (outError) {
             *outError = QString("Failed to parse CapabilitiesResponse from envelope payload");
         }
         return std::nullopt;
     }
-    
+
     return response;
 }
 
-std::optional<palantir::XYSineResponse> LocalSocketChannel::sendXYSineRequest(
-    const palantir::XYSineRequest& request, QString* outError)
+// Pick the x/y columns of a bulk or packed response (same length)
+static bool selectXYColumns(const std::vector<phoenix::transport::BulkColumn>& columns,
+                            const phoenix::transport::BulkColumn*& outX,
+                            const phoenix::transport::BulkColumn*& outY,
+                            QString* outError)
 {
-    // Ensure connected
-    if (!isConnected() && !connect()) {
+    using namespace phoenix::transport;
+
+    outX = findBulkColumn(columns, "x");
+    outY = findBulkColumn(columns, "y");
+    if (!outX || !outY) {
         if (outError) {
-            *outError = QString("Failed to connect to Bedrock server");
+            *outError = QString("Bulk response is missing x/y columns");
         }
-        return std::nullopt;
+        return false;
     }
-    
-    // Create envelope from XYSineRequest
-    QString envelopeError;
-    auto envelope = phoenix::transport::makeEnvelope(
-        palantir::MessageType::XY_SINE_REQUEST,
-        request,
-        {},
-        &envelopeError
-    );
-    
-    if (!envelope.has_value()) {
+    if (outX->elementCount() != outY->elementCount()) {
         if (outError) {
-            *outError = QString("Failed to create envelope: %1").arg(envelopeError);
+            *outError = QString("Bulk response has mismatched x/y sizes");
         }
+        return false;
+    }
+    return true;
+}
+
+// Parse the XYSineResponse of an envelope (v2: message followed by packed
+// columns, decoded into the repeated fields)
+static std::optional<palantir::XYSineResponse> parseXYSineResponse(const palantir::MessageEnvelope& envelope,
+                                                                   QString* outError)
+{
+    std::string_view message;
+    std::vector<phoenix::transport::BulkColumn> packed;
+    if (!phoenix::transport::unpackPayload(envelope, message, packed, outError)) {
         return std::nullopt;
     }
-    
-    // Serialize envelope
-    std::string serialized;
-    if (!envelope->SerializeToString(&serialized)) {
+    palantir::XYSineResponse response;
+    if (!response.ParseFromArray(message.data(), static_cast<int>(message.size()))) {
         if (outError) {
-            *outError = QString("Failed to serialize MessageEnvelope");
+            *outError = QString("Failed to parse XYSineResponse from envelope payload");
         }
         return std::nullopt;
     }
-    
-    // Check size limit before sending (fail fast client-side)
-    // MAX_MESSAGE_SIZE = 10MB - matches Bedrock server limit
-    if (serialized.size() > MAX_MESSAGE_SIZE) {
-        if (outError) {
-            *outError = QString("Message too large: envelope size %1 exceeds limit %2 MB")
-                       .arg(serialized.size())
-                       .arg(MAX_MESSAGE_SIZE / (1024 * 1024));
+
+    if (!packed.empty()) {
+        const phoenix::transport::BulkColumn* x = nullptr;
+        const phoenix::transport::BulkColumn* y = nullptr;
+        phoenix::transport::QuantizationMap quantization;
+        if (!selectXYColumns(packed, x, y, outError) ||
+            !phoenix::transport::readQuantization(envelope, quantization, outError)) {
+            return std::nullopt;
         }
+        // One bulk decode per column straight into the repeated fields
+        const int count = static_cast<int>(x->elementCount());
+        const char* base = envelope.payload().data();
+        response.mutable_x()->Resize(count, 0.0);
+        response.mutable_y()->Resize(count, 0.0);
+        if (!phoenix::transport::decodeColumn(base + x->offset, *x, quantization,
+                                              response.mutable_x()->mutable_data(), outError) ||
+            !phoenix::transport::decodeColumn(base + y->offset, *y, quantization,
+                                              response.mutable_y()->mutable_data(), outError)) {
+            return std::nullopt;
+        }
+    }
+
+    return response;
+}
+
+std::optional<palantir::XYSineResponse> LocalSocketChannel::sendXYSineRequest(
+    const palantir::XYSineRequest& request, QString* outError)
+{
+    auto envelope = roundTrip(palantir::MessageType::XY_SINE_REQUEST,
+                              request,
+                              palantir::MessageType::XY_SINE_RESPONSE,
+                              outError);
+    if (!envelope.has_value()) {
         return std::nullopt;
     }
-    
-    // Create length-prefixed frame (4-byte little-endian length + serialized envelope)
-    uint32_t length = static_cast<uint32_t>(serialized.size());
-    QByteArray data;
-    data.append(reinterpret_cast<const char*>(&length), 4);
-    data.append(serialized.data(), static_cast<int>(serialized.size()));
-    
-    // Send request
-    qint64 written = m_socket->write(data);
-    if (written != data.size()) {
+    return parseXYSineResponse(*envelope, outError);
+}
+
+bool LocalSocketChannel::sendXYSineBatch(const std::vector<palantir::XYSineRequest>& requests,
+                                         const XYSineBatchItemCallback& onItem,
+                                         QString* outError,
+                                         const RequestControl& control)
+{
+    using namespace phoenix::transport;
+
+    if (requests.size() > MAX_BATCH_ITEMS) {
         if (outError) {
-            *outError = QString("Failed to send XYSineRequest");
+            *outError = QString("Batch of %1 items exceeds the limit of %2").arg(requests.size()).arg(MAX_BATCH_ITEMS);
         }
-        return std::nullopt;
+        return false;
     }
-    
-    // Wait for data to be written
-    if (!m_socket->waitForBytesWritten(5000)) {
-        if (outError) {
-            *outError = QString("Timeout writing XYSineRequest");
+
+    // Items arrive on the I/O thread in the order Bedrock finishes them
+    auto delivered = std::make_shared<std::vector<bool>>(requests.size(), false);
+    auto deliver = [onItem, delivered](const palantir::MessageEnvelope& envelope) {
+        const auto index = batchIndex(envelope);
+        if (!index || *index >= delivered->size() || (*delivered)[*index]) {
+            qWarning() << "LocalSocketChannel: Dropping batch item with bad or repeated index";
+            return;
         }
-        return std::nullopt;
+        (*delivered)[*index] = true;
+
+        QString itemError;
+        if (envelope.type() == palantir::MessageType::ERROR_RESPONSE) {
+            palantir::ErrorResponse errorResponse;
+            const std::string& payload = envelope.payload();
+            itemError = errorResponse.ParseFromArray(payload.data(), static_cast<int>(payload.size()))
+                ? mapErrorResponse(errorResponse)
+                : QString("Received ERROR_RESPONSE but failed to parse ErrorResponse");
+            onItem(*index, nullptr, itemError);
+            return;
+        }
+        auto response = parseXYSineResponse(envelope, &itemError);
+        onItem(*index, response ? &*response : nullptr, itemError);
+    };
+
+    auto envelope = roundTrip(XY_SINE_BATCH_REQUEST,
+                              makeXYSineBatch(requests),
+                              XY_SINE_BATCH_RESPONSE,
+                              outError,
+                              deliver,
+                              {},
+                              control);
+    if (!envelope.has_value()) {
+        return false;
     }
-    
-    // Wait for response
-    if (!m_socket->waitForReadyRead(5000)) {
-        if (outError) {
-            *outError = QString("Timeout waiting for XYSineResponse");
+
+    // Items Bedrock skipped still get an answer
+    for (size_t index = 0; index < delivered->size(); ++index) {
+        if (!(*delivered)[index]) {
+            onItem(index, nullptr, QString("Bedrock did not answer batch item %1").arg(index));
         }
-        return std::nullopt;
     }
-    
-    // Read length prefix (4 bytes)
-    QByteArray lengthBytes = m_socket->read(4);
-    if (lengthBytes.size() != 4) {
+    return true;
+}
+
+// Map the region of a shared-memory bulk response and read its column
+// layout. The region is unlinked as soon as it is mapped; the mapping lives
+// as long as outRegion. Names outside the connection's prefix are refused
+// before anything is opened or unlinked.
+static bool mapBulkColumns(const palantir::MessageEnvelope& envelope,
+                           const std::string& regionName,
+                           const std::string& prefix,
+                           std::unique_ptr<phoenix::transport::SharedMemoryRegion>& outRegion,
+                           std::vector<phoenix::transport::BulkColumn>& outColumns,
+                           QString* outError)
+{
+    using namespace phoenix::transport;
+
+    if (!isAcceptedBulkShmName(regionName, prefix)) {
         if (outError) {
-            *outError = QString("Failed to read length prefix");
+            *outError = QString("Bulk response names region '%1' outside this connection's prefix")
+                            .arg(QString::fromStdString(regionName));
         }
-        return std::nullopt;
+        return false;
     }
-    
-    uint32_t responseLength;
-    std::memcpy(&responseLength, lengthBytes.data(), 4);
-    
-    // Read envelope bytes (may need multiple reads)
-    QByteArray envelopeBytes;
-    while (envelopeBytes.size() < static_cast<int>(responseLength)) {
-        if (!m_socket->waitForReadyRead(5000)) {
-            if (outError) {
-                *outError = QString("Timeout reading MessageEnvelope");
-            }
-            return std::nullopt;
-        }
-        envelopeBytes += m_socket->read(responseLength - envelopeBytes.size());
+    outRegion = SharedMemoryRegion::open(regionName, outError);
+    if (!outRegion) {
+        return false;
     }
-    
-    if (envelopeBytes.size() != static_cast<int>(responseLength)) {
+    outRegion->unlink();
+
+    auto columnsIt = envelope.metadata().find(kBulkColumnsKey);
+    if (columnsIt == envelope.metadata().end()) {
         if (outError) {
-            *outError = QString("Failed to read complete MessageEnvelope");
+            *outError = QString("Bulk response is missing %1 metadata").arg(kBulkColumnsKey);
         }
-        return std::nullopt;
+        return false;
     }
-    
-    // Parse envelope
-    palantir::MessageEnvelope responseEnvelope;
-    QString parseError;
-    if (!phoenix::transport::parseEnvelope(envelopeBytes, responseEnvelope, &parseError)) {
-        if (outError) {
-            *outError = QString("Failed to parse MessageEnvelope: %1").arg(parseError);
+    if (!parseBulkColumns(columnsIt->second, outColumns, outError)) {
+        return false;
+    }
+    for (const BulkColumn& column : outColumns) {
+        if (!validateBulkColumn(column, outRegion->size(), outError)) {
+            return false;
         }
-        return std::nullopt;
     }
-    
-    // Validate envelope
-    if (responseEnvelope.version() != 1) {
+    return true;
+}
+
+// Point slice at the x/y columns stored at base (mapped region or packed
+// payload). Aligned f64 columns are used in place; reduced-precision or
+// unaligned columns are upcast into the scratch buffers. Reused columns
+// (delta responses) are absent and left null.
+static bool sliceXYColumns(const char* base,
+                           const std::vector<phoenix::transport::BulkColumn>& columns,
+                           const phoenix::transport::QuantizationMap& quantization,
+                           bool reusedX,
+                           bool reusedY,
+                           std::vector<double>& scratchX,
+                           std::vector<double>& scratchY,
+                           LocalSocketChannel::XYSineSlice& slice,
+                           QString* outError)
+{
+    using namespace phoenix::transport;
+
+    if (!reusedX && !reusedY) {
+        const BulkColumn* x = nullptr;
+        const BulkColumn* y = nullptr;
+        if (!selectXYColumns(columns, x, y, outError)) {
+            return false;
+        }
+        slice.x = columnDoubles(base + x->offset, *x, quantization, scratchX, outError);
+        slice.y = columnDoubles(base + y->offset, *y, quantization, scratchY, outError);
+        slice.count = x->elementCount();
+        return slice.x != nullptr && slice.y != nullptr;
+    }
+    if (reusedX && reusedY) {
+        return true;
+    }
+
+    const BulkColumn* sent = findBulkColumn(columns, reusedX ? "y" : "x");
+    if (!sent) {
         if (outError) {
-            *outError = QString("Invalid envelope version: %1").arg(responseEnvelope.version());
+            *outError = QString("Bulk response is missing its %1 column").arg(reusedX ? "y" : "x");
         }
-        return std::nullopt;
+        return false;
     }
-    
-    // Check for error response
-    if (responseEnvelope.type() == palantir::MessageType::ERROR_RESPONSE) {
-        palantir::ErrorResponse errorResponse;
-        const std::string& payload = responseEnvelope.payload();
-        if (errorResponse.ParseFromArray(payload.data(), static_cast<int>(payload.size()))) {
-            if (outError) {
-                *outError = mapErrorResponse(errorResponse);
+    const double* data = columnDoubles(base + sent->offset, *sent, quantization,
+                                       reusedX ? scratchY : scratchX, outError);
+    (reusedX ? slice.y : slice.x) = data;
+    slice.count = sent->elementCount();
+    return data != nullptr;
+}
+
+std::optional<std::string> LocalSocketChannel::streamXYSineRequest(
+    const palantir::XYSineRequest& request,
+    const XYSineChunkCallback& onChunk,
+    QString* outError,
+    const phoenix::transport::ReducedPrecision& precision,
+    const std::optional<phoenix::transport::ViewportRange>& range,
+    const RequestControl& control,
+    const phoenix::transport::DeltaBase* base)
+{
+    // Intermediate chunks are decoded and handed over as they arrive; a chunk
+    // that fails to parse poisons the stream (reported once the request ends)
+    auto streamError = std::make_shared<QString>();
+    auto lastStatus = std::make_shared<std::string>();
+    auto deliver = [onChunk, streamError, lastStatus, base,
+                    prefix = m_bulkShmPrefix](const palantir::MessageEnvelope& envelope) {
+        if (!streamError->isEmpty()) {
+            return;
+        }
+        std::string_view message;
+        std::vector<phoenix::transport::BulkColumn> packed;
+        QString unpackError;
+        if (!phoenix::transport::unpackPayload(envelope, message, packed, &unpackError)) {
+            *streamError = unpackError;
+            return;
+        }
+        palantir::XYSineResponse chunk;
+        if (!chunk.ParseFromArray(message.data(), static_cast<int>(message.size()))) {
+            *streamError = QString("Failed to parse XYSineResponse from envelope payload");
+            return;
+        }
+
+        // Delta responses leave out the columns base already holds
+        const std::set<std::string> reused = phoenix::transport::reusedColumns(envelope);
+        const bool reusedX = reused.count("x") > 0;
+        const bool reusedY = reused.count("y") > 0;
+        if (!reused.empty() && (!base || reused.size() != size_t(reusedX) + size_t(reusedY))) {
+            *streamError = QString("XYSineResponse reuses columns the request did not offer");
+            return;
+        }
+
+        // Samples come inline in the payload (repeated fields, or packed
+        // columns under v2) or from a shared-memory region; packed and
+        // shared-memory columns may be reduced precision
+        XYSineSlice slice;
+        std::unique_ptr<phoenix::transport::SharedMemoryRegion> region;
+        std::vector<phoenix::transport::BulkColumn> columns;
+        phoenix::transport::QuantizationMap quantization;
+        std::vector<double> scratchX;
+        std::vector<double> scratchY;
+        QString columnError;
+        auto regionName = envelope.metadata().find(phoenix::transport::kBulkShmNameKey);
+        if (regionName != envelope.metadata().end()) {
+            if (!mapBulkColumns(envelope, regionName->second, prefix, region, columns, &columnError) ||
+                !phoenix::transport::readQuantization(envelope, quantization, &columnError) ||
+                !sliceXYColumns(region->data(), columns, quantization, reusedX, reusedY, scratchX, scratchY,
+                                slice, &columnError)) {
+                *streamError = columnError;
+                return;
+            }
+        } else if (!packed.empty()) {
+            // Aligned f64 is read in place: no per-element copy at all
+            if (!phoenix::transport::readQuantization(envelope, quantization, &columnError) ||
+                !sliceXYColumns(envelope.payload().data(), packed, quantization, reusedX, reusedY, scratchX,
+                                scratchY, slice, &columnError)) {
+                *streamError = columnError;
+                return;
             }
         } else {
-            if (outError) {
-                *outError = QString("Received ERROR_RESPONSE but failed to parse ErrorResponse");
+            if (!reusedX && !reusedY && chunk.x_size() != chunk.y_size()) {
+                *streamError = QString("XYSineResponse chunk has mismatched x/y sizes");
+                return;
             }
+            slice.x = reusedX ? nullptr : chunk.x().data();
+            slice.y = reusedY ? nullptr : chunk.y().data();
+            slice.count = static_cast<size_t>(reusedX ? chunk.y_size() : chunk.x_size());
         }
-        return std::nullopt;
-    }
-    
-    // Validate response type
-    if (responseEnvelope.type() != palantir::MessageType::XY_SINE_RESPONSE) {
-        if (outError) {
-            *outError = QString("Unexpected message type: %1 (expected XY_SINE_RESPONSE)")
-                       .arg(static_cast<int>(responseEnvelope.type()));
+        if (reusedX && reusedY) {
+            slice.count = base->count;
         }
+
+        // Unchunked responses are a single chunk covering the whole result
+        slice.info.totalSamples = slice.count;
+        if (auto chunked = phoenix::transport::chunkInfo(envelope)) {
+            slice.info = *chunked;
+        }
+        if (slice.info.offset + slice.count > slice.info.totalSamples) {
+            *streamError = QString("XYSineResponse chunk %1 exceeds total sample count").arg(slice.info.index);
+            return;
+        }
+        if (reusedX || reusedY) {
+            if (slice.info.totalSamples != base->count) {
+                *streamError = QString("XYSineResponse reuses columns of a base with %1 samples for %2 samples")
+                                   .arg(base->count)
+                                   .arg(slice.info.totalSamples);
+                return;
+            }
+            if (reusedX) {
+                slice.x = base->x + slice.info.offset;
+            }
+            if (reusedY) {
+                slice.y = base->y + slice.info.offset;
+            }
+        }
+        *lastStatus = chunk.status();
+        onChunk(slice);
+    };
+
+    std::map<std::string, std::string> metadata;
+    if (m_bulkShmEnabled.load()) {
+        metadata[phoenix::transport::kAcceptBulkShmKey] = m_bulkShmPrefix;
+    }
+    phoenix::transport::setPrecisionMetadata(metadata, precision);
+    if (range.has_value()) {
+        phoenix::transport::setRangeMetadata(metadata, *range);
+    }
+    if (base) {
+        phoenix::transport::setBaseColumnsMetadata(metadata, *base);
+    }
+
+    auto envelope = roundTrip(palantir::MessageType::XY_SINE_REQUEST,
+                              request,
+                              palantir::MessageType::XY_SINE_RESPONSE,
+                              outError,
+                              deliver,
+                              metadata,
+                              control);
+    if (!envelope.has_value()) {
         return std::nullopt;
     }
-    
-    // Parse inner XYSineResponse from payload
-    palantir::XYSineResponse response;
-    const std::string& payload = responseEnvelope.payload();
-    if (!response.ParseFromArray(payload.data(), static_cast<int>(payload.size()))) {
+
+    // Final chunk (or the whole response) completes on this thread; the
+    // I/O thread has finished with earlier chunks by the time the future is ready
+    deliver(*envelope);
+    if (!streamError->isEmpty()) {
         if (outError) {
-            *outError = QString("Failed to parse XYSineResponse from envelope payload");
+            *outError = *streamError;
         }
         return std::nullopt;
     }
-    
-    return response;
+
+    return *lastStatus;
 }
 
 QString LocalSocketChannel::mapErrorResponse(const palantir::ErrorResponse& errorResponse)
@@ -490,4 +1266,3 @@ std::optional<int> LocalSocketChannel::getCapabilities(QString* outError)
     return std::nullopt;
 }
 #endif
-
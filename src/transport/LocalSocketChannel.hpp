@@ -1,20 +1,50 @@
 #pragma once
 
 #include "TransportClient.hpp"
-#include <QLocalSocket>
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <functional>
 #include <memory>
 
 #ifdef PHX_WITH_TRANSPORT_DEPS
+#include "palantir/capabilities.pb.h"
+#include "palantir/envelope.pb.h"
 #include "palantir/xysine.pb.h"
 #include "palantir/error.pb.h"
+#include "MessageDispatcher.hpp"
+#include "EnvelopeHelpers.hpp"
+#include "FrameCodec.hpp"
+#include "BulkData.hpp"
+#include "DeltaResponse.hpp"
+#include "RangeQuery.hpp"
+#include "SessionAuth.hpp"
+#include "TrafficTrace.hpp"
+#include <google/protobuf/message.h>
+#include <chrono>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
 #endif
 
-// Local socket transport channel (skeleton for WP1)
-// WP1: Minimal implementation - no actual IPC yet
-// Future: Will implement Palantir IPC protocol over QLocalSocket
+class QLocalSocket;
+class QObject;
+class QThread;
+class QTimer;
+
+// Local socket transport channel (Palantir IPC over QLocalSocket)
+//
+// The QLocalSocket lives on a dedicated I/O thread owned by the channel.
+// Requests are tagged with a correlation ID (envelope metadata) so many
+// requests can be in flight at once; responses are routed through a
+// MessageType-indexed dispatcher and complete the matching pending request.
+// Callers never touch the socket directly and may send from any thread.
 class LocalSocketChannel : public TransportClient {
 public:
-    LocalSocketChannel();
+    explicit LocalSocketChannel(const QString& socketPath = QString());
     ~LocalSocketChannel() override;
 
     // TransportClient interface
@@ -24,26 +54,280 @@ public:
 #ifdef PHX_WITH_TRANSPORT_DEPS
     std::optional<palantir::CapabilitiesResponse>
         getCapabilities(QString* outError = nullptr) override;
-    
+
     // XY Sine RPC (Sprint 4.5)
     std::optional<palantir::XYSineResponse>
         sendXYSineRequest(const palantir::XYSineRequest& request, QString* outError = nullptr);
+
+    // One slice of an XY Sine result: count samples starting at info.offset
+    // of info.totalSamples. x/y point into the decoded payload or a mapped
+    // shared-memory region and are valid only during the callback.
+    struct XYSineSlice {
+        const double* x = nullptr;
+        const double* y = nullptr;
+        size_t count = 0;
+        phoenix::transport::ChunkInfo info;
+    };
+    using XYSineChunkCallback = std::function<void(const XYSineSlice& slice)>;
+
+    // Fraction done (0..1) reported by Bedrock while a request runs
+    using ProgressCallback = std::function<void(double fraction)>;
+
+    // Progress and cancellation hooks of one blocking RPC
+    struct RequestControl {
+        // PROGRESS_UPDATE fractions, on the I/O thread (advertises accept_progress)
+        ProgressCallback onProgress;
+        // Correlation ID once the request is queued, on the calling thread;
+        // hand it to cancelRequest() from any thread to abandon the RPC
+        std::function<void(uint64_t correlationId)> onSent;
+    };
+
+    /**
+     * XY Sine RPC with chunked streaming.
+     *
+     * Advertises accept_chunked so Bedrock may split results larger than
+     * MAX_MESSAGE_SIZE into sequenced envelopes, and accept_bulk_shm when the
+     * shared-memory side channel is enabled. Every slice is handed to onChunk
+     * as it arrives (intermediate chunks on the I/O thread, the final one on
+     * the calling thread); a non-chunked response is delivered as a single
+     * chunk. The full result is never held in serialized form.
+     *
+     * A reduced precision (plot-only results) asks Bedrock for f32 or
+     * delta-quantized int16 columns; slices are always upcast to double.
+     *
+     * A viewport range (Bedrock lists kRangeQueryFeature) asks for the
+     * samples of the visible x-range only, decimated to the plot width.
+     *
+     * control.onProgress receives Bedrock's progress updates; control.onSent
+     * exposes the request for cancelRequest().
+     *
+     * A base (Bedrock lists kDeltaFeature) names a result the caller already
+     * holds; columns Bedrock finds unchanged are not sent and the slices
+     * point into base instead.
+     *
+     * @return Status string of the final chunk, or empty optional on error
+     */
+    std::optional<std::string> streamXYSineRequest(
+        const palantir::XYSineRequest& request,
+        const XYSineChunkCallback& onChunk,
+        QString* outError = nullptr,
+        const phoenix::transport::ReducedPrecision& precision = {},
+        const std::optional<phoenix::transport::ViewportRange>& range = std::nullopt,
+        const RequestControl& control = {},
+        const phoenix::transport::DeltaBase* base = nullptr);
+
+    // One answered item of a batch: response on success, nullptr and the
+    // error otherwise. Runs on the I/O thread (items Bedrock left out: on the
+    // calling thread, once the batch has ended); must not block.
+    using XYSineBatchItemCallback = std::function<void(size_t index,
+                                                       const palantir::XYSineResponse* response,
+                                                       const QString& error)>;
+
+    /**
+     * XY Sine batch RPC (only when Bedrock's capabilities list kBatchFeature).
+     *
+     * Sends every request in one XY_SINE_BATCH_REQUEST envelope (see
+     * BatchRpc.hpp). onItem runs once per item, in the order Bedrock
+     * finishes them; each answered item extends the request deadline.
+     *
+     * @return true once the batch has ended (every item reported, possibly
+     *         with its own error); false if the batch as a whole failed, in
+     *         which case items not reported yet never will be
+     */
+    bool sendXYSineBatch(const std::vector<palantir::XYSineRequest>& requests,
+                         const XYSineBatchItemCallback& onItem,
+                         QString* outError = nullptr,
+                         const RequestControl& control = {});
+
+    // Outcome of an asynchronous request: envelope on success, error otherwise.
+    // ERROR_RESPONSE envelopes are delivered as-is; callers decide how to map them.
+    struct Reply {
+        std::optional<palantir::MessageEnvelope> envelope;
+        QString error;
+    };
+    using ReplyCallback = std::function<void(Reply reply)>;
+    // Receives non-final chunks of a chunked response, in order
+    using ChunkCallback = std::function<void(const palantir::MessageEnvelope& chunk)>;
+
+    /**
+     * Send a request without blocking.
+     *
+     * The callback runs exactly once, on the I/O thread, when the response
+     * arrives, the request times out, or the connection drops. It must not
+     * block, and must not release the last reference to the channel (the
+     * channel cannot be destroyed on its own I/O thread).
+     *
+     * @return Correlation ID of the request (0 if it could not be queued; the
+     *         callback then runs with the error, on the I/O thread as well)
+     */
+    uint64_t sendRequest(palantir::MessageType type,
+                         const google::protobuf::Message& request,
+                         ReplyCallback onReply,
+                         const std::map<std::string, std::string>& metadata = {},
+                         int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    /**
+     * Send a request that accepts a chunked response.
+     *
+     * Adds accept_chunked/max_chunk_bytes to the metadata. Every chunk but the
+     * last is passed to onChunk on the I/O thread and extends the request
+     * deadline by timeoutMs; the last chunk (or an unchunked/error response)
+     * completes the request through onReply.
+     *
+     * A non-null onProgress adds accept_progress; PROGRESS_UPDATE envelopes
+     * for the request are passed to it on the I/O thread and extend the
+     * deadline like chunks do.
+     */
+    uint64_t sendStreamingRequest(palantir::MessageType type,
+                                  const google::protobuf::Message& request,
+                                  ChunkCallback onChunk,
+                                  ReplyCallback onReply,
+                                  const std::map<std::string, std::string>& metadata = {},
+                                  int timeoutMs = DEFAULT_TIMEOUT_MS,
+                                  ProgressCallback onProgress = nullptr);
+
+    // Future-based variant of sendRequest()
+    std::future<Reply> sendRequestAsync(palantir::MessageType type,
+                                        const google::protobuf::Message& request,
+                                        const std::map<std::string, std::string>& metadata = {},
+                                        int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    // Number of requests awaiting a response
+    int pendingRequestCount() const;
+
+    /**
+     * Abandon an in-flight request (any thread).
+     *
+     * The request completes right away (on the I/O thread, after any chunk
+     * being delivered) with a "Request cancelled" error. When cancellation is
+     * enabled, CANCEL_REQUEST tells Bedrock to stop working on it; anything
+     * it still sends for the request is dropped.
+     *
+     * @return true if the request was still pending
+     */
+    bool cancelRequest(uint64_t correlationId);
+
+    // Send CANCEL_REQUEST on cancelRequest() (enable only when Bedrock's
+    // capabilities list kCancelFeature). Off by default: cancelling is then
+    // local and Bedrock finishes the computation.
+    void setCancelEnabled(bool enabled) { m_cancelEnabled.store(enabled); }
+    bool cancelEnabled() const { return m_cancelEnabled.load(); }
+
+    // Allow Bedrock to return bulk arrays through shared memory (enable only
+    // when its capabilities list kBulkSharedMemoryFeature). Off by default.
+    // Only regions named with bulkSharedMemoryPrefix() are mapped (and
+    // unlinked); responses naming any other region fail.
+    void setBulkSharedMemoryEnabled(bool enabled) { m_bulkShmEnabled.store(enabled); }
+    bool bulkSharedMemoryEnabled() const { return m_bulkShmEnabled.load(); }
+    const std::string& bulkSharedMemoryPrefix() const { return m_bulkShmPrefix; }
+
+    // Accept compressed response payloads (enable only when Bedrock's
+    // capabilities list kCompressionFeature). Off by default.
+    void setCompressionEnabled(bool enabled) { m_compressionEnabled.store(enabled); }
+    bool compressionEnabled() const { return m_compressionEnabled.load(); }
+
+    // Envelope version for outgoing requests. PROTOCOL_VERSION_V2 (only when
+    // Bedrock lists kProtocolV2Feature) lets responses carry packed numeric
+    // columns; the default v1 works with every Bedrock build.
+    void setProtocolVersion(uint32_t version) { m_protocolVersion.store(version); }
+    uint32_t protocolVersion() const { return m_protocolVersion.load(); }
+
+    // Pin Bedrock's Ed25519 identity (default: PALANTIR_SERVER_KEY, hex).
+    // connect() then runs the authenticated handshake, failing against any
+    // server that cannot prove the identity, and every frame carries a MAC
+    // (see SessionAuth.hpp). Takes effect on the next connect().
+    void setServerIdentity(const std::optional<phoenix::transport::IdentityPublicKey>& identity);
+    // True while connected through an authenticated session
+    bool isAuthenticated() const { return m_authenticated.load(); }
+
+    // Record every envelope sent and received, as it crosses the socket, to
+    // a trace for offline replay (see TrafficTrace.hpp); nullptr stops
+    // recording. A recorder may be shared by several channels.
+    void setTrafficRecorder(std::shared_ptr<phoenix::transport::TrafficRecorder> recorder);
+
+    // Inbound message routing (register handlers for server-initiated messages)
+    phoenix::transport::MessageDispatcher& dispatcher() { return m_dispatcher; }
+
+    static constexpr int DEFAULT_TIMEOUT_MS = 5000;
+
+    // Error mapping helper (normalized error semantics; shared with EpollChannel)
+    static QString mapErrorResponse(const palantir::ErrorResponse& errorResponse);
 #else
     std::optional<int> getCapabilities(QString* outError = nullptr) override;
 #endif
 
 private:
-    std::unique_ptr<QLocalSocket> m_socket;
-    // TODO(WP2+): Add protocol framing, message dispatch, state machine
-    
-    // Constants
+    // Run fn on the I/O thread and wait for it (direct call if already there)
+    void runOnIoThread(const std::function<void()>& fn) const;
+    // Queue fn on the I/O thread without waiting
+    void postToIoThread(std::function<void()> fn) const;
+
+    QString m_socketPath;
+    QThread* m_ioThread;
+    QObject* m_ioContext;     // Lives on m_ioThread; parent of socket and timer
+    QLocalSocket* m_socket;   // Owned by m_ioContext, only touched on m_ioThread
+    QTimer* m_timeoutTimer;   // Owned by m_ioContext
+    std::atomic<bool> m_connected;
+
 #ifdef PHX_WITH_TRANSPORT_DEPS
+    struct PendingRequest {
+        ReplyCallback onReply;
+        ChunkCallback onChunk;  // Set for streaming requests only
+        ProgressCallback onProgress;
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::milliseconds timeout;
+    };
+
+    uint64_t queueRequest(palantir::MessageType type,
+                          const google::protobuf::Message& request,
+                          ReplyCallback onReply,
+                          ChunkCallback onChunk,
+                          ProgressCallback onProgress,
+                          const std::map<std::string, std::string>& metadata,
+                          int timeoutMs);
+
+    void readSocket();
+    void onReadyRead();
+    // Handshake right after connecting (I/O thread); false if it failed
+    bool authenticate();
+    // Write an encoded frame, tagged when the session is authenticated (I/O thread)
+    bool writeFrame(std::string& frame);
+    // false if the frame was malformed and the connection was closed
+    bool handleFrame(const char* data, size_t size);
+    void completePending(const palantir::MessageEnvelope& envelope);
+    void reportProgress(const palantir::MessageEnvelope& envelope);
+    void failPending(uint64_t id, const QString& error);
+    void failAllPending(const QString& error);
+    void expireTimedOutRequests();
+
+    // Blocking round trip used by the synchronous RPC wrappers
+    std::optional<palantir::MessageEnvelope> roundTrip(palantir::MessageType type,
+                                                       const google::protobuf::Message& request,
+                                                       palantir::MessageType expectedType,
+                                                       QString* outError,
+                                                       ChunkCallback onChunk = nullptr,
+                                                       const std::map<std::string, std::string>& metadata = {},
+                                                       const RequestControl& control = {});
+
+    phoenix::transport::FrameDecoder m_frameDecoder;  // Reusable read buffer (I/O thread only)
+    phoenix::transport::MessageDispatcher m_dispatcher;
+    mutable std::mutex m_pendingMutex;
+    std::map<uint64_t, PendingRequest> m_pending;  // Ordered: begin() is the oldest
+    std::set<uint64_t> m_cancelled;  // Cancelled requests Bedrock may still answer (m_pendingMutex)
+    std::atomic<uint64_t> m_nextCorrelationId;
+    std::atomic<bool> m_bulkShmEnabled;
+    const std::string m_bulkShmPrefix;  // Region names Bedrock may use (sent with kAcceptBulkShmKey)
+    std::atomic<bool> m_compressionEnabled;
+    std::atomic<bool> m_cancelEnabled;
+    std::atomic<uint32_t> m_protocolVersion;
+    std::shared_ptr<phoenix::transport::TrafficRecorder> m_recorder;  // I/O thread only
+    std::optional<phoenix::transport::IdentityPublicKey> m_serverIdentity;  // I/O thread only
+    QString m_identityError;  // Malformed PALANTIR_SERVER_KEY: connect() refuses
+    std::unique_ptr<phoenix::transport::AuthSession> m_session;  // I/O thread only
+    bool m_handshaking = false;  // I/O thread only; authenticate() owns the socket
+    std::atomic<bool> m_authenticated;
+
+    // Constants
     static constexpr uint32_t MAX_MESSAGE_SIZE = 10 * 1024 * 1024; // 10MB - matches Bedrock limit
 #endif
-    
-    // Error mapping helper (normalized error semantics)
-#ifdef PHX_WITH_TRANSPORT_DEPS
-    static QString mapErrorResponse(const palantir::ErrorResponse& errorResponse);
-#endif
 };
-
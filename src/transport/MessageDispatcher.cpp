@@ -0,0 +1,56 @@
+#include "MessageDispatcher.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+namespace phoenix::transport {
+
+void MessageDispatcher::registerHandler(palantir::MessageType type, Handler handler)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_handlers[static_cast<int>(type)] = std::move(handler);
+}
+
+void MessageDispatcher::unregisterHandler(palantir::MessageType type)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_handlers.erase(static_cast<int>(type));
+}
+
+bool MessageDispatcher::hasHandler(palantir::MessageType type) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_handlers.find(static_cast<int>(type)) != m_handlers.end();
+}
+
+void MessageDispatcher::setFallbackHandler(Handler handler)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fallback = std::move(handler);
+}
+
+bool MessageDispatcher::dispatch(const palantir::MessageEnvelope& envelope) const
+{
+    // Copy the handler out so it runs without holding the lock
+    // (handlers may register/unregister other handlers)
+    Handler handler;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_handlers.find(static_cast<int>(envelope.type()));
+        if (it != m_handlers.end()) {
+            handler = it->second;
+        } else {
+            handler = m_fallback;
+        }
+    }
+
+    if (!handler) {
+        return false;
+    }
+
+    handler(envelope);
+    return true;
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,45 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "palantir/envelope.pb.h"
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace phoenix::transport {
+
+/**
+ * MessageType-indexed handler table for inbound envelopes.
+ *
+ * Handlers are registered per MessageType and invoked on the thread that
+ * calls dispatch() (the channel's I/O thread for LocalSocketChannel).
+ * Handlers must not block; hand long work off to another thread.
+ */
+class MessageDispatcher {
+public:
+    using Handler = std::function<void(const palantir::MessageEnvelope&)>;
+
+    // Register (or replace) the handler for a message type
+    void registerHandler(palantir::MessageType type, Handler handler);
+    void unregisterHandler(palantir::MessageType type);
+    bool hasHandler(palantir::MessageType type) const;
+
+    // Handler for types without a registered handler (optional)
+    void setFallbackHandler(Handler handler);
+
+    /**
+     * Route an envelope to its handler.
+     *
+     * @return true if a handler (or the fallback) consumed the envelope
+     */
+    bool dispatch(const palantir::MessageEnvelope& envelope) const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<int, Handler> m_handlers;  // MessageType -> handler
+    Handler m_fallback;
+};
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
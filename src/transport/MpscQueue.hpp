@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace phoenix::transport {
+
+/**
+ * Unbounded lock-free multi-producer / single-consumer queue.
+ *
+ * Intrusive linked list after Dmitry Vyukov: push() is a single atomic
+ * exchange (wait-free, any thread); pop() is called by one consumer only.
+ * A push that is halfway done may be invisible to pop() for a moment, so
+ * producers must wake the consumer after pushing (e.g. through an eventfd)
+ * rather than rely on a single pop() seeing the item.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue()
+        : m_head(new Node())
+        , m_tail(m_head.load(std::memory_order_relaxed))
+    {
+    }
+
+    ~MpscQueue()
+    {
+        while (pop()) {
+        }
+        delete m_tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value)
+    {
+        Node* node = new Node();
+        node->value.emplace(std::move(value));
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer only
+    std::optional<T> pop()
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return std::nullopt;
+        }
+        // next becomes the new (empty) sentinel
+        m_tail = next;
+        std::optional<T> value(std::move(next->value));
+        next->value.reset();
+        delete tail;
+        return value;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+    std::atomic<Node*> m_head;  // Last pushed node (producers)
+    Node* m_tail;               // Sentinel before the oldest item (consumer)
+};
+
+} // namespace phoenix::transport
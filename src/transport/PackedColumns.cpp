@@ -0,0 +1,137 @@
+#include "PackedColumns.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include "EnvelopeHelpers.hpp"
+#include <QByteArray>
+
+namespace phoenix::transport {
+
+bool packFloat64Columns(palantir::MessageEnvelope& envelope,
+                        const std::vector<PackedFloat64Column>& columns,
+                        QString* outError)
+{
+    return packColumns(envelope, columns, ReducedPrecision{}, outError);
+}
+
+bool packColumns(palantir::MessageEnvelope& envelope,
+                 const std::vector<PackedFloat64Column>& columns,
+                 const ReducedPrecision& precision,
+                 QString* outError)
+{
+    if (envelope.metadata().count(kPackedColumnsKey) > 0 ||
+        envelope.metadata().count(kPayloadEncodingKey) > 0) {
+        if (outError) {
+            *outError = "Envelope payload is already packed or encoded";
+        }
+        return false;
+    }
+
+    BulkDType reduced = BulkDType::Float64;
+    if (precision.mode == TransferPrecision::Float32) {
+        reduced = BulkDType::Float32;
+    } else if (precision.mode == TransferPrecision::DeltaInt16) {
+        reduced = BulkDType::DeltaInt16;
+    }
+
+    std::string& payload = *envelope.mutable_payload();
+    const size_t messageBytes = payload.size();
+
+    std::vector<BulkColumn> descriptors;
+    descriptors.reserve(columns.size());
+    QuantizationMap quantization;
+    std::string bytes;
+    for (const PackedFloat64Column& column : columns) {
+        BulkDType dtype = reduced;
+        Quantization columnQuantization;
+        if (!encodeColumn(column.data, column.count, dtype, precision.errorBound, bytes, &columnQuantization)) {
+            dtype = BulkDType::Float64;
+            encodeColumn(column.data, column.count, dtype, 0.0, bytes);
+        }
+        if (dtype == BulkDType::DeltaInt16) {
+            quantization[column.name] = columnQuantization;
+        }
+
+        const size_t offset = (payload.size() + PACKED_COLUMN_ALIGNMENT - 1)
+                              / PACKED_COLUMN_ALIGNMENT * PACKED_COLUMN_ALIGNMENT;
+        payload.resize(offset, '\0');  // Zero padding
+        payload.append(bytes);
+        descriptors.push_back({column.name, dtype, offset, bytes.size()});
+    }
+
+    auto& metadata = *envelope.mutable_metadata();
+    metadata[kPackedColumnsKey] = formatBulkColumns(descriptors);
+    metadata[kPackedMessageBytesKey] = std::to_string(messageBytes);
+    if (!quantization.empty()) {
+        metadata[kQuantizationKey] = formatQuantization(quantization);
+    }
+    envelope.set_version(PROTOCOL_VERSION_V2);
+    return true;
+}
+
+bool unpackPayload(const palantir::MessageEnvelope& envelope,
+                   std::string_view& outMessage,
+                   std::vector<BulkColumn>& outColumns,
+                   QString* outError)
+{
+    const std::string& payload = envelope.payload();
+    outMessage = payload;
+    outColumns.clear();
+
+    auto columnsIt = envelope.metadata().find(kPackedColumnsKey);
+    if (columnsIt == envelope.metadata().end()) {
+        return true;
+    }
+
+    auto fail = [&](const QString& error) {
+        if (outError) {
+            *outError = error;
+        }
+        outColumns.clear();
+        return false;
+    };
+
+    if (envelope.version() < PROTOCOL_VERSION_V2) {
+        return fail(QString("Packed columns require protocol version %1").arg(PROTOCOL_VERSION_V2));
+    }
+
+    auto messageIt = envelope.metadata().find(kPackedMessageBytesKey);
+    bool ok = false;
+    const qulonglong messageBytes = messageIt == envelope.metadata().end()
+        ? 0 : QByteArray::fromStdString(messageIt->second).toULongLong(&ok);
+    if (!ok || messageBytes > payload.size()) {
+        return fail(QString("Packed payload has an invalid %1").arg(kPackedMessageBytesKey));
+    }
+
+    if (!parseBulkColumns(columnsIt->second, outColumns, outError)) {
+        return false;
+    }
+    for (const BulkColumn& column : outColumns) {
+        if (!validateBulkColumn(column, payload.size(), outError)) {
+            outColumns.clear();
+            return false;
+        }
+        if (column.offset < messageBytes) {
+            return fail(QString("Packed column '%1' overlaps the inner message")
+                        .arg(QString::fromStdString(column.name)));
+        }
+    }
+
+    outMessage = std::string_view(payload.data(), static_cast<size_t>(messageBytes));
+    return true;
+}
+
+bool readQuantization(const palantir::MessageEnvelope& envelope, QuantizationMap& outQuantization,
+                      QString* outError)
+{
+    outQuantization.clear();
+    auto it = envelope.metadata().find(kQuantizationKey);
+    if (it == envelope.metadata().end()) {
+        return true;
+    }
+    return parseQuantization(it->second, outQuantization, outError);
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
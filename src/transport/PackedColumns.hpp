@@ -0,0 +1,82 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "BulkData.hpp"
+#include "palantir/envelope.pb.h"
+#include <QString>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace phoenix::transport {
+
+// Packed numeric columns (protocol v2).
+//
+// Instead of protobuf `repeated double` fields, a v2 envelope may carry its
+// numeric columns as raw little-endian bytes appended to the payload:
+//
+//   payload = [inner message][zero padding][column bytes]...
+//
+// kPackedMessageBytesKey is the length of the inner message; kPackedColumnsKey
+// describes the columns with the bulk column format ("x:f64:offset:length;..."
+// with offsets relative to the start of the payload, shape = length / dtype
+// size). Columns start on PACKED_COLUMN_ALIGNMENT boundaries so a receiver
+// can read them in place. The corresponding repeated fields of the inner
+// message are left empty.
+static constexpr const char* kPackedColumnsKey = "packed_columns";
+static constexpr const char* kPackedMessageBytesKey = "packed_message_bytes";
+static constexpr size_t PACKED_COLUMN_ALIGNMENT = 8;
+
+// One column of samples to pack (server side / tests)
+struct PackedFloat64Column {
+    std::string name;
+    const double* data = nullptr;
+    size_t count = 0;
+};
+
+/**
+ * Append columns to envelope's payload and describe them in its metadata.
+ *
+ * The payload must hold only the serialized inner message. Sets the envelope
+ * version to PROTOCOL_VERSION_V2. Compress (if at all) after packing.
+ *
+ * @return true on success, false if the envelope is already packed or encoded
+ */
+bool packFloat64Columns(palantir::MessageEnvelope& envelope,
+                        const std::vector<PackedFloat64Column>& columns,
+                        QString* outError = nullptr);
+
+/**
+ * Same as packFloat64Columns(), storing each column at the requested reduced
+ * precision where it stays within precision.errorBound (f64 otherwise) and
+ * listing DeltaInt16 parameters under kQuantizationKey.
+ */
+bool packColumns(palantir::MessageEnvelope& envelope,
+                 const std::vector<PackedFloat64Column>& columns,
+                 const ReducedPrecision& precision,
+                 QString* outError = nullptr);
+
+/**
+ * Split a (decompressed) payload into its inner message and packed columns.
+ *
+ * Envelopes without kPackedColumnsKey yield the whole payload as the message
+ * and no columns, so v1 and v2 responses go through the same call.
+ *
+ * @return true on success, false on malformed or out-of-bounds descriptors
+ */
+bool unpackPayload(const palantir::MessageEnvelope& envelope,
+                   std::string_view& outMessage,
+                   std::vector<BulkColumn>& outColumns,
+                   QString* outError = nullptr);
+
+/**
+ * Read kQuantizationKey (empty map when absent). Applies to packed and
+ * shared-memory columns alike.
+ */
+bool readQuantization(const palantir::MessageEnvelope& envelope, QuantizationMap& outQuantization,
+                      QString* outError = nullptr);
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,215 @@
+#include "PooledTransport.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include "palantir/capabilities.pb.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <algorithm>
+#include <tuple>
+
+namespace phoenix::transport {
+
+PooledTransport::PooledTransport(const QStringList& socketPaths, ChannelFactory factory, int keepaliveIntervalMs)
+{
+    if (!factory) {
+        // Not TransportFactory: RemoteExecutor needs LocalSocketChannel's full API
+        // (EpollChannel is a benchmark backend)
+        factory = [](const QString& socketPath) { return std::make_unique<LocalSocketChannel>(socketPath); };
+    }
+    m_endpoints.reserve(static_cast<size_t>(socketPaths.size()));
+    for (const QString& socketPath : socketPaths) {
+        Endpoint endpoint;
+        endpoint.connections = std::make_unique<ConnectionManager>(
+            [factory, socketPath]() { return factory(socketPath); }, keepaliveIntervalMs);
+        endpoint.stats.socketPath = socketPath;
+        m_endpoints.push_back(std::move(endpoint));
+    }
+}
+
+PooledTransport::~PooledTransport()
+{
+    disconnect();
+}
+
+std::shared_ptr<PooledTransport> PooledTransport::shared()
+{
+    static std::shared_ptr<PooledTransport> pool = std::make_shared<PooledTransport>(socketPathsFromEnvironment());
+    static std::once_flag quitHook;
+    std::call_once(quitHook, []() {
+        // Close the connections while the application is still fully alive
+        if (QCoreApplication* app = QCoreApplication::instance()) {
+            QObject::connect(app, &QCoreApplication::aboutToQuit, []() { PooledTransport::shared()->disconnect(); });
+        }
+    });
+    return pool;
+}
+
+QStringList PooledTransport::socketPathsFromEnvironment()
+{
+    QStringList paths;
+    for (const QString& path : qEnvironmentVariable("PALANTIR_SOCKET_PATHS").split(',', Qt::SkipEmptyParts)) {
+        const QString trimmed = path.trimmed();
+        if (!trimmed.isEmpty() && !paths.contains(trimmed)) {
+            paths.append(trimmed);
+        }
+    }
+    if (paths.isEmpty()) {
+        const QString single = qEnvironmentVariable("PALANTIR_SOCKET_PATH");
+        paths.append(single.isEmpty() ? QStringLiteral("palantir_bedrock") : single);
+    }
+    return paths;
+}
+
+bool PooledTransport::connect()
+{
+    bool any = false;
+    for (size_t i = 0; i < m_endpoints.size(); ++i) {
+        const bool connected = m_endpoints[i].connections->channel() != nullptr;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_endpoints[i].stats.healthy = connected;
+        any = any || connected;
+    }
+    return any;
+}
+
+void PooledTransport::disconnect()
+{
+    for (Endpoint& endpoint : m_endpoints) {
+        endpoint.connections->shutdown();
+    }
+}
+
+bool PooledTransport::isConnected() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::any_of(m_endpoints.begin(), m_endpoints.end(),
+                       [](const Endpoint& endpoint) { return endpoint.stats.healthy; });
+}
+
+std::optional<palantir::CapabilitiesResponse> PooledTransport::getCapabilities(QString* outError)
+{
+    std::set<size_t> tried;
+    while (auto lease = acquire(outError, tried)) {
+        const auto start = std::chrono::steady_clock::now();
+        auto response = lease->channel->getCapabilities(outError);
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+        if (response.has_value()) {
+            release(*lease, Outcome::Success, latency);
+            return response;
+        }
+        const bool lost = !lease->channel->isConnected();
+        release(*lease, lost ? Outcome::EndpointDown : Outcome::Failed, latency);
+        if (!lost) {
+            return std::nullopt;
+        }
+        tried.insert(lease->endpoint);
+    }
+    return std::nullopt;
+}
+
+std::optional<PooledTransport::Lease> PooledTransport::acquire(QString* outError, const std::set<size_t>& exclude)
+{
+    std::set<size_t> skipped = exclude;
+    for (;;) {
+        // Least loaded first; healthy endpoints before ones marked down,
+        // lower latency on ties. Reserve the slot before connecting so
+        // concurrent callers spread out.
+        size_t chosen = m_endpoints.size();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = 0; i < m_endpoints.size(); ++i) {
+                if (skipped.count(i)) {
+                    continue;
+                }
+                if (chosen == m_endpoints.size()) {
+                    chosen = i;
+                    continue;
+                }
+                const EndpointStats& a = m_endpoints[i].stats;
+                const EndpointStats& b = m_endpoints[chosen].stats;
+                if (std::make_tuple(!a.healthy, a.inFlight, a.latencyMs)
+                    < std::make_tuple(!b.healthy, b.inFlight, b.latencyMs)) {
+                    chosen = i;
+                }
+            }
+            if (chosen == m_endpoints.size()) {
+                break;
+            }
+            ++m_endpoints[chosen].stats.inFlight;
+        }
+
+        Endpoint& endpoint = m_endpoints[chosen];
+        Lease lease;
+        lease.endpoint = chosen;
+        lease.socketPath = endpoint.stats.socketPath;
+        lease.channel = endpoint.connections->channel(outError);
+        if (lease.channel) {
+            lease.capabilities = endpoint.connections->capabilities(outError);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (lease.channel && lease.capabilities) {
+            endpoint.stats.healthy = true;
+            return lease;
+        }
+        --endpoint.stats.inFlight;
+        if (endpoint.stats.healthy) {
+            qWarning() << "PooledTransport: Endpoint" << endpoint.stats.socketPath << "is down";
+        }
+        endpoint.stats.healthy = false;
+        ++endpoint.stats.failures;
+        skipped.insert(chosen);
+    }
+
+    if (outError && outError->isEmpty()) {
+        *outError = QStringLiteral("No Bedrock endpoint available");
+    }
+    return std::nullopt;
+}
+
+void PooledTransport::release(const Lease& lease, Outcome outcome, std::chrono::microseconds latency)
+{
+    if (lease.endpoint >= m_endpoints.size()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    EndpointStats& stats = m_endpoints[lease.endpoint].stats;
+    stats.inFlight = std::max(stats.inFlight - 1, 0);
+    ++stats.requests;
+    switch (outcome) {
+        case Outcome::Success: {
+            const double ms = latency.count() / 1000.0;
+            stats.latencyMs = stats.latencyMs == 0.0
+                ? ms
+                : (1.0 - LATENCY_SMOOTHING) * stats.latencyMs + LATENCY_SMOOTHING * ms;
+            break;
+        }
+        case Outcome::Failed:
+            ++stats.failures;
+            break;
+        case Outcome::EndpointDown:
+            ++stats.failures;
+            if (stats.healthy) {
+                qWarning() << "PooledTransport: Lost endpoint" << stats.socketPath;
+            }
+            stats.healthy = false;
+            break;
+    }
+}
+
+std::vector<PooledTransport::EndpointStats> PooledTransport::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<EndpointStats> result;
+    result.reserve(m_endpoints.size());
+    for (const Endpoint& endpoint : m_endpoints) {
+        result.push_back(endpoint.stats);
+    }
+    return result;
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,113 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "TransportClient.hpp"
+#include "ConnectionManager.hpp"
+#include <QString>
+#include <QStringList>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace phoenix::transport {
+
+/**
+ * Transport backend spreading work across several Bedrock processes.
+ *
+ * Each endpoint (socket path) keeps its own persistent connection through a
+ * ConnectionManager (reconnect backoff, keepalive, capabilities cache). The
+ * pool tracks per-endpoint in-flight requests and a moving average of
+ * request latency; acquire() hands out the least-loaded healthy endpoint
+ * (ties broken by latency). An endpoint whose connection fails is marked
+ * down and only tried after the healthy ones until it answers again.
+ *
+ * Callers retry on another endpoint by passing the ones already tried to
+ * acquire() (see RemoteExecutor). Thread-safe.
+ */
+class PooledTransport : public TransportClient {
+public:
+    // One routed request: keep the lease until the request is over, then release() it
+    struct Lease {
+        size_t endpoint = 0;
+        QString socketPath;
+        std::shared_ptr<LocalSocketChannel> channel;
+        std::shared_ptr<const ConnectionManager::ServerCapabilities> capabilities;
+    };
+
+    enum class Outcome {
+        Success,       // Counts towards the endpoint's latency
+        Failed,        // Request error (endpoint stays healthy)
+        EndpointDown   // Connection lost; the endpoint is marked down
+    };
+
+    struct EndpointStats {
+        QString socketPath;
+        int inFlight = 0;
+        double latencyMs = 0.0;  // Moving average of successful requests
+        bool healthy = true;
+        uint64_t requests = 0;
+        uint64_t failures = 0;
+    };
+
+    using ChannelFactory = std::function<std::unique_ptr<LocalSocketChannel>(const QString& socketPath)>;
+
+    // factory defaults to LocalSocketChannel on each socket path
+    explicit PooledTransport(const QStringList& socketPaths, ChannelFactory factory = nullptr,
+                             int keepaliveIntervalMs = ConnectionManager::DEFAULT_KEEPALIVE_INTERVAL_MS);
+    ~PooledTransport() override;
+
+    PooledTransport(const PooledTransport&) = delete;
+    PooledTransport& operator=(const PooledTransport&) = delete;
+
+    // Process-wide pool over socketPathsFromEnvironment() (shut down on
+    // application quit); RemoteExecutor uses it when several endpoints are set
+    static std::shared_ptr<PooledTransport> shared();
+
+    // Socket paths from PALANTIR_SOCKET_PATHS (comma-separated), falling
+    // back to the single-endpoint PALANTIR_SOCKET_PATH / default
+    static QStringList socketPathsFromEnvironment();
+
+    // TransportClient interface (connect() succeeds if any endpoint does;
+    // getCapabilities() asks the least-loaded endpoint)
+    bool connect() override;
+    void disconnect() override;
+    bool isConnected() const override;
+    std::optional<palantir::CapabilitiesResponse> getCapabilities(QString* outError = nullptr) override;
+
+    /**
+     * Pick the least-loaded healthy endpoint and connect to it (counts as
+     * in flight until released).
+     *
+     * @param exclude Endpoints not to use (already tried for this request)
+     * @return Lease, or empty optional if no endpoint could be reached
+     *         (outError holds the last connection error)
+     */
+    std::optional<Lease> acquire(QString* outError = nullptr, const std::set<size_t>& exclude = {});
+
+    // End a request started with acquire()
+    void release(const Lease& lease, Outcome outcome, std::chrono::microseconds latency);
+
+    size_t endpointCount() const { return m_endpoints.size(); }
+    std::vector<EndpointStats> stats() const;
+
+    // Weight of the newest sample in the latency average
+    static constexpr double LATENCY_SMOOTHING = 0.2;
+
+private:
+    struct Endpoint {
+        std::unique_ptr<ConnectionManager> connections;
+        EndpointStats stats;
+    };
+
+    mutable std::mutex m_mutex;  // Guards every Endpoint::stats
+    std::vector<Endpoint> m_endpoints;
+};
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,58 @@
+#include "RangeQuery.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include <QByteArray>
+
+namespace phoenix::transport {
+
+void setRangeMetadata(std::map<std::string, std::string>& metadata, const ViewportRange& range)
+{
+    // 17 significant digits: the range round-trips exactly
+    metadata[kRangeXMinKey] = QByteArray::number(range.xMin, 'g', 17).toStdString();
+    metadata[kRangeXMaxKey] = QByteArray::number(range.xMax, 'g', 17).toStdString();
+    metadata[kRangePixelsKey] = std::to_string(range.pixelWidth);
+    metadata[kDecimationKey] = range.decimation;
+}
+
+std::optional<ViewportRange> rangeFromEnvelope(const palantir::MessageEnvelope& envelope,
+                                               QString* outError)
+{
+    const auto& metadata = envelope.metadata();
+    auto pixelsIt = metadata.find(kRangePixelsKey);
+    if (pixelsIt == metadata.end()) {
+        return std::nullopt;
+    }
+
+    auto value = [&](const char* key) {
+        auto it = metadata.find(key);
+        return it == metadata.end() ? QByteArray() : QByteArray::fromStdString(it->second);
+    };
+
+    ViewportRange range;
+    bool pixelsOk = false;
+    bool minOk = false;
+    bool maxOk = false;
+    range.pixelWidth = QByteArray::fromStdString(pixelsIt->second).toUInt(&pixelsOk);
+    range.xMin = value(kRangeXMinKey).toDouble(&minOk);
+    range.xMax = value(kRangeXMaxKey).toDouble(&maxOk);
+    auto decimationIt = metadata.find(kDecimationKey);
+    if (decimationIt != metadata.end()) {
+        range.decimation = decimationIt->second;
+    }
+
+    if (!pixelsOk || !minOk || !maxOk || !range.isValid()) {
+        if (outError) {
+            *outError = QString("Malformed range query: [%1, %2] at %3 px")
+                            .arg(QString::fromUtf8(value(kRangeXMinKey)))
+                            .arg(QString::fromUtf8(value(kRangeXMaxKey)))
+                            .arg(QString::fromStdString(pixelsIt->second));
+        }
+        return std::nullopt;
+    }
+    return range;
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,54 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "palantir/envelope.pb.h"
+#include <QString>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace phoenix::transport {
+
+// Viewport range queries (server-side decimation).
+//
+// Bedrock lists kRangeQueryFeature in its capabilities. An XY Sine request
+// may then carry the visible x-range and the plot width in pixels; Bedrock
+// answers with only the samples in that range (plus the nearest sample
+// outside each end), reduced with kDecimationKey ("minmax": min/max per
+// pixel column, "lttb": largest-triangle-three-buckets) to about two points
+// per pixel. kRangeSourceSamplesKey on the response is the number of
+// samples the range held before decimation. Without kRangePixelsKey the
+// full result is sent, as before.
+static constexpr const char* kRangeQueryFeature = "xy_sine.range";
+static constexpr const char* kRangeXMinKey = "range_x_min";
+static constexpr const char* kRangeXMaxKey = "range_x_max";
+static constexpr const char* kRangePixelsKey = "range_pixels";
+static constexpr const char* kDecimationKey = "decimation";
+static constexpr const char* kRangeSourceSamplesKey = "range_source_samples";
+
+// Visible part of a plot for one range query
+struct ViewportRange {
+    double xMin = 0.0;
+    double xMax = 0.0;
+    uint32_t pixelWidth = 0;
+    std::string decimation = "minmax";
+
+    bool isValid() const { return pixelWidth > 0 && xMax > xMin; }
+};
+
+// Add the range query keys to request metadata
+void setRangeMetadata(std::map<std::string, std::string>& metadata, const ViewportRange& range);
+
+/**
+ * Read the range query keys of a request (server side / tests).
+ *
+ * @return Range, or empty optional if the request is not a range query or
+ *         its keys are malformed (outError set only in the latter case)
+ */
+std::optional<ViewportRange> rangeFromEnvelope(const palantir::MessageEnvelope& envelope,
+                                               QString* outError = nullptr);
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,60 @@
+#include "RingBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace phoenix::transport {
+
+RingBuffer::RingBuffer(size_t initialCapacity)
+    : m_storage(new char[std::max<size_t>(initialCapacity, 1)])
+    , m_capacity(std::max<size_t>(initialCapacity, 1))
+    , m_head(0)
+    , m_tail(0)
+{
+}
+
+char* RingBuffer::prepareWrite(size_t minBytes)
+{
+    if (m_capacity - m_tail >= minBytes) {
+        return m_storage.get() + m_tail;
+    }
+
+    const size_t used = size();
+    if (used + minBytes <= m_capacity) {
+        // Enough room overall: slide unread bytes back to the front
+        std::memmove(m_storage.get(), m_storage.get() + m_head, used);
+    } else {
+        // Grow geometrically so large frames settle after a few reads
+        const size_t newCapacity = std::max(m_capacity * 2, used + minBytes);
+        std::unique_ptr<char[]> storage(new char[newCapacity]);
+        std::memcpy(storage.get(), m_storage.get() + m_head, used);
+        m_storage = std::move(storage);
+        m_capacity = newCapacity;
+    }
+    m_head = 0;
+    m_tail = used;
+    return m_storage.get() + m_tail;
+}
+
+void RingBuffer::commitWrite(size_t bytes)
+{
+    m_tail = std::min(m_tail + bytes, m_capacity);
+}
+
+void RingBuffer::consume(size_t bytes)
+{
+    m_head = std::min(m_head + bytes, m_tail);
+    if (m_head == m_tail) {
+        // Empty: rewind for free instead of compacting later
+        m_head = 0;
+        m_tail = 0;
+    }
+}
+
+void RingBuffer::clear()
+{
+    m_head = 0;
+    m_tail = 0;
+}
+
+} // namespace phoenix::transport
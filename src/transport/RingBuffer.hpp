@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace phoenix::transport {
+
+/**
+ * Reusable receive buffer for framed socket reads.
+ *
+ * Socket reads append at the tail and complete frames are consumed from the
+ * head. Unlike a wrapping ring, unread bytes are always kept contiguous (they
+ * are moved to the front when the tail runs out of room), so a complete frame
+ * can be parsed in place without reassembly. Capacity only grows; once it
+ * fits the largest frame seen, reads no longer allocate.
+ *
+ * Not thread-safe; owned by a single reader (the channel's I/O thread).
+ */
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t initialCapacity = DEFAULT_CAPACITY);
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * Reserve writable space at the tail.
+     *
+     * @return Pointer to at least minBytes of writable memory; call
+     *         commitWrite() with the number of bytes actually written
+     */
+    char* prepareWrite(size_t minBytes);
+    void commitWrite(size_t bytes);
+
+    // Unread bytes (contiguous)
+    const char* data() const { return m_storage.get() + m_head; }
+    size_t size() const { return m_tail - m_head; }
+    bool empty() const { return m_head == m_tail; }
+
+    // Drop bytes from the head (e.g. a fully handled frame)
+    void consume(size_t bytes);
+    void clear();
+
+    size_t capacity() const { return m_capacity; }
+
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+private:
+    std::unique_ptr<char[]> m_storage;
+    size_t m_capacity;
+    size_t m_head;  // First unread byte
+    size_t m_tail;  // One past the last written byte
+};
+
+} // namespace phoenix::transport
@@ -0,0 +1,290 @@
+#include "SessionAuth.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include "FrameCodec.hpp"
+#include <QByteArray>
+#include <cstring>
+
+#ifdef PHX_WITH_LIBSODIUM
+#include <sodium.h>
+#endif
+
+namespace phoenix::transport {
+
+namespace {
+
+#ifdef PHX_WITH_LIBSODIUM
+static_assert(crypto_onetimeauth_poly1305_BYTES == FRAME_MAC_BYTES, "Tag size is part of the wire format");
+static_assert(crypto_kx_PUBLICKEYBYTES == sizeof(SessionKey) && crypto_kx_SESSIONKEYBYTES == sizeof(SessionKey),
+              "X25519 keys and session keys are 32 bytes");
+static_assert(crypto_sign_PUBLICKEYBYTES == sizeof(IdentityPublicKey) &&
+                  crypto_sign_SECRETKEYBYTES == sizeof(IdentitySecretKey),
+              "Ed25519 key sizes");
+
+constexpr char kTranscriptLabel[] = "phoenix-auth-v1";
+
+bool initSodium()
+{
+    static const bool initialized = sodium_init() >= 0;
+    return initialized;
+}
+
+// Bytes the server signs: label, client key, server key
+std::string transcript(const SessionKey& clientKey, const SessionKey& serverKey)
+{
+    std::string bytes(kTranscriptLabel, sizeof(kTranscriptLabel) - 1);
+    bytes.append(reinterpret_cast<const char*>(clientKey.data()), clientKey.size());
+    bytes.append(reinterpret_cast<const char*>(serverKey.data()), serverKey.size());
+    return bytes;
+}
+
+bool readKey(const palantir::MessageEnvelope& envelope, const char* name, unsigned char* outKey, size_t size,
+             QString* outError)
+{
+    auto it = envelope.metadata().find(name);
+    if (it == envelope.metadata().end()) {
+        if (outError) {
+            *outError = QString("Handshake is missing %1").arg(name);
+        }
+        return false;
+    }
+    return keyFromHex(it->second, outKey, size, outError);
+}
+#endif
+
+bool failWithoutSodium(QString* outError)
+{
+    if (!sessionAuthAvailable()) {
+        if (outError) {
+            *outError = QString("Authenticated sessions need libsodium (PHX_WITH_LIBSODIUM=OFF)");
+        }
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool sessionAuthAvailable()
+{
+#ifdef PHX_WITH_LIBSODIUM
+    return initSodium();
+#else
+    return false;
+#endif
+}
+
+bool generateIdentity(IdentityPublicKey& outPublic, IdentitySecretKey& outSecret)
+{
+#ifdef PHX_WITH_LIBSODIUM
+    return initSodium() && crypto_sign_keypair(outPublic.data(), outSecret.data()) == 0;
+#else
+    (void)outPublic;
+    (void)outSecret;
+    return false;
+#endif
+}
+
+std::string keyToHex(const unsigned char* key, size_t size)
+{
+    return QByteArray(reinterpret_cast<const char*>(key), static_cast<qsizetype>(size)).toHex().toStdString();
+}
+
+bool keyFromHex(const std::string& hex, unsigned char* outKey, size_t size, QString* outError)
+{
+    // fromHex() skips stray characters; only exact, complete keys pass
+    const QByteArray text = QByteArray::fromStdString(hex).toLower();
+    const QByteArray bytes = QByteArray::fromHex(text);
+    if (static_cast<size_t>(bytes.size()) != size || bytes.toHex() != text) {
+        if (outError) {
+            *outError = QString("Malformed key: expected %1 hex digits").arg(size * 2);
+        }
+        return false;
+    }
+    std::memcpy(outKey, bytes.constData(), size);
+    return true;
+}
+
+FrameMac::FrameMac(const SessionKey& key)
+    : m_key(key)
+{
+}
+
+FrameMac::~FrameMac()
+{
+#ifdef PHX_WITH_LIBSODIUM
+    sodium_memzero(m_key.data(), m_key.size());
+#endif
+}
+
+void FrameMac::computeTag(uint32_t lengthPrefix, const char* envelope, size_t envelopeSize, unsigned char* outTag)
+{
+#ifdef PHX_WITH_LIBSODIUM
+    // One-time Poly1305 key: ChaCha20 keystream at this frame's sequence number
+    unsigned char nonce[crypto_stream_chacha20_NONCEBYTES];
+    for (size_t i = 0; i < sizeof(nonce); ++i) {
+        nonce[i] = static_cast<unsigned char>(m_sequence >> (8 * i));
+    }
+    unsigned char oneTimeKey[crypto_onetimeauth_poly1305_KEYBYTES];
+    crypto_stream_chacha20(oneTimeKey, sizeof(oneTimeKey), nonce, m_key.data());
+
+    // Prefix bytes exactly as framed (see encodeFrame), then the envelope in place
+    unsigned char header[FRAME_HEADER_SIZE];
+    std::memcpy(header, &lengthPrefix, FRAME_HEADER_SIZE);
+    crypto_onetimeauth_poly1305_state state;
+    crypto_onetimeauth_poly1305_init(&state, oneTimeKey);
+    crypto_onetimeauth_poly1305_update(&state, header, sizeof(header));
+    crypto_onetimeauth_poly1305_update(&state, reinterpret_cast<const unsigned char*>(envelope), envelopeSize);
+    crypto_onetimeauth_poly1305_final(&state, outTag);
+    sodium_memzero(oneTimeKey, sizeof(oneTimeKey));
+    sodium_memzero(&state, sizeof(state));
+#else
+    (void)lengthPrefix;
+    (void)envelope;
+    (void)envelopeSize;
+    std::memset(outTag, 0, FRAME_MAC_BYTES);
+#endif
+    ++m_sequence;
+}
+
+void FrameMac::sign(char* frame, size_t frameSize, unsigned char* outTag)
+{
+    const size_t envelopeSize = frameSize - FRAME_HEADER_SIZE;
+    const uint32_t lengthPrefix = static_cast<uint32_t>(envelopeSize + FRAME_MAC_BYTES);
+    std::memcpy(frame, &lengthPrefix, FRAME_HEADER_SIZE);
+    computeTag(lengthPrefix, frame + FRAME_HEADER_SIZE, envelopeSize, outTag);
+}
+
+bool FrameMac::verify(const char* body, size_t bodySize)
+{
+    if (bodySize < FRAME_MAC_BYTES) {
+        ++m_sequence;
+        return false;
+    }
+    const size_t envelopeSize = bodySize - FRAME_MAC_BYTES;
+    unsigned char expected[FRAME_MAC_BYTES];
+    computeTag(static_cast<uint32_t>(bodySize), body, envelopeSize, expected);
+#ifdef PHX_WITH_LIBSODIUM
+    return crypto_verify_16(expected, reinterpret_cast<const unsigned char*>(body + envelopeSize)) == 0;
+#else
+    return false;
+#endif
+}
+
+ClientHandshake::ClientHandshake(const IdentityPublicKey& serverIdentity)
+    : m_serverIdentity(serverIdentity)
+{
+}
+
+ClientHandshake::~ClientHandshake()
+{
+#ifdef PHX_WITH_LIBSODIUM
+    sodium_memzero(m_secretKey.data(), m_secretKey.size());
+#endif
+}
+
+bool ClientHandshake::hello(std::map<std::string, std::string>& outMetadata, QString* outError)
+{
+    if (failWithoutSodium(outError)) {
+        return false;
+    }
+#ifdef PHX_WITH_LIBSODIUM
+    crypto_kx_keypair(m_publicKey.data(), m_secretKey.data());
+#endif
+    outMetadata[kAuthClientKeyKey] = keyToHex(m_publicKey);
+    return true;
+}
+
+std::unique_ptr<AuthSession> ClientHandshake::finish(const palantir::MessageEnvelope& response, QString* outError)
+{
+    if (failWithoutSodium(outError)) {
+        return nullptr;
+    }
+#ifdef PHX_WITH_LIBSODIUM
+    SessionKey serverKey;
+    unsigned char signature[crypto_sign_BYTES];
+    if (!readKey(response, kAuthServerKeyKey, serverKey.data(), serverKey.size(), outError) ||
+        !readKey(response, kAuthSignatureKey, signature, sizeof(signature), outError)) {
+        return nullptr;
+    }
+
+    const std::string signedBytes = transcript(m_publicKey, serverKey);
+    if (crypto_sign_verify_detached(signature, reinterpret_cast<const unsigned char*>(signedBytes.data()),
+                                    signedBytes.size(), m_serverIdentity.data()) != 0) {
+        if (outError) {
+            *outError = QString("Handshake is not signed by the pinned server key");
+        }
+        return nullptr;
+    }
+
+    SessionKey receiveKey;
+    SessionKey sendKey;
+    if (crypto_kx_client_session_keys(receiveKey.data(), sendKey.data(), m_publicKey.data(), m_secretKey.data(),
+                                      serverKey.data()) != 0) {
+        if (outError) {
+            *outError = QString("Handshake carries an invalid server session key");
+        }
+        return nullptr;
+    }
+    auto session = std::make_unique<AuthSession>(sendKey, receiveKey);
+    sodium_memzero(receiveKey.data(), receiveKey.size());
+    sodium_memzero(sendKey.data(), sendKey.size());
+    return session;
+#else
+    (void)response;
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<AuthSession> acceptHandshake(const palantir::MessageEnvelope& hello,
+                                             const IdentitySecretKey& identity,
+                                             std::map<std::string, std::string>& outMetadata,
+                                             QString* outError)
+{
+    if (failWithoutSodium(outError)) {
+        return nullptr;
+    }
+#ifdef PHX_WITH_LIBSODIUM
+    SessionKey clientKey;
+    if (!readKey(hello, kAuthClientKeyKey, clientKey.data(), clientKey.size(), outError)) {
+        return nullptr;
+    }
+
+    SessionKey publicKey;
+    SessionKey secretKey;
+    SessionKey receiveKey;
+    SessionKey sendKey;
+    crypto_kx_keypair(publicKey.data(), secretKey.data());
+    const bool derived = crypto_kx_server_session_keys(receiveKey.data(), sendKey.data(), publicKey.data(),
+                                                       secretKey.data(), clientKey.data()) == 0;
+    sodium_memzero(secretKey.data(), secretKey.size());
+    if (!derived) {
+        if (outError) {
+            *outError = QString("Handshake carries an invalid client session key");
+        }
+        return nullptr;
+    }
+
+    unsigned char signature[crypto_sign_BYTES];
+    const std::string signedBytes = transcript(clientKey, publicKey);
+    crypto_sign_detached(signature, nullptr, reinterpret_cast<const unsigned char*>(signedBytes.data()),
+                         signedBytes.size(), identity.data());
+    outMetadata[kAuthServerKeyKey] = keyToHex(publicKey);
+    outMetadata[kAuthSignatureKey] = keyToHex(signature, sizeof(signature));
+
+    auto session = std::make_unique<AuthSession>(sendKey, receiveKey);
+    sodium_memzero(receiveKey.data(), receiveKey.size());
+    sodium_memzero(sendKey.data(), sendKey.size());
+    return session;
+#else
+    (void)hello;
+    (void)identity;
+    (void)outMetadata;
+    return nullptr;
+#endif
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,157 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "palantir/envelope.pb.h"
+#include <QString>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace phoenix::transport {
+
+// Authenticated sessions (sockets in shared directories).
+//
+// The client pins Bedrock's long-term Ed25519 public key. Right after
+// connecting, before any other frame, it sends AUTH_HELLO (empty payload)
+// with a fresh X25519 public key in kAuthClientKeyKey. Bedrock answers
+// AUTH_RESPONSE with a fresh X25519 key of its own (kAuthServerKeyKey) and an
+// Ed25519 signature (kAuthSignatureKey) over
+//
+//   "phoenix-auth-v1" || client key || server key
+//
+// (all keys and the signature hex-encoded). Both sides derive one session
+// key per direction from the exchange (crypto_kx). From then on every frame
+// in either direction ends with a Poly1305 tag that the length prefix counts:
+//
+//   [4-byte length = n + 16][envelope (n bytes)][16-byte tag]
+//
+// The tag covers the length prefix and the envelope. Its one-time key is the
+// ChaCha20 keystream of the direction's session key at the frame's sequence
+// number, so forged, replayed, reordered or dropped frames all fail
+// verification, which closes the connection. Envelopes themselves are
+// unchanged and not encrypted.
+static constexpr palantir::MessageType AUTH_HELLO = static_cast<palantir::MessageType>(16);
+static constexpr palantir::MessageType AUTH_RESPONSE = static_cast<palantir::MessageType>(17);
+static constexpr const char* kAuthFeature = "transport.auth";
+static constexpr const char* kAuthClientKeyKey = "auth_client_key";
+static constexpr const char* kAuthServerKeyKey = "auth_server_key";
+static constexpr const char* kAuthSignatureKey = "auth_signature";
+static constexpr size_t FRAME_MAC_BYTES = 16;
+
+// Long-term Ed25519 identity of a Bedrock server
+using IdentityPublicKey = std::array<unsigned char, 32>;
+using IdentitySecretKey = std::array<unsigned char, 64>;
+using SessionKey = std::array<unsigned char, 32>;
+
+// False when built without libsodium (PHX_WITH_LIBSODIUM=OFF); handshakes then fail
+bool sessionAuthAvailable();
+
+// New random identity (server side / tests)
+bool generateIdentity(IdentityPublicKey& outPublic, IdentitySecretKey& outSecret);
+
+// Hex form of keys (e.g. PALANTIR_SERVER_KEY)
+std::string keyToHex(const unsigned char* key, size_t size);
+template <size_t N>
+std::string keyToHex(const std::array<unsigned char, N>& key)
+{
+    return keyToHex(key.data(), N);
+}
+bool keyFromHex(const std::string& hex, unsigned char* outKey, size_t size, QString* outError = nullptr);
+
+/**
+ * MAC state of one direction of an authenticated session.
+ *
+ * Frames must be signed and verified in the order they cross the socket;
+ * every call advances the sequence number. Not thread-safe.
+ */
+class FrameMac {
+public:
+    explicit FrameMac(const SessionKey& key);
+    ~FrameMac();
+
+    FrameMac(const FrameMac&) = delete;
+    FrameMac& operator=(const FrameMac&) = delete;
+
+    /**
+     * Tag an encoded frame ([length prefix][envelope]) in place.
+     *
+     * Adds FRAME_MAC_BYTES to the length prefix and writes the tag to
+     * outTag; send it right after the frame.
+     */
+    void sign(char* frame, size_t frameSize, unsigned char* outTag);
+
+    /**
+     * Check a received frame body ([envelope][tag], as FrameDecoder reports it).
+     *
+     * @return true if the tag is valid; the envelope is then the first
+     *         bodySize - FRAME_MAC_BYTES bytes
+     */
+    bool verify(const char* body, size_t bodySize);
+
+    uint64_t sequence() const { return m_sequence; }
+
+private:
+    void computeTag(uint32_t lengthPrefix, const char* envelope, size_t envelopeSize, unsigned char* outTag);
+
+    SessionKey m_key;
+    uint64_t m_sequence = 0;
+};
+
+// Both directions of an established session
+struct AuthSession {
+    AuthSession(const SessionKey& sendKey, const SessionKey& receiveKey)
+        : send(sendKey)
+        , receive(receiveKey)
+    {
+    }
+
+    FrameMac send;
+    FrameMac receive;
+};
+
+/**
+ * Client half of the handshake (one per connection attempt).
+ */
+class ClientHandshake {
+public:
+    explicit ClientHandshake(const IdentityPublicKey& serverIdentity);
+    ~ClientHandshake();
+
+    ClientHandshake(const ClientHandshake&) = delete;
+    ClientHandshake& operator=(const ClientHandshake&) = delete;
+
+    // Metadata of the AUTH_HELLO envelope (fresh key pair per call)
+    bool hello(std::map<std::string, std::string>& outMetadata, QString* outError = nullptr);
+
+    /**
+     * Check Bedrock's AUTH_RESPONSE against the pinned identity.
+     *
+     * @return Session keys, or nullptr if the response is malformed or not
+     *         signed by the pinned identity
+     */
+    std::unique_ptr<AuthSession> finish(const palantir::MessageEnvelope& response, QString* outError = nullptr);
+
+private:
+    IdentityPublicKey m_serverIdentity;
+    SessionKey m_publicKey{};
+    SessionKey m_secretKey{};
+};
+
+/**
+ * Server half: answer an AUTH_HELLO (Bedrock side / mock server).
+ *
+ * @param outMetadata Metadata for the AUTH_RESPONSE envelope (empty payload)
+ * @return Session keys, or nullptr if the hello is malformed
+ */
+std::unique_ptr<AuthSession> acceptHandshake(const palantir::MessageEnvelope& hello,
+                                             const IdentitySecretKey& identity,
+                                             std::map<std::string, std::string>& outMetadata,
+                                             QString* outError = nullptr);
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,152 @@
+#include "SharedMemoryRegion.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace phoenix::transport {
+
+SharedMemoryRegion::SharedMemoryRegion(std::string name, void* data, size_t size, bool writable)
+    : m_name(std::move(name))
+    , m_data(data)
+    , m_size(size)
+    , m_writable(writable)
+{
+}
+
+SharedMemoryRegion::~SharedMemoryRegion()
+{
+#ifndef _WIN32
+    if (m_data && m_size > 0) {
+        ::munmap(m_data, m_size);
+    }
+#endif
+}
+
+#ifndef _WIN32
+static QString errnoMessage(const char* operation, const std::string& name)
+{
+    return QString("%1(%2) failed: %3")
+           .arg(operation, QString::fromStdString(name), QString::fromLocal8Bit(std::strerror(errno)));
+}
+#endif
+
+std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::create(const std::string& name, size_t size,
+                                                               QString* outError)
+{
+#ifndef _WIN32
+    if (size == 0) {
+        if (outError) {
+            *outError = "Shared memory region size must be non-zero";
+        }
+        return nullptr;
+    }
+
+    // Owner-only: the consumer runs as the same user on the same host
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        if (outError) {
+            *outError = errnoMessage("shm_open", name);
+        }
+        return nullptr;
+    }
+
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        if (outError) {
+            *outError = errnoMessage("ftruncate", name);
+        }
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps the object alive
+    if (data == MAP_FAILED) {
+        if (outError) {
+            *outError = errnoMessage("mmap", name);
+        }
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemoryRegion>(new SharedMemoryRegion(name, data, size, true));
+#else
+    (void)name;
+    (void)size;
+    if (outError) {
+        *outError = "Shared memory transport is not supported on this platform";
+    }
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::open(const std::string& name, QString* outError)
+{
+#ifndef _WIN32
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        if (outError) {
+            *outError = errnoMessage("shm_open", name);
+        }
+        return nullptr;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        if (outError) {
+            *outError = QString("Shared memory region %1 is empty or unreadable")
+                        .arg(QString::fromStdString(name));
+        }
+        ::close(fd);
+        return nullptr;
+    }
+
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        if (outError) {
+            *outError = errnoMessage("mmap", name);
+        }
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemoryRegion>(new SharedMemoryRegion(name, data, size, false));
+#else
+    (void)name;
+    if (outError) {
+        *outError = "Shared memory transport is not supported on this platform";
+    }
+    return nullptr;
+#endif
+}
+
+std::string SharedMemoryRegion::uniqueName()
+{
+    static std::atomic<unsigned> counter{0};
+#ifndef _WIN32
+    const long pid = static_cast<long>(::getpid());
+#else
+    const long pid = 0;
+#endif
+    return "/phx_" + std::to_string(pid) + "_" + std::to_string(counter.fetch_add(1));
+}
+
+bool SharedMemoryRegion::unlink()
+{
+#ifndef _WIN32
+    return ::shm_unlink(m_name.c_str()) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace phoenix::transport
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QString>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace phoenix::transport {
+
+/**
+ * Named POSIX shared-memory region (shm_open + mmap).
+ *
+ * Used as a side channel for bulk numeric arrays between Bedrock and Phoenix
+ * on the same host: the producer creates and fills a region, the envelope
+ * carries only its name and column layout, and the consumer maps it read-only.
+ *
+ * The mapping is released on destruction; the name persists until unlink().
+ * Not available on Windows (create/open fail with an error).
+ */
+class SharedMemoryRegion {
+public:
+    ~SharedMemoryRegion();
+
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    /**
+     * Create a new region of size bytes mapped read-write (producer side).
+     *
+     * @return Region on success, nullptr on failure (name exists, no memory, ...)
+     */
+    static std::unique_ptr<SharedMemoryRegion> create(const std::string& name, size_t size,
+                                                      QString* outError = nullptr);
+
+    /**
+     * Map an existing region read-only (consumer side).
+     *
+     * @return Region on success, nullptr on failure
+     */
+    static std::unique_ptr<SharedMemoryRegion> open(const std::string& name, QString* outError = nullptr);
+
+    // Process-unique region name, short enough for macOS (PSHMNAMLEN = 31)
+    static std::string uniqueName();
+
+    /**
+     * Remove the name so no one else can open it. Existing mappings stay
+     * valid until released; the memory is freed once all are gone.
+     *
+     * @return true if the name was removed
+     */
+    bool unlink();
+
+    const char* data() const { return static_cast<const char*>(m_data); }
+    char* mutableData() { return m_writable ? static_cast<char*>(m_data) : nullptr; }
+    size_t size() const { return m_size; }
+    const std::string& name() const { return m_name; }
+
+private:
+    SharedMemoryRegion(std::string name, void* data, size_t size, bool writable);
+
+    std::string m_name;
+    void* m_data;
+    size_t m_size;
+    bool m_writable;
+};
+
+} // namespace phoenix::transport
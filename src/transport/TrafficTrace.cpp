@@ -0,0 +1,146 @@
+#include "TrafficTrace.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include <algorithm>
+#include <cstring>
+
+namespace phoenix::transport {
+
+namespace {
+
+void putLittleEndian(char* out, uint64_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+uint64_t getLittleEndian(const char* in, size_t bytes)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+TrafficRecorder::~TrafficRecorder()
+{
+    close();
+}
+
+bool TrafficRecorder::open(const QString& path, QString* outError)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || m_file.write(kTraceMagic, sizeof(kTraceMagic)) != static_cast<qint64>(sizeof(kTraceMagic))) {
+        if (outError) {
+            *outError = QString("Cannot write trace %1: %2").arg(path, m_file.errorString());
+        }
+        m_file.close();
+        return false;
+    }
+    m_start = std::chrono::steady_clock::now();
+    m_records = 0;
+    return true;
+}
+
+void TrafficRecorder::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool TrafficRecorder::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file.isOpen();
+}
+
+void TrafficRecorder::record(TraceDirection direction, const char* data, size_t size)
+{
+    // Timestamp before the lock so contention does not skew it
+    const auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count();
+    char header[TRACE_RECORD_HEADER_SIZE];
+    header[0] = static_cast<char>(direction);
+    putLittleEndian(header + 1, static_cast<uint64_t>(std::max<int64_t>(elapsed, 0)), 8);
+    putLittleEndian(header + 9, static_cast<uint32_t>(size), 4);
+    m_file.write(header, sizeof(header));
+    m_file.write(data, static_cast<qint64>(size));
+    ++m_records;
+}
+
+uint64_t TrafficRecorder::recordCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_records;
+}
+
+bool TraceReader::open(const QString& path, QString* outError)
+{
+    m_file.close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (outError) {
+            *outError = QString("Cannot read trace %1: %2").arg(path, m_file.errorString());
+        }
+        return false;
+    }
+    char magic[sizeof(kTraceMagic)];
+    if (m_file.read(magic, sizeof(magic)) != static_cast<qint64>(sizeof(magic))
+        || std::memcmp(magic, kTraceMagic, sizeof(magic)) != 0) {
+        if (outError) {
+            *outError = QString("%1 is not a Phoenix traffic trace").arg(path);
+        }
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool TraceReader::next(TraceRecord& out, QString* outError)
+{
+    char header[TRACE_RECORD_HEADER_SIZE];
+    const qint64 headerRead = m_file.read(header, sizeof(header));
+    if (headerRead == 0) {
+        return false;  // Clean end of trace
+    }
+    if (headerRead != static_cast<qint64>(sizeof(header))
+        || static_cast<uint8_t>(header[0]) > static_cast<uint8_t>(TraceDirection::Received)) {
+        if (outError) {
+            *outError = QStringLiteral("Truncated or corrupt trace record header");
+        }
+        return false;
+    }
+
+    const uint64_t size = getLittleEndian(header + 9, 4);
+    out.direction = static_cast<TraceDirection>(header[0]);
+    out.timestampNs = getLittleEndian(header + 1, 8);
+    out.envelope.resize(size);
+    if (m_file.read(out.envelope.data(), static_cast<qint64>(size)) != static_cast<qint64>(size)) {
+        if (outError) {
+            *outError = QString("Truncated trace record (%1 bytes expected)").arg(size);
+        }
+        return false;
+    }
+    return true;
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,96 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include <QFile>
+#include <QString>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace phoenix::transport {
+
+// IPC traffic traces (record/replay).
+//
+// File layout: the 8-byte magic "PHXTRC01", then one record per envelope:
+//   [1 byte direction][8 bytes timestamp][4 bytes length][envelope bytes]
+// Integers are little-endian; the timestamp is nanoseconds since recording
+// started. Envelope bytes are exactly what crossed the socket (compressed
+// payloads stay compressed), so a replay repeats the same parse work.
+static constexpr char kTraceMagic[8] = {'P', 'H', 'X', 'T', 'R', 'C', '0', '1'};
+static constexpr size_t TRACE_RECORD_HEADER_SIZE = 1 + 8 + 4;
+
+enum class TraceDirection : uint8_t {
+    Sent = 0,       // Phoenix -> Bedrock
+    Received = 1    // Bedrock -> Phoenix
+};
+
+struct TraceRecord {
+    TraceDirection direction = TraceDirection::Sent;
+    uint64_t timestampNs = 0;
+    std::string envelope;  // Serialized MessageEnvelope (no frame length prefix)
+};
+
+/**
+ * Appends envelopes to a trace file.
+ *
+ * record() may be called from any thread; records are written in call order.
+ */
+class TrafficRecorder {
+public:
+    TrafficRecorder() = default;
+    ~TrafficRecorder();
+
+    TrafficRecorder(const TrafficRecorder&) = delete;
+    TrafficRecorder& operator=(const TrafficRecorder&) = delete;
+
+    /**
+     * Create (truncate) path and write the trace header. Timestamps count
+     * from here.
+     *
+     * @return false if the file cannot be written (outError says why)
+     */
+    bool open(const QString& path, QString* outError = nullptr);
+    void close();
+    bool isOpen() const;
+
+    // Append one envelope (no-op when closed)
+    void record(TraceDirection direction, const char* data, size_t size);
+
+    uint64_t recordCount() const;
+
+private:
+    mutable std::mutex m_mutex;
+    QFile m_file;
+    std::chrono::steady_clock::time_point m_start;
+    uint64_t m_records = 0;
+};
+
+/**
+ * Reads a trace file record by record.
+ */
+class TraceReader {
+public:
+    /**
+     * Open path and check the trace header.
+     *
+     * @return false if the file is missing or not a trace
+     */
+    bool open(const QString& path, QString* outError = nullptr);
+
+    /**
+     * Read the next record.
+     *
+     * @return false at the end of the trace, or on a truncated record
+     *         (outError set only in the latter case)
+     */
+    bool next(TraceRecord& out, QString* outError = nullptr);
+
+private:
+    QFile m_file;
+};
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
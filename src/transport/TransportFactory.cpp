@@ -1,17 +1,37 @@
 #include "TransportFactory.hpp"
 #include "LocalSocketChannel.hpp"
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "PooledTransport.hpp"
+#endif
+#if defined(PHX_WITH_TRANSPORT_DEPS) && defined(__linux__)
+#include "EpollChannel.hpp"
+#endif
 #include <memory>
 
 std::unique_ptr<TransportClient> TransportFactory::makeTransportClient(TransportBackend backend)
 {
+#ifdef PHX_WITH_TRANSPORT_DEPS
+    const QStringList socketPaths = phoenix::transport::PooledTransport::socketPathsFromEnvironment();
+    if (backend == TransportBackend::Pooled
+        || (backend == TransportBackend::Auto && socketPaths.size() > 1)) {
+        return std::make_unique<phoenix::transport::PooledTransport>(socketPaths);
+    }
+#endif
+#if defined(PHX_WITH_TRANSPORT_DEPS) && defined(__linux__)
+    // EpollChannel has no authenticated sessions; a pinned key needs LocalSocket
+    if (backend == TransportBackend::Epoll && qEnvironmentVariableIsEmpty("PALANTIR_SERVER_KEY")) {
+        return std::make_unique<phoenix::transport::EpollChannel>();
+    }
+#endif
+
     switch (backend) {
         case TransportBackend::LocalSocket:
+        case TransportBackend::Epoll:   // Not Linux, without transport deps, or PALANTIR_SERVER_KEY set
+        case TransportBackend::Pooled:  // Without transport deps
         case TransportBackend::Auto:
-            // WP1: Both return LocalSocketChannel (no other backends yet)
             return std::make_unique<LocalSocketChannel>();
     }
     
     // Should never reach here, but return LocalSocket as fallback
     return std::make_unique<LocalSocketChannel>();
 }
-
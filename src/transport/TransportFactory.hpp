@@ -6,14 +6,15 @@
 // Transport backend selection
 enum class TransportBackend {
     LocalSocket,  // QLocalSocket-based IPC (future)
-    Auto          // Auto-select (currently same as LocalSocket)
+    Epoll,        // Raw Unix socket on a dedicated epoll I/O thread (Linux; LocalSocket elsewhere or with PALANTIR_SERVER_KEY).
+                  // Benchmarks only: analysis runs always use LocalSocketChannel (see EpollChannel.hpp)
+    Pooled,       // Several Bedrock processes, least-loaded routing (PALANTIR_SOCKET_PATHS)
+    Auto          // Pooled when PALANTIR_SOCKET_PATHS lists several endpoints, else LocalSocket
 };
 
 // Factory for creating transport clients
-// WP1: Simple factory, no environment variable detection yet
 class TransportFactory {
 public:
     // Create a transport client for the specified backend
     static std::unique_ptr<TransportClient> makeTransportClient(TransportBackend backend);
 };
-
@@ -0,0 +1,107 @@
+#include "ui/analysis/LivePreviewController.hpp"
+#include <QTimer>
+#include <algorithm>
+
+LivePreviewController::LivePreviewController(QObject* parent)
+    : QObject(parent)
+    , m_coalesceTimer(new QTimer(this))
+    , m_settleTimer(new QTimer(this))
+{
+    // Not restarted by further edits, so a steady drag still previews
+    m_coalesceTimer->setSingleShot(true);
+    m_coalesceTimer->setInterval(COALESCE_MS);
+    connect(m_coalesceTimer, &QTimer::timeout, this, &LivePreviewController::onCoalesceTimeout);
+
+    // Restarted by every edit: fires once the user lets go
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(SETTLE_MS);
+    connect(m_settleTimer, &QTimer::timeout, this, &LivePreviewController::onSettleTimeout);
+}
+
+LivePreviewController::~LivePreviewController() = default;
+
+void LivePreviewController::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled) {
+        cancelPending();
+    }
+}
+
+void LivePreviewController::setPreviewSamples(int samples)
+{
+    m_previewSamples = std::max(samples, MIN_PREVIEW_SAMPLES);
+}
+
+void LivePreviewController::parametersEdited(const QMap<QString, QVariant>& params)
+{
+    if (!m_enabled) {
+        return;
+    }
+    m_pending = params;
+
+    // Back at the values already on screen in full
+    if (m_refined && m_pending == m_requested) {
+        m_coalesceTimer->stop();
+        m_settleTimer->stop();
+        return;
+    }
+
+    if (!m_coalesceTimer->isActive()) {
+        m_coalesceTimer->start();
+    }
+    m_settleTimer->start();
+}
+
+void LivePreviewController::cancelPending()
+{
+    m_coalesceTimer->stop();
+    m_settleTimer->stop();
+    m_pending.clear();
+    m_requested.clear();
+    m_refined = true;
+}
+
+QMap<QString, QVariant> LivePreviewController::previewParams(const QMap<QString, QVariant>& params, int maxSamples)
+{
+    QMap<QString, QVariant> preview = params;
+    const QString samplesKey = params.contains("samples") ? "samples" : "num_samples";
+    if (params.contains(samplesKey)) {
+        bool ok = false;
+        const int samples = params.value(samplesKey).toInt(&ok);
+        if (ok && samples > maxSamples) {
+            preview[samplesKey] = maxSamples;
+        }
+    }
+    return preview;
+}
+
+void LivePreviewController::onCoalesceTimeout()
+{
+    if (m_pending == m_requested) {
+        return;
+    }
+    m_requested = m_pending;
+
+    const QMap<QString, QVariant> preview = previewParams(m_pending, m_previewSamples);
+    if (preview == m_pending) {
+        // Small enough to run in full straight away
+        m_refined = true;
+        m_settleTimer->stop();
+        emit refineRequested(m_pending);
+        return;
+    }
+    m_refined = false;
+    emit previewRequested(preview);
+}
+
+void LivePreviewController::onSettleTimeout()
+{
+    if (m_refined && m_pending == m_requested) {
+        return;
+    }
+    m_coalesceTimer->stop();
+    m_requested = m_pending;
+    m_refined = true;
+    emit refineRequested(m_pending);
+}
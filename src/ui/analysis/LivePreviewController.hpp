@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+
+class QTimer;
+
+// Turns a stream of parameter edits (slider scrubbing, spin box typing) into
+// the runs a live preview needs:
+//
+// - Edits are coalesced for COALESCE_MS, then previewRequested() asks for a
+//   low-resolution run of the latest values. While edits keep coming a
+//   preview goes out every COALESCE_MS, so the plot follows the cursor.
+// - Once edits stop for SETTLE_MS, refineRequested() asks for the run at the
+//   requested resolution.
+//
+// The receiver cancels whatever run is still in flight before starting the
+// requested one; only the latest values matter. Disabled by default.
+class LivePreviewController : public QObject {
+    Q_OBJECT
+
+public:
+    explicit LivePreviewController(QObject* parent = nullptr);
+    ~LivePreviewController() override;
+
+    // Disabling drops any pending preview and refinement
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    // Sample count of preview runs (clamped to at least MIN_PREVIEW_SAMPLES)
+    void setPreviewSamples(int samples);
+    int previewSamples() const { return m_previewSamples; }
+
+    // Feed an edit; ignored while disabled or when nothing changed since
+    // the last requested run
+    void parametersEdited(const QMap<QString, QVariant>& params);
+
+    // Drop pending requests (an explicit Run supersedes them)
+    void cancelPending();
+
+    // params with the sample count ("samples" or "num_samples") capped at
+    // maxSamples; unchanged if already at or below it
+    static QMap<QString, QVariant> previewParams(const QMap<QString, QVariant>& params, int maxSamples);
+
+    // 40 previews/s at most while scrubbing
+    static constexpr int COALESCE_MS = 25;
+    static constexpr int SETTLE_MS = 250;
+    static constexpr int DEFAULT_PREVIEW_SAMPLES = 4096;
+    static constexpr int MIN_PREVIEW_SAMPLES = 256;
+
+signals:
+    void previewRequested(const QMap<QString, QVariant>& params);
+    void refineRequested(const QMap<QString, QVariant>& params);
+
+private:
+    void onCoalesceTimeout();
+    void onSettleTimeout();
+
+    bool m_enabled = false;
+    int m_previewSamples = DEFAULT_PREVIEW_SAMPLES;
+    QTimer* m_coalesceTimer;
+    QTimer* m_settleTimer;
+    QMap<QString, QVariant> m_pending;    // Latest edit
+    QMap<QString, QVariant> m_requested;  // Values of the last requested run
+    bool m_refined = true;                // m_requested ran at full resolution
+};
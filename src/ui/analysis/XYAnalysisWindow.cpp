@@ -1,14 +1,30 @@
 #include "ui/analysis/XYAnalysisWindow.hpp"
 #include "ui/analysis/AnalysisWindowManager.hpp"
+#include "ui/analysis/LivePreviewController.hpp"
 #include "plot/XYPlotViewGraphs.hpp"
 #include "ui/widgets/FeatureParameterPanel.hpp"
 #include "features/FeatureRegistry.hpp"
+#include "analysis/AnalysisScheduler.hpp"
 #include "analysis/AnalysisWorker.hpp"
+#include "analysis/DeltaBaseSlot.hpp"
+#include "analysis/SweepDataset.hpp"
+#include "analysis/SweepPlan.hpp"
 #include "analysis/demo/XYSineDemo.hpp"
 #include "ui/themes/ThemeManager.h"
 // TODO(Phase 3+): Re-enable license checks when LicenseManager is available
 // #include "app/LicenseManager.h"
 #include <QToolBar>
+#include <QActionGroup>
+#include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFile>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QSettings>
+#include <QSpinBox>
+#include <QProgressBar>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QWidget>
@@ -16,13 +32,13 @@
 #include <QMessageBox>
 #include <QCloseEvent>
 #include <QShowEvent>
-#include <QThread>
 #include <QPointF>
 #include <QDebug>
 #include <QLayout>
 #include <QLayoutItem>
 #include <QHideEvent>
 #include <QEvent>
+#include <algorithm>
 
 XYAnalysisWindow::XYAnalysisWindow(QWidget* parent)
     : QMainWindow(nullptr)  // S4.3 shape: true top-level, no Qt parent
@@ -31,9 +47,15 @@ XYAnalysisWindow::XYAnalysisWindow(QWidget* parent)
     , m_runAction(nullptr)
     , m_cancelAction(nullptr)
     , m_closeAction(nullptr)
+    , m_livePreviewAction(nullptr)
+    , m_sweepAction(nullptr)
+    , m_exportSweepAction(nullptr)
+    , m_runModeGroup(nullptr)
+    , m_progressBar(nullptr)
+    , m_progressAction(nullptr)
     , m_parameterPanel(nullptr)
-    , m_workerThread(nullptr)
-    , m_worker(nullptr)
+    , m_livePreview(new LivePreviewController(this))
+    , m_deltaBase(std::make_shared<DeltaBaseSlot>())
 {
     setWindowTitle(tr("XY Plot Analysis"));
     resize(900, 600);
@@ -50,6 +72,17 @@ XYAnalysisWindow::XYAnalysisWindow(QWidget* parent)
     // Set plot view as central widget initially (parameter panel will be added later if needed)
     setCentralWidget(m_plotView->widget());
     
+    // Re-plot for the visible range whenever zoom/pan settles
+    m_plotView->setViewportChangedCallback([this](double xMin, double xMax, int pixelWidth) {
+        onViewportChanged(xMin, xMax, pixelWidth);
+    });
+    
+    // Live preview runs replace each other; see startLiveRun()
+    connect(m_livePreview, &LivePreviewController::previewRequested, this,
+            [this](const QMap<QString, QVariant>& params) { startLiveRun(params, true); });
+    connect(m_livePreview, &LivePreviewController::refineRequested, this,
+            [this](const QMap<QString, QVariant>& params) { startLiveRun(params, false); });
+    
     // Setup toolbar
     setupToolbar();
     
@@ -69,7 +102,7 @@ XYAnalysisWindow::XYAnalysisWindow(QWidget* parent)
 
 XYAnalysisWindow::~XYAnalysisWindow()
 {
-    // Clean up worker thread if still running
+    // Cancel a job still running (never waits for it)
     cleanupWorker();
 }
 
@@ -80,6 +113,7 @@ void XYAnalysisWindow::setupToolbar()
     
     // Run action
     m_runAction = m_toolbar->addAction(tr("Run"));
+    m_runAction->setObjectName("runAction");
     m_runAction->setToolTip(tr("Run analysis"));
     connect(m_runAction, &QAction::triggered, this, &XYAnalysisWindow::onRunClicked);
     
@@ -89,6 +123,66 @@ void XYAnalysisWindow::setupToolbar()
     m_cancelAction->setVisible(false);
     connect(m_cancelAction, &QAction::triggered, this, &XYAnalysisWindow::onCancelClicked);
     
+    // Progress of the running analysis (shown while it runs)
+    m_progressBar = new QProgressBar(m_toolbar);
+    m_progressBar->setRange(0, 100);
+    m_progressBar->setMaximumWidth(160);
+    m_progressBar->setTextVisible(true);
+    m_progressAction = m_toolbar->addWidget(m_progressBar);
+    m_progressAction->setVisible(false);
+    
+    // Live preview toggle (recompute as parameters change)
+    m_livePreviewAction = m_toolbar->addAction(tr("Live Preview"));
+    m_livePreviewAction->setToolTip(tr("Recompute while parameters are edited"));
+    m_livePreviewAction->setCheckable(true);
+    connect(m_livePreviewAction, &QAction::toggled, this, &XYAnalysisWindow::onLivePreviewToggled);
+    
+    // Parameter sweep and its CSV export
+    m_sweepAction = m_toolbar->addAction(tr("Sweep..."));
+    m_sweepAction->setObjectName("sweepAction");
+    m_sweepAction->setToolTip(tr("Run the analysis over a range of one parameter"));
+    connect(m_sweepAction, &QAction::triggered, this, &XYAnalysisWindow::onSweepClicked);
+    m_exportSweepAction = m_toolbar->addAction(tr("Export Sweep..."));
+    m_exportSweepAction->setObjectName("exportSweepAction");
+    m_exportSweepAction->setToolTip(tr("Save the last sweep as CSV"));
+    m_exportSweepAction->setEnabled(false);
+    connect(m_exportSweepAction, &QAction::triggered, this, &XYAnalysisWindow::onExportSweepClicked);
+    
+    m_toolbar->addSeparator();
+    
+    // Where runs compute; the last pick is the default of new windows
+    m_runModeGroup = new QActionGroup(this);
+    m_runModeGroup->setExclusive(true);
+    const struct {
+        AnalysisRunMode mode;
+        const char* name;
+        QString text;
+        QString toolTip;
+    } modes[] = {
+        {AnalysisRunMode::LocalOnly, "runModeLocal", tr("Local"), tr("Compute on this machine")},
+        {AnalysisRunMode::RemoteOnly, "runModeRemote", tr("Remote"), tr("Compute on the Bedrock server")},
+        {AnalysisRunMode::Auto, "runModeAuto", tr("Auto"), tr("Compute wherever it is expected to finish first")},
+    };
+    for (const auto& entry : modes) {
+        QAction* action = m_toolbar->addAction(entry.text);
+        action->setObjectName(entry.name);
+        action->setToolTip(entry.toolTip);
+        action->setCheckable(true);
+        action->setData(static_cast<int>(entry.mode));
+        m_runModeGroup->addAction(action);
+    }
+    connect(m_runModeGroup, &QActionGroup::triggered, this, &XYAnalysisWindow::onRunModeTriggered);
+    
+    QSettings settings;
+    const QString saved = settings.value(RUN_MODE_SETTING).toString();
+    if (saved == QLatin1String("remote")) {
+        setRunMode(AnalysisRunMode::RemoteOnly);
+    } else if (saved == QLatin1String("auto")) {
+        setRunMode(AnalysisRunMode::Auto);
+    } else {
+        setRunMode(AnalysisRunMode::LocalOnly);
+    }
+    
     m_toolbar->addSeparator();
     
     // Close action
@@ -175,6 +269,8 @@ void XYAnalysisWindow::setupParameterPanel(const QString& featureId)
     // Create parameter panel with feature descriptor
     m_parameterPanel = new FeatureParameterPanel(*desc, splitter);
     splitter->addWidget(m_parameterPanel);
+    connect(m_parameterPanel, &FeatureParameterPanel::parametersChanged,
+            this, &XYAnalysisWindow::onParametersChanged);
     
 #ifndef NDEBUG
     if (qEnvironmentVariableIsSet("PHOENIX_DEBUG_UI_LOG")) {
@@ -221,8 +317,8 @@ void XYAnalysisWindow::onRunClicked()
         return;
     }
     
-    // Prevent double-click spam
-    if (m_workerThread && m_workerThread->isRunning()) {
+    // Prevent double-click spam (a live-preview run is simply replaced)
+    if (m_worker && !m_liveRun) {
         return;
     }
     
@@ -250,29 +346,136 @@ void XYAnalysisWindow::onRunClicked()
         }
     }
     
-    // Clean up any existing worker
+    // This run supersedes pending live-preview runs
+    m_livePreview->cancelPending();
+    startRun(params);
+    
+    // Disable Run button, show Cancel button
+    if (m_runAction) {
+        m_runAction->setEnabled(false);
+    }
+    if (m_cancelAction) {
+        m_cancelAction->setEnabled(true);
+        m_cancelAction->setVisible(true);
+    }
+    if (m_progressBar) {
+        m_progressBar->setValue(0);
+        m_progressAction->setVisible(true);
+    }
+}
+
+void XYAnalysisWindow::startRun(QMap<QString, QVariant> params, bool preview)
+{
+    // Clean up any existing worker (including a range refinement)
     cleanupWorker();
+    m_refining = false;
+    m_liveRun = false;
+    m_sweepRun = false;
+    m_previewRun = preview;
+    m_pendingViewport.reset();
+    m_lastParams = params;
+    m_resultMode = m_runMode;
+    m_fullResult = XYSineResult();
     
-    // Create worker thread
-    m_workerThread = new QThread(this);
-    m_worker = new AnalysisWorker();
+    // Remote results come back as an overview sized to the plot; zooming
+    // refines them with range queries
+    m_overviewPixels = m_plotView ? m_plotView->plotPixelWidth() : 0;
+    if (m_resultMode == AnalysisRunMode::RemoteOnly && m_overviewPixels > 0) {
+        params[Decimation::kViewPixelsParam] = m_overviewPixels;
+    }
     
-    // Move worker to thread
-    m_worker->moveToThread(m_workerThread);
+    startWorker(params);
+}
+
+void XYAnalysisWindow::startLiveRun(const QMap<QString, QVariant>& params, bool preview)
+{
+    // Values mid-edit may be invalid; Run reports them, the preview waits
+    if (!m_parameterPanel || !m_parameterPanel->isValid()) {
+        return;
+    }
     
-    // Set parameters
-    m_worker->setParameters(m_currentFeatureId, params);
+    // Cancels the run in flight, whatever it was: its values are stale
+    startRun(params, preview);
+    m_liveRun = true;
     
-    // Connect signals (use QueuedConnection for cross-thread safety)
-    connect(m_workerThread, &QThread::started, m_worker, &AnalysisWorker::run);
-    connect(m_worker, &AnalysisWorker::finished, this, &XYAnalysisWindow::onWorkerFinished, Qt::QueuedConnection);
-    connect(m_worker, &AnalysisWorker::cancelled, this, &XYAnalysisWindow::onWorkerCancelled, Qt::QueuedConnection);
+    // An explicit run this replaced gives the toolbar back
+    if (m_runAction) {
+        m_runAction->setEnabled(true);
+    }
+    if (m_cancelAction) {
+        m_cancelAction->setVisible(false);
+    }
+    if (m_progressAction) {
+        m_progressAction->setVisible(false);
+    }
+}
+
+void XYAnalysisWindow::setLivePreviewEnabled(bool enabled)
+{
+    if (m_livePreviewAction) {
+        m_livePreviewAction->setChecked(enabled);
+    }
+}
+
+bool XYAnalysisWindow::isLivePreviewEnabled() const
+{
+    return m_livePreview->isEnabled();
+}
+
+void XYAnalysisWindow::setRunMode(AnalysisRunMode mode)
+{
+    // Takes effect with the next run; the running one keeps its mode
+    m_runMode = mode;
+    if (m_runModeGroup) {
+        for (QAction* action : m_runModeGroup->actions()) {
+            action->setChecked(action->data().toInt() == static_cast<int>(mode));
+        }
+    }
+}
+
+void XYAnalysisWindow::onRunModeTriggered(QAction* action)
+{
+    const auto mode = static_cast<AnalysisRunMode>(action->data().toInt());
+    setRunMode(mode);
     
-    // Cleanup connections
-    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
-    connect(m_workerThread, &QThread::finished, m_workerThread, &QObject::deleteLater);
+    QSettings settings;
+    settings.setValue(RUN_MODE_SETTING, mode == AnalysisRunMode::RemoteOnly ? QStringLiteral("remote")
+                                        : mode == AnalysisRunMode::Auto     ? QStringLiteral("auto")
+                                                                            : QStringLiteral("local"));
+}
+
+bool XYAnalysisWindow::startSweep(const SweepAxis& axis, QString* outError)
+{
+    const FeatureDescriptor* feature = FeatureRegistry::instance().getFeature(m_currentFeatureId);
+    if (!feature || !m_parameterPanel) {
+        if (outError) {
+            *outError = tr("No feature to sweep");
+        }
+        return false;
+    }
+    auto plan = std::make_shared<SweepPlan>(*feature, m_parameterPanel->parameters());
+    plan->addAxis(axis);
+    if (!plan->validate(outError)) {
+        return false;
+    }
+    
+    // Supersedes whatever runs, like Run
+    m_livePreview->cancelPending();
+    cleanupWorker();
+    m_refining = false;
+    m_liveRun = false;
+    m_previewRun = false;
+    m_pendingViewport.reset();
+    m_resultMode = m_runMode;
+    
+    // The job fills its own dataset: a cancelled sweep may still be writing
+    // to the one before. The last sweep's points carry over if it matches.
+    m_sweepJob = m_sweep && m_sweep->matches(*plan) ? std::make_shared<SweepDataset>(*m_sweep)
+                                                    : std::make_shared<SweepDataset>(*plan);
+    m_sweepPlan = std::move(plan);
+    m_sweepRun = true;
+    startWorker(m_sweepPlan->fixedParams());
     
-    // Disable Run button, show Cancel button
     if (m_runAction) {
         m_runAction->setEnabled(false);
     }
@@ -280,16 +483,183 @@ void XYAnalysisWindow::onRunClicked()
         m_cancelAction->setEnabled(true);
         m_cancelAction->setVisible(true);
     }
+    if (m_progressBar) {
+        m_progressBar->setValue(0);
+        m_progressAction->setVisible(true);
+    }
+    return true;
+}
+
+bool XYAnalysisWindow::exportSweep(const QString& path, QString* outError) const
+{
+    if (!m_sweep || m_sweep->doneCount() == 0) {
+        if (outError) {
+            *outError = tr("No sweep results to export");
+        }
+        return false;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (outError) {
+            *outError = file.errorString();
+        }
+        return false;
+    }
+    return m_sweep->exportCsv(&file, outError);
+}
+
+void XYAnalysisWindow::onSweepClicked()
+{
+    const FeatureDescriptor* feature = FeatureRegistry::instance().getFeature(m_currentFeatureId);
+    if (!feature) {
+        return;
+    }
+    
+    // One numeric parameter from first to last value
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("Parameter Sweep"));
+    auto* layout = new QFormLayout(&dialog);
+    auto* param = new QComboBox(&dialog);
+    auto* first = new QDoubleSpinBox(&dialog);
+    auto* last = new QDoubleSpinBox(&dialog);
+    auto* steps = new QSpinBox(&dialog);
+    first->setDecimals(4);
+    last->setDecimals(4);
+    steps->setRange(2, 1000);
+    steps->setValue(10);
+    const QList<ParamSpec> specs = feature->params();
+    for (const ParamSpec& spec : specs) {
+        if (spec.type() == ParamSpec::Type::Int || spec.type() == ParamSpec::Type::Double) {
+            param->addItem(spec.displayName(), spec.name());
+        }
+    }
+    if (param->count() == 0) {
+        return;
+    }
+    auto limit = [feature, param, first, last]() {
+        const ParamSpec* spec = feature->findParam(param->currentData().toString());
+        const double min = spec && spec->minValue().isValid() ? spec->minValue().toDouble() : -1e9;
+        const double max = spec && spec->maxValue().isValid() ? spec->maxValue().toDouble() : 1e9;
+        first->setRange(min, max);
+        last->setRange(min, max);
+        first->setValue(min);
+        last->setValue(max);
+    };
+    limit();
+    connect(param, QOverload<int>::of(&QComboBox::currentIndexChanged), &dialog, limit);
+    layout->addRow(tr("Parameter:"), param);
+    layout->addRow(tr("From:"), first);
+    layout->addRow(tr("To:"), last);
+    layout->addRow(tr("Steps:"), steps);
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    layout->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    
+    QString error;
+    const SweepAxis axis = SweepAxis::range(param->currentData().toString(), first->value(), last->value(),
+                                            static_cast<size_t>(steps->value()));
+    if (!startSweep(axis, &error)) {
+        QMessageBox::warning(this, tr("Invalid Sweep"), error);
+    }
+}
+
+void XYAnalysisWindow::onExportSweepClicked()
+{
+    const QString path = QFileDialog::getSaveFileName(this, tr("Export Sweep"), QString(),
+                                                      tr("CSV files (*.csv)"));
+    if (path.isEmpty()) {
+        return;
+    }
+    QString error;
+    if (!exportSweep(path, &error)) {
+        QMessageBox::warning(this, tr("Export Failed"), error);
+    }
+}
+
+void XYAnalysisWindow::onLivePreviewToggled(bool enabled)
+{
+    m_livePreview->setEnabled(enabled);
+    
+    // Show the current values right away
+    if (enabled && m_parameterPanel) {
+        onParametersChanged(m_parameterPanel->parameters());
+    }
+}
+
+void XYAnalysisWindow::onParametersChanged(const QMap<QString, QVariant>& params)
+{
+    if (!m_livePreview->isEnabled()) {
+        return;
+    }
+    // Previews resolve about two samples per pixel of the plot
+    const int pixels = m_plotView ? m_plotView->plotPixelWidth() : 0;
+    m_livePreview->setPreviewSamples(std::max(LivePreviewController::DEFAULT_PREVIEW_SAMPLES, 2 * pixels));
+    m_livePreview->parametersEdited(params);
+}
+
+void XYAnalysisWindow::startWorker(const QMap<QString, QVariant>& params)
+{
+    // The job owns the worker; it is deleted (on this thread) once the job
+    // has run, or when the scheduler drops the job unstarted
+    std::shared_ptr<AnalysisWorker> worker(new AnalysisWorker(), [](AnalysisWorker* w) { w->deleteLater(); });
+    worker->setParameters(m_currentFeatureId, params);
+    worker->setRunMode(m_resultMode);
+    worker->setDeltaBaseSlot(m_deltaBase);
+    worker->setCacheResults(!m_previewRun);
+    if (m_sweepRun) {
+        worker->setSweep(m_sweepPlan, m_sweepJob);
+    }
+    m_worker = worker.get();
     
-    // Start thread
-    m_workerThread->start();
+    // Signals arrive queued from the pool thread; a generation check drops
+    // those of a job this window has since cancelled or replaced
+    const quint64 run = ++m_runGeneration;
+    connect(worker.get(), &AnalysisWorker::finished, this,
+            [this, run](bool success, const QVariant& result, const QString& error) {
+        if (run == m_runGeneration) {
+            onWorkerFinished(success, result, error);
+        }
+    }, Qt::QueuedConnection);
+    connect(worker.get(), &AnalysisWorker::cancelled, this, [this, run]() {
+        if (run == m_runGeneration) {
+            onWorkerCancelled();
+        }
+    }, Qt::QueuedConnection);
+    connect(worker.get(), &AnalysisWorker::partialResult, this,
+            [this, run](const QVariant& chunk, qulonglong offset, qulonglong totalSamples) {
+        if (run == m_runGeneration) {
+            onWorkerPartialResult(chunk, offset, totalSamples);
+        }
+    }, Qt::QueuedConnection);
+    connect(worker.get(), &AnalysisWorker::progress, this, [this, run](double fraction) {
+        if (run == m_runGeneration) {
+            onWorkerProgress(fraction);
+        }
+    }, Qt::QueuedConnection);
+    
+    // Cancelling this window's jobs (cleanupWorker) reaches the executor;
+    // sweeps are bulk work and queue behind interactive runs
+    const JobPriority priority = m_sweepRun ? JobPriority::Batch : JobPriority::Interactive;
+    AnalysisScheduler::instance().submit(AnalysisScheduler::ownerOf(this), priority,
+                                         [worker](const CancellationToken& token) {
+        const uint64_t callback = token.onCancel([raw = worker.get()]() { raw->requestCancel(); });
+        worker->run();
+        token.removeCallback(callback);
+    });
 }
 
 void XYAnalysisWindow::onCancelClicked()
 {
-    if (m_worker) {
-        m_worker->requestCancel();
+    if (!m_worker) {
+        return;
     }
+    // Back to idle at once; the job winds down in the background
+    cleanupWorker();
+    onWorkerCancelled();
 }
 
 void XYAnalysisWindow::onCloseClicked()
@@ -299,7 +669,53 @@ void XYAnalysisWindow::onCloseClicked()
 
 void XYAnalysisWindow::onWorkerFinished(bool success, const QVariant& result, const QString& error)
 {
-    // Re-enable Run button, hide Cancel button
+    // The final result supersedes any streamed preview
+    m_streamed = XYSineResult();
+    
+    // Sweeps leave the plot alone; their points are exported
+    if (m_sweepRun) {
+        m_sweepRun = false;
+        m_sweep = std::move(m_sweepJob);
+        if (m_exportSweepAction) {
+            m_exportSweepAction->setEnabled(m_sweep && m_sweep->doneCount() > 0);
+        }
+        if (m_runAction) {
+            m_runAction->setEnabled(true);
+        }
+        if (m_cancelAction) {
+            m_cancelAction->setVisible(false);
+            m_cancelAction->setEnabled(true);
+        }
+        if (m_progressAction) {
+            m_progressAction->setVisible(false);
+        }
+        m_worker = nullptr;
+        if (!success && !error.isEmpty()) {
+            QMessageBox::warning(this, tr("Sweep Incomplete"), error);
+        }
+        return;
+    }
+    
+    // Range refinements only replace the visible points
+    if (m_refining) {
+        m_refining = false;
+        if (!success) {
+            qWarning() << "XYAnalysisWindow::onWorkerFinished: Range refinement failed:" << error;
+        } else if (m_plotView && m_currentFeatureId == "xy_sine") {
+            XYSineResult xyResult = result.value<XYSineResult>();
+            std::vector<QPointF> points;
+            points.reserve(xyResult.x.size());
+            for (size_t i = 0; i < xyResult.x.size(); ++i) {
+                points.emplace_back(xyResult.x[i], xyResult.y[i]);
+            }
+            m_plotView->setVisibleData(points);
+        }
+        m_worker = nullptr;  // Job done; the scheduler deletes the worker
+        startPendingRefinement();
+        return;
+    }
+    
+    // Re-enable Run button, hide Cancel button and progress
     if (m_runAction) {
         m_runAction->setEnabled(true);
     }
@@ -307,19 +723,44 @@ void XYAnalysisWindow::onWorkerFinished(bool success, const QVariant& result, co
         m_cancelAction->setVisible(false);
         m_cancelAction->setEnabled(true);  // Re-enable for next run
     }
+    if (m_progressAction) {
+        m_progressAction->setVisible(false);
+    }
     
-    // Handle error
+    // Handle error (live-preview failures must not interrupt editing)
+    const bool liveRun = m_liveRun;
+    m_liveRun = false;
     if (!success) {
-        if (!error.isEmpty()) {
+        if (liveRun) {
+            qWarning() << "XYAnalysisWindow::onWorkerFinished: Live preview failed:" << error;
+        } else if (!error.isEmpty()) {
             QMessageBox::warning(this, tr("Computation Failed"), error);
         }
-        cleanupWorker();
+        m_worker = nullptr;
         return;
     }
     
     // Handle success - update plot
     if (m_currentFeatureId == "xy_sine") {
         XYSineResult xyResult = result.value<XYSineResult>();
+        if (!xyResult.x.empty()) {
+            m_resultXMin = xyResult.x.front();
+            m_resultXMax = xyResult.x.back();
+        }
+        
+        // Local (and Auto) results are kept whole and plotted decimated to
+        // the plot width; remote results already arrive as an overview
+        if (m_resultMode != AnalysisRunMode::RemoteOnly) {
+            m_fullResult = xyResult;
+            Decimation::Viewport overview;
+            overview.xMin = m_resultXMin;
+            overview.xMax = m_resultXMax;
+            overview.pixelWidth = m_plotView ? m_plotView->plotPixelWidth() : 0;
+            XYSineResult reduced;
+            if (Decimation::decimate(m_fullResult, overview, reduced)) {
+                xyResult = std::move(reduced);
+            }
+        }
         
         // Convert to QPointF vector
         std::vector<QPointF> points;
@@ -337,12 +778,129 @@ void XYAnalysisWindow::onWorkerFinished(bool success, const QVariant& result, co
         }
     }
     
-    cleanupWorker();
+    m_worker = nullptr;
+    startPendingRefinement();
+}
+
+void XYAnalysisWindow::onViewportChanged(double xMin, double xMax, int pixelWidth)
+{
+    if (m_currentFeatureId != "xy_sine" || !m_plotView) {
+        return;
+    }
+    
+    Decimation::Viewport viewport;
+    viewport.xMin = xMin;
+    viewport.xMax = xMax;
+    viewport.pixelWidth = pixelWidth;
+    
+    // Local result: decimate in place, constant render cost at any zoom
+    if (!m_fullResult.x.empty()) {
+        XYSineResult reduced;
+        if (Decimation::decimate(m_fullResult, viewport, reduced)) {
+            std::vector<QPointF> points;
+            points.reserve(reduced.x.size());
+            for (size_t i = 0; i < reduced.x.size(); ++i) {
+                points.emplace_back(reduced.x[i], reduced.y[i]);
+            }
+            m_plotView->setVisibleData(points);
+        }
+        return;
+    }
+    
+    // Remote result: ask Bedrock for the visible range, unless the overview
+    // already covers it at this width
+    if (m_resultMode != AnalysisRunMode::RemoteOnly || m_lastParams.isEmpty()) {
+        return;
+    }
+    if (xMin <= m_resultXMin && xMax >= m_resultXMax && pixelWidth == m_overviewPixels) {
+        return;
+    }
+    if (m_worker) {
+        // One refinement at a time; only the latest viewport matters
+        m_pendingViewport = viewport;
+        return;
+    }
+    
+    QMap<QString, QVariant> params = m_lastParams;
+    params[Decimation::kViewXMinParam] = xMin;
+    params[Decimation::kViewXMaxParam] = xMax;
+    params[Decimation::kViewPixelsParam] = pixelWidth;
+    m_refining = true;
+    startWorker(params);
+}
+
+void XYAnalysisWindow::startPendingRefinement()
+{
+    if (!m_pendingViewport) {
+        return;
+    }
+    const Decimation::Viewport viewport = *m_pendingViewport;
+    m_pendingViewport.reset();
+    onViewportChanged(viewport.xMin, viewport.xMax, viewport.pixelWidth);
+}
+
+void XYAnalysisWindow::onWorkerPartialResult(const QVariant& chunk, qulonglong offset, qulonglong totalSamples)
+{
+    if (m_currentFeatureId != "xy_sine" || !m_plotView || m_refining) {
+        return;
+    }
+    
+    // Chunks arrive in order; a new stream starts at offset 0
+    if (offset == 0) {
+        m_streamed.x.clear();
+        m_streamed.y.clear();
+        m_streamed.x.reserve(static_cast<size_t>(totalSamples));
+        m_streamed.y.reserve(static_cast<size_t>(totalSamples));
+        m_streamReplot.invalidate();
+    } else if (offset != m_streamed.x.size()) {
+        qWarning() << "XYAnalysisWindow::onWorkerPartialResult: Out-of-sequence chunk at" << offset;
+        return;
+    }
+    
+    XYSineResult xyChunk = chunk.value<XYSineResult>();
+    const size_t count = std::min(xyChunk.x.size(), xyChunk.y.size());
+    m_streamed.x.insert(m_streamed.x.end(), xyChunk.x.begin(), xyChunk.x.begin() + count);
+    m_streamed.y.insert(m_streamed.y.end(), xyChunk.y.begin(), xyChunk.y.begin() + count);
+    
+    // Replot at most every STREAM_REPLOT_MS, reduced to the plot width: the
+    // cost per replot stays bounded however many chunks arrive
+    if (m_streamReplot.isValid() && m_streamReplot.elapsed() < STREAM_REPLOT_MS) {
+        return;
+    }
+    m_streamReplot.start();
+    
+    Decimation::Viewport received;
+    received.xMin = m_streamed.x.front();
+    received.xMax = m_streamed.x.back();
+    received.pixelWidth = m_plotView->plotPixelWidth();
+    XYSineResult reduced;
+    const XYSineResult& shown = Decimation::decimate(m_streamed, received, reduced) ? reduced : m_streamed;
+    std::vector<QPointF> points;
+    points.reserve(shown.x.size());
+    for (size_t i = 0; i < shown.x.size(); ++i) {
+        points.emplace_back(shown.x[i], shown.y[i]);
+    }
+    m_plotView->setData(points);
+}
+
+void XYAnalysisWindow::onWorkerProgress(double fraction)
+{
+    // Range refinements and live previews run in the background; only
+    // explicit runs show progress
+    if (m_refining || m_liveRun || !m_progressBar) {
+        return;
+    }
+    m_progressBar->setValue(qRound(fraction * 100.0));
 }
 
 void XYAnalysisWindow::onWorkerCancelled()
 {
-    // Re-enable Run button, hide Cancel button
+    m_refining = false;
+    m_liveRun = false;
+    m_sweepRun = false;
+    m_pendingViewport.reset();
+    
+    // Re-enable Run button, hide Cancel button and progress
     if (m_runAction) {
         m_runAction->setEnabled(true);
     }
@@ -350,25 +908,22 @@ void XYAnalysisWindow::onWorkerCancelled()
         m_cancelAction->setVisible(false);
         m_cancelAction->setEnabled(true);
     }
+    if (m_progressAction) {
+        m_progressAction->setVisible(false);
+    }
     
-    cleanupWorker();
+    m_worker = nullptr;
 }
 
 void XYAnalysisWindow::cleanupWorker()
 {
-    if (m_workerThread) {
-        if (m_workerThread->isRunning()) {
-            m_workerThread->quit();
-            m_workerThread->wait(1000);  // Wait up to 1 second
-        }
-        if (m_workerThread->isRunning()) {
-            qWarning() << "XYAnalysisWindow::cleanupWorker: Thread did not stop, terminating";
-            m_workerThread->terminate();
-            m_workerThread->wait(1000);
-        }
-        m_workerThread = nullptr;
+    // Never blocks: a job still queued is dropped, a running one is
+    // cancelled and its remaining signals are ignored
+    if (m_worker) {
+        ++m_runGeneration;
+        AnalysisScheduler::instance().cancelOwner(AnalysisScheduler::ownerOf(this));
     }
-    m_worker = nullptr;  // Will be deleted by deleteLater() connection
+    m_worker = nullptr;
 }
 
 void XYAnalysisWindow::showEvent(QShowEvent* event)
@@ -426,11 +981,7 @@ void XYAnalysisWindow::changeEvent(QEvent* event)
 void XYAnalysisWindow::closeEvent(QCloseEvent* event)
 {
     // Cancel any running analysis before closing
-    if (m_worker) {
-        m_worker->requestCancel();
-    }
-    
-    // Clean up worker thread
+    m_livePreview->setEnabled(false);
     cleanupWorker();
     
     // Unregister from window manager before closing
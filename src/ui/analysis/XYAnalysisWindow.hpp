@@ -1,13 +1,29 @@
 #pragma once
 
+#include "analysis/AnalysisWorker.hpp"
+#include "analysis/Decimation.hpp"
+#include <QElapsedTimer>
 #include <QMainWindow>
+#include <QMap>
+#include <QPointer>
+#include <QPointF>
+#include <QVariant>
 #include <memory>
+#include <optional>
+#include <vector>
 
+class DeltaBaseSlot;
+class SweepDataset;
+class SweepPlan;
+struct SweepAxis;
 class XYPlotViewGraphs;
 class QToolBar;
 class QAction;
+class QActionGroup;
+class QProgressBar;
 class QWidget;
 class FeatureParameterPanel;
+class LivePreviewController;
 class QCloseEvent;
 
 class XYAnalysisWindow : public QMainWindow {
@@ -19,6 +35,32 @@ public:
 
     void setFeature(const QString& featureId);
     
+    // Local runs keep the full result and decimate it per viewport; remote
+    // runs fetch a plot-sized overview and refine it with range queries.
+    // Auto runs may land on either path, so they are handled like local ones.
+    // Same as picking the mode on the toolbar, which also makes it the
+    // default of new windows (RUN_MODE_SETTING).
+    void setRunMode(AnalysisRunMode mode);
+    AnalysisRunMode runMode() const { return m_runMode; }
+    static constexpr const char* RUN_MODE_SETTING = "analysis/runMode";
+    
+    // Live preview: parameter edits recompute without pressing Run, first
+    // at low resolution, then in full once editing stops (see
+    // LivePreviewController). Same as toggling the toolbar action.
+    void setLivePreviewEnabled(bool enabled);
+    bool isLivePreviewEnabled() const;
+    
+    // Parameter sweep: the feature over axis, the other parameters as in the
+    // panel, on the run mode's executor in the background (same as the
+    // Sweep toolbar action). Sweeping the same plan again reruns only the
+    // points not done. False (and outError) if the plan is invalid.
+    bool startSweep(const SweepAxis& axis, QString* outError = nullptr);
+    bool isSweepRunning() const { return m_sweepRun; }
+    // Last finished sweep (nullptr before the first)
+    const SweepDataset* sweepDataset() const { return m_sweep.get(); }
+    // CSV of the last sweep (see SweepDataset::exportCsv); Export Sweep action
+    bool exportSweep(const QString& path, QString* outError = nullptr) const;
+    
     // Public access to plot view for setting data
     XYPlotViewGraphs* plotView() const { return m_plotView; }
 
@@ -34,12 +76,24 @@ private slots:
     void onCloseClicked();
     void onWorkerFinished(bool success, const QVariant& result, const QString& error);
     void onWorkerCancelled();
+    void onWorkerPartialResult(const QVariant& chunk, qulonglong offset, qulonglong totalSamples);
+    void onWorkerProgress(double fraction);
     void onThemeChanged(); // Theme sync handler
+    void onLivePreviewToggled(bool enabled);
+    void onRunModeTriggered(QAction* action);
+    void onSweepClicked();
+    void onExportSweepClicked();
+    void onParametersChanged(const QMap<QString, QVariant>& params);
 
 private:
     void setupToolbar();
     void setupParameterPanel(const QString& featureId);
     void cleanupWorker();
+    void startRun(QMap<QString, QVariant> params, bool preview = false);
+    void startLiveRun(const QMap<QString, QVariant>& params, bool preview);
+    void startWorker(const QMap<QString, QVariant>& params);
+    void onViewportChanged(double xMin, double xMax, int pixelWidth);
+    void startPendingRefinement();
     
 #ifndef NDEBUG
 public:
@@ -51,11 +105,48 @@ public:
     QAction* m_runAction;
     QAction* m_cancelAction;
     QAction* m_closeAction;
+    QAction* m_livePreviewAction;
+    QAction* m_sweepAction;
+    QAction* m_exportSweepAction;  // Enabled once a sweep has points done
+    QActionGroup* m_runModeGroup;  // Local / Remote / Auto; data() is the AnalysisRunMode
+    QProgressBar* m_progressBar;
+    QAction* m_progressAction;  // Toolbar slot of m_progressBar (toggles visibility)
     FeatureParameterPanel* m_parameterPanel;
+    LivePreviewController* m_livePreview;
     QString m_currentFeatureId;
     
-    // Worker thread infrastructure
-    QThread* m_workerThread;
-    class AnalysisWorker* m_worker;
+    // Worker of the running job (runs on the AnalysisScheduler pool, deleted
+    // by it); signals of jobs this window has given up on are ignored
+    QPointer<AnalysisWorker> m_worker;
+    quint64 m_runGeneration = 0;
+    
+    // Previous remote result, offered as the base of the next run
+    std::shared_ptr<DeltaBaseSlot> m_deltaBase;
+    
+    // Samples received so far from a streamed (chunked) result, and when
+    // they were last plotted
+    XYSineResult m_streamed;
+    QElapsedTimer m_streamReplot;
+    static constexpr qint64 STREAM_REPLOT_MS = 50;
+    
+    // Viewport refinement (see setRunMode)
+    AnalysisRunMode m_runMode = AnalysisRunMode::LocalOnly;    // Of the next run
+    AnalysisRunMode m_resultMode = AnalysisRunMode::LocalOnly; // Of the last run and its refinements
+    QMap<QString, QVariant> m_lastParams;   // Parameters of the last full run
+    XYSineResult m_fullResult;              // Last local result, undecimated
+    double m_resultXMin = 0.0;              // x extent of the last full run
+    double m_resultXMax = 0.0;
+    int m_overviewPixels = 0;               // Plot width the overview was fetched for
+    bool m_refining = false;                // Running worker is a range refinement
+    bool m_liveRun = false;                 // Running worker is a live-preview run
+    bool m_previewRun = false;              // Low-resolution preview: not worth caching
+    std::optional<Decimation::Viewport> m_pendingViewport;  // Refinement to run next
+    
+    // Sweeps: the running one fills m_sweepJob on the pool, which becomes
+    // m_sweep once it has finished
+    bool m_sweepRun = false;                      // Running worker is a sweep
+    std::shared_ptr<const SweepPlan> m_sweepPlan;
+    std::shared_ptr<SweepDataset> m_sweepJob;
+    std::shared_ptr<SweepDataset> m_sweep;
 };
 
@@ -134,7 +134,7 @@ void FeatureParameterPanelTests::testValidation()
     // Set valid values - should be valid
     QMap<QString, QVariant> validParams;
     validParams.insert("frequency", 10.0);  // Within 0.1-100.0 range
-    validParams.insert("samples", 5000);    // Within 10-100000 range
+    validParams.insert("samples", 5000);    // Within 10-50000000 range
     panel.setParameters(validParams);
     
     QVERIFY(panel.isValid());
@@ -102,7 +102,7 @@ void FeatureRegistryTests::testXYSineParams()
     QCOMPARE(samplesParam->type(), ParamSpec::Type::Int);
     QCOMPARE(samplesParam->defaultValue().toInt(), 1000);
     QCOMPARE(samplesParam->minValue().toInt(), 10);
-    QCOMPARE(samplesParam->maxValue().toInt(), 100000);
+    QCOMPARE(samplesParam->maxValue().toInt(), 50000000);
 }
 
 void FeatureRegistryTests::testInvalidLookup()
@@ -182,9 +182,9 @@ void FeatureRegistryTests::testParamValidation()
     
     QVERIFY(samplesParam->isValid(1000));
     QVERIFY(samplesParam->isValid(10));    // Min
-    QVERIFY(samplesParam->isValid(100000)); // Max
+    QVERIFY(samplesParam->isValid(50000000)); // Max
     QVERIFY(!samplesParam->isValid(5));     // Below min
-    QVERIFY(!samplesParam->isValid(200000)); // Above max
+    QVERIFY(!samplesParam->isValid(60000000)); // Above max
     QVERIFY(!samplesParam->isValid(3.14));  // Not an int
 }
 
@@ -0,0 +1,297 @@
+#include <QtTest/QtTest>
+#include "analysis/AnalysisScheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AnalysisSchedulerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testPoolSizedToHardware();
+    void testInteractiveBeforeBatch();
+    void testFairAcrossOwners();
+    void testCancelOwner();
+    void testFanOutIsStolen();
+    void testWaitLeavesQueuedJobsAlone();
+    void testOwnersDroppedWhenIdle();
+    void testFanOutSharesParentToken();
+    void testShutdownDropsQueuedJobs();
+    void testThrowingJobReachesWaiter();
+};
+
+namespace {
+
+// Occupies the single worker of a scheduler until released
+struct Gate {
+    std::promise<void> promise;
+    std::shared_future<void> future = promise.get_future().share();
+
+    AnalysisScheduler::Job job()
+    {
+        auto opened = future;
+        return [opened](const CancellationToken&) { opened.wait(); };
+    }
+};
+
+} // namespace
+
+void AnalysisSchedulerTests::testPoolSizedToHardware()
+{
+    AnalysisScheduler scheduler;
+    QVERIFY(scheduler.threadCount() >= 2);
+    QVERIFY(scheduler.threadCount() >= std::thread::hardware_concurrency());
+    QCOMPARE(AnalysisScheduler(3).threadCount(), size_t(3));
+}
+
+void AnalysisSchedulerTests::testInteractiveBeforeBatch()
+{
+    AnalysisScheduler scheduler(1);
+    Gate gate;
+    auto busy = scheduler.submit(1, JobPriority::Interactive, gate.job());
+    QTRY_COMPARE(scheduler.queued(), size_t(0));
+
+    std::mutex mutex;
+    std::string order;
+    auto record = [&](char c) {
+        return [&, c](const CancellationToken&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order += c;
+        };
+    };
+    std::vector<std::future<bool>> done;
+    for (int i = 0; i < 6; ++i) {
+        done.push_back(scheduler.submit(1, JobPriority::Batch, record('b')));
+    }
+    for (int i = 0; i < 6; ++i) {
+        done.push_back(scheduler.submit(1, JobPriority::Interactive, record('i')));
+    }
+    gate.promise.set_value();
+    for (auto& future : done) {
+        QVERIFY(future.get());
+    }
+    QVERIFY(busy.get());
+
+    // Interactive work goes first, but batch work is not starved meanwhile
+    QCOMPARE(order.size(), size_t(12));
+    const size_t lastInteractive = order.rfind('i');
+    QVERIFY(lastInteractive < 9);
+    QVERIFY(order.find('b') < lastInteractive);
+}
+
+void AnalysisSchedulerTests::testFairAcrossOwners()
+{
+    AnalysisScheduler scheduler(1);
+    Gate gate;
+    auto busy = scheduler.submit(1, JobPriority::Interactive, gate.job());
+    QTRY_COMPARE(scheduler.queued(), size_t(0));
+
+    // Window A queues many jobs before window B queues a few
+    std::mutex mutex;
+    std::string order;
+    std::vector<std::future<bool>> done;
+    for (int i = 0; i < 8; ++i) {
+        done.push_back(scheduler.submit(10, JobPriority::Interactive, [&](const CancellationToken&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order += 'A';
+        }));
+    }
+    for (int i = 0; i < 2; ++i) {
+        done.push_back(scheduler.submit(20, JobPriority::Interactive, [&](const CancellationToken&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order += 'B';
+        }));
+    }
+    gate.promise.set_value();
+    for (auto& future : done) {
+        QVERIFY(future.get());
+    }
+    QVERIFY(busy.get());
+    QCOMPARE(QString::fromStdString(order), QStringLiteral("ABABAAAAAA"));
+}
+
+void AnalysisSchedulerTests::testCancelOwner()
+{
+    AnalysisScheduler scheduler(1);
+
+    // A running job sees its token cancelled; a queued one never runs
+    std::atomic<bool> started{false};
+    std::atomic<bool> stop{false};
+    auto running = scheduler.submit(5, JobPriority::Interactive, [&](const CancellationToken& token) {
+        const uint64_t callback = token.onCancel([&]() { stop.store(true); });
+        started.store(true);
+        while (!stop.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        token.removeCallback(callback);
+    });
+    std::atomic<bool> queuedRan{false};
+    auto queued = scheduler.submit(5, JobPriority::Interactive,
+                                   [&](const CancellationToken&) { queuedRan.store(true); });
+    QTRY_VERIFY(started.load());
+
+    // Another owner is unaffected
+    std::atomic<bool> otherCancelled{true};
+    auto other = scheduler.submit(6, JobPriority::Interactive, [&](const CancellationToken& token) {
+        otherCancelled.store(token.isCancelled());
+    });
+
+    scheduler.cancelOwner(5);
+    QVERIFY(running.get());
+    QVERIFY(!queued.get());
+    QVERIFY(!queuedRan.load());
+    QVERIFY(other.get());
+    QVERIFY(!otherCancelled.load());
+
+    // Later jobs of the owner get a fresh token
+    QVERIFY(!scheduler.token(5).isCancelled());
+    std::atomic<bool> ran{false};
+    auto again = scheduler.submit(5, JobPriority::Interactive, [&](const CancellationToken& token) {
+        ran.store(!token.isCancelled());
+    });
+    QVERIFY(again.get());
+    QVERIFY(ran.load());
+}
+
+void AnalysisSchedulerTests::testFanOutIsStolen()
+{
+    AnalysisScheduler scheduler(4);
+    std::atomic<int> done{0};
+    std::atomic<int> childrenRan{0};
+    auto parent = scheduler.submit(1, JobPriority::Batch, [&](const CancellationToken&) {
+        std::vector<std::future<bool>> children;
+        for (int i = 0; i < 64; ++i) {
+            children.push_back(scheduler.submit(1, JobPriority::Batch, [&](const CancellationToken&) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                done.fetch_add(1);
+            }));
+        }
+        // Waiting inside a job helps instead of blocking a worker
+        for (auto& child : children) {
+            childrenRan.fetch_add(scheduler.wait(child) ? 1 : 0);
+        }
+    });
+    QVERIFY(scheduler.wait(parent));
+    QCOMPARE(done.load(), 64);
+    QCOMPARE(childrenRan.load(), 64);
+    QVERIFY(scheduler.stolen() > 0);
+    QCOMPARE(scheduler.completed(), uint64_t(65));
+}
+
+void AnalysisSchedulerTests::testWaitLeavesQueuedJobsAlone()
+{
+    AnalysisScheduler scheduler(1);
+    std::atomic<bool> otherRan{false};
+    std::atomic<bool> ranDuringWait{false};
+    std::atomic<bool> started{false};
+    auto parent = scheduler.submit(1, JobPriority::Interactive, [&](const CancellationToken&) {
+        started.store(true);
+        while (scheduler.queued() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        // Awaited work running outside the pool (no fan-out to help with)
+        std::promise<bool> elsewhere;
+        std::future<bool> result = elsewhere.get_future();
+        std::thread finisher([&elsewhere]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            elsewhere.set_value(true);
+        });
+        scheduler.wait(result);
+        finisher.join();
+        ranDuringWait.store(otherRan.load());
+    });
+    QTRY_VERIFY(started.load());
+
+    // Another window's job waits for the worker instead of running inside the wait
+    auto other = scheduler.submit(2, JobPriority::Interactive,
+                                  [&](const CancellationToken&) { otherRan.store(true); });
+    QVERIFY(scheduler.wait(parent));
+    QVERIFY(other.get());
+    QVERIFY(!ranDuringWait.load());
+}
+
+void AnalysisSchedulerTests::testOwnersDroppedWhenIdle()
+{
+    AnalysisScheduler scheduler(2);
+    std::vector<std::future<bool>> done;
+    for (AnalysisScheduler::OwnerId owner = 1; owner <= 50; ++owner) {
+        done.push_back(scheduler.submit(owner, JobPriority::Batch, [](const CancellationToken&) {}));
+    }
+    for (auto& future : done) {
+        QVERIFY(future.get());
+    }
+    QTRY_COMPARE(scheduler.owners(), size_t(0));
+
+    // Asking for a token does not make an owner either, and a later object
+    // at the same address starts clean
+    QVERIFY(!scheduler.token(7).isCancelled());
+    QCOMPARE(scheduler.owners(), size_t(0));
+}
+
+void AnalysisSchedulerTests::testFanOutSharesParentToken()
+{
+    AnalysisScheduler scheduler(1);
+    std::atomic<bool> childCancelled{false};
+    std::atomic<bool> parentCancelled{false};
+    std::atomic<bool> started{false};
+    auto parent = scheduler.submit(1, JobPriority::Interactive, [&](const CancellationToken& token) {
+        // Fan-out under another owner still follows the parent's cancellation
+        auto child = scheduler.submit(2, JobPriority::Batch, [&](const CancellationToken& childToken) {
+            started.store(true);
+            while (!childToken.isCancelled()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            childCancelled.store(true);
+        });
+        scheduler.wait(child);
+        parentCancelled.store(token.isCancelled());
+    });
+    QTRY_VERIFY(started.load());
+    QCOMPARE(scheduler.owners(), size_t(1));  // Fan-out adds no owner
+
+    scheduler.cancelOwner(1);
+    QVERIFY(scheduler.wait(parent));
+    QVERIFY(childCancelled.load());
+    QVERIFY(parentCancelled.load());
+}
+
+void AnalysisSchedulerTests::testShutdownDropsQueuedJobs()
+{
+    auto scheduler = std::make_unique<AnalysisScheduler>(1);
+    auto running = scheduler->submit(1, JobPriority::Interactive, [](const CancellationToken& token) {
+        while (!token.isCancelled()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    auto queued = scheduler->submit(1, JobPriority::Batch, [](const CancellationToken&) {});
+    QTRY_COMPARE(scheduler->queued(), size_t(1));
+
+    // Destruction cancels the running job instead of waiting it out
+    scheduler.reset();
+    QVERIFY(running.get());
+    QVERIFY(!queued.get());
+}
+
+void AnalysisSchedulerTests::testThrowingJobReachesWaiter()
+{
+    AnalysisScheduler scheduler(1);
+    auto thrown = scheduler.submit(1, JobPriority::Interactive, [](const CancellationToken&) {
+        throw std::runtime_error("job failed");
+    });
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, scheduler.wait(thrown));
+
+    // The worker survived and keeps serving
+    std::atomic<bool> ran{false};
+    auto next = scheduler.submit(1, JobPriority::Interactive, [&](const CancellationToken&) { ran.store(true); });
+    QVERIFY(scheduler.wait(next));
+    QVERIFY(ran.load());
+    QCOMPARE(scheduler.completed(), uint64_t(1));
+}
+
+QTEST_MAIN(AnalysisSchedulerTests)
+#include "test_analysis_scheduler.moc"
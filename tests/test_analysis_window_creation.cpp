@@ -1,7 +1,13 @@
 #include <QtTest/QtTest>
 #include "ui/analysis/XYAnalysisWindow.hpp"
 #include "plot/XYPlotViewGraphs.hpp"
+#include "analysis/SweepDataset.hpp"
+#include "analysis/SweepPlan.hpp"
+#include <QAction>
 #include <QApplication>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTemporaryDir>
 #include <QWidget>
 #include <QPointF>
 #include <vector>
@@ -10,11 +16,22 @@ class AnalysisWindowCreationTests : public QObject {
     Q_OBJECT
 
 private slots:
+    void initTestCase();
     void testWindowCreation();
     void testWindowLoadsQML();
     void testWindowWithFeature();
+    void testRunModeSelector();
+    void testAutoRunFromWindow();
+    void testSweepFromWindow();
 };
 
+void AnalysisWindowCreationTests::initTestCase()
+{
+    // Keep the run mode setting out of the user's configuration
+    QStandardPaths::setTestModeEnabled(true);
+    QSettings().remove(XYAnalysisWindow::RUN_MODE_SETTING);
+}
+
 void AnalysisWindowCreationTests::testWindowCreation()
 {
     // Create window
@@ -94,6 +111,95 @@ void AnalysisWindowCreationTests::testWindowWithFeature()
     QApplication::processEvents();
 }
 
+void AnalysisWindowCreationTests::testRunModeSelector()
+{
+    XYAnalysisWindow* window = new XYAnalysisWindow();
+    QCOMPARE(window->runMode(), AnalysisRunMode::LocalOnly);
+    
+    QAction* remote = window->findChild<QAction*>("runModeRemote");
+    QAction* autoMode = window->findChild<QAction*>("runModeAuto");
+    QVERIFY(remote && autoMode);
+    
+    // Picking a mode on the toolbar switches the window to it
+    remote->trigger();
+    QCOMPARE(window->runMode(), AnalysisRunMode::RemoteOnly);
+    autoMode->trigger();
+    QCOMPARE(window->runMode(), AnalysisRunMode::Auto);
+    
+    // setRunMode() keeps the toolbar in step
+    window->setRunMode(AnalysisRunMode::RemoteOnly);
+    QVERIFY(remote->isChecked());
+    QVERIFY(!autoMode->isChecked());
+    
+    // The last pick is the default of the next window
+    XYAnalysisWindow* next = new XYAnalysisWindow();
+    QCOMPARE(next->runMode(), AnalysisRunMode::Auto);
+    QVERIFY(next->findChild<QAction*>("runModeAuto")->isChecked());
+    
+    QSettings().remove(XYAnalysisWindow::RUN_MODE_SETTING);
+    next->deleteLater();
+    window->deleteLater();
+    QApplication::processEvents();
+}
+
+void AnalysisWindowCreationTests::testAutoRunFromWindow()
+{
+    // Without a Bedrock server, Auto runs locally
+    XYAnalysisWindow* window = new XYAnalysisWindow();
+    window->setFeature("xy_sine");
+    window->findChild<QAction*>("runModeAuto")->trigger();
+    window->show();
+    QApplication::processEvents();
+    
+    QAction* run = window->findChild<QAction*>("runAction");
+    QVERIFY(run);
+    run->trigger();
+    QVERIFY(!run->isEnabled());
+    
+    // Run comes back once the result is plotted
+    QTRY_VERIFY_WITH_TIMEOUT(run->isEnabled(), 10000);
+    
+    QSettings().remove(XYAnalysisWindow::RUN_MODE_SETTING);
+    window->close();
+    QApplication::processEvents();
+}
+
+void AnalysisWindowCreationTests::testSweepFromWindow()
+{
+    XYAnalysisWindow* window = new XYAnalysisWindow();
+    window->setFeature("xy_sine");
+    window->show();
+    QApplication::processEvents();
+    
+    QAction* exportSweep = window->findChild<QAction*>("exportSweepAction");
+    QVERIFY(window->findChild<QAction*>("sweepAction"));
+    QVERIFY(exportSweep);
+    QVERIFY(!exportSweep->isEnabled());
+    
+    // A bad axis is refused up front
+    QString error;
+    QVERIFY(!window->startSweep(SweepAxis::range("no_such_param", 1.0, 2.0, 2), &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!window->isSweepRunning());
+    
+    QVERIFY2(window->startSweep(SweepAxis::range("frequency", 1.0, 4.0, 4), &error), qPrintable(error));
+    QVERIFY(window->isSweepRunning());
+    QTRY_VERIFY_WITH_TIMEOUT(!window->isSweepRunning(), 10000);
+    
+    QVERIFY(window->sweepDataset());
+    QCOMPARE(window->sweepDataset()->doneCount(), size_t(4));
+    QVERIFY(exportSweep->isEnabled());
+    
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("sweep.csv");
+    QVERIFY2(window->exportSweep(path, &error), qPrintable(error));
+    QVERIFY(QFileInfo(path).size() > 0);
+    
+    window->close();
+    QApplication::processEvents();
+}
+
 QTEST_MAIN(AnalysisWindowCreationTests)
 #include "test_analysis_window_creation.moc"
 
@@ -0,0 +1,314 @@
+#include <QtTest/QtTest>
+#include "analysis/AutoExecutor.hpp"
+#include "analysis/ExecutionCostModel.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+
+class AutoRunModeTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testPicksFasterPath();
+    void testUnavailablePaths();
+    void testBacklogShiftsWork();
+    void testSplitsLargeBatches();
+    void testCacheHitsAreNotMeasurements();
+    void testDecisionsKeptForAudit();
+    void testExecuteRoutesAndFallsBack();
+    void testBatchSplitAndRetry();
+};
+
+namespace {
+
+using Path = ExecutionCostModel::Path;
+using std::chrono::milliseconds;
+
+const QString kFeature = QStringLiteral("xy_sine");
+
+ExecutionCostModel::RemoteLink link(double rttMs = 1.0)
+{
+    ExecutionCostModel::RemoteLink remote;
+    remote.available = true;
+    remote.rttMs = rttMs;
+    return remote;
+}
+
+// Measured rates: local and remote ns per sample (remote net of a 1 ms RTT)
+void teach(ExecutionCostModel& model, double localNs, double remoteNs)
+{
+    constexpr size_t samples = 1000000;
+    model.recordLocal(kFeature, samples, std::chrono::nanoseconds(static_cast<int64_t>(localNs * samples)));
+    model.recordRemote(kFeature, samples,
+                       milliseconds(1) + std::chrono::nanoseconds(static_cast<int64_t>(remoteNs * samples)), 1.0);
+}
+
+QMap<QString, QVariant> params(int samples)
+{
+    QMap<QString, QVariant> p;
+    p.insert("samples", samples);
+    return p;
+}
+
+// Answers at once, from its "cache" unless cached is cleared, or fails
+class FakeExecutor : public IAnalysisExecutor {
+public:
+    void execute(const QString&, const QMap<QString, QVariant>&, ProgressCallback,
+                 ResultCallback onResult, ErrorCallback onError) override
+    {
+        ++runs;
+        if (fail) {
+            if (onError) {
+                onError(QString("Bedrock unavailable"));
+            }
+            return;
+        }
+        XYSineResult result;
+        result.x = {0.0};
+        result.y = {1.0};
+        if (cached && onHit) {
+            onHit(0);
+        }
+        if (onResult) {
+            onResult(result);
+        }
+    }
+
+    void executeBatch(const QString&, const std::vector<QMap<QString, QVariant>>& paramSets,
+                      ProgressCallback, BatchItemCallback onItem) override
+    {
+        XYSineResult result;
+        result.x = {0.0};
+        result.y = {1.0};
+        items += paramSets.size();
+        for (size_t index = 0; index < paramSets.size(); ++index) {
+            if (fail) {
+                onItem(index, nullptr, QString("Bedrock unavailable"));
+                continue;
+            }
+            if (cached && onHit) {
+                onHit(index);
+            }
+            if (onItem) {
+                onItem(index, &result, QString());
+            }
+        }
+    }
+
+    void cancel() override {}
+    void setCacheHitCallback(CacheHitCallback callback) override { onHit = std::move(callback); }
+
+    bool fail = false;
+    bool cached = true;
+    CacheHitCallback onHit;
+    std::atomic<int> runs{0};
+    std::atomic<size_t> items{0};
+};
+
+} // namespace
+
+void AutoRunModeTests::testPicksFasterPath()
+{
+    ExecutionCostModel model;
+
+    // Starting estimates: small jobs stay local, the round trip dominates
+    ExecutionCostModel::Decision decision = model.decide(kFeature, 1000, 1, true, link());
+    QCOMPARE(decision.path, Path::Local);
+    QCOMPARE(decision.localItems, size_t(1));
+
+    // A fast server and a slow local machine
+    teach(model, 20.0, 0.5);
+    QCOMPARE(model.localNsPerSample(kFeature), 20.0);
+    QVERIFY(qAbs(model.remoteNsPerSample(kFeature) - 0.5) < 1e-9);
+    decision = model.decide(kFeature, 10000000, 1, true, link());
+    QCOMPARE(decision.path, Path::Remote);
+    QCOMPARE(decision.localItems, size_t(0));
+    QVERIFY(decision.remoteMs < decision.localMs);
+    QCOMPARE(decision.reason, QString("remote faster"));
+
+    // Still local below the round trip
+    QCOMPARE(model.decide(kFeature, 100, 1, true, link(5.0)).path, Path::Local);
+
+    // Measurements are per feature
+    QCOMPARE(model.localNsPerSample("other"), ExecutionCostModel::DEFAULT_LOCAL_NS_PER_SAMPLE);
+}
+
+void AutoRunModeTests::testUnavailablePaths()
+{
+    ExecutionCostModel model;
+    teach(model, 100.0, 0.1);
+
+    QCOMPARE(model.decide(kFeature, 10000000, 1, true, ExecutionCostModel::RemoteLink()).path, Path::Local);
+    const ExecutionCostModel::Decision remoteOnly = model.decide("bedrock_only", 10, 4, false, link());
+    QCOMPARE(remoteOnly.path, Path::Remote);
+    QCOMPARE(remoteOnly.reason, QString("no local implementation"));
+    // Nowhere to go: remote, which reports the error
+    QCOMPARE(model.decide("bedrock_only", 10, 1, false, ExecutionCostModel::RemoteLink()).path, Path::Remote);
+}
+
+void AutoRunModeTests::testBacklogShiftsWork()
+{
+    ExecutionCostModel model;
+    teach(model, 10.0, 12.0);
+    QCOMPARE(model.decide(kFeature, 1000000, 1, true, link()).path, Path::Local);
+
+    // Two local runs already sharing the cores
+    model.runStarted(Path::Local);
+    model.runStarted(Path::Local);
+    QCOMPARE(model.decide(kFeature, 1000000, 1, true, link()).path, Path::Remote);
+
+    // A loaded server shifts it back
+    ExecutionCostModel::RemoteLink busy = link();
+    busy.inFlight = 4;
+    QCOMPARE(model.decide(kFeature, 1000000, 1, true, busy).path, Path::Local);
+
+    model.runFinished(Path::Local);
+    model.runFinished(Path::Local);
+    QCOMPARE(model.decide(kFeature, 1000000, 1, true, link()).path, Path::Local);
+}
+
+void AutoRunModeTests::testSplitsLargeBatches()
+{
+    ExecutionCostModel model;
+    teach(model, 10.0, 10.0);
+
+    // Equal speeds: half each, finishing in about half the time
+    ExecutionCostModel::Decision decision = model.decide(kFeature, 1000000, 10, true, link());
+    QCOMPARE(decision.path, Path::Split);
+    QCOMPARE(decision.localItems, size_t(5));
+    QVERIFY(decision.splitMs < decision.localMs * 0.6);
+
+    // Three times faster remotely: a quarter stays local
+    ExecutionCostModel fresh;
+    teach(fresh, 30.0, 10.0);
+    decision = fresh.decide(kFeature, 1000000, 100, true, link());
+    QCOMPARE(decision.path, Path::Split);
+    QCOMPARE(decision.localItems, size_t(25));
+
+    // Single requests are never split
+    QVERIFY(fresh.decide(kFeature, 100000000, 1, true, link()).path != Path::Split);
+}
+
+void AutoRunModeTests::testCacheHitsAreNotMeasurements()
+{
+    ExecutionCostModel model;
+    FakeExecutor local;
+    FakeExecutor remote;
+    AutoExecutor executor(&local, &remote, [](const QString&) { return ExecutionCostModel::RemoteLink(); },
+                          &model);
+
+    // Runs and batch items the executor reports as cache hits are not timed
+    executor.execute(kFeature, params(1000000), nullptr, nullptr, nullptr);
+    executor.executeBatch(kFeature, std::vector<QMap<QString, QVariant>>(4, params(1000000)), nullptr, nullptr);
+    QCOMPARE(local.runs.load(), 1);
+    QCOMPARE(local.items.load(), size_t(4));
+    QCOMPARE(model.localNsPerSample(kFeature), ExecutionCostModel::DEFAULT_LOCAL_NS_PER_SAMPLE);
+
+    // Computed ones are, however fast
+    local.cached = false;
+    executor.execute(kFeature, params(1000000), nullptr, nullptr, nullptr);
+    QVERIFY(model.localNsPerSample(kFeature) < ExecutionCostModel::DEFAULT_LOCAL_NS_PER_SAMPLE);
+
+    // Runs move the average, newest weighted by SMOOTHING
+    ExecutionCostModel measured;
+    measured.recordLocal(kFeature, 1000000, milliseconds(5));
+    QCOMPARE(measured.localNsPerSample(kFeature), 5.0);
+    measured.recordLocal(kFeature, 1000000, milliseconds(15));
+    QVERIFY(qAbs(measured.localNsPerSample(kFeature) - 7.0) < 1e-9);
+}
+
+void AutoRunModeTests::testDecisionsKeptForAudit()
+{
+    ExecutionCostModel model;
+    for (size_t i = 0; i < ExecutionCostModel::KEPT_DECISIONS + 10; ++i) {
+        model.decide(kFeature, 1000 + i, 1, true, link());
+    }
+    const std::vector<ExecutionCostModel::Decision> decisions = model.recentDecisions();
+    QCOMPARE(decisions.size(), ExecutionCostModel::KEPT_DECISIONS);
+    QCOMPARE(decisions.back().samples, size_t(1000 + ExecutionCostModel::KEPT_DECISIONS + 9));
+    QCOMPARE(decisions.back().featureId, kFeature);
+    QVERIFY(!decisions.back().reason.isEmpty());
+}
+
+void AutoRunModeTests::testExecuteRoutesAndFallsBack()
+{
+    ExecutionCostModel model;
+    teach(model, 20.0, 0.5);
+    FakeExecutor local;
+    FakeExecutor remote;
+    bool remoteAvailable = true;
+    AutoExecutor executor(&local, &remote,
+                          [&](const QString&) {
+                              return remoteAvailable ? link() : ExecutionCostModel::RemoteLink();
+                          },
+                          &model);
+
+    int results = 0;
+    QStringList errors;
+    auto onResult = [&](const XYSineResult&) { ++results; };
+    auto onError = [&](const QString& error) { errors.append(error); };
+
+    executor.execute(kFeature, params(100000000), nullptr, onResult, onError);
+    QCOMPARE(remote.runs.load(), 1);
+    QCOMPARE(local.runs.load(), 0);
+
+    remoteAvailable = false;
+    executor.execute(kFeature, params(100000000), nullptr, onResult, onError);
+    QCOMPARE(local.runs.load(), 1);
+
+    // The remote path fails: answered locally, no error
+    remoteAvailable = true;
+    remote.fail = true;
+    executor.execute(kFeature, params(100000000), nullptr, onResult, onError);
+    QCOMPARE(remote.runs.load(), 2);
+    QCOMPARE(local.runs.load(), 2);
+    QCOMPARE(results, 3);
+    QVERIFY(errors.isEmpty());
+
+    // Without a local implementation the error stands
+    executor.execute("bedrock_only", params(10), nullptr, onResult, onError);
+    QCOMPARE(errors, QStringList({"Bedrock unavailable"}));
+    QCOMPARE(local.runs.load(), 2);
+}
+
+void AutoRunModeTests::testBatchSplitAndRetry()
+{
+    ExecutionCostModel model;
+    teach(model, 10.0, 10.0);
+    FakeExecutor local;
+    FakeExecutor remote;
+    AutoExecutor executor(&local, &remote, [](const QString&) { return link(); }, &model);
+
+    const std::vector<QMap<QString, QVariant>> paramSets(10, params(100000000));
+    std::mutex mutex;
+    std::multiset<size_t> reported;
+    size_t failures = 0;
+    double lastProgress = 0.0;
+    auto onItem = [&](size_t index, const XYSineResult* result, const QString&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reported.insert(index);
+        failures += result ? 0 : 1;
+    };
+
+    executor.executeBatch(kFeature, paramSets, [&](double fraction) { lastProgress = fraction; }, onItem);
+    QCOMPARE(model.recentDecisions().back().path, Path::Split);
+    QCOMPARE(local.items.load(), size_t(5));
+    QCOMPARE(remote.items.load(), size_t(5));
+    QCOMPARE(reported.size(), size_t(10));
+    QCOMPARE(std::set<size_t>(reported.begin(), reported.end()).size(), size_t(10));
+    QCOMPARE(lastProgress, 1.0);
+
+    // Remote items that fail are run locally and reported once
+    reported.clear();
+    remote.fail = true;
+    executor.executeBatch(kFeature, paramSets, nullptr, onItem);
+    QCOMPARE(local.items.load(), size_t(5 + 10));
+    QCOMPARE(reported.size(), size_t(10));
+    QCOMPARE(std::set<size_t>(reported.begin(), reported.end()).size(), size_t(10));
+    QCOMPARE(failures, size_t(0));
+}
+
+QTEST_MAIN(AutoRunModeTests)
+#include "test_auto_run_mode.moc"
@@ -0,0 +1,141 @@
+#include <QtTest/QtTest>
+#include "analysis/Decimation.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include <algorithm>
+#include <cmath>
+
+class DecimationTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testMinMaxKeepsExtremesPerPixel();
+    void testOutputBoundedByPlotWidth();
+    void testRangeKeepsEdgeSamples();
+    void testSmallRangeIsNotReduced();
+    void testLttbKeepsEndpointsAndBudget();
+    void testViewportFromParams();
+};
+
+static XYSineResult sineResult(int samples, double frequency = 50.0)
+{
+    QMap<QString, QVariant> params;
+    params["samples"] = samples;
+    params["frequency"] = frequency;
+    XYSineResult result;
+    XYSineDemo::compute(params, result);
+    return result;
+}
+
+void DecimationTests::testMinMaxKeepsExtremesPerPixel()
+{
+    const XYSineResult input = sineResult(100000);
+    XYSineResult reduced;
+    Decimation::minMaxPerPixel(input.x.data(), input.y.data(), input.x.size(),
+                               input.x.front(), input.x.back(), 200, reduced);
+
+    // Global extremes survive, and points stay in x order
+    const double inputMax = *std::max_element(input.y.begin(), input.y.end());
+    const double inputMin = *std::min_element(input.y.begin(), input.y.end());
+    QCOMPARE(*std::max_element(reduced.y.begin(), reduced.y.end()), inputMax);
+    QCOMPARE(*std::min_element(reduced.y.begin(), reduced.y.end()), inputMin);
+    QVERIFY(std::is_sorted(reduced.x.begin(), reduced.x.end()));
+    QVERIFY(reduced.x.size() <= Decimation::pointBudget(200));
+}
+
+void DecimationTests::testOutputBoundedByPlotWidth()
+{
+    // Same transfer/render size whatever the result size
+    for (int samples : {10000, 100000, 1000000}) {
+        const XYSineResult input = sineResult(samples);
+        Decimation::Viewport viewport;
+        viewport.xMin = input.x.front();
+        viewport.xMax = input.x.back();
+        viewport.pixelWidth = 800;
+        XYSineResult reduced;
+        QVERIFY(Decimation::decimate(input, viewport, reduced));
+        QVERIFY(reduced.x.size() <= Decimation::pointBudget(800) + 2);
+        QCOMPARE(reduced.x.size(), reduced.y.size());
+    }
+}
+
+void DecimationTests::testRangeKeepsEdgeSamples()
+{
+    const XYSineResult input = sineResult(100000);
+    Decimation::Viewport viewport;
+    viewport.xMin = 1.0;
+    viewport.xMax = 2.0;
+    viewport.pixelWidth = 100;
+    XYSineResult reduced;
+    QVERIFY(Decimation::decimate(input, viewport, reduced));
+
+    // One sample on each side of the range, everything else inside it
+    QVERIFY(reduced.x.front() < 1.0);
+    QVERIFY(reduced.x.back() > 2.0);
+    for (size_t i = 1; i + 1 < reduced.x.size(); ++i) {
+        QVERIFY(reduced.x[i] >= 1.0 && reduced.x[i] <= 2.0);
+    }
+    QVERIFY(reduced.x.size() <= Decimation::pointBudget(100) + 2);
+}
+
+void DecimationTests::testSmallRangeIsNotReduced()
+{
+    const XYSineResult input = sineResult(1000, 1.0);
+    Decimation::Viewport viewport;
+    viewport.xMin = 0.5;
+    viewport.xMax = 0.6;  // About 16 samples, far below 2 x 800
+    viewport.pixelWidth = 800;
+    XYSineResult reduced;
+    QVERIFY(Decimation::decimate(input, viewport, reduced));
+
+    auto first = std::lower_bound(input.x.begin(), input.x.end(), 0.5) - 1;
+    QCOMPARE(reduced.x.front(), *first);
+    for (size_t i = 0; i < reduced.x.size(); ++i) {
+        QCOMPARE(reduced.x[i], *(first + i));
+    }
+
+    // Invalid viewports are rejected
+    viewport.pixelWidth = 0;
+    QVERIFY(!Decimation::decimate(input, viewport, reduced));
+}
+
+void DecimationTests::testLttbKeepsEndpointsAndBudget()
+{
+    const XYSineResult input = sineResult(50000, 3.0);
+    XYSineResult reduced;
+    Decimation::lttb(input.x.data(), input.y.data(), input.x.size(), 500, reduced);
+    QCOMPARE(reduced.x.size(), size_t(500));
+    QCOMPARE(reduced.x.front(), input.x.front());
+    QCOMPARE(reduced.x.back(), input.x.back());
+    QVERIFY(std::is_sorted(reduced.x.begin(), reduced.x.end()));
+
+    // Peaks are picked, not averaged away
+    QVERIFY(*std::max_element(reduced.y.begin(), reduced.y.end()) > 0.99);
+
+    Decimation::lttb(input.x.data(), input.y.data(), input.x.size(), 2, reduced);
+    QCOMPARE(reduced.x.size(), size_t(2));
+}
+
+void DecimationTests::testViewportFromParams()
+{
+    QMap<QString, QVariant> params;
+    QVERIFY(!Decimation::viewportFromParams(params, 0.0, 1.0).has_value());
+
+    params[Decimation::kViewPixelsParam] = 640;
+    auto full = Decimation::viewportFromParams(params, 0.0, 1.0);
+    QVERIFY(full.has_value());
+    QCOMPARE(full->xMin, 0.0);
+    QCOMPARE(full->xMax, 1.0);
+    QVERIFY(full->method == Decimation::Method::MinMax);
+
+    params[Decimation::kViewXMinParam] = 0.25;
+    params[Decimation::kViewXMaxParam] = 0.5;
+    params[Decimation::kDecimationParam] = "lttb";
+    auto range = Decimation::viewportFromParams(params, 0.0, 1.0);
+    QVERIFY(range.has_value());
+    QCOMPARE(range->xMin, 0.25);
+    QCOMPARE(range->pixelWidth, 640);
+    QVERIFY(range->method == Decimation::Method::Lttb);
+}
+
+QTEST_MAIN(DecimationTests)
+#include "test_decimation.moc"
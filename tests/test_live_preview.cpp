@@ -0,0 +1,164 @@
+#include <QtTest/QtTest>
+#include "ui/analysis/LivePreviewController.hpp"
+#include <QSignalSpy>
+
+class LivePreviewTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testPreviewParams();
+    void testDisabledIgnoresEdits();
+    void testScrubbingPreviewsThenRefines();
+    void testSmallRunsSkipPreview();
+    void testUnchangedValuesNotRerun();
+    void testCancelPending();
+};
+
+namespace {
+
+// Longer than any timer of the controller
+constexpr int kQuietMs = LivePreviewController::SETTLE_MS + 200;
+
+QMap<QString, QVariant> sineParams(double frequency, int samples)
+{
+    QMap<QString, QVariant> params;
+    params.insert("frequency", frequency);
+    params.insert("amplitude", 1.0);
+    params.insert("phase", 0.0);
+    params.insert("samples", samples);
+    return params;
+}
+
+} // namespace
+
+void LivePreviewTests::testPreviewParams()
+{
+    QMap<QString, QVariant> capped = LivePreviewController::previewParams(sineParams(2.0, 100000), 1000);
+    QCOMPARE(capped.value("samples").toInt(), 1000);
+    QCOMPARE(capped.value("frequency").toDouble(), 2.0);
+
+    // Already small enough: unchanged
+    QCOMPARE(LivePreviewController::previewParams(sineParams(2.0, 500), 1000), sineParams(2.0, 500));
+
+    // Legacy key
+    QMap<QString, QVariant> legacy;
+    legacy.insert("num_samples", 50000);
+    QCOMPARE(LivePreviewController::previewParams(legacy, 1000).value("num_samples").toInt(), 1000);
+
+    // No sample count: nothing to cap
+    QMap<QString, QVariant> none;
+    none.insert("frequency", 1.0);
+    QCOMPARE(LivePreviewController::previewParams(none, 1000), none);
+}
+
+void LivePreviewTests::testDisabledIgnoresEdits()
+{
+    LivePreviewController controller;
+    QSignalSpy previews(&controller, &LivePreviewController::previewRequested);
+    QSignalSpy refines(&controller, &LivePreviewController::refineRequested);
+
+    QVERIFY(!controller.isEnabled());
+    controller.parametersEdited(sineParams(2.0, 100000));
+    QTest::qWait(kQuietMs);
+    QCOMPARE(previews.count(), 0);
+    QCOMPARE(refines.count(), 0);
+}
+
+void LivePreviewTests::testScrubbingPreviewsThenRefines()
+{
+    LivePreviewController controller;
+    controller.setEnabled(true);
+    controller.setPreviewSamples(1000);
+    QSignalSpy previews(&controller, &LivePreviewController::previewRequested);
+    QSignalSpy refines(&controller, &LivePreviewController::refineRequested);
+
+    // A slider dragged for about 200 ms, one edit every 5 ms
+    const int edits = 40;
+    for (int i = 1; i <= edits; ++i) {
+        controller.parametersEdited(sineParams(1.0 + 0.1 * i, 100000));
+        QTest::qWait(5);
+    }
+
+    // Edits coalesced into a few low-resolution previews, no full run yet
+    QVERIFY(previews.count() >= 2);
+    QVERIFY(previews.count() < edits);
+    for (const QList<QVariant>& preview : previews) {
+        QCOMPARE(preview.at(0).value<QMap<QString, QVariant>>().value("samples").toInt(), 1000);
+    }
+    QCOMPARE(refines.count(), 0);
+
+    // Let go: one full-resolution run of the final values
+    QTRY_COMPARE_WITH_TIMEOUT(refines.count(), 1, kQuietMs * 2);
+    QCOMPARE(refines.at(0).at(0).value<QMap<QString, QVariant>>(), sineParams(1.0 + 0.1 * edits, 100000));
+    QTest::qWait(kQuietMs);
+    QCOMPARE(refines.count(), 1);
+}
+
+void LivePreviewTests::testSmallRunsSkipPreview()
+{
+    LivePreviewController controller;
+    controller.setEnabled(true);
+    QSignalSpy previews(&controller, &LivePreviewController::previewRequested);
+    QSignalSpy refines(&controller, &LivePreviewController::refineRequested);
+
+    // At or below the preview resolution the full run is the preview
+    controller.parametersEdited(sineParams(3.0, 500));
+    QTRY_COMPARE_WITH_TIMEOUT(refines.count(), 1, LivePreviewController::SETTLE_MS);
+    QTest::qWait(kQuietMs);
+    QCOMPARE(refines.count(), 1);
+    QCOMPARE(previews.count(), 0);
+
+    // The preview resolution has a floor
+    controller.setPreviewSamples(1);
+    QCOMPARE(controller.previewSamples(), LivePreviewController::MIN_PREVIEW_SAMPLES);
+}
+
+void LivePreviewTests::testUnchangedValuesNotRerun()
+{
+    LivePreviewController controller;
+    controller.setEnabled(true);
+    QSignalSpy previews(&controller, &LivePreviewController::previewRequested);
+    QSignalSpy refines(&controller, &LivePreviewController::refineRequested);
+
+    controller.parametersEdited(sineParams(2.0, 100000));
+    QTRY_COMPARE_WITH_TIMEOUT(refines.count(), 1, kQuietMs);
+    QCOMPARE(previews.count(), 1);
+
+    // Same values again (e.g. a spin box set to its current value)
+    controller.parametersEdited(sineParams(2.0, 100000));
+    QTest::qWait(kQuietMs);
+    QCOMPARE(previews.count(), 1);
+    QCOMPARE(refines.count(), 1);
+
+    // Away and back before the preview goes out: nothing to run either
+    controller.parametersEdited(sineParams(4.0, 100000));
+    controller.parametersEdited(sineParams(2.0, 100000));
+    QTest::qWait(kQuietMs);
+    QCOMPARE(previews.count(), 1);
+    QCOMPARE(refines.count(), 1);
+}
+
+void LivePreviewTests::testCancelPending()
+{
+    LivePreviewController controller;
+    controller.setEnabled(true);
+    QSignalSpy previews(&controller, &LivePreviewController::previewRequested);
+    QSignalSpy refines(&controller, &LivePreviewController::refineRequested);
+
+    // An explicit Run supersedes the pending runs
+    controller.parametersEdited(sineParams(2.0, 100000));
+    controller.cancelPending();
+    QTest::qWait(kQuietMs);
+    QCOMPARE(previews.count(), 0);
+    QCOMPARE(refines.count(), 0);
+
+    // Disabling mid-drag drops the refinement
+    controller.parametersEdited(sineParams(3.0, 100000));
+    QTRY_COMPARE_WITH_TIMEOUT(previews.count(), 1, kQuietMs);
+    controller.setEnabled(false);
+    QTest::qWait(kQuietMs);
+    QCOMPARE(refines.count(), 0);
+}
+
+QTEST_MAIN(LivePreviewTests)
+#include "test_live_preview.moc"
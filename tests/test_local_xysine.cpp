@@ -1,5 +1,6 @@
 #include <QtTest/QtTest>
 #include "analysis/demo/XYSineDemo.hpp"
+#include "analysis/AnalysisScheduler.hpp"
 #include "analysis/AnalysisWorker.hpp"
 #include "analysis/AnalysisProgress.hpp"
 #include "transport/LocalSocketChannel.hpp"
@@ -15,6 +16,8 @@ private slots:
     void testLocalXYSineMatchesBedrockMath();
     void testLocalXYSineParameterParsing();
     void testLocalXYSineSampleClamping();
+    void testComputeStopsWhenCancelled();
+    void testChunksRunUnderJobToken();
     void testDemoModeBypassesBedrock();
 };
 
@@ -118,6 +121,45 @@ void LocalXYSineTests::testLocalXYSineSampleClamping()
     QCOMPARE(result3.x.size(), 2);
 }
 
+void LocalXYSineTests::testComputeStopsWhenCancelled()
+{
+    CancellationToken token;
+    token.cancel();
+
+    // Single chunk and fanned out alike
+    XYSineDemo::Params params;
+    params.samples = 1000;
+    XYSineResult small;
+    QVERIFY(!XYSineDemo::compute(params, small, token));
+
+    params.samples = static_cast<int>(XYSineDemo::PARALLEL_MIN_SAMPLES * 4);
+    XYSineResult large;
+    QVERIFY(!XYSineDemo::compute(params, large, token));
+
+    // Uncancelled, the same call completes
+    XYSineResult complete;
+    QVERIFY(XYSineDemo::compute(params, complete, CancellationToken()));
+    QCOMPARE(complete.y.size(), static_cast<size_t>(params.samples));
+}
+
+void LocalXYSineTests::testChunksRunUnderJobToken()
+{
+    // Cancelling the job's owner stops the chunks it fanned out
+    AnalysisScheduler& scheduler = AnalysisScheduler::instance();
+    const char owner = 0;
+    std::atomic<bool> computed(true);
+    std::future<bool> job = scheduler.submit(AnalysisScheduler::ownerOf(&owner), JobPriority::Interactive,
+                                             [&](const CancellationToken&) {
+        AnalysisScheduler::instance().cancelOwner(AnalysisScheduler::ownerOf(&owner));
+        XYSineDemo::Params params;
+        params.samples = static_cast<int>(XYSineDemo::PARALLEL_MIN_SAMPLES * 4);
+        XYSineResult result;
+        computed.store(XYSineDemo::compute(params, result, CancellationToken()));
+    });
+    QVERIFY(scheduler.wait(job));
+    QVERIFY(!computed.load());
+}
+
 void LocalXYSineTests::testDemoModeBypassesBedrock()
 {
     // Set demo mode environment variable
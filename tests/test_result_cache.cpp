@@ -0,0 +1,197 @@
+#include <QtTest/QtTest>
+#include "analysis/LocalExecutor.hpp"
+#include "analysis/ResultCache.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include <memory>
+
+class ResultCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testKeyIsCanonical();
+    void testHitsAndMisses();
+    void testLeastRecentlyUsedEvicted();
+    void testBudget();
+    void testLocalExecutorReusesResults();
+    void testPreviewRunsNotStored();
+};
+
+namespace {
+
+ResultCache::SharedResult makeResult(size_t samples)
+{
+    auto result = std::make_shared<XYSineResult>();
+    result->x.assign(samples, 1.0);
+    result->y.assign(samples, 2.0);
+    return result;
+}
+
+} // namespace
+
+void ResultCacheTests::testKeyIsCanonical()
+{
+    const QString version = QStringLiteral("test-1");
+    QMap<QString, QVariant> a;
+    a.insert(QStringLiteral("samples"), 250);
+    a.insert(QStringLiteral("frequency"), 1.5);
+    QMap<QString, QVariant> b;
+    b.insert(QStringLiteral("frequency"), 1.5);
+    b.insert(QStringLiteral("samples"), 250.0);
+
+    const QByteArray key = ResultCache::key(QStringLiteral("xy_sine"), a, version);
+    QCOMPARE(key.size(), 32);  // BLAKE2b-256
+    QCOMPARE(ResultCache::key(QStringLiteral("xy_sine"), b, version), key);
+
+    // Feature, value, value type and version all count
+    b.insert(QStringLiteral("samples"), 251);
+    QVERIFY(ResultCache::key(QStringLiteral("xy_sine"), b, version) != key);
+    QVERIFY(ResultCache::key(QStringLiteral("other"), a, version) != key);
+    QVERIFY(ResultCache::key(QStringLiteral("xy_sine"), a, QStringLiteral("test-2")) != key);
+    QMap<QString, QVariant> text = a;
+    text.insert(QStringLiteral("samples"), QStringLiteral("250"));
+    QVERIFY(ResultCache::key(QStringLiteral("xy_sine"), text, version) != key);
+}
+
+void ResultCacheTests::testHitsAndMisses()
+{
+    ResultCache cache;
+    const QByteArray key = ResultCache::key(QStringLiteral("xy_sine"), {}, QStringLiteral("test"));
+    QVERIFY(!cache.lookup(key));
+
+    const ResultCache::SharedResult result = makeResult(100);
+    cache.insert(key, result);
+    QCOMPARE(cache.lookup(key), result);  // The same object, not a copy
+    QCOMPARE(cache.lookup(key), result);
+
+    const ResultCache::Stats stats = cache.stats();
+    QCOMPARE(stats.hits, uint64_t(2));
+    QCOMPARE(stats.misses, uint64_t(1));
+    QCOMPARE(stats.insertions, uint64_t(1));
+    QCOMPARE(stats.entries, size_t(1));
+    QCOMPARE(stats.bytes, ResultCache::resultBytes(*result) + size_t(key.size()));
+
+    cache.clear();
+    QVERIFY(!cache.lookup(key));
+    QCOMPARE(cache.stats().entries, size_t(0));
+    QCOMPARE(cache.stats().hits, uint64_t(0));
+}
+
+void ResultCacheTests::testLeastRecentlyUsedEvicted()
+{
+    // Room for two results of 1000 samples, not three
+    const size_t entryBytes = ResultCache::resultBytes(*makeResult(1000)) + 32;
+    ResultCache cache(2 * entryBytes + entryBytes / 2);
+    const QByteArray first(32, 'a');
+    const QByteArray second(32, 'b');
+    const QByteArray third(32, 'c');
+    cache.insert(first, makeResult(1000));
+    cache.insert(second, makeResult(1000));
+
+    // Using the first entry makes the second the oldest
+    QVERIFY(cache.lookup(first));
+    cache.insert(third, makeResult(1000));
+    QVERIFY(cache.lookup(first));
+    QVERIFY(!cache.lookup(second));
+    QVERIFY(cache.lookup(third));
+    QCOMPARE(cache.stats().evictions, uint64_t(1));
+    QVERIFY(cache.stats().bytes <= cache.budget());
+}
+
+void ResultCacheTests::testBudget()
+{
+    const size_t entryBytes = ResultCache::resultBytes(*makeResult(1000)) + 32;
+    ResultCache cache(4 * entryBytes);
+    for (char c = 'a'; c < 'e'; ++c) {
+        cache.insert(QByteArray(32, c), makeResult(1000));
+    }
+    QCOMPARE(cache.stats().entries, size_t(4));
+
+    // Results larger than the whole budget are not kept
+    cache.insert(QByteArray(32, 'z'), makeResult(10000));
+    QVERIFY(!cache.lookup(QByteArray(32, 'z')));
+    QCOMPARE(cache.stats().entries, size_t(4));
+
+    // Shrinking evicts the oldest at once
+    cache.setBudget(2 * entryBytes);
+    QCOMPARE(cache.stats().entries, size_t(2));
+    QVERIFY(!cache.lookup(QByteArray(32, 'a')));
+    QVERIFY(cache.lookup(QByteArray(32, 'd')));
+
+    // No budget, no caching
+    cache.setBudget(0);
+    QCOMPARE(cache.stats().entries, size_t(0));
+    cache.insert(QByteArray(32, 'a'), makeResult(10));
+    QVERIFY(!cache.lookup(QByteArray(32, 'a')));
+}
+
+void ResultCacheTests::testLocalExecutorReusesResults()
+{
+    ResultCache cache;
+    LocalExecutor executor;
+    executor.setResultCache(&cache);
+
+    auto run = [&executor](int samples) {
+        XYSineResult delivered;
+        QString error;
+        executor.execute(QStringLiteral("xy_sine"),
+                         {{QStringLiteral("samples"), samples}, {QStringLiteral("frequency"), 2.0}},
+                         nullptr,
+                         [&delivered](const XYSineResult& result) { delivered = result; },
+                         [&error](const QString& message) { error = message; });
+        return std::make_pair(delivered, error);
+    };
+
+    const auto first = run(5000);
+    QVERIFY2(first.second.isEmpty(), qPrintable(first.second));
+    QCOMPARE(cache.stats().misses, uint64_t(1));
+    QCOMPARE(cache.stats().entries, size_t(1));
+
+    const auto again = run(5000);
+    QCOMPARE(cache.stats().hits, uint64_t(1));
+    QVERIFY(again.first.x == first.first.x);
+    QVERIFY(again.first.y == first.first.y);
+
+    run(6000);
+    QCOMPARE(cache.stats().misses, uint64_t(2));
+    QCOMPARE(cache.stats().entries, size_t(2));
+
+    // Batch items share the cache with single runs
+    const std::vector<QMap<QString, QVariant>> paramSets = {
+        {{QStringLiteral("samples"), 5000.0}, {QStringLiteral("frequency"), 2}},
+        {{QStringLiteral("samples"), 7000}, {QStringLiteral("frequency"), 2.0}}};
+    std::vector<size_t> sizes(paramSets.size(), 0);
+    executor.executeBatch(QStringLiteral("xy_sine"), paramSets, nullptr,
+                          [&sizes](size_t index, const XYSineResult* result, const QString&) {
+                              sizes[index] = result ? result->x.size() : 0;
+                          });
+    QCOMPARE(sizes[0], size_t(5000));
+    QCOMPARE(sizes[1], size_t(7000));
+    QCOMPARE(cache.stats().hits, uint64_t(2));
+    QCOMPARE(cache.stats().entries, size_t(3));
+}
+
+void ResultCacheTests::testPreviewRunsNotStored()
+{
+    ResultCache cache;
+    LocalExecutor executor;
+    executor.setResultCache(&cache);
+    executor.setStoreResults(false);
+
+    const QMap<QString, QVariant> params = {{QStringLiteral("samples"), 4096}};
+    size_t delivered = 0;
+    executor.execute(QStringLiteral("xy_sine"), params, nullptr,
+                     [&delivered](const XYSineResult& result) { delivered = result.x.size(); }, nullptr);
+    QCOMPARE(delivered, size_t(4096));
+    QCOMPARE(cache.stats().entries, size_t(0));
+
+    // Still answered from the cache when a stored run computed it first
+    executor.setStoreResults(true);
+    executor.execute(QStringLiteral("xy_sine"), params, nullptr, nullptr, nullptr);
+    QCOMPARE(cache.stats().entries, size_t(1));
+    executor.setStoreResults(false);
+    executor.execute(QStringLiteral("xy_sine"), params, nullptr, nullptr, nullptr);
+    QCOMPARE(cache.stats().hits, uint64_t(1));
+}
+
+QTEST_MAIN(ResultCacheTests)
+#include "test_result_cache.moc"
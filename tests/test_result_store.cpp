@@ -0,0 +1,220 @@
+#include <QtTest/QtTest>
+#include "analysis/ResultStore.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include <QFile>
+#include <QTemporaryDir>
+#include <chrono>
+#include <thread>
+
+class ResultStoreTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRoundTrip();
+    void testSharedBetweenInstances();
+    void testEvictBySize();
+    void testEvictByAge();
+    void testEvictionSeenByOtherInstance();
+    void testDamagedRecordIsAMiss();
+    void testTornIndexEntryIsDropped();
+};
+
+namespace {
+
+XYSineResult makeResult(size_t samples, double scale)
+{
+    XYSineResult result;
+    for (size_t i = 0; i < samples; ++i) {
+        result.x.push_back(static_cast<double>(i));
+        result.y.push_back(scale * static_cast<double>(i));
+    }
+    return result;
+}
+
+QByteArray makeKey(char c)
+{
+    return QByteArray(32, c);
+}
+
+// Bytes one record of samples takes in a segment
+uint64_t recordBytes(size_t samples)
+{
+    return 64 + samples * 2 * sizeof(double);
+}
+
+} // namespace
+
+void ResultStoreTests::testRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ResultStore store(dir.path());
+    QVERIFY(store.isOpen());
+
+    QVERIFY(!store.get(makeKey('a')));
+    const XYSineResult original = makeResult(1000, 0.5);
+    QString error;
+    QVERIFY2(store.put(makeKey('a'), original, &error), qPrintable(error));
+
+    const ResultStore::SharedResult loaded = store.get(makeKey('a'));
+    QVERIFY(loaded);
+    QVERIFY(loaded->x == original.x);
+    QVERIFY(loaded->y == original.y);
+    QVERIFY(!store.get(makeKey('b')));
+
+    const ResultStore::Stats stats = store.stats();
+    QCOMPARE(stats.hits, uint64_t(1));
+    QCOMPARE(stats.misses, uint64_t(2));
+    QCOMPARE(stats.writes, uint64_t(1));
+    QCOMPARE(stats.entries, size_t(1));
+    QCOMPARE(stats.bytes, recordBytes(1000));
+
+    // Keys are ResultCache keys; anything else is refused
+    QVERIFY(!store.put(QByteArray("short"), original));
+}
+
+void ResultStoreTests::testSharedBetweenInstances()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ResultStore first(dir.path());
+    ResultStore second(dir.path());
+
+    // second read the (empty) index before first wrote
+    QVERIFY(!second.get(makeKey('a')));
+    QVERIFY(first.put(makeKey('a'), makeResult(100, 1.0)));
+    QVERIFY(second.put(makeKey('b'), makeResult(200, 2.0)));
+
+    ResultStore::SharedResult fromFirst = second.get(makeKey('a'));
+    QVERIFY(fromFirst);
+    QCOMPARE(fromFirst->x.size(), size_t(100));
+    ResultStore::SharedResult fromSecond = first.get(makeKey('b'));
+    QVERIFY(fromSecond);
+    QCOMPARE(fromSecond->y[10], 20.0);
+
+    // A later session
+    ResultStore reopened(dir.path());
+    QVERIFY(reopened.get(makeKey('a')));
+    QVERIFY(reopened.get(makeKey('b')));
+    QCOMPARE(reopened.stats().entries, size_t(2));
+}
+
+void ResultStoreTests::testEvictBySize()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // One record per segment, room for two
+    ResultStore::Limits limits;
+    limits.segmentBytes = 1;
+    limits.maxBytes = 2 * recordBytes(1000) + recordBytes(1000) / 2;
+    ResultStore store(dir.path(), limits);
+
+    QVERIFY(store.put(makeKey('a'), makeResult(1000, 1.0)));
+    QVERIFY(store.put(makeKey('b'), makeResult(1000, 2.0)));
+    QVERIFY(store.put(makeKey('c'), makeResult(1000, 3.0)));
+    QVERIFY(!store.get(makeKey('a')));
+    QVERIFY(store.get(makeKey('b')));
+    QVERIFY(store.get(makeKey('c')));
+    QCOMPARE(store.stats().evictedSegments, uint64_t(1));
+    QVERIFY(store.stats().bytes <= limits.maxBytes);
+
+    // Larger than the whole store: not kept
+    QString error;
+    QVERIFY(!store.put(makeKey('d'), makeResult(10000, 1.0), &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(store.get(makeKey('c')));
+}
+
+void ResultStoreTests::testEvictByAge()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ResultStore store(dir.path());
+    QVERIFY(store.put(makeKey('a'), makeResult(100, 1.0)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    ResultStore::Limits limits;
+    limits.maxAge = std::chrono::milliseconds(20);
+    store.setLimits(limits);
+    QVERIFY(!store.get(makeKey('a')));
+    QCOMPARE(store.stats().entries, size_t(0));
+    QCOMPARE(store.stats().bytes, uint64_t(0));
+
+    // The store keeps working afterwards
+    QVERIFY(store.put(makeKey('b'), makeResult(100, 1.0)));
+    QVERIFY(store.get(makeKey('b')));
+}
+
+void ResultStoreTests::testEvictionSeenByOtherInstance()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ResultStore::Limits limits;
+    limits.segmentBytes = 1;
+    ResultStore writer(dir.path(), limits);
+    ResultStore reader(dir.path());
+
+    QVERIFY(writer.put(makeKey('a'), makeResult(1000, 1.0)));
+    QVERIFY(writer.put(makeKey('b'), makeResult(1000, 2.0)));
+    QVERIFY(reader.get(makeKey('a')));
+
+    // The writer's eviction rewrites the index; the reader notices
+    limits.maxBytes = recordBytes(1000);
+    writer.setLimits(limits);
+    QVERIFY(!reader.get(makeKey('a')));
+    QVERIFY(reader.get(makeKey('b')));
+    QCOMPARE(reader.stats().entries, size_t(1));
+}
+
+void ResultStoreTests::testDamagedRecordIsAMiss()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ResultStore store(dir.path());
+    QVERIFY(store.put(makeKey('a'), makeResult(100, 1.0)));
+
+    // Overwrite the record's key: the index now points at someone else's data
+    QFile segment(dir.filePath(QStringLiteral("segment-00000001.dat")));
+    QVERIFY(segment.open(QIODevice::ReadWrite));
+    QVERIFY(segment.seek(8));
+    QVERIFY(segment.write(makeKey('z')) == 32);
+    segment.close();
+    QVERIFY(!store.get(makeKey('a')));
+
+    // Truncated segment
+    QVERIFY(store.put(makeKey('b'), makeResult(100, 1.0)));
+    QVERIFY(segment.resize(64));
+    QVERIFY(!store.get(makeKey('b')));
+}
+
+void ResultStoreTests::testTornIndexEntryIsDropped()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        ResultStore store(dir.path());
+        QVERIFY(store.put(makeKey('a'), makeResult(100, 1.0)));
+    }
+
+    // A writer died halfway through its index entry
+    QFile index(dir.filePath(QStringLiteral("index")));
+    QVERIFY(index.open(QIODevice::WriteOnly | QIODevice::Append));
+    QVERIFY(index.write(QByteArray(20, 'x')) == 20);
+    index.close();
+
+    // The next entry replaces the torn one instead of following it
+    ResultStore store(dir.path());
+    QVERIFY(store.put(makeKey('b'), makeResult(200, 2.0)));
+    QCOMPARE(index.size(), qint64(16 + 2 * 64));
+
+    ResultStore reader(dir.path());
+    QVERIFY(reader.get(makeKey('a')));
+    const ResultStore::SharedResult b = reader.get(makeKey('b'));
+    QVERIFY(b);
+    QCOMPARE(b->x.size(), size_t(200));
+    QCOMPARE(reader.stats().entries, size_t(2));
+}
+
+QTEST_MAIN(ResultStoreTests)
+#include "test_result_store.moc"
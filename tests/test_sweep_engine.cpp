@@ -0,0 +1,254 @@
+#include <QtTest/QtTest>
+#include "analysis/LocalExecutor.hpp"
+#include "analysis/SweepDataset.hpp"
+#include "analysis/SweepEngine.hpp"
+#include "analysis/SweepPlan.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include "features/FeatureRegistry.hpp"
+#include <QBuffer>
+#include <set>
+
+class SweepEngineTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testExpansion();
+    void testValidation();
+    void testLocalSweep();
+    void testCancelAndResume();
+    void testFailedPointsAndExport();
+};
+
+namespace {
+
+FeatureDescriptor xySine()
+{
+    const FeatureDescriptor* feature = FeatureRegistry::instance().getFeature("xy_sine");
+    return feature ? *feature : FeatureDescriptor();
+}
+
+// frequency 1..4 × phase {0, 0.5, 1}, 200 samples each
+SweepPlan makePlan()
+{
+    QMap<QString, QVariant> fixed;
+    fixed.insert("samples", 200);
+    SweepPlan plan(xySine(), fixed);
+    plan.addAxis(SweepAxis::range("frequency", 1.0, 4.0, 4))
+        .addAxis(SweepAxis::list("phase", {0.0, 0.5, 1.0}));
+    return plan;
+}
+
+// Fails every point whose frequency is 2
+class FlakyExecutor : public IAnalysisExecutor {
+public:
+    void execute(const QString& featureId, const QMap<QString, QVariant>& params,
+                 ProgressCallback, ResultCallback onResult, ErrorCallback onError) override
+    {
+        (void)featureId;
+        XYSineResult result;
+        if (params.value("frequency").toDouble() == 2.0 || !XYSineDemo::compute(params, result)) {
+            onError(QString("Bedrock error"));
+            return;
+        }
+        onResult(result);
+    }
+
+    void executeBatch(const QString& featureId, const std::vector<QMap<QString, QVariant>>& paramSets,
+                      ProgressCallback, BatchItemCallback onItem) override
+    {
+        ++batches;
+        for (size_t index = 0; index < paramSets.size(); ++index) {
+            execute(featureId, paramSets[index], nullptr,
+                    [&](const XYSineResult& result) { onItem(index, &result, QString()); },
+                    [&](const QString& error) { onItem(index, nullptr, error); });
+        }
+    }
+
+    void cancel() override {}
+
+    int batches = 0;
+};
+
+} // namespace
+
+void SweepEngineTests::testExpansion()
+{
+    const SweepPlan plan = makePlan();
+    QString error;
+    QVERIFY2(plan.validate(&error), qPrintable(error));
+    QCOMPARE(plan.pointCount(), size_t(12));
+
+    // Last axis fastest
+    QCOMPARE(plan.axisValue(0, 0), 1.0);
+    QCOMPARE(plan.axisValue(1, 1), 0.5);
+    QCOMPARE(plan.axisValue(0, 4), 2.0);
+    QCOMPARE(plan.axisValue(1, 4), 0.5);
+    QCOMPARE(plan.axisValue(0, 11), 4.0);
+
+    // Defaults, then fixed parameters, then the axes
+    const QMap<QString, QVariant> params = plan.paramsAt(5);
+    QCOMPARE(params.value("frequency").toDouble(), 2.0);
+    QCOMPARE(params.value("phase").toDouble(), 1.0);
+    QCOMPARE(params.value("samples").toInt(), 200);
+    QCOMPARE(params.value("amplitude").toDouble(), 1.0);
+
+    // Int axes pass ints
+    SweepPlan samplesPlan(xySine());
+    samplesPlan.addAxis(SweepAxis::range("samples", 10, 20, 3));
+    QVERIFY(samplesPlan.validate());
+    QCOMPARE(samplesPlan.paramsAt(1).value("samples").typeId(), int(QMetaType::Int));
+    QCOMPARE(samplesPlan.paramsAt(1).value("samples").toInt(), 15);
+
+    const SweepAxis single = SweepAxis::range("phase", 0.25, 3.0, 1);
+    QCOMPARE(single.values.size(), size_t(1));
+    QCOMPARE(single.values[0], 0.25);
+}
+
+void SweepEngineTests::testValidation()
+{
+    QString error;
+    QVERIFY(!SweepPlan(xySine()).validate(&error));  // No axes
+
+    SweepPlan unknown(xySine());
+    unknown.addAxis(SweepAxis::list("wavelength", {1.0}));
+    QVERIFY(!unknown.validate(&error));
+    QVERIFY(error.contains("wavelength"));
+
+    SweepPlan outOfRange(xySine());
+    outOfRange.addAxis(SweepAxis::range("frequency", 1.0, 500.0, 5));
+    QVERIFY(!outOfRange.validate(&error));
+
+    SweepPlan twice(xySine());
+    twice.addAxis(SweepAxis::list("phase", {0.0})).addAxis(SweepAxis::list("phase", {1.0}));
+    QVERIFY(!twice.validate(&error));
+
+    SweepPlan empty(xySine());
+    empty.addAxis(SweepAxis::list("phase", {}));
+    QVERIFY(!empty.validate(&error));
+
+    FeatureDescriptor withEnum("shaped", "Shaped");
+    withEnum.addParam(ParamSpec("shape", "Shape", ParamSpec::Type::Enum).setEnumValues({"a", "b"}));
+    SweepPlan notNumeric(withEnum);
+    notNumeric.addAxis(SweepAxis::list("shape", {0.0}));
+    QVERIFY(!notNumeric.validate(&error));
+
+    // The engine refuses it too, without touching the dataset
+    FlakyExecutor executor;
+    SweepEngine engine(&executor);
+    SweepDataset dataset;
+    QVERIFY(!engine.run(twice, dataset, nullptr, nullptr, &error));
+    QCOMPARE(executor.batches, 0);
+    QCOMPARE(dataset.pointCount(), size_t(0));
+}
+
+void SweepEngineTests::testLocalSweep()
+{
+    LocalExecutor executor;
+    executor.setResultCache(nullptr);
+    SweepEngine engine(&executor);
+    engine.setChunkPoints(5);
+
+    const SweepPlan plan = makePlan();
+    SweepDataset dataset;
+    std::set<size_t> streamed;
+    double lastProgress = 0.0;
+    QString error;
+    const bool ok = engine.run(plan, dataset,
+                               [&](double fraction) { lastProgress = fraction; },
+                               [&](size_t point, const XYSineResult* result, const QString&) {
+                                   QVERIFY(result);
+                                   // The dataset has the point before it is streamed
+                                   QCOMPARE(dataset.status(point), SweepDataset::PointStatus::Done);
+                                   QVERIFY(streamed.insert(point).second);
+                               },
+                               &error);
+    QVERIFY2(ok, qPrintable(error));
+    QCOMPARE(streamed.size(), plan.pointCount());
+    QCOMPARE(lastProgress, 1.0);
+    QCOMPARE(dataset.doneCount(), plan.pointCount());
+    QCOMPARE(dataset.axisNames(), QStringList({"frequency", "phase"}));
+    QCOMPARE(dataset.axisColumn(0)[7], 3.0);
+
+    for (size_t point = 0; point < plan.pointCount(); ++point) {
+        XYSineResult expected;
+        QVERIFY(XYSineDemo::compute(plan.paramsAt(point), expected));
+        const XYSineResult actual = dataset.result(point);
+        QCOMPARE(dataset.sampleCount(point), size_t(200));
+        QVERIFY(actual.x == expected.x);
+        QVERIFY(actual.y == expected.y);
+    }
+}
+
+void SweepEngineTests::testCancelAndResume()
+{
+    LocalExecutor executor;
+    executor.setResultCache(nullptr);
+    SweepEngine engine(&executor);
+    engine.setChunkPoints(2);
+
+    const SweepPlan plan = makePlan();
+    SweepDataset dataset;
+    size_t firstRun = 0;
+    QString error;
+    QVERIFY(!engine.run(plan, dataset, nullptr,
+                        [&](size_t, const XYSineResult*, const QString&) {
+                            if (++firstRun == 3) {
+                                engine.cancel();
+                            }
+                        },
+                        &error));
+    QVERIFY(error.contains("cancelled"));
+    QVERIFY(dataset.doneCount() >= 3);
+    QVERIFY(dataset.doneCount() < plan.pointCount());
+    QCOMPARE(dataset.failedCount(), size_t(0));  // Cancelled points stay pending
+    QCOMPARE(dataset.doneCount(), firstRun);
+
+    // Resume: only the pending points run
+    std::set<size_t> secondRun;
+    QVERIFY(engine.run(plan, dataset, nullptr,
+                       [&](size_t point, const XYSineResult*, const QString&) { secondRun.insert(point); }));
+    QCOMPARE(firstRun + secondRun.size(), plan.pointCount());
+    QCOMPARE(dataset.doneCount(), plan.pointCount());
+
+    // Another plan starts over
+    SweepPlan other = makePlan();
+    other.addAxis(SweepAxis::list("amplitude", {2.0}));
+    QVERIFY(!dataset.matches(other));
+    QVERIFY(engine.run(other, dataset, nullptr, nullptr));
+    QCOMPARE(dataset.axisNames().size(), 3);
+}
+
+void SweepEngineTests::testFailedPointsAndExport()
+{
+    FlakyExecutor executor;
+    SweepEngine engine(&executor);
+
+    const SweepPlan plan = makePlan();
+    SweepDataset dataset;
+    QString error;
+    QVERIFY(!engine.run(plan, dataset, nullptr, nullptr, &error));
+    QCOMPARE(dataset.failedCount(), size_t(3));
+    QCOMPARE(dataset.doneCount(), size_t(9));
+    QCOMPARE(dataset.status(3), SweepDataset::PointStatus::Failed);
+    QCOMPARE(dataset.error(3), QString("Bedrock error"));
+    QVERIFY(!dataset.x(3));
+    QCOMPARE(executor.batches, 1);
+
+    // Retried on resume; the done points are not sent again
+    QVERIFY(!engine.run(plan, dataset, nullptr, nullptr));
+    QCOMPARE(executor.batches, 2);
+    QCOMPARE(dataset.failedCount(), size_t(3));
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY2(dataset.exportCsv(&buffer, &error), qPrintable(error));
+    const QList<QByteArray> lines = buffer.data().split('\n');
+    QCOMPARE(lines.first(), QByteArray("point,frequency,phase,x,y"));
+    // Header, 9 points of 200 samples, trailing newline
+    QCOMPARE(lines.size(), 1 + 9 * 200 + 1);
+    QVERIFY(lines[1].startsWith("0,1,0,0,"));
+    QVERIFY(!buffer.data().contains("\n3,2,"));
+}
+
+QTEST_MAIN(SweepEngineTests)
+#include "test_sweep_engine.moc"
@@ -0,0 +1,211 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/BatchRpc.hpp"
+#include "transport/ConnectionManager.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "analysis/LocalExecutor.hpp"
+#include "analysis/RemoteExecutor.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include "FrameTestUtils.hpp"
+
+using namespace phoenix::transport;
+
+namespace {
+
+constexpr int kQuietKeepaliveMs = 60000;
+
+// What executeBatch() reported for one item
+struct ItemOutcome {
+    int calls = 0;
+    size_t samples = 0;
+    QString error;
+};
+
+std::vector<QMap<QString, QVariant>> sweep(int count, int samples)
+{
+    std::vector<QMap<QString, QVariant>> paramSets;
+    for (int i = 0; i < count; ++i) {
+        paramSets.push_back({{QStringLiteral("samples"), samples + i},
+                             {QStringLiteral("frequency"), 1.0 + 0.1 * i}});
+    }
+    return paramSets;
+}
+
+std::vector<ItemOutcome> runBatch(IAnalysisExecutor& executor, const std::vector<QMap<QString, QVariant>>& paramSets,
+                                  double* lastProgress = nullptr)
+{
+    std::vector<ItemOutcome> outcomes(paramSets.size());
+    return callOffThread([&]() {
+        executor.executeBatch(QStringLiteral("xy_sine"), paramSets,
+                              [lastProgress](double fraction) {
+                                  if (lastProgress) {
+                                      *lastProgress = fraction;
+                                  }
+                              },
+                              [&outcomes](size_t index, const XYSineResult* result, const QString& error) {
+                                  ItemOutcome& outcome = outcomes[index];
+                                  ++outcome.calls;
+                                  outcome.samples = result ? result->x.size() : 0;
+                                  outcome.error = error;
+                              });
+        return outcomes;
+    });
+}
+
+MockServerConfig batchServerConfig()
+{
+    MockServerConfig config;
+    config.features = {"xy_sine", kBatchFeature};
+    return config;
+}
+
+} // namespace
+#endif
+
+class BatchRpcTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testBatchPayloadRoundTrip();
+    void testBatchTravelsInOneRequest();
+    void testPerItemErrors();
+    void testFallbackWithoutBatchFeature();
+    void testLargeItemsRunSingly();
+    void testLocalBatchUsesAllItems();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void BatchRpcTest::testBatchPayloadRoundTrip()
+{
+    std::vector<palantir::XYSineRequest> items(3);
+    items[0].set_samples(10);
+    items[1].set_frequency(2.5);
+    items[2].set_phase(0.5);
+
+    std::vector<palantir::XYSineRequest> parsed;
+    QString error;
+    QVERIFY2(parseXYSineBatch(makeXYSineBatch(items).SerializeAsString(), parsed, &error), qPrintable(error));
+    QCOMPARE(parsed.size(), size_t(3));
+    QCOMPARE(parsed[0].samples(), 10);
+    QCOMPARE(parsed[1].frequency(), 2.5);
+    QCOMPARE(parsed[2].phase(), 0.5);
+
+    // Truncated payloads are rejected
+    QVERIFY(!parseXYSineBatch(std::string("\x0a\x05\x01", 3), parsed, &error));
+}
+
+void BatchRpcTest::testBatchTravelsInOneRequest()
+{
+    MockBedrockServer server(batchServerConfig());
+    QVERIFY(server.listen());
+    const QString name = server.socketName();
+    ConnectionManager connections([name]() { return std::make_unique<LocalSocketChannel>(name); },
+                                  kQuietKeepaliveMs);
+    RemoteExecutor executor(&connections);
+    executor.setResultCache(nullptr);  // Every item reaches the server
+    executor.setResultStore(nullptr);
+
+    double progress = 0.0;
+    const auto outcomes = runBatch(executor, sweep(50, 100), &progress);
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        QCOMPARE(outcomes[i].calls, 1);
+        QVERIFY2(outcomes[i].error.isEmpty(), qPrintable(outcomes[i].error));
+        QCOMPARE(outcomes[i].samples, size_t(100 + i));
+    }
+    QCOMPARE(progress, 1.0);
+    QCOMPARE(server.requestsReceived(), uint64_t(2));  // Capabilities + one batch
+    QCOMPARE(server.batchItemsReceived(), uint64_t(50));
+}
+
+void BatchRpcTest::testPerItemErrors()
+{
+    MockServerConfig config = batchServerConfig();
+    config.errorEvery = 3;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+    const QString name = server.socketName();
+    ConnectionManager connections([name]() { return std::make_unique<LocalSocketChannel>(name); },
+                                  kQuietKeepaliveMs);
+    RemoteExecutor executor(&connections);
+    executor.setResultCache(nullptr);  // Every item reaches the server
+    executor.setResultStore(nullptr);
+
+    const auto outcomes = runBatch(executor, sweep(9, 50));
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        QCOMPARE(outcomes[i].calls, 1);
+        if (i % 3 == 2) {
+            QVERIFY(!outcomes[i].error.isEmpty());
+            QCOMPARE(outcomes[i].samples, size_t(0));
+        } else {
+            QVERIFY2(outcomes[i].error.isEmpty(), qPrintable(outcomes[i].error));
+            QCOMPARE(outcomes[i].samples, size_t(50 + i));
+        }
+    }
+}
+
+void BatchRpcTest::testFallbackWithoutBatchFeature()
+{
+    MockBedrockServer server;  // Lists xy_sine only
+    QVERIFY(server.listen());
+    const QString name = server.socketName();
+    ConnectionManager connections([name]() { return std::make_unique<LocalSocketChannel>(name); },
+                                  kQuietKeepaliveMs);
+    RemoteExecutor executor(&connections);
+    executor.setResultCache(nullptr);  // Every item reaches the server
+    executor.setResultStore(nullptr);
+
+    const auto outcomes = runBatch(executor, sweep(5, 100));
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        QCOMPARE(outcomes[i].calls, 1);
+        QCOMPARE(outcomes[i].samples, size_t(100 + i));
+    }
+    QCOMPARE(server.requestsReceived(), uint64_t(6));
+    QCOMPARE(server.batchItemsReceived(), uint64_t(0));
+}
+
+void BatchRpcTest::testLargeItemsRunSingly()
+{
+    MockBedrockServer server(batchServerConfig());
+    QVERIFY(server.listen());
+    const QString name = server.socketName();
+    ConnectionManager connections([name]() { return std::make_unique<LocalSocketChannel>(name); },
+                                  kQuietKeepaliveMs);
+    RemoteExecutor executor(&connections);
+    executor.setResultCache(nullptr);  // Every item reaches the server
+    executor.setResultStore(nullptr);
+
+    // Over DEFAULT_MAX_CHUNK_BYTES: needs a chunked response of its own
+    auto paramSets = sweep(3, 200);
+    paramSets[1][QStringLiteral("samples")] = 300000;
+    const auto outcomes = runBatch(executor, paramSets);
+    QCOMPARE(outcomes[0].samples, size_t(200));
+    QCOMPARE(outcomes[1].samples, size_t(300000));
+    QCOMPARE(outcomes[2].samples, size_t(202));
+    QCOMPARE(server.requestsReceived(), uint64_t(3));  // Capabilities + batch + single
+    QCOMPARE(server.batchItemsReceived(), uint64_t(2));
+}
+
+void BatchRpcTest::testLocalBatchUsesAllItems()
+{
+    LocalExecutor executor;
+    double progress = 0.0;
+    const auto outcomes = runBatch(executor, sweep(64, 32), &progress);
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        QCOMPARE(outcomes[i].calls, 1);
+        QCOMPARE(outcomes[i].samples, size_t(32 + i));
+    }
+    QCOMPARE(progress, 1.0);
+}
+#else
+void BatchRpcTest::testBatchPayloadRoundTrip() { QSKIP("Transport deps not enabled"); }
+void BatchRpcTest::testBatchTravelsInOneRequest() { QSKIP("Transport deps not enabled"); }
+void BatchRpcTest::testPerItemErrors() { QSKIP("Transport deps not enabled"); }
+void BatchRpcTest::testFallbackWithoutBatchFeature() { QSKIP("Transport deps not enabled"); }
+void BatchRpcTest::testLargeItemsRunSingly() { QSKIP("Transport deps not enabled"); }
+void BatchRpcTest::testLocalBatchUsesAllItems() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(BatchRpcTest)
+#include "BatchRpc_test.moc"
@@ -0,0 +1,252 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/BulkData.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "transport/SharedMemoryRegion.hpp"
+#include "palantir/envelope.pb.h"
+#include "palantir/xysine.pb.h"
+#include "FrameTestUtils.hpp"
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace phoenix::transport;
+
+// Bedrock answers for XY Sine: through shared memory when the request
+// accepts it, inline otherwise. Keeps its regions alive so the test can
+// check the client released the names.
+struct BulkAnswers {
+    int samples;
+    bool foreignNames;  // Name regions outside the prefix the client offered
+    bool sawAcceptBulk = false;
+    std::vector<std::unique_ptr<SharedMemoryRegion>> regions;
+
+    explicit BulkAnswers(int samples, bool foreignNames = false)
+        : samples(samples)
+        , foreignNames(foreignNames)
+    {
+    }
+
+    std::string lastRegionName() const { return regions.empty() ? std::string() : regions.back()->name(); }
+
+    MockServerConfig config()
+    {
+        MockServerConfig config;
+        config.onRequest = [this](MockReply& reply) {
+            if (reply.request().type() != palantir::MessageType::XY_SINE_REQUEST) {
+                return false;
+            }
+            answer(reply);
+            return true;
+        };
+        return config;
+    }
+
+    void answer(const MockReply& reply)
+    {
+        const auto& requestMetadata = reply.request().metadata();
+        std::map<std::string, std::string> metadata;
+        palantir::XYSineResponse response;
+        response.set_status("OK");
+
+        sawAcceptBulk = requestMetadata.count(kAcceptBulkShmKey) > 0;
+        if (sawAcceptBulk) {
+            const size_t columnBytes = static_cast<size_t>(samples) * sizeof(double);
+            const std::string regionName = foreignNames
+                ? SharedMemoryRegion::uniqueName()
+                : requestMetadata.at(kAcceptBulkShmKey) + std::to_string(regions.size());
+            auto region = SharedMemoryRegion::create(regionName, 2 * columnBytes);
+            QVERIFY(region);
+            auto* x = reinterpret_cast<double*>(region->mutableData());
+            auto* y = reinterpret_cast<double*>(region->mutableData() + columnBytes);
+            for (int i = 0; i < samples; ++i) {
+                x[i] = i;
+                y[i] = 2.0 * i;
+            }
+            metadata[kBulkShmNameKey] = region->name();
+            metadata[kBulkColumnsKey] = formatBulkColumns({
+                {"x", BulkDType::Float64, 0, columnBytes},
+                {"y", BulkDType::Float64, columnBytes, columnBytes}});
+            regions.push_back(std::move(region));
+        } else {
+            for (int i = 0; i < samples; ++i) {
+                response.add_x(i);
+                response.add_y(2.0 * i);
+            }
+        }
+        reply.send(palantir::MessageType::XY_SINE_RESPONSE, response, std::move(metadata));
+    }
+};
+
+// Runs the blocking XY Sine RPC off the test thread (which hosts the server)
+static std::optional<std::string> streamXYSine(LocalSocketChannel& channel,
+                                               std::vector<double>& x, std::vector<double>& y,
+                                               QString& error)
+{
+    return callOffThread([&]() {
+        palantir::XYSineRequest request;
+        return channel.streamXYSineRequest(
+            request,
+            [&](const LocalSocketChannel::XYSineSlice& slice) {
+                x.assign(slice.x, slice.x + slice.count);
+                y.assign(slice.y, slice.y + slice.count);
+            },
+            &error);
+    });
+}
+#endif
+
+class BulkSharedMemoryTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testBulkColumnsRoundTrip();
+    void testSharedMemoryRegionCreateOpenUnlink();
+    void testXYSineOverSharedMemory();
+    void testInlineFallbackWhenDisabled();
+    void testForeignRegionNamesRefused();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void BulkSharedMemoryTest::testBulkColumnsRoundTrip()
+{
+    const std::vector<BulkColumn> columns = {
+        {"x", BulkDType::Float64, 0, 8000},
+        {"y", BulkDType::Float64, 8000, 8000}};
+    const std::string text = formatBulkColumns(columns);
+    QCOMPARE(text, std::string("x:f64:0:8000;y:f64:8000:8000"));
+
+    std::vector<BulkColumn> parsed;
+    QVERIFY(parseBulkColumns(text, parsed));
+    QCOMPARE(parsed.size(), size_t(2));
+    const BulkColumn* y = findBulkColumn(parsed, "y");
+    QVERIFY(y != nullptr);
+    QCOMPARE(y->offset, uint64_t(8000));
+    QCOMPARE(y->elementCount(), size_t(1000));
+
+    QString error;
+    QVERIFY(!parseBulkColumns("x:f16:0:8", parsed, &error));
+    QVERIFY(!parseBulkColumns("x:f64:zero:8", parsed, &error));
+    QVERIFY(parsed.empty());
+
+    // Bounds and alignment against the mapped region
+    QVERIFY(validateBulkColumn(columns[1], 16000));
+    QVERIFY(!validateBulkColumn(columns[1], 15999, &error));
+    QVERIFY(!validateBulkColumn({"z", BulkDType::Float64, 4, 8}, 64, &error));
+
+    // Region names: the connection's prefix and a plain suffix only
+    const std::string prefix = makeBulkShmPrefix();
+    QVERIFY(prefix != makeBulkShmPrefix());
+    QVERIFY(isAcceptedBulkShmName(prefix + "0", prefix));
+    QVERIFY(isAcceptedBulkShmName(prefix + "42_y", prefix));
+    QVERIFY(!isAcceptedBulkShmName(prefix, prefix));
+    QVERIFY(!isAcceptedBulkShmName(prefix + "../x", prefix));
+    QVERIFY(!isAcceptedBulkShmName(prefix + "a/b", prefix));
+    QVERIFY(!isAcceptedBulkShmName("/phx_1234_0", prefix));
+    QVERIFY(!isAcceptedBulkShmName(prefix + std::string(300, 'a'), prefix));
+    QVERIFY(!isAcceptedBulkShmName("/anything", ""));
+}
+
+void BulkSharedMemoryTest::testSharedMemoryRegionCreateOpenUnlink()
+{
+    const std::string name = SharedMemoryRegion::uniqueName();
+    QString error;
+    auto producer = SharedMemoryRegion::create(name, 4096, &error);
+    QVERIFY2(producer, qPrintable(error));
+    std::memcpy(producer->mutableData(), "bulk", 4);
+
+    auto consumer = SharedMemoryRegion::open(name, &error);
+    QVERIFY2(consumer, qPrintable(error));
+    QVERIFY(consumer->size() >= 4096);
+    QVERIFY(consumer->mutableData() == nullptr);  // Read-only mapping
+    QCOMPARE(QByteArray(consumer->data(), 4), QByteArray("bulk"));
+
+    // Creating the same name twice fails; after unlink the name is gone but
+    // existing mappings stay readable
+    QVERIFY(!SharedMemoryRegion::create(name, 4096));
+    QVERIFY(consumer->unlink());
+    QVERIFY(!SharedMemoryRegion::open(name));
+    QCOMPARE(QByteArray(consumer->data(), 4), QByteArray("bulk"));
+}
+
+void BulkSharedMemoryTest::testXYSineOverSharedMemory()
+{
+    BulkAnswers answers(5000);
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    channel.setBulkSharedMemoryEnabled(true);
+
+    std::vector<double> x;
+    std::vector<double> y;
+    QString error;
+    auto status = streamXYSine(channel, x, y, error);
+    QVERIFY2(status.has_value(), qPrintable(error));
+    QCOMPARE(QString::fromStdString(*status), QString("OK"));
+    QVERIFY(answers.sawAcceptBulk);
+
+    QCOMPARE(x.size(), size_t(5000));
+    QCOMPARE(x[4999], 4999.0);
+    QCOMPARE(y[4999], 9998.0);
+
+    // The client unlinks the region once it has mapped it
+    QVERIFY(!answers.lastRegionName().empty());
+    QVERIFY(!SharedMemoryRegion::open(answers.lastRegionName()));
+}
+
+void BulkSharedMemoryTest::testInlineFallbackWhenDisabled()
+{
+    BulkAnswers answers(100);
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    QVERIFY(!channel.bulkSharedMemoryEnabled());
+
+    std::vector<double> x;
+    std::vector<double> y;
+    QString error;
+    auto status = streamXYSine(channel, x, y, error);
+    QVERIFY2(status.has_value(), qPrintable(error));
+    QVERIFY(!answers.sawAcceptBulk);
+    QCOMPARE(x.size(), size_t(100));
+    QCOMPARE(y[99], 198.0);
+}
+
+void BulkSharedMemoryTest::testForeignRegionNamesRefused()
+{
+    BulkAnswers answers(100, true);
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    channel.setBulkSharedMemoryEnabled(true);
+
+    std::vector<double> x;
+    std::vector<double> y;
+    QString error;
+    auto status = streamXYSine(channel, x, y, error);
+    QVERIFY(!status.has_value());
+    QVERIFY2(error.contains("prefix"), qPrintable(error));
+    QVERIFY(x.empty());
+
+    // The region the server named is neither mapped nor unlinked
+    QVERIFY(!answers.lastRegionName().empty());
+    auto untouched = SharedMemoryRegion::open(answers.lastRegionName());
+    QVERIFY(untouched != nullptr);
+    untouched->unlink();
+}
+#else
+void BulkSharedMemoryTest::testBulkColumnsRoundTrip() { QSKIP("Transport deps not enabled"); }
+void BulkSharedMemoryTest::testSharedMemoryRegionCreateOpenUnlink() { QSKIP("Transport deps not enabled"); }
+void BulkSharedMemoryTest::testXYSineOverSharedMemory() { QSKIP("Transport deps not enabled"); }
+void BulkSharedMemoryTest::testInlineFallbackWhenDisabled() { QSKIP("Transport deps not enabled"); }
+void BulkSharedMemoryTest::testForeignRegionNamesRefused() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(BulkSharedMemoryTest)
+#include "BulkSharedMemory_test.moc"
@@ -0,0 +1,243 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "palantir/envelope.pb.h"
+#include "palantir/error.pb.h"
+#include "palantir/xysine.pb.h"
+#include "FrameTestUtils.hpp"
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <vector>
+
+using namespace phoenix::transport;
+
+// Bedrock answers with a slow XY Sine: every tick advances each running
+// request by one step, reporting progress when asked to, and answers once
+// all steps are done. CANCEL_REQUEST stops the request and ends it with an
+// ERROR_RESPONSE.
+struct SlowAnswers {
+    struct Job {
+        MockReply reply;
+        bool reportProgress = false;
+        int step = 0;
+    };
+
+    int steps;
+    int stepsRun = 0;
+    bool sawAcceptProgress = false;
+    std::vector<Job> jobs;
+    std::vector<std::string> cancelledIds;
+    QTimer timer;
+
+    explicit SlowAnswers(int steps)
+        : steps(steps)
+    {
+        timer.setInterval(10);
+        QObject::connect(&timer, &QTimer::timeout, &timer, [this]() { tick(); });
+        timer.start();
+    }
+
+    MockServerConfig config()
+    {
+        MockServerConfig config;
+        config.onRequest = [this](MockReply& reply) {
+            receive(reply);
+            return true;
+        };
+        return config;
+    }
+
+    void receive(const MockReply& reply)
+    {
+        const std::string id = reply.correlationId();
+        if (reply.request().type() == CANCEL_REQUEST) {
+            cancelledIds.push_back(id);
+            for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+                if (it->reply.correlationId() == id) {
+                    it->reply.sendError(palantir::ErrorCode::INTERNAL_ERROR, "Cancelled");
+                    jobs.erase(it);
+                    break;
+                }
+            }
+            return;
+        }
+
+        const bool reportProgress = reply.request().metadata().count(kAcceptProgressKey) > 0;
+        sawAcceptProgress = sawAcceptProgress || reportProgress;
+        jobs.push_back({reply, reportProgress, 0});
+    }
+
+    void tick()
+    {
+        for (auto it = jobs.begin(); it != jobs.end();) {
+            ++it->step;
+            ++stepsRun;
+            if (it->reportProgress) {
+                palantir::MessageEnvelope update;
+                update.set_version(PROTOCOL_VERSION);
+                update.set_type(PROGRESS_UPDATE);
+                (*update.mutable_metadata())[kCorrelationIdKey] = it->reply.correlationId();
+                setProgressFraction(update, static_cast<double>(it->step) / steps);
+                it->reply.sendEnvelope(update);
+            }
+            if (it->step < steps) {
+                ++it;
+                continue;
+            }
+
+            palantir::XYSineResponse response;
+            response.set_status("OK");
+            response.add_x(0.0);
+            response.add_y(0.0);
+            it->reply.send(palantir::MessageType::XY_SINE_RESPONSE, response);
+            it = jobs.erase(it);
+        }
+    }
+};
+
+// Streams a one-sample XY Sine request, reporting progress and the request ID
+static std::optional<std::string> runSlowRequest(LocalSocketChannel& channel,
+                                                 const LocalSocketChannel::RequestControl& control,
+                                                 QString* outError)
+{
+    palantir::XYSineRequest request;
+    request.set_samples(1);
+    return channel.streamXYSineRequest(
+        request, [](const LocalSocketChannel::XYSineSlice&) {}, outError, {}, std::nullopt, control);
+}
+#endif
+
+class CancellationTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testProgressFractionRoundTrip();
+    void testProgressReachesCallbackBeforeResponse();
+    void testCancelStopsServerComputation();
+    void testCancelWithoutFeatureIsLocalOnly();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void CancellationTest::testProgressFractionRoundTrip()
+{
+    palantir::MessageEnvelope envelope;
+    QVERIFY(!progressFraction(envelope).has_value());
+
+    setProgressFraction(envelope, 0.375);
+    QCOMPARE(*progressFraction(envelope), 0.375);
+
+    // Out-of-range values are clamped, garbage is rejected
+    (*envelope.mutable_metadata())[kProgressKey] = "1.5";
+    QCOMPARE(*progressFraction(envelope), 1.0);
+    (*envelope.mutable_metadata())[kProgressKey] = "half";
+    QVERIFY(!progressFraction(envelope).has_value());
+}
+
+void CancellationTest::testProgressReachesCallbackBeforeResponse()
+{
+    SlowAnswers answers(4);
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    std::mutex mutex;
+    std::vector<double> fractions;
+    LocalSocketChannel::RequestControl control;
+    control.onProgress = [&](double fraction) {
+        std::lock_guard<std::mutex> lock(mutex);
+        fractions.push_back(fraction);
+    };
+
+    QString error;
+    auto status = callOffThread([&]() { return runSlowRequest(channel, control, &error); });
+    QVERIFY2(status.has_value(), qPrintable(error));
+    QVERIFY(answers.sawAcceptProgress);
+
+    // Every update arrives, in order, before the response completes the call
+    std::lock_guard<std::mutex> lock(mutex);
+    QCOMPARE(fractions.size(), size_t(4));
+    QVERIFY(std::is_sorted(fractions.begin(), fractions.end()));
+    QCOMPARE(fractions.back(), 1.0);
+}
+
+void CancellationTest::testCancelStopsServerComputation()
+{
+    SlowAnswers answers(1000);  // About ten seconds of work
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    channel.setCancelEnabled(true);
+
+    std::atomic<uint64_t> sentId{0};
+    std::atomic<int> updates{0};
+    LocalSocketChannel::RequestControl control;
+    control.onProgress = [&](double) { updates.fetch_add(1); };
+    control.onSent = [&](uint64_t id) { sentId.store(id); };
+
+    QString error;
+    auto future = std::async(std::launch::async, [&]() { return runSlowRequest(channel, control, &error); });
+    QTRY_VERIFY(sentId.load() != 0 && updates.load() > 0);
+
+    QVERIFY(channel.cancelRequest(sentId.load()));
+    QTRY_VERIFY(future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready);
+    QVERIFY(!future.get().has_value());
+    QCOMPARE(error, QString("Request cancelled"));
+    QCOMPARE(channel.pendingRequestCount(), 0);
+    QVERIFY(!channel.cancelRequest(sentId.load()));  // Already gone
+
+    // Bedrock hears about it and stops computing
+    QTRY_COMPARE(answers.cancelledIds.size(), size_t(1));
+    QCOMPARE(answers.cancelledIds.front(), std::to_string(sentId.load()));
+    QVERIFY(answers.jobs.empty());
+    const int stepsAtCancel = answers.stepsRun;
+    QTest::qWait(50);
+    QCOMPARE(answers.stepsRun, stepsAtCancel);
+
+    // The channel stays usable; the cancelled request's error is dropped
+    answers.steps = 1;
+    auto status = callOffThread([&]() { return runSlowRequest(channel, {}, &error); });
+    QVERIFY2(status.has_value(), qPrintable(error));
+}
+
+void CancellationTest::testCancelWithoutFeatureIsLocalOnly()
+{
+    SlowAnswers answers(20);
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    QVERIFY(!channel.cancelEnabled());
+
+    std::atomic<uint64_t> sentId{0};
+    LocalSocketChannel::RequestControl control;
+    control.onSent = [&](uint64_t id) { sentId.store(id); };
+
+    QString error;
+    auto future = std::async(std::launch::async, [&]() { return runSlowRequest(channel, control, &error); });
+    QTRY_VERIFY(sentId.load() != 0);
+    QVERIFY(channel.cancelRequest(sentId.load()));
+    QTRY_VERIFY(future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready);
+    QVERIFY(!future.get().has_value());
+
+    // No CANCEL_REQUEST: the server finishes and its late response is dropped
+    QTRY_VERIFY(answers.jobs.empty());
+    QVERIFY(answers.cancelledIds.empty());
+    QCOMPARE(channel.pendingRequestCount(), 0);
+}
+#else
+void CancellationTest::testProgressFractionRoundTrip() { QSKIP("Transport deps not enabled"); }
+void CancellationTest::testProgressReachesCallbackBeforeResponse() { QSKIP("Transport deps not enabled"); }
+void CancellationTest::testCancelStopsServerComputation() { QSKIP("Transport deps not enabled"); }
+void CancellationTest::testCancelWithoutFeatureIsLocalOnly() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(CancellationTest)
+#include "Cancellation_test.moc"
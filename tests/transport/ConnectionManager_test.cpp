@@ -0,0 +1,165 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/ConnectionManager.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "palantir/capabilities.pb.h"
+#include "palantir/envelope.pb.h"
+#include "FrameTestUtils.hpp"
+#include <QUuid>
+#include <memory>
+#include <string>
+
+using namespace phoenix::transport;
+
+// Bedrock answers to CAPABILITIES_REQUEST with a server version the test can
+// change; counts the requests.
+struct CapabilitiesAnswers {
+    std::string version = "1.0";
+    int requests = 0;
+
+    MockServerConfig config()
+    {
+        MockServerConfig config;
+        config.onRequest = [this](MockReply& reply) {
+            if (reply.request().type() != palantir::MessageType::CAPABILITIES_REQUEST) {
+                return true;  // Only capabilities are answered
+            }
+            ++requests;
+            palantir::CapabilitiesResponse response;
+            response.mutable_capabilities()->set_server_version(version);
+            response.mutable_capabilities()->add_supported_features("xy_sine");
+            response.mutable_capabilities()->add_supported_features("transport.shm");
+            reply.send(palantir::MessageType::CAPABILITIES_RESPONSE, response);
+            return true;
+        };
+        return config;
+    }
+};
+
+static ConnectionManager::ChannelFactory channelFactory(const QString& name)
+{
+    return [name]() { return std::make_unique<LocalSocketChannel>(name); };
+}
+
+// Keepalives effectively disabled unless a test asks for them
+static constexpr int kQuietKeepaliveMs = 60000;
+#endif
+
+class ConnectionManagerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testCapabilitiesCachedAcrossRuns();
+    void testReconnectInvalidatesCapabilities();
+    void testBackoffFailsFastAndDoubles();
+    void testKeepaliveRefreshesServerVersion();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void ConnectionManagerTest::testCapabilitiesCachedAcrossRuns()
+{
+    CapabilitiesAnswers answers;
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    ConnectionManager manager(channelFactory(server.socketName()), kQuietKeepaliveMs);
+
+    for (int run = 0; run < 3; ++run) {
+        QString error;
+        auto channel = manager.channel(&error);
+        QVERIFY2(channel, qPrintable(error));
+        auto capabilities = callOffThread([&]() { return manager.capabilities(&error); });
+        QVERIFY2(capabilities, qPrintable(error));
+        QVERIFY(capabilities->supports("xy_sine"));
+        QVERIFY(!capabilities->supports("unknown_feature"));
+    }
+
+    QCOMPARE(manager.connectCount(), 1);
+    QCOMPARE(manager.capabilitiesFetchCount(), 1);
+    QCOMPARE(answers.requests, 1);
+    // The fetch doubled as the first round-trip measurement
+    QVERIFY(manager.rttMicros() > 0);
+}
+
+void ConnectionManagerTest::testReconnectInvalidatesCapabilities()
+{
+    CapabilitiesAnswers answers;
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    ConnectionManager manager(channelFactory(server.socketName()), kQuietKeepaliveMs);
+
+    QString error;
+    auto channel = manager.channel(&error);
+    QVERIFY2(channel, qPrintable(error));
+    auto first = callOffThread([&]() { return manager.capabilities(&error); });
+    QVERIFY2(first, qPrintable(error));
+    QCOMPARE(first->serverVersion, std::string("1.0"));
+
+    // Server restarts with a new version
+    answers.version = "2.0";
+    server.disconnectClients();
+    QTRY_VERIFY(!channel->isConnected());
+
+    QVERIFY2(manager.channel(&error), qPrintable(error));
+    QVERIFY(manager.cachedCapabilities() == nullptr);
+    auto second = callOffThread([&]() { return manager.capabilities(&error); });
+    QVERIFY2(second, qPrintable(error));
+    QCOMPARE(second->serverVersion, std::string("2.0"));
+
+    QCOMPARE(manager.connectCount(), 2);
+    QCOMPARE(manager.capabilitiesFetchCount(), 2);
+}
+
+void ConnectionManagerTest::testBackoffFailsFastAndDoubles()
+{
+    const QString missing = QStringLiteral("phx_conn_test_missing_%1")
+                                .arg(QUuid::createUuid().toString(QUuid::Id128));
+    ConnectionManager manager(channelFactory(missing), kQuietKeepaliveMs);
+
+    QString error;
+    QVERIFY(!manager.channel(&error));
+    QCOMPARE(manager.currentBackoffMs(), 500);
+
+    // Inside the backoff window: no connection attempt
+    QVERIFY(!manager.channel(&error));
+    QVERIFY2(error.contains("retrying"), qPrintable(error));
+    QCOMPARE(manager.currentBackoffMs(), 500);
+
+    // Next attempt once the window has passed
+    QTest::qWait(300);
+    QVERIFY(!manager.channel(&error));
+    QCOMPARE(manager.currentBackoffMs(), 1000);
+    QCOMPARE(manager.connectCount(), 0);
+}
+
+void ConnectionManagerTest::testKeepaliveRefreshesServerVersion()
+{
+    CapabilitiesAnswers answers;
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    ConnectionManager manager(channelFactory(server.socketName()), 100);
+
+    QString error;
+    QVERIFY2(manager.channel(&error), qPrintable(error));
+    auto capabilities = callOffThread([&]() { return manager.capabilities(&error); });
+    QVERIFY2(capabilities, qPrintable(error));
+    QCOMPARE(capabilities->serverVersion, std::string("1.0"));
+
+    // Upgraded in place: the next keepalive picks it up without a reconnect
+    answers.version = "1.1";
+    QTRY_VERIFY(manager.cachedCapabilities()
+                && manager.cachedCapabilities()->serverVersion == "1.1");
+    QCOMPARE(manager.connectCount(), 1);
+    QCOMPARE(manager.capabilitiesFetchCount(), 1);
+}
+#else
+void ConnectionManagerTest::testCapabilitiesCachedAcrossRuns() { QSKIP("Transport deps not enabled"); }
+void ConnectionManagerTest::testReconnectInvalidatesCapabilities() { QSKIP("Transport deps not enabled"); }
+void ConnectionManagerTest::testBackoffFailsFastAndDoubles() { QSKIP("Transport deps not enabled"); }
+void ConnectionManagerTest::testKeepaliveRefreshesServerVersion() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(ConnectionManagerTest)
+#include "ConnectionManager_test.moc"
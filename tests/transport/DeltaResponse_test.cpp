@@ -0,0 +1,273 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/ConnectionManager.hpp"
+#include "transport/DeltaResponse.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "analysis/DeltaBaseSlot.hpp"
+#include "analysis/RemoteExecutor.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include "FrameTestUtils.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace phoenix::transport;
+
+namespace {
+
+constexpr int kQuietKeepaliveMs = 60000;
+
+// A streamed result reassembled from its slices
+struct Streamed {
+    std::vector<double> x;
+    std::vector<double> y;
+    int chunks = 0;
+    QString error;
+    bool ok = false;
+};
+
+Streamed streamSine(LocalSocketChannel& channel, int samples, double frequency, const DeltaBase* base)
+{
+    palantir::XYSineRequest request;
+    request.set_samples(samples);
+    request.set_frequency(frequency);
+    return callOffThread([&]() {
+        Streamed streamed;
+        auto status = channel.streamXYSineRequest(
+            request,
+            [&streamed](const LocalSocketChannel::XYSineSlice& slice) {
+                streamed.x.resize(slice.info.totalSamples);
+                streamed.y.resize(slice.info.totalSamples);
+                std::copy(slice.x, slice.x + slice.count, streamed.x.begin() + slice.info.offset);
+                std::copy(slice.y, slice.y + slice.count, streamed.y.begin() + slice.info.offset);
+                ++streamed.chunks;
+            },
+            &streamed.error, {}, std::nullopt, {}, base);
+        streamed.ok = status.has_value();
+        return streamed;
+    });
+}
+
+DeltaBase baseOf(const Streamed& streamed)
+{
+    DeltaBase base;
+    base.x = streamed.x.data();
+    base.y = streamed.y.data();
+    base.count = streamed.x.size();
+    base.xHash = columnHash(base.x, base.count);
+    base.yHash = columnHash(base.y, base.count);
+    return base;
+}
+
+bool isSine(const std::vector<double>& y, double frequency)
+{
+    for (size_t i = 0; i < y.size(); ++i) {
+        const double t = static_cast<double>(i) / (y.size() - 1.0);
+        if (std::abs(y[i] - std::sin(2.0 * M_PI * frequency * t)) > 1e-9) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+#endif
+
+class DeltaResponseTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testColumnHash();
+    void testBaseColumnsMetadata();
+    void testUnchangedXIsReused();
+    void testReuseAcrossChunks();
+    void testSizeChangeSendsEverything();
+    void testRemoteExecutorReruns();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void DeltaResponseTest::testColumnHash()
+{
+    std::vector<double> column = {0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    const uint64_t hash = columnHash(column.data(), column.size());
+    QCOMPARE(columnHash(column.data(), column.size()), hash);
+
+    // Bit-exact: -0.0 is a different column
+    column[0] = -0.0;
+    QVERIFY(columnHash(column.data(), column.size()) != hash);
+    column[0] = 0.0;
+
+    // Every element counts, including the tail after the last full lane group
+    column[6] = 6.5;
+    QVERIFY(columnHash(column.data(), column.size()) != hash);
+    column[6] = 6.0;
+    QVERIFY(columnHash(column.data(), column.size() - 1) != hash);
+
+    // Swapped elements land in different lanes
+    std::swap(column[1], column[2]);
+    QVERIFY(columnHash(column.data(), column.size()) != hash);
+}
+
+void DeltaResponseTest::testBaseColumnsMetadata()
+{
+    DeltaBase base;
+    base.xHash = 0x0123456789abcdefULL;
+    base.yHash = 0xfedcba9876543210ULL;
+    palantir::MessageEnvelope envelope;
+    std::map<std::string, std::string> metadata;
+    setBaseColumnsMetadata(metadata, base);
+    envelope.mutable_metadata()->insert(metadata.begin(), metadata.end());
+
+    QString error;
+    auto hashes = baseColumnsFromEnvelope(envelope, &error);
+    QVERIFY2(hashes.has_value(), qPrintable(error));
+    QCOMPARE(hashes->at("x"), base.xHash);
+    QCOMPARE(hashes->at("y"), base.yHash);
+
+    (*envelope.mutable_metadata())[kBaseColumnsKey] = "x:not-hex";
+    QVERIFY(!baseColumnsFromEnvelope(envelope, &error).has_value());
+    QVERIFY(!error.isEmpty());
+
+    envelope.mutable_metadata()->erase(kBaseColumnsKey);
+    error.clear();
+    QVERIFY(!baseColumnsFromEnvelope(envelope, &error).has_value());
+    QVERIFY(error.isEmpty());
+}
+
+void DeltaResponseTest::testUnchangedXIsReused()
+{
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    const Streamed first = streamSine(channel, 1000, 1.0, nullptr);
+    QVERIFY2(first.ok, qPrintable(first.error));
+    const DeltaBase base = baseOf(first);
+
+    // New frequency, same samples: only y travels
+    const Streamed second = streamSine(channel, 1000, 2.0, &base);
+    QVERIFY2(second.ok, qPrintable(second.error));
+    QCOMPARE(server.columnsReused(), uint64_t(1));
+    QVERIFY(second.x == first.x);
+    QVERIFY(isSine(second.y, 2.0));
+
+    // Same parameters again: nothing but the envelope travels
+    const DeltaBase secondBase = baseOf(second);
+    const Streamed third = streamSine(channel, 1000, 2.0, &secondBase);
+    QVERIFY2(third.ok, qPrintable(third.error));
+    QCOMPARE(server.columnsReused(), uint64_t(3));
+    QVERIFY(third.x == second.x);
+    QVERIFY(third.y == second.y);
+}
+
+void DeltaResponseTest::testReuseAcrossChunks()
+{
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    // 16 bytes per sample: 3 chunks in full, 2 with x left out
+    const int samples = 600000;
+    const Streamed first = streamSine(channel, samples, 1.0, nullptr);
+    QVERIFY2(first.ok, qPrintable(first.error));
+    QCOMPARE(first.chunks, 3);
+    const DeltaBase base = baseOf(first);
+
+    const Streamed second = streamSine(channel, samples, 3.0, &base);
+    QVERIFY2(second.ok, qPrintable(second.error));
+    QCOMPARE(second.chunks, 2);
+    QVERIFY(second.x == first.x);
+    QVERIFY(isSine(second.y, 3.0));
+}
+
+void DeltaResponseTest::testSizeChangeSendsEverything()
+{
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    const Streamed first = streamSine(channel, 1000, 1.0, nullptr);
+    QVERIFY2(first.ok, qPrintable(first.error));
+    const DeltaBase base = baseOf(first);
+
+    const Streamed second = streamSine(channel, 1001, 1.0, &base);
+    QVERIFY2(second.ok, qPrintable(second.error));
+    QCOMPARE(server.columnsReused(), uint64_t(0));
+    QCOMPARE(second.x.size(), size_t(1001));
+    QVERIFY(isSine(second.y, 1.0));
+}
+
+void DeltaResponseTest::testRemoteExecutorReruns()
+{
+    MockServerConfig config;
+    config.features = {"xy_sine", kDeltaFeature};
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+    const QString name = server.socketName();
+    ConnectionManager connections([name]() { return std::make_unique<LocalSocketChannel>(name); },
+                                  kQuietKeepaliveMs);
+    // A new executor per run, as a window makes them; the slot carries the base
+    auto slot = std::make_shared<DeltaBaseSlot>();
+    auto run = [&connections](double frequency, const std::shared_ptr<DeltaBaseSlot>& base) {
+        return callOffThread([&connections, frequency, base]() {
+            RemoteExecutor executor(&connections);
+            executor.setResultStore(nullptr);  // Runs from earlier test sessions must not answer
+            executor.setDeltaBaseSlot(base);
+            XYSineResult delivered;
+            QString error;
+            executor.execute(QStringLiteral("xy_sine"),
+                             {{QStringLiteral("samples"), 2000}, {QStringLiteral("frequency"), frequency}},
+                             nullptr,
+                             [&delivered](const XYSineResult& result) { delivered = result; },
+                             [&error](const QString& message) { error = message; });
+            return std::make_pair(delivered, error);
+        });
+    };
+
+    const auto first = run(1.0, slot);
+    QVERIFY2(first.second.isEmpty(), qPrintable(first.second));
+    QCOMPARE(server.columnsReused(), uint64_t(0));
+    QVERIFY(slot->get(QStringLiteral("xy_sine")).result != nullptr);
+    QVERIFY(slot->get(QStringLiteral("other")).result == nullptr);
+
+    // Scrubbing the frequency: x comes from the previous result
+    const auto second = run(1.5, slot);
+    QVERIFY2(second.second.isEmpty(), qPrintable(second.second));
+    QCOMPARE(server.columnsReused(), uint64_t(1));
+    QVERIFY(second.first.x == first.first.x);
+    QVERIFY(isSine(second.first.y, 1.5));
+
+    // Without a slot nothing is offered
+    const auto unslotted = run(2.0, nullptr);
+    QVERIFY2(unslotted.second.isEmpty(), qPrintable(unslotted.second));
+    QCOMPARE(server.columnsReused(), uint64_t(1));
+
+    // Reduced precision never uses a base
+    const auto plotOnly = callOffThread([&connections, slot]() {
+        RemoteExecutor executor(&connections);
+        executor.setResultStore(nullptr);
+        executor.setDeltaBaseSlot(slot);
+        QString error;
+        executor.execute(QStringLiteral("xy_sine"),
+                         {{QStringLiteral("samples"), 2000}, {QStringLiteral("transfer_precision"), "float32"}},
+                         nullptr, [](const XYSineResult&) {}, [&error](const QString& message) { error = message; });
+        return error;
+    });
+    QVERIFY2(plotOnly.isEmpty(), qPrintable(plotOnly));
+    QCOMPARE(server.columnsReused(), uint64_t(1));
+}
+#else
+void DeltaResponseTest::testColumnHash() { QSKIP("Transport deps not enabled"); }
+void DeltaResponseTest::testBaseColumnsMetadata() { QSKIP("Transport deps not enabled"); }
+void DeltaResponseTest::testUnchangedXIsReused() { QSKIP("Transport deps not enabled"); }
+void DeltaResponseTest::testReuseAcrossChunks() { QSKIP("Transport deps not enabled"); }
+void DeltaResponseTest::testSizeChangeSendsEverything() { QSKIP("Transport deps not enabled"); }
+void DeltaResponseTest::testRemoteExecutorReruns() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(DeltaResponseTest)
+#include "DeltaResponse_test.moc"
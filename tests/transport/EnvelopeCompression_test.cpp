@@ -0,0 +1,267 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "transport/FrameCodec.hpp"
+#include "palantir/envelope.pb.h"
+#include "palantir/xysine.pb.h"
+#include "FrameTestUtils.hpp"
+#include <QElapsedTimer>
+#include <cmath>
+#include <random>
+#include <string>
+
+using namespace phoenix::transport;
+
+static palantir::XYSineResponse makeSineResponse(int samples)
+{
+    palantir::XYSineResponse response;
+    response.set_status("OK");
+    for (int i = 0; i < samples; ++i) {
+        const double x = static_cast<double>(i) / samples;
+        response.add_x(x);
+        response.add_y(std::sin(2.0 * M_PI * 3.0 * x));
+    }
+    return response;
+}
+
+// Bedrock answers for XY Sine: compresses every response payload (no
+// threshold) when the request accepts zlib. Records the last payload size
+// on the wire.
+struct CompressingAnswers {
+    bool sawAcceptEncoding = false;
+    size_t lastWirePayloadBytes = 0;
+
+    MockServerConfig config()
+    {
+        MockServerConfig config;
+        config.onRequest = [this](MockReply& reply) {
+            if (reply.request().type() != palantir::MessageType::XY_SINE_REQUEST) {
+                return false;
+            }
+            answer(reply);
+            return true;
+        };
+        return config;
+    }
+
+    void answer(const MockReply& reply)
+    {
+        const palantir::MessageEnvelope& request = reply.request();
+        palantir::XYSineRequest sineRequest;
+        sineRequest.ParseFromString(request.payload());
+
+        auto accept = request.metadata().find(kAcceptEncodingKey);
+        sawAcceptEncoding = accept != request.metadata().end() && accept->second == "zlib";
+        CompressionOptions compression;
+        if (sawAcceptEncoding) {
+            compression.encoding = PayloadEncoding::Zlib;
+            compression.threshold = 0;
+        }
+
+        auto envelope = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE,
+                                     makeSineResponse(sineRequest.samples()),
+                                     {{kCorrelationIdKey, reply.correlationId()}},
+                                     compression);
+        lastWirePayloadBytes = envelope->payload().size();
+        reply.sendEnvelope(*envelope);
+    }
+};
+#endif
+
+class EnvelopeCompressionTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testCompressedEnvelopeRoundTrip();
+    void testSmallAndIncompressiblePayloadsStayPlain();
+    void testRejectsUnknownEncodingAndOversizeOutput();
+    void testEnvelopeViewDecompressesPayload();
+    void testChannelNegotiatesCompression();
+    void benchmarkEndToEndByPayloadSize();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void EnvelopeCompressionTest::testCompressedEnvelopeRoundTrip()
+{
+    const palantir::XYSineResponse response = makeSineResponse(20000);
+    CompressionOptions compression;
+    compression.encoding = PayloadEncoding::Zlib;
+
+    QString error;
+    auto envelope = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response, {}, compression, &error);
+    QVERIFY2(envelope.has_value(), qPrintable(error));
+    QCOMPARE(envelope->metadata().at(kPayloadEncodingKey), std::string("zlib"));
+    QVERIFY(envelope->payload().size() < response.ByteSizeLong());
+
+    std::string serialized;
+    QVERIFY(envelope->SerializeToString(&serialized));
+    palantir::MessageEnvelope parsed;
+    QVERIFY2(parseEnvelope(serialized.data(), serialized.size(), parsed, &error), qPrintable(error));
+
+    // Receivers always see the plain payload
+    QCOMPARE(parsed.metadata().count(kPayloadEncodingKey), size_t(0));
+    QCOMPARE(parsed.payload(), response.SerializeAsString());
+}
+
+void EnvelopeCompressionTest::testSmallAndIncompressiblePayloadsStayPlain()
+{
+    CompressionOptions compression;
+    compression.encoding = PayloadEncoding::Zlib;
+
+    // Below the threshold
+    palantir::XYSineRequest request;
+    request.set_samples(1000);
+    auto small = makeEnvelope(palantir::MessageType::XY_SINE_REQUEST, request, {}, compression);
+    QVERIFY(small.has_value());
+    QCOMPARE(small->metadata().count(kPayloadEncodingKey), size_t(0));
+
+    // Random doubles do not shrink: sent as-is even above the threshold
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+    palantir::XYSineResponse response;
+    for (int i = 0; i < 20000; ++i) {
+        response.add_x(noise(rng));
+        response.add_y(noise(rng));
+    }
+    compression.threshold = 0;
+    auto noisy = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response, {}, compression);
+    QVERIFY(noisy.has_value());
+    if (noisy->metadata().count(kPayloadEncodingKey) > 0) {
+        QVERIFY(noisy->payload().size() < response.ByteSizeLong());
+    }
+
+    // Identity never compresses
+    compression.encoding = PayloadEncoding::Identity;
+    auto plain = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, makeSineResponse(20000), {}, compression);
+    QVERIFY(plain.has_value());
+    QCOMPARE(plain->metadata().count(kPayloadEncodingKey), size_t(0));
+}
+
+void EnvelopeCompressionTest::testRejectsUnknownEncodingAndOversizeOutput()
+{
+    palantir::MessageEnvelope envelope;
+    envelope.set_version(PROTOCOL_VERSION);
+    envelope.set_type(palantir::MessageType::XY_SINE_RESPONSE);
+    envelope.set_payload(std::string("\x7f\xff\xff\xff" "abc", 7));  // Claims ~2 GB once inflated
+    (*envelope.mutable_metadata())[kPayloadEncodingKey] = "zlib";
+
+    QString error;
+    QVERIFY(!decompressPayload(envelope, &error));
+    QVERIFY(error.contains("too large"));
+
+    (*envelope.mutable_metadata())[kPayloadEncodingKey] = "brotli";
+    QVERIFY(!decompressPayload(envelope, &error));
+    QVERIFY(error.contains("Unsupported payload encoding"));
+
+    // Corrupt zlib stream with a plausible size header
+    envelope.set_payload(std::string("\x00\x00\x01\x00" "garbage", 11));
+    (*envelope.mutable_metadata())[kPayloadEncodingKey] = "zlib";
+    std::string serialized;
+    envelope.SerializeToString(&serialized);
+    palantir::MessageEnvelope parsed;
+    QVERIFY(!parseEnvelope(serialized.data(), serialized.size(), parsed, &error));
+
+    // Compressing an already-encoded envelope is a caller bug
+    CompressionOptions compression;
+    compression.encoding = PayloadEncoding::Zlib;
+    QVERIFY(!compressPayload(envelope, compression, &error));
+}
+
+void EnvelopeCompressionTest::testEnvelopeViewDecompressesPayload()
+{
+    const palantir::XYSineResponse response = makeSineResponse(20000);
+    CompressionOptions compression;
+    compression.encoding = PayloadEncoding::Zlib;
+    auto envelope = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response, {}, compression);
+    QVERIFY(envelope.has_value());
+    const std::string serialized = envelope->SerializeAsString();
+
+    EnvelopeView view;
+    QString error;
+    QVERIFY2(decodeEnvelopeView(serialized.data(), serialized.size(), view, &error), qPrintable(error));
+    google::protobuf::Arena arena;
+    auto* parsed = parsePayload<palantir::XYSineResponse>(view, arena);
+    QVERIFY(parsed != nullptr);
+    QCOMPARE(parsed->y_size(), 20000);
+    QCOMPARE(parsed->y(19999), response.y(19999));
+}
+
+void EnvelopeCompressionTest::testChannelNegotiatesCompression()
+{
+    CompressingAnswers answers;
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    palantir::XYSineRequest request;
+    request.set_samples(5000);
+    QString error;
+
+    // Not negotiated: plain payload
+    auto plain = callOffThread([&]() { return channel.sendXYSineRequest(request, &error); });
+    QVERIFY2(plain.has_value(), qPrintable(error));
+    QVERIFY(!answers.sawAcceptEncoding);
+
+    channel.setCompressionEnabled(true);
+    auto compressed = callOffThread([&]() { return channel.sendXYSineRequest(request, &error); });
+    QVERIFY2(compressed.has_value(), qPrintable(error));
+    QVERIFY(answers.sawAcceptEncoding);
+    QVERIFY(answers.lastWirePayloadBytes < plain->ByteSizeLong());
+    QCOMPARE(compressed->x_size(), 5000);
+    QCOMPARE(compressed->y(4999), plain->y(4999));
+}
+
+void EnvelopeCompressionTest::benchmarkEndToEndByPayloadSize()
+{
+    // Full round trip over a local socket (server serialize + compress,
+    // socket copies, client inflate + parse) per payload size, with and
+    // without compression. Use the crossover to tune the threshold.
+    CompressingAnswers answers;
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    constexpr int repetitions = 5;
+    for (int samples : {1000, 4000, 16000, 64000, 256000}) {
+        palantir::XYSineRequest request;
+        request.set_samples(samples);
+
+        qint64 elapsedNs[2] = {0, 0};
+        size_t wireBytes[2] = {0, 0};
+        for (int mode = 0; mode < 2; ++mode) {
+            channel.setCompressionEnabled(mode == 1);
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < repetitions; ++i) {
+                QString error;
+                auto response = callOffThread([&]() { return channel.sendXYSineRequest(request, &error); });
+                QVERIFY2(response.has_value(), qPrintable(error));
+                QCOMPARE(response->x_size(), samples);
+            }
+            elapsedNs[mode] = timer.nsecsElapsed();
+            wireBytes[mode] = answers.lastWirePayloadBytes;
+        }
+
+        qDebug().noquote() << QString("[PERF] payload_bytes=%1 identity_us=%2 zlib_us=%3 zlib_bytes=%4")
+                                  .arg(wireBytes[0])
+                                  .arg(elapsedNs[0] / 1000.0 / repetitions, 0, 'f', 1)
+                                  .arg(elapsedNs[1] / 1000.0 / repetitions, 0, 'f', 1)
+                                  .arg(wireBytes[1]);
+    }
+}
+#else
+void EnvelopeCompressionTest::testCompressedEnvelopeRoundTrip() { QSKIP("Transport deps not enabled"); }
+void EnvelopeCompressionTest::testSmallAndIncompressiblePayloadsStayPlain() { QSKIP("Transport deps not enabled"); }
+void EnvelopeCompressionTest::testRejectsUnknownEncodingAndOversizeOutput() { QSKIP("Transport deps not enabled"); }
+void EnvelopeCompressionTest::testEnvelopeViewDecompressesPayload() { QSKIP("Transport deps not enabled"); }
+void EnvelopeCompressionTest::testChannelNegotiatesCompression() { QSKIP("Transport deps not enabled"); }
+void EnvelopeCompressionTest::benchmarkEndToEndByPayloadSize() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(EnvelopeCompressionTest)
+#include "EnvelopeCompression_test.moc"
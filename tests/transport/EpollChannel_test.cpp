@@ -0,0 +1,179 @@
+#include <QtTest/QtTest>
+
+#if defined(PHX_WITH_TRANSPORT_DEPS) && defined(__linux__)
+#include "MockBedrockServer.hpp"
+#include "transport/EpollChannel.hpp"
+#include "transport/TransportFactory.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "FrameTestUtils.hpp"
+#include <atomic>
+#include <vector>
+
+using namespace phoenix::transport;
+
+namespace {
+
+palantir::XYSineRequest xySineRequest(int samples)
+{
+    palantir::XYSineRequest request;
+    request.set_samples(samples);
+    request.set_frequency(1.0);
+    request.set_amplitude(1.0);
+    return request;
+}
+
+// Reply handed from the I/O thread to the test thread
+struct ReplySlot {
+    EpollChannel::Reply reply;
+    std::atomic<bool> done{false};
+
+    EpollChannel::ReplyCallback callback()
+    {
+        return [this](EpollChannel::Reply r) {
+            reply = std::move(r);
+            done.store(true);
+        };
+    }
+};
+
+} // namespace
+#endif
+
+class EpollChannelTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRoundTrips();
+    void testConcurrentRequestsBatchWrites();
+    void testChunkedResponse();
+    void testServerCloseFailsPendingRequests();
+    void testFactoryBackend();
+};
+
+#if defined(PHX_WITH_TRANSPORT_DEPS) && defined(__linux__)
+void EpollChannelTest::testRoundTrips()
+{
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+    EpollChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    QVERIFY(channel.isConnected());
+
+    QString error;
+    auto capabilities = callOffThread([&]() { return channel.getCapabilities(&error); });
+    QVERIFY2(capabilities.has_value(), qPrintable(error));
+    QCOMPARE(capabilities->capabilities().supported_features_size(), 1);
+
+    auto response = callOffThread([&]() { return channel.sendXYSineRequest(xySineRequest(1000), &error); });
+    QVERIFY2(response.has_value(), qPrintable(error));
+    QCOMPARE(response->x_size(), 1000);
+    QCOMPARE(response->y_size(), 1000);
+
+    channel.disconnect();
+    QVERIFY(!channel.isConnected());
+    QVERIFY(!callOffThread([&]() { return channel.getCapabilities(&error); }).has_value());
+}
+
+void EpollChannelTest::testConcurrentRequestsBatchWrites()
+{
+    MockServerConfig config;
+    config.responseDelayMs = 50;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+    EpollChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    constexpr int kRequests = 64;
+    std::atomic<int> succeeded{0};
+    std::atomic<int> finished{0};
+    for (int i = 0; i < kRequests; ++i) {
+        channel.sendRequest(palantir::MessageType::XY_SINE_REQUEST, xySineRequest(100 + i),
+                            [&](EpollChannel::Reply reply) {
+                                if (reply.envelope
+                                    && reply.envelope->type() == palantir::MessageType::XY_SINE_RESPONSE) {
+                                    succeeded.fetch_add(1);
+                                }
+                                finished.fetch_add(1);
+                            });
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(finished.load(), kRequests, 5000);
+    QCOMPARE(succeeded.load(), kRequests);
+
+    const EpollChannel::IoStats stats = channel.ioStats();
+    QCOMPARE(stats.framesWritten, uint64_t(kRequests));
+    QVERIFY(stats.writeCalls >= 1);
+    QVERIFY(stats.writeCalls <= stats.framesWritten);
+    QCOMPARE(stats.framesRead, uint64_t(kRequests));
+    QCOMPARE(server.requestsReceived(), uint64_t(kRequests));
+}
+
+void EpollChannelTest::testChunkedResponse()
+{
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+    EpollChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    constexpr int kSamples = 20000;
+    std::vector<ChunkInfo> chunks;  // Written before last.done is set
+    ReplySlot last;
+    channel.sendRequest(
+        palantir::MessageType::XY_SINE_REQUEST, xySineRequest(kSamples), last.callback(),
+        [&](const palantir::MessageEnvelope& chunk) { chunks.push_back(chunkInfo(chunk).value_or(ChunkInfo{})); },
+        {{kMaxChunkBytesKey, "65536"}});
+    QTRY_VERIFY_WITH_TIMEOUT(last.done.load(), 5000);
+    QVERIFY2(last.reply.envelope.has_value(), qPrintable(last.reply.error));
+
+    // Every chunk but the last went to onChunk, in order
+    const auto final = chunkInfo(*last.reply.envelope);
+    QVERIFY(final.has_value());
+    QCOMPARE(chunks.size(), size_t(final->count - 1));
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        QCOMPARE(chunks[i].index, uint32_t(i));
+        QCOMPARE(chunks[i].totalSamples, uint64_t(kSamples));
+    }
+    QCOMPARE(final->index, final->count - 1);
+}
+
+void EpollChannelTest::testServerCloseFailsPendingRequests()
+{
+    MockServerConfig config;
+    config.responseDelayMs = 1000;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+    EpollChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    ReplySlot pending;
+    channel.sendRequest(palantir::MessageType::XY_SINE_REQUEST, xySineRequest(100), pending.callback());
+    QTRY_COMPARE_WITH_TIMEOUT(server.requestsReceived(), uint64_t(1), 5000);
+
+    server.close();
+    QTRY_VERIFY_WITH_TIMEOUT(pending.done.load(), 5000);
+    QVERIFY(!pending.reply.envelope.has_value());
+    QVERIFY(!pending.reply.error.isEmpty());
+    QTRY_VERIFY_WITH_TIMEOUT(!channel.isConnected(), 5000);
+
+    // Requests after the drop fail right away
+    ReplySlot late;
+    QCOMPARE(channel.sendRequest(palantir::MessageType::XY_SINE_REQUEST, xySineRequest(100), late.callback()),
+             uint64_t(0));
+    QVERIFY(late.done.load());
+    QVERIFY(!late.reply.envelope.has_value());
+}
+
+void EpollChannelTest::testFactoryBackend()
+{
+    auto client = TransportFactory::makeTransportClient(TransportBackend::Epoll);
+    QVERIFY(dynamic_cast<EpollChannel*>(client.get()) != nullptr);
+}
+#else
+void EpollChannelTest::testRoundTrips() { QSKIP("Transport deps not enabled or not Linux"); }
+void EpollChannelTest::testConcurrentRequestsBatchWrites() { QSKIP("Transport deps not enabled or not Linux"); }
+void EpollChannelTest::testChunkedResponse() { QSKIP("Transport deps not enabled or not Linux"); }
+void EpollChannelTest::testServerCloseFailsPendingRequests() { QSKIP("Transport deps not enabled or not Linux"); }
+void EpollChannelTest::testFactoryBackend() { QSKIP("Transport deps not enabled or not Linux"); }
+#endif
+
+QTEST_MAIN(EpollChannelTest)
+#include "EpollChannel_test.moc"
@@ -0,0 +1,350 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "transport/FrameCodec.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "transport/RingBuffer.hpp"
+#include "palantir/envelope.pb.h"
+#include "palantir/xysine.pb.h"
+#include <QElapsedTimer>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// Allocation counting for the round-trip benchmark: counts operator new
+// calls made by the measuring thread while counting is enabled.
+static std::atomic<size_t> g_allocationCount{0};
+static thread_local bool t_countAllocations = false;
+
+void* operator new(std::size_t size)
+{
+    if (t_countAllocations) {
+        g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// Counts allocations made by fn on this thread
+template <typename Fn>
+static size_t countAllocations(Fn&& fn)
+{
+    g_allocationCount.store(0);
+    t_countAllocations = true;
+    fn();
+    t_countAllocations = false;
+    return g_allocationCount.load();
+}
+
+using namespace phoenix::transport;
+
+static palantir::XYSineResponse makeResponse(int samples)
+{
+    palantir::XYSineResponse response;
+    for (int i = 0; i < samples; ++i) {
+        response.add_x(i * 0.001);
+        response.add_y(i * -0.001);
+    }
+    response.set_status("OK");
+    return response;
+}
+#endif
+
+class FrameCodecTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRingBufferCompactsAndGrows();
+    void testEncodeFrameMatchesProtobuf();
+    void testDecodeEnvelopeView();
+    void testDecodeRejectsInvalidEnvelopes();
+    void testFrameDecoderHandlesPartialAndOversizeFrames();
+    void benchmarkAllocationsPerRoundTrip();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void FrameCodecTest::testRingBufferCompactsAndGrows()
+{
+    RingBuffer buffer(16);
+    std::memcpy(buffer.prepareWrite(12), "0123456789ab", 12);
+    buffer.commitWrite(12);
+    buffer.consume(10);
+    QCOMPARE(buffer.size(), size_t(2));
+
+    // 2 unread + 10 new fits in 16: compacts instead of growing
+    std::memcpy(buffer.prepareWrite(10), "cdefghijkl", 10);
+    buffer.commitWrite(10);
+    QCOMPARE(buffer.capacity(), size_t(16));
+    QCOMPARE(QByteArray(buffer.data(), static_cast<qsizetype>(buffer.size())), QByteArray("abcdefghijkl"));
+
+    // Does not fit: grows and keeps unread bytes
+    std::memcpy(buffer.prepareWrite(20), "mnopqrstuvwxyz012345", 20);
+    buffer.commitWrite(20);
+    QVERIFY(buffer.capacity() >= 32);
+    QCOMPARE(QByteArray(buffer.data(), static_cast<qsizetype>(buffer.size())),
+             QByteArray("abcdefghijklmnopqrstuvwxyz012345"));
+
+    buffer.consume(buffer.size());
+    QVERIFY(buffer.empty());
+}
+
+void FrameCodecTest::testEncodeFrameMatchesProtobuf()
+{
+    palantir::XYSineResponse response = makeResponse(100);
+    const std::map<std::string, std::string> metadata = {
+        {kCorrelationIdKey, "42"}, {"empty", ""}};
+
+    std::string frame;
+    QString error;
+    QVERIFY2(encodeFrame(palantir::MessageType::XY_SINE_RESPONSE, response, metadata, frame, &error),
+             qPrintable(error));
+
+    uint32_t length = 0;
+    std::memcpy(&length, frame.data(), FRAME_HEADER_SIZE);
+    QCOMPARE(size_t(length), frame.size() - FRAME_HEADER_SIZE);
+
+    // The standard protobuf parser must read exactly what makeEnvelope() would produce
+    palantir::MessageEnvelope parsed;
+    QVERIFY(parseEnvelope(frame.data() + FRAME_HEADER_SIZE, length, parsed, &error));
+    auto expected = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response, metadata);
+    QVERIFY(expected.has_value());
+    QCOMPARE(parsed.version(), expected->version());
+    QCOMPARE(parsed.type(), expected->type());
+    QVERIFY(parsed.payload() == expected->payload());
+    QCOMPARE(parsed.metadata_size(), 2);
+    QCOMPARE(parsed.metadata().at(kCorrelationIdKey), std::string("42"));
+    QCOMPARE(parsed.metadata().at("empty"), std::string());
+
+    // Empty inner message: payload omitted, as protobuf does for proto3 bytes
+    palantir::XYSineRequest emptyRequest;
+    QVERIFY(encodeFrame(palantir::MessageType::XY_SINE_REQUEST, emptyRequest, {}, frame));
+    QVERIFY(parseEnvelope(frame.data() + FRAME_HEADER_SIZE, frame.size() - FRAME_HEADER_SIZE, parsed));
+    QVERIFY(parsed.payload().empty());
+}
+
+void FrameCodecTest::testDecodeEnvelopeView()
+{
+    palantir::XYSineResponse response = makeResponse(10);
+    auto envelope = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response,
+                                 {{kCorrelationIdKey, "7"}, {kChunkIndexKey, "0"}});
+    QVERIFY(envelope.has_value());
+    std::string serialized;
+    QVERIFY(envelope->SerializeToString(&serialized));
+
+    EnvelopeView view;
+    QString error;
+    QVERIFY2(decodeEnvelopeView(serialized.data(), serialized.size(), view, &error), qPrintable(error));
+    QCOMPARE(view.version, PROTOCOL_VERSION);
+    QCOMPARE(view.type, palantir::MessageType::XY_SINE_RESPONSE);
+    QCOMPARE(view.metadata.size(), size_t(2));
+    QVERIFY(view.metadataValue(kCorrelationIdKey) == std::string_view("7"));
+    QVERIFY(!view.metadataValue("missing").has_value());
+
+    // Payload is a view into the envelope bytes, not a copy
+    QVERIFY(view.payload.data() >= serialized.data());
+    QVERIFY(view.payload.data() + view.payload.size() <= serialized.data() + serialized.size());
+
+    google::protobuf::Arena arena;
+    auto* parsed = parsePayload<palantir::XYSineResponse>(view, arena);
+    QVERIFY(parsed != nullptr);
+    QCOMPARE(parsed->GetArena(), &arena);
+    QCOMPARE(parsed->x_size(), 10);
+    QCOMPARE(parsed->y(9), response.y(9));
+    QCOMPARE(parsed->status(), std::string("OK"));
+}
+
+void FrameCodecTest::testDecodeRejectsInvalidEnvelopes()
+{
+    EnvelopeView view;
+    QString error;
+    QVERIFY(!decodeEnvelopeView("", 0, view, &error));
+
+    palantir::MessageEnvelope envelope;
+    envelope.set_version(MAX_PROTOCOL_VERSION + 1);
+    envelope.set_type(palantir::MessageType::XY_SINE_RESPONSE);
+    std::string serialized = envelope.SerializeAsString();
+    QVERIFY(!decodeEnvelopeView(serialized.data(), serialized.size(), view, &error));
+    QVERIFY(error.contains("Invalid protocol version"));
+
+    envelope.set_version(PROTOCOL_VERSION);
+    envelope.set_type(palantir::MessageType::MESSAGE_TYPE_UNSPECIFIED);
+    serialized = envelope.SerializeAsString();
+    QVERIFY(!decodeEnvelopeView(serialized.data(), serialized.size(), view, &error));
+    QVERIFY(error.contains("UNSPECIFIED"));
+
+    // Truncated payload length
+    envelope.set_type(palantir::MessageType::XY_SINE_RESPONSE);
+    envelope.set_payload(std::string(100, 'x'));
+    serialized = envelope.SerializeAsString();
+    QVERIFY(!decodeEnvelopeView(serialized.data(), serialized.size() - 10, view, &error));
+    QVERIFY(error.contains("Failed to parse"));
+}
+
+void FrameCodecTest::testFrameDecoderHandlesPartialAndOversizeFrames()
+{
+    palantir::XYSineResponse response = makeResponse(50);
+    std::string first;
+    std::string second;
+    QVERIFY(encodeFrame(palantir::MessageType::XY_SINE_RESPONSE, response, {{kCorrelationIdKey, "1"}}, first));
+    QVERIFY(encodeFrame(palantir::MessageType::XY_SINE_RESPONSE, response, {{kCorrelationIdKey, "2"}}, second));
+    const std::string stream = first + second;
+
+    // Feed one byte at a time (worst-case socket fragmentation) into a small buffer
+    FrameDecoder decoder(1024 * 1024, 8);
+    QList<std::string> correlationIds;
+    for (char byte : stream) {
+        *decoder.buffer().prepareWrite(1) = byte;
+        decoder.buffer().commitWrite(1);
+
+        const char* body = nullptr;
+        uint32_t length = 0;
+        while (decoder.nextFrame(&body, &length) == FrameDecoder::Status::FrameReady) {
+            EnvelopeView view;
+            QVERIFY(decodeEnvelopeView(body, length, view));
+            correlationIds.append(std::string(*view.metadataValue(kCorrelationIdKey)));
+            decoder.consumeFrame(length);
+        }
+    }
+    QCOMPARE(correlationIds, QList<std::string>({"1", "2"}));
+    QVERIFY(decoder.buffer().empty());
+
+    // Declared length above the limit is reported before the body arrives
+    FrameDecoder small(16);
+    const uint32_t hugeLength = 1000;
+    std::memcpy(small.buffer().prepareWrite(FRAME_HEADER_SIZE), &hugeLength, FRAME_HEADER_SIZE);
+    small.buffer().commitWrite(FRAME_HEADER_SIZE);
+    const char* body = nullptr;
+    uint32_t length = 0;
+    QCOMPARE(small.nextFrame(&body, &length), FrameDecoder::Status::FrameTooLarge);
+    QCOMPARE(length, hugeLength);
+}
+
+void FrameCodecTest::benchmarkAllocationsPerRoundTrip()
+{
+    // One round trip = encode a request frame + receive and decode a
+    // 1000-sample XY Sine response frame into its inner message.
+    constexpr int iterations = 200;
+    palantir::XYSineRequest request;
+    request.set_frequency(2.0);
+    request.set_samples(1000);
+    const std::map<std::string, std::string> metadata = {{kCorrelationIdKey, "12345"}};
+
+    std::string responseFrame;
+    QVERIFY(encodeFrame(palantir::MessageType::XY_SINE_RESPONSE, makeResponse(1000), metadata, responseFrame));
+    const qsizetype responseSize = static_cast<qsizetype>(responseFrame.size());
+
+    // Previous path: temporary payload string, heap envelope, serialized copy,
+    // QByteArray frame; readAll()/append()/mid()/remove() on receive, then a
+    // heap envelope and a second parse of payload()
+    QByteArray readBuffer;
+    double checksum = 0.0;
+    auto legacyRoundTrip = [&]() {
+        std::string serializedPayload;
+        request.SerializeToString(&serializedPayload);
+        palantir::MessageEnvelope envelope;
+        envelope.set_version(PROTOCOL_VERSION);
+        envelope.set_type(palantir::MessageType::XY_SINE_REQUEST);
+        envelope.set_payload(serializedPayload);
+        for (const auto& [key, value] : metadata) {
+            (*envelope.mutable_metadata())[key] = value;
+        }
+        std::string serialized;
+        envelope.SerializeToString(&serialized);
+        uint32_t length = static_cast<uint32_t>(serialized.size());
+        QByteArray frame;
+        frame.reserve(static_cast<qsizetype>(4 + serialized.size()));
+        frame.append(reinterpret_cast<const char*>(&length), 4);
+        frame.append(serialized.data(), static_cast<qsizetype>(serialized.size()));
+
+        const QByteArray readAll(responseFrame.data(), responseSize);
+        readBuffer.append(readAll);
+        std::memcpy(&length, readBuffer.constData(), 4);
+        const QByteArray body = readBuffer.mid(4, static_cast<qsizetype>(length));
+        readBuffer.remove(0, static_cast<qsizetype>(4 + length));
+        palantir::MessageEnvelope responseEnvelope;
+        parseEnvelope(body, responseEnvelope);
+        palantir::XYSineResponse response;
+        response.ParseFromString(responseEnvelope.payload());
+        checksum += response.y(999);
+    };
+
+    // Codec path: frame encoded in place into a reused buffer, socket bytes
+    // read into the ring buffer, envelope and payload decoded from those bytes
+    // with the inner message on a reused arena
+    std::string requestFrame;
+    FrameDecoder decoder(10 * 1024 * 1024);
+    std::vector<char> arenaBlock(256 * 1024);
+    google::protobuf::ArenaOptions arenaOptions;
+    arenaOptions.initial_block = arenaBlock.data();
+    arenaOptions.initial_block_size = arenaBlock.size();
+    google::protobuf::Arena arena(arenaOptions);
+    EnvelopeView view;
+    auto codecRoundTrip = [&]() {
+        encodeFrame(palantir::MessageType::XY_SINE_REQUEST, request, metadata, requestFrame);
+
+        std::memcpy(decoder.buffer().prepareWrite(responseFrame.size()), responseFrame.data(), responseFrame.size());
+        decoder.buffer().commitWrite(responseFrame.size());
+        const char* body = nullptr;
+        uint32_t length = 0;
+        decoder.nextFrame(&body, &length);
+        decodeEnvelopeView(body, length, view);
+        auto* response = parsePayload<palantir::XYSineResponse>(view, arena);
+        checksum += response->y(999);
+        decoder.consumeFrame(length);
+        arena.Reset();
+    };
+
+    // Warm up both paths (buffer capacities, arena blocks)
+    legacyRoundTrip();
+    codecRoundTrip();
+
+    QElapsedTimer timer;
+    timer.start();
+    const size_t legacyAllocations = countAllocations([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            legacyRoundTrip();
+        }
+    });
+    const qint64 legacyNs = timer.nsecsElapsed();
+
+    timer.restart();
+    const size_t codecAllocations = countAllocations([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            codecRoundTrip();
+        }
+    });
+    const qint64 codecNs = timer.nsecsElapsed();
+
+    qDebug() << "[PERF] allocations per round trip: legacy" << double(legacyAllocations) / iterations
+             << "codec" << double(codecAllocations) / iterations;
+    qDebug() << "[PERF] time per round trip (us): legacy" << legacyNs / 1000.0 / iterations
+             << "codec" << codecNs / 1000.0 / iterations;
+    QVERIFY(checksum != 0.0);
+
+    QVERIFY(codecAllocations < legacyAllocations);
+}
+#else
+void FrameCodecTest::testRingBufferCompactsAndGrows() { QSKIP("Transport deps not enabled"); }
+void FrameCodecTest::testEncodeFrameMatchesProtobuf() { QSKIP("Transport deps not enabled"); }
+void FrameCodecTest::testDecodeEnvelopeView() { QSKIP("Transport deps not enabled"); }
+void FrameCodecTest::testDecodeRejectsInvalidEnvelopes() { QSKIP("Transport deps not enabled"); }
+void FrameCodecTest::testFrameDecoderHandlesPartialAndOversizeFrames() { QSKIP("Transport deps not enabled"); }
+void FrameCodecTest::benchmarkAllocationsPerRoundTrip() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(FrameCodecTest)
+#include "FrameCodec_test.moc"
@@ -0,0 +1,60 @@
+#pragma once
+
+// Helpers for stand-in Bedrock servers in transport tests
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "transport/EnvelopeHelpers.hpp"
+#include "palantir/envelope.pb.h"
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QList>
+#include <QLocalSocket>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <string>
+
+// Writes one [length][envelope] frame to a server-side socket
+inline void writeFrame(QLocalSocket* socket, const palantir::MessageEnvelope& envelope)
+{
+    std::string serialized;
+    envelope.SerializeToString(&serialized);
+    uint32_t length = static_cast<uint32_t>(serialized.size());
+    QByteArray frame(reinterpret_cast<const char*>(&length), 4);
+    frame.append(serialized.data(), static_cast<qsizetype>(serialized.size()));
+    socket->write(frame);
+    socket->flush();
+}
+
+// Reads every complete frame from a server-side socket buffer
+inline QList<palantir::MessageEnvelope> readFrames(QLocalSocket* socket, QByteArray& buffer)
+{
+    QList<palantir::MessageEnvelope> envelopes;
+    buffer.append(socket->readAll());
+    while (buffer.size() >= 4) {
+        uint32_t length;
+        std::memcpy(&length, buffer.constData(), 4);
+        if (buffer.size() < static_cast<qsizetype>(4 + length)) {
+            break;
+        }
+        palantir::MessageEnvelope envelope;
+        if (phoenix::transport::parseEnvelope(buffer.mid(4, length), envelope)) {
+            envelopes.append(envelope);
+        }
+        buffer.remove(0, 4 + length);
+    }
+    return envelopes;
+}
+
+// Runs a blocking client call off the test thread, which keeps serving the
+// stand-in server's sockets meanwhile
+template <typename Fn>
+auto callOffThread(Fn fn) -> decltype(fn())
+{
+    auto future = std::async(std::launch::async, std::move(fn));
+    while (future.wait_for(std::chrono::milliseconds(5)) != std::future_status::ready) {
+        QCoreApplication::processEvents();
+    }
+    return future.get();
+}
+#endif
@@ -0,0 +1,417 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "transport/MessageDispatcher.hpp"
+#include "palantir/capabilities.pb.h"
+#include "palantir/envelope.pb.h"
+#include "palantir/xysine.pb.h"
+#include "FrameTestUtils.hpp"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QThread>
+#include <QUuid>
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace phoenix::transport;
+
+// Answers every XY Sine request with `samples` points split into `chunkCount`
+// envelopes (ramp data: x[i] = i, y[i] = -i)
+static void writeChunkedXYSine(QLocalSocket* socket, const palantir::MessageEnvelope& request,
+                               int samples, int chunkCount)
+{
+    const int perChunk = (samples + chunkCount - 1) / chunkCount;
+    for (int index = 0; index < chunkCount; ++index) {
+        const int begin = index * perChunk;
+        const int end = std::min(samples, begin + perChunk);
+        palantir::XYSineResponse slice;
+        for (int i = begin; i < end; ++i) {
+            slice.add_x(i);
+            slice.add_y(-i);
+        }
+        slice.set_status(index + 1 == chunkCount ? "OK" : "PARTIAL");
+
+        auto envelope = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, slice,
+                                     {{kCorrelationIdKey, request.metadata().at(kCorrelationIdKey)}});
+        ChunkInfo info;
+        info.index = static_cast<uint32_t>(index);
+        info.count = static_cast<uint32_t>(chunkCount);
+        info.offset = static_cast<uint64_t>(begin);
+        info.totalSamples = static_cast<uint64_t>(samples);
+        setChunkInfo(*envelope, info);
+        writeFrame(socket, *envelope);
+    }
+}
+#endif
+
+class LocalSocketChannelTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testDispatcherRoutesByType();
+    void testDispatcherFallback();
+    void testCorrelationIdRoundTrip();
+    void testOutOfOrderResponsesCompleteMatchingRequests();
+    void testSendWhileDisconnectedFailsImmediately();
+    void testTimeoutFailsPendingRequest();
+    void testMalformedFrameFailsAllAndCloses();
+    void testChunkInfoRoundTrip();
+    void testChunkedResponseStreamsSlices();
+    void testStreamXYSineReassemblesChunks();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void LocalSocketChannelTest::testDispatcherRoutesByType()
+{
+    MessageDispatcher dispatcher;
+    int capsCalls = 0;
+    int sineCalls = 0;
+    dispatcher.registerHandler(palantir::MessageType::CAPABILITIES_RESPONSE,
+                               [&](const palantir::MessageEnvelope&) { ++capsCalls; });
+    dispatcher.registerHandler(palantir::MessageType::XY_SINE_RESPONSE,
+                               [&](const palantir::MessageEnvelope&) { ++sineCalls; });
+
+    palantir::MessageEnvelope envelope;
+    envelope.set_type(palantir::MessageType::XY_SINE_RESPONSE);
+    QVERIFY(dispatcher.dispatch(envelope));
+    QCOMPARE(capsCalls, 0);
+    QCOMPARE(sineCalls, 1);
+
+    envelope.set_type(palantir::MessageType::ERROR_RESPONSE);
+    QVERIFY(!dispatcher.dispatch(envelope));
+
+    dispatcher.unregisterHandler(palantir::MessageType::XY_SINE_RESPONSE);
+    QVERIFY(!dispatcher.hasHandler(palantir::MessageType::XY_SINE_RESPONSE));
+}
+
+void LocalSocketChannelTest::testDispatcherFallback()
+{
+    MessageDispatcher dispatcher;
+    int fallbackCalls = 0;
+    dispatcher.setFallbackHandler([&](const palantir::MessageEnvelope&) { ++fallbackCalls; });
+
+    palantir::MessageEnvelope envelope;
+    envelope.set_type(palantir::MessageType::ERROR_RESPONSE);
+    QVERIFY(dispatcher.dispatch(envelope));
+    QCOMPARE(fallbackCalls, 1);
+}
+
+void LocalSocketChannelTest::testCorrelationIdRoundTrip()
+{
+    palantir::MessageEnvelope envelope;
+    QVERIFY(!correlationId(envelope).has_value());
+
+    setCorrelationId(envelope, 18446744073709551615ull);
+    auto id = correlationId(envelope);
+    QVERIFY(id.has_value());
+    QCOMPARE(*id, uint64_t(18446744073709551615ull));
+
+    (*envelope.mutable_metadata())[kCorrelationIdKey] = "not-a-number";
+    QVERIFY(!correlationId(envelope).has_value());
+}
+
+void LocalSocketChannelTest::testOutOfOrderResponsesCompleteMatchingRequests()
+{
+    const QString serverName = QStringLiteral("phx_lsc_test_%1")
+                               .arg(QUuid::createUuid().toString(QUuid::Id128));
+    QLocalServer server;
+    QVERIFY(server.listen(serverName));
+
+    // Stand-in server: holds requests until two arrive, then answers newest first
+    QLocalSocket* serverSocket = nullptr;
+    QByteArray serverBuffer;
+    QList<palantir::MessageEnvelope> received;
+    connect(&server, &QLocalServer::newConnection, this, [&]() {
+        serverSocket = server.nextPendingConnection();
+        connect(serverSocket, &QLocalSocket::readyRead, this, [&]() {
+            received.append(readFrames(serverSocket, serverBuffer));
+            if (received.size() < 2) {
+                return;
+            }
+            for (int i = received.size() - 1; i >= 0; --i) {
+                palantir::XYSineResponse response;
+                response.set_status(received[i].metadata().at(kCorrelationIdKey));
+                auto reply = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response,
+                                          {{kCorrelationIdKey, received[i].metadata().at(kCorrelationIdKey)}});
+                writeFrame(serverSocket, *reply);
+            }
+            received.clear();
+        });
+    });
+
+    LocalSocketChannel channel(serverName);
+    QVERIFY(channel.connect());
+    QVERIFY(channel.isConnected());
+
+    std::mutex resultsMutex;
+    QMap<uint64_t, QString> statusById;
+    auto record = [&](uint64_t expectedId) {
+        return [&, expectedId](LocalSocketChannel::Reply reply) {
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            palantir::XYSineResponse response;
+            if (reply.envelope) {
+                response.ParseFromString(reply.envelope->payload());
+            }
+            statusById.insert(expectedId, QString::fromStdString(response.status()));
+        };
+    };
+
+    palantir::XYSineRequest request;
+    uint64_t firstId = 0;
+    uint64_t secondId = 0;
+    firstId = channel.sendRequest(palantir::MessageType::XY_SINE_REQUEST, request,
+                                  [&](LocalSocketChannel::Reply reply) { record(firstId)(std::move(reply)); });
+    secondId = channel.sendRequest(palantir::MessageType::XY_SINE_REQUEST, request,
+                                   [&](LocalSocketChannel::Reply reply) { record(secondId)(std::move(reply)); });
+    QVERIFY(firstId != 0);
+    QVERIFY(secondId != 0);
+    QVERIFY(firstId != secondId);
+
+    auto completedCount = [&]() {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        return statusById.size();
+    };
+    QTRY_COMPARE_WITH_TIMEOUT(completedCount(), 2, 5000);
+    QCOMPARE(channel.pendingRequestCount(), 0);
+
+    std::lock_guard<std::mutex> lock(resultsMutex);
+    QCOMPARE(statusById.value(firstId), QString::number(firstId));
+    QCOMPARE(statusById.value(secondId), QString::number(secondId));
+}
+
+void LocalSocketChannelTest::testSendWhileDisconnectedFailsImmediately()
+{
+    LocalSocketChannel channel(QStringLiteral("phx_lsc_test_no_such_server"));
+    QVERIFY(!channel.isConnected());
+
+    // The failure is reported on the I/O thread, like any other outcome
+    palantir::CapabilitiesRequest request;
+    auto replied = std::make_shared<std::promise<std::pair<QString, QThread*>>>();
+    auto future = replied->get_future();
+    uint64_t id = channel.sendRequest(palantir::MessageType::CAPABILITIES_REQUEST, request,
+                                      [replied](LocalSocketChannel::Reply reply) {
+                                          replied->set_value({reply.error, QThread::currentThread()});
+                                      });
+    QCOMPARE(id, uint64_t(0));
+    QCOMPARE(channel.pendingRequestCount(), 0);
+    QCOMPARE(future.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    const auto [error, thread] = future.get();
+    QVERIFY(error.contains("Not connected"));
+    QVERIFY(thread != QThread::currentThread());
+}
+
+void LocalSocketChannelTest::testTimeoutFailsPendingRequest()
+{
+    const QString serverName = QStringLiteral("phx_lsc_test_%1")
+                               .arg(QUuid::createUuid().toString(QUuid::Id128));
+    QLocalServer server;  // Accepts but never answers
+    QVERIFY(server.listen(serverName));
+
+    LocalSocketChannel channel(serverName);
+    QVERIFY(channel.connect());
+
+    palantir::CapabilitiesRequest request;
+    auto future = channel.sendRequestAsync(palantir::MessageType::CAPABILITIES_REQUEST, request, {}, 200);
+    QCOMPARE(channel.pendingRequestCount(), 1);
+
+    QTRY_VERIFY_WITH_TIMEOUT(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready, 2000);
+    LocalSocketChannel::Reply reply = future.get();
+    QVERIFY(!reply.envelope.has_value());
+    QVERIFY(reply.error.contains("Timeout"));
+}
+
+void LocalSocketChannelTest::testMalformedFrameFailsAllAndCloses()
+{
+    const QString serverName = QStringLiteral("phx_lsc_test_%1")
+                               .arg(QUuid::createUuid().toString(QUuid::Id128));
+    QLocalServer server;
+    QVERIFY(server.listen(serverName));
+
+    // Stand-in server: once two requests arrive, answers with a frame that
+    // is not an envelope
+    QLocalSocket* serverSocket = nullptr;
+    QByteArray serverBuffer;
+    int received = 0;
+    connect(&server, &QLocalServer::newConnection, this, [&]() {
+        serverSocket = server.nextPendingConnection();
+        connect(serverSocket, &QLocalSocket::readyRead, this, [&]() {
+            received += readFrames(serverSocket, serverBuffer).size();
+            if (received < 2) {
+                return;
+            }
+            const QByteArray garbage("\x00\x01\x02\x03\xFF\xFE\xFD\xFC", 8);
+            const uint32_t length = static_cast<uint32_t>(garbage.size());
+            serverSocket->write(reinterpret_cast<const char*>(&length), 4);
+            serverSocket->write(garbage);
+            serverSocket->flush();
+        });
+    });
+
+    LocalSocketChannel channel(serverName);
+    QVERIFY(channel.connect());
+
+    palantir::CapabilitiesRequest request;
+    auto first = channel.sendRequestAsync(palantir::MessageType::CAPABILITIES_REQUEST, request);
+    auto second = channel.sendRequestAsync(palantir::MessageType::CAPABILITIES_REQUEST, request);
+
+    // Nobody owns the frame: every request fails and the connection closes
+    QTRY_VERIFY_WITH_TIMEOUT(second.wait_for(std::chrono::seconds(0)) == std::future_status::ready, 5000);
+    QVERIFY(first.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    for (LocalSocketChannel::Reply reply : {first.get(), second.get()}) {
+        QVERIFY(!reply.envelope.has_value());
+        QVERIFY(reply.error.contains("Failed to parse MessageEnvelope"));
+    }
+    QCOMPARE(channel.pendingRequestCount(), 0);
+    QTRY_VERIFY_WITH_TIMEOUT(!channel.isConnected(), 2000);
+}
+
+void LocalSocketChannelTest::testChunkInfoRoundTrip()
+{
+    palantir::MessageEnvelope envelope;
+    QVERIFY(!chunkInfo(envelope).has_value());
+
+    ChunkInfo info;
+    info.index = 2;
+    info.count = 3;
+    info.offset = 5000000;
+    info.totalSamples = 7500000;
+    setChunkInfo(envelope, info);
+
+    auto parsed = chunkInfo(envelope);
+    QVERIFY(parsed.has_value());
+    QCOMPARE(parsed->index, 2u);
+    QCOMPARE(parsed->count, 3u);
+    QCOMPARE(parsed->offset, uint64_t(5000000));
+    QCOMPARE(parsed->totalSamples, uint64_t(7500000));
+    QVERIFY(parsed->isLast());
+
+    // Index past the end is inconsistent
+    (*envelope.mutable_metadata())[kChunkIndexKey] = "3";
+    QVERIFY(!chunkInfo(envelope).has_value());
+}
+
+void LocalSocketChannelTest::testChunkedResponseStreamsSlices()
+{
+    const QString serverName = QStringLiteral("phx_lsc_test_%1")
+                               .arg(QUuid::createUuid().toString(QUuid::Id128));
+    QLocalServer server;
+    QVERIFY(server.listen(serverName));
+
+    QLocalSocket* serverSocket = nullptr;
+    QByteArray serverBuffer;
+    bool sawAcceptChunked = false;
+    connect(&server, &QLocalServer::newConnection, this, [&]() {
+        serverSocket = server.nextPendingConnection();
+        connect(serverSocket, &QLocalSocket::readyRead, this, [&]() {
+            for (const auto& request : readFrames(serverSocket, serverBuffer)) {
+                sawAcceptChunked = request.metadata().count(kAcceptChunkedKey) > 0;
+                writeChunkedXYSine(serverSocket, request, 10, 4);
+            }
+        });
+    });
+
+    LocalSocketChannel channel(serverName);
+    QVERIFY(channel.connect());
+
+    std::mutex chunksMutex;
+    QList<uint64_t> chunkOffsets;
+    palantir::XYSineRequest request;
+    auto promise = std::make_shared<std::promise<LocalSocketChannel::Reply>>();
+    auto future = promise->get_future();
+    channel.sendStreamingRequest(
+        palantir::MessageType::XY_SINE_REQUEST, request,
+        [&](const palantir::MessageEnvelope& chunk) {
+            std::lock_guard<std::mutex> lock(chunksMutex);
+            chunkOffsets.append(chunkInfo(chunk)->offset);
+        },
+        [promise](LocalSocketChannel::Reply reply) { promise->set_value(std::move(reply)); });
+
+    QTRY_VERIFY_WITH_TIMEOUT(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready, 5000);
+    LocalSocketChannel::Reply reply = future.get();
+    QVERIFY(reply.envelope.has_value());
+    QVERIFY(sawAcceptChunked);
+
+    // Three intermediate chunks streamed, the fourth completed the request
+    auto last = chunkInfo(*reply.envelope);
+    QVERIFY(last.has_value());
+    QVERIFY(last->isLast());
+    QCOMPARE(last->offset, uint64_t(9));
+    std::lock_guard<std::mutex> lock(chunksMutex);
+    QCOMPARE(chunkOffsets, QList<uint64_t>({0, 3, 6}));
+    QCOMPARE(channel.pendingRequestCount(), 0);
+}
+
+void LocalSocketChannelTest::testStreamXYSineReassemblesChunks()
+{
+    const QString serverName = QStringLiteral("phx_lsc_test_%1")
+                               .arg(QUuid::createUuid().toString(QUuid::Id128));
+    QLocalServer server;
+    QVERIFY(server.listen(serverName));
+
+    const int samples = 1000;
+    QLocalSocket* serverSocket = nullptr;
+    QByteArray serverBuffer;
+    connect(&server, &QLocalServer::newConnection, this, [&]() {
+        serverSocket = server.nextPendingConnection();
+        connect(serverSocket, &QLocalSocket::readyRead, this, [&]() {
+            for (const auto& request : readFrames(serverSocket, serverBuffer)) {
+                writeChunkedXYSine(serverSocket, request, samples, 7);
+            }
+        });
+    });
+
+    LocalSocketChannel channel(serverName);
+    QVERIFY(channel.connect());
+
+    // The synchronous API blocks its caller, so drive it from another thread
+    // while this thread's event loop runs the stand-in server
+    std::vector<double> x;
+    std::vector<double> y;
+    int chunks = 0;
+    QString error;
+    auto future = std::async(std::launch::async, [&]() {
+        palantir::XYSineRequest request;
+        return channel.streamXYSineRequest(
+            request,
+            [&](const LocalSocketChannel::XYSineSlice& slice) {
+                x.resize(slice.info.totalSamples);
+                y.resize(slice.info.totalSamples);
+                std::copy(slice.x, slice.x + slice.count, x.begin() + slice.info.offset);
+                std::copy(slice.y, slice.y + slice.count, y.begin() + slice.info.offset);
+                ++chunks;
+            },
+            &error);
+    });
+
+    QTRY_VERIFY_WITH_TIMEOUT(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready, 5000);
+    auto status = future.get();
+    QVERIFY2(status.has_value(), qPrintable(error));
+    QCOMPARE(QString::fromStdString(*status), QString("OK"));
+    QCOMPARE(chunks, 7);
+    QCOMPARE(x.size(), size_t(samples));
+    for (int i = 0; i < samples; ++i) {
+        QCOMPARE(x[i], double(i));
+        QCOMPARE(y[i], double(-i));
+    }
+}
+#else
+void LocalSocketChannelTest::testDispatcherRoutesByType() { QSKIP("Transport deps not enabled"); }
+void LocalSocketChannelTest::testDispatcherFallback() { QSKIP("Transport deps not enabled"); }
+void LocalSocketChannelTest::testCorrelationIdRoundTrip() { QSKIP("Transport deps not enabled"); }
+void LocalSocketChannelTest::testOutOfOrderResponsesCompleteMatchingRequests() { QSKIP("Transport deps not enabled"); }
+void LocalSocketChannelTest::testSendWhileDisconnectedFailsImmediately() { QSKIP("Transport deps not enabled"); }
+void LocalSocketChannelTest::testTimeoutFailsPendingRequest() { QSKIP("Transport deps not enabled"); }
+void LocalSocketChannelTest::testMalformedFrameFailsAllAndCloses() { QSKIP("Transport deps not enabled"); }
+void LocalSocketChannelTest::testChunkInfoRoundTrip() { QSKIP("Transport deps not enabled"); }
+void LocalSocketChannelTest::testChunkedResponseStreamsSlices() { QSKIP("Transport deps not enabled"); }
+void LocalSocketChannelTest::testStreamXYSineReassemblesChunks() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(LocalSocketChannelTest)
+#include "LocalSocketChannel_test.moc"
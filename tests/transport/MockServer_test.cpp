@@ -0,0 +1,259 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "palantir/capabilities.pb.h"
+#include "palantir/error.pb.h"
+#include "palantir/xysine.pb.h"
+#include "FrameTestUtils.hpp"
+#include <QElapsedTimer>
+#include <vector>
+
+using namespace phoenix::transport;
+
+// Streams an XY Sine request, counting samples and checking slice order
+static std::optional<std::string> streamSine(LocalSocketChannel& channel, int samples, size_t* outSamples,
+                                             int* outChunks, QString* outError)
+{
+    palantir::XYSineRequest request;
+    request.set_samples(samples);
+    *outSamples = 0;
+    *outChunks = 0;
+    return channel.streamXYSineRequest(
+        request,
+        [&](const LocalSocketChannel::XYSineSlice& slice) {
+            if (slice.info.offset == *outSamples) {
+                *outSamples += slice.count;
+            }
+            ++*outChunks;
+        },
+        outError);
+}
+#endif
+
+class MockServerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testCapabilities();
+    void testFixedPayloadSize();
+    void testLargeResultIsChunked();
+    void testResponseDelay();
+    void testErrorInjection();
+    void testUnknownMessageType();
+    void testRequestHook();
+    void testServerThread();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void MockServerTest::testCapabilities()
+{
+    MockServerConfig config;
+    config.serverVersion = "mock-test";
+    config.features = {"xy_sine", kCancelFeature};
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    QString error;
+    auto capabilities = callOffThread([&]() { return channel.getCapabilities(&error); });
+    QVERIFY2(capabilities.has_value(), qPrintable(error));
+    QCOMPARE(capabilities->capabilities().server_version(), std::string("mock-test"));
+    QCOMPARE(capabilities->capabilities().supported_features_size(), 2);
+    QCOMPARE(capabilities->capabilities().supported_features(1), std::string(kCancelFeature));
+    QCOMPARE(server.requestsReceived(), uint64_t(1));
+}
+
+void MockServerTest::testFixedPayloadSize()
+{
+    MockServerConfig config;
+    config.fixedSamples = 500;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    // The configured size wins over the requested one
+    QString error;
+    palantir::XYSineRequest request;
+    request.set_samples(10);
+    auto response = callOffThread([&]() { return channel.sendXYSineRequest(request, &error); });
+    QVERIFY2(response.has_value(), qPrintable(error));
+    QCOMPARE(response->x_size(), 500);
+    QCOMPARE(response->y_size(), 500);
+    QCOMPARE(response->x(0), 0.0);
+    QVERIFY(qAbs(response->y(125) - 1.0) < 1e-2);  // Quarter period of a unit sine
+}
+
+void MockServerTest::testLargeResultIsChunked()
+{
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    // 1M samples is 16 MB, over the 10 MB frame limit: only chunks can carry it
+    const int samples = 1000000;
+    size_t received = 0;
+    int chunks = 0;
+    QString error;
+    auto status = callOffThread([&]() { return streamSine(channel, samples, &received, &chunks, &error); });
+    QVERIFY2(status.has_value(), qPrintable(error));
+    QCOMPARE(received, size_t(samples));
+    QVERIFY(chunks > 1);
+}
+
+void MockServerTest::testResponseDelay()
+{
+    MockServerConfig config;
+    config.responseDelayMs = 100;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    // Concurrent requests are delayed together, not one after another
+    QElapsedTimer timer;
+    timer.start();
+    QString error;
+    const bool ok = callOffThread([&]() {
+        std::vector<std::future<LocalSocketChannel::Reply>> replies;
+        palantir::XYSineRequest request;
+        request.set_samples(100);
+        for (int i = 0; i < 4; ++i) {
+            replies.push_back(channel.sendRequestAsync(palantir::MessageType::XY_SINE_REQUEST, request));
+        }
+        for (auto& reply : replies) {
+            LocalSocketChannel::Reply result = reply.get();
+            if (!result.envelope || result.envelope->type() != palantir::MessageType::XY_SINE_RESPONSE) {
+                error = result.error;
+                return false;
+            }
+        }
+        return true;
+    });
+    QVERIFY2(ok, qPrintable(error));
+    QVERIFY(timer.elapsed() >= 100);
+    QVERIFY(timer.elapsed() < 350);
+}
+
+void MockServerTest::testErrorInjection()
+{
+    MockServerConfig config;
+    config.errorEvery = 3;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    palantir::XYSineRequest request;
+    request.set_samples(10);
+    std::vector<bool> outcomes;
+    for (int i = 0; i < 6; ++i) {
+        QString error;
+        outcomes.push_back(callOffThread([&]() { return channel.sendXYSineRequest(request, &error); }).has_value());
+    }
+    QCOMPARE(outcomes, (std::vector<bool>{true, true, false, true, true, false}));
+    QCOMPARE(server.errorsInjected(), uint64_t(2));
+
+    // Capabilities are never failed
+    QString error;
+    QVERIFY(callOffThread([&]() { return channel.getCapabilities(&error); }).has_value());
+}
+
+void MockServerTest::testUnknownMessageType()
+{
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    palantir::XYSineRequest request;
+    auto reply = callOffThread([&]() {
+        return channel.sendRequestAsync(palantir::MessageType::XY_SINE_RESPONSE, request).get();
+    });
+    QVERIFY(reply.envelope.has_value());
+    QCOMPARE(reply.envelope->type(), palantir::MessageType::ERROR_RESPONSE);
+    palantir::ErrorResponse error;
+    QVERIFY(error.ParseFromString(reply.envelope->payload()));
+    QCOMPARE(error.error_code(), palantir::ErrorCode::UNKNOWN_MESSAGE_TYPE);
+}
+
+void MockServerTest::testRequestHook()
+{
+    // The hook answers XY Sine itself and leaves capabilities to the server
+    int hooked = 0;
+    MockServerConfig config;
+    config.onRequest = [&hooked](MockReply& reply) {
+        ++hooked;
+        if (reply.request().type() != palantir::MessageType::XY_SINE_REQUEST) {
+            return false;
+        }
+        palantir::XYSineResponse response;
+        response.set_status("hooked");
+        response.add_x(1.0);
+        response.add_y(2.0);
+        reply.send(palantir::MessageType::XY_SINE_RESPONSE, response);
+        return true;
+    };
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    QString error;
+    palantir::XYSineRequest request;
+    request.set_samples(1000);
+    auto response = callOffThread([&]() { return channel.sendXYSineRequest(request, &error); });
+    QVERIFY2(response.has_value(), qPrintable(error));
+    QCOMPARE(response->status(), std::string("hooked"));
+    QCOMPARE(response->x_size(), 1);
+
+    auto capabilities = callOffThread([&]() { return channel.getCapabilities(&error); });
+    QVERIFY2(capabilities.has_value(), qPrintable(error));
+    QCOMPARE(capabilities->capabilities().server_version(), std::string("mock-1.0"));
+    QCOMPARE(hooked, 2);
+}
+
+void MockServerTest::testServerThread()
+{
+    // Blocking clients can call straight in: the server has its own thread
+    MockServerThread server;
+    QString error;
+    QVERIFY2(server.start(QString(), &error), qPrintable(error));
+
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    palantir::XYSineRequest request;
+    request.set_samples(1000);
+    auto response = channel.sendXYSineRequest(request, &error);
+    QVERIFY2(response.has_value(), qPrintable(error));
+    QCOMPARE(response->x_size(), 1000);
+
+    channel.disconnect();
+    server.stop();
+    QVERIFY(server.socketName().isEmpty());
+}
+#else
+void MockServerTest::testCapabilities() { QSKIP("Transport deps not enabled"); }
+void MockServerTest::testFixedPayloadSize() { QSKIP("Transport deps not enabled"); }
+void MockServerTest::testLargeResultIsChunked() { QSKIP("Transport deps not enabled"); }
+void MockServerTest::testResponseDelay() { QSKIP("Transport deps not enabled"); }
+void MockServerTest::testErrorInjection() { QSKIP("Transport deps not enabled"); }
+void MockServerTest::testUnknownMessageType() { QSKIP("Transport deps not enabled"); }
+void MockServerTest::testRequestHook() { QSKIP("Transport deps not enabled"); }
+void MockServerTest::testServerThread() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(MockServerTest)
+#include "MockServer_test.moc"
@@ -0,0 +1,254 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "transport/PackedColumns.hpp"
+#include "palantir/envelope.pb.h"
+#include "palantir/xysine.pb.h"
+#include "FrameTestUtils.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace phoenix::transport;
+
+// XY Sine response envelope in protocol v2: status in the message, x/y packed
+static palantir::MessageEnvelope makePackedResponse(const std::vector<double>& x, const std::vector<double>& y,
+                                                    const std::map<std::string, std::string>& metadata = {})
+{
+    palantir::XYSineResponse response;
+    response.set_status("OK");
+    auto envelope = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response, metadata);
+    packFloat64Columns(*envelope, {{"x", x.data(), x.size()}, {"y", y.data(), y.size()}});
+    return *envelope;
+}
+
+// Bedrock answers in the protocol version of each request: packed columns
+// for v2, repeated fields for v1 (an older build).
+struct VersionedAnswers {
+    int samples;
+    uint32_t lastRequestVersion = 0;
+
+    explicit VersionedAnswers(int samples)
+        : samples(samples)
+    {
+    }
+
+    MockServerConfig config()
+    {
+        MockServerConfig config;
+        config.onRequest = [this](MockReply& reply) {
+            if (reply.request().type() != palantir::MessageType::XY_SINE_REQUEST) {
+                return false;
+            }
+            answer(reply);
+            return true;
+        };
+        return config;
+    }
+
+    void answer(const MockReply& reply)
+    {
+        lastRequestVersion = reply.request().version();
+
+        std::vector<double> x(samples);
+        std::vector<double> y(samples);
+        for (int i = 0; i < samples; ++i) {
+            x[i] = i;
+            y[i] = -0.5 * i;
+        }
+
+        if (lastRequestVersion >= PROTOCOL_VERSION_V2) {
+            reply.sendEnvelope(makePackedResponse(x, y, {{kCorrelationIdKey, reply.correlationId()}}));
+            return;
+        }
+        palantir::XYSineResponse response;
+        response.set_status("OK");
+        for (int i = 0; i < samples; ++i) {
+            response.add_x(x[i]);
+            response.add_y(y[i]);
+        }
+        reply.send(palantir::MessageType::XY_SINE_RESPONSE, response);
+    }
+};
+#endif
+
+class PackedColumnsTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testPackUnpackRoundTrip();
+    void testVersionNegotiationPath();
+    void testRejectsMalformedPackedPayloads();
+    void testStreamingDecodesPackedColumns();
+    void testV1ServerStillWorks();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void PackedColumnsTest::testPackUnpackRoundTrip()
+{
+    const std::vector<double> x = {0.0, 1.0, 2.0, 3.0, 4.0};
+    const std::vector<double> y = {1.5, -2.5, 3.25, -0.125, 1e300};
+    const palantir::MessageEnvelope envelope = makePackedResponse(x, y);
+    QCOMPARE(envelope.version(), PROTOCOL_VERSION_V2);
+
+    // Survives serialization and parsing like any other envelope
+    const std::string serialized = envelope.SerializeAsString();
+    palantir::MessageEnvelope parsed;
+    QString error;
+    QVERIFY2(parseEnvelope(serialized.data(), serialized.size(), parsed, &error), qPrintable(error));
+
+    std::string_view message;
+    std::vector<BulkColumn> columns;
+    QVERIFY2(unpackPayload(parsed, message, columns, &error), qPrintable(error));
+    QCOMPARE(columns.size(), size_t(2));
+
+    palantir::XYSineResponse response;
+    QVERIFY(response.ParseFromArray(message.data(), static_cast<int>(message.size())));
+    QCOMPARE(QString::fromStdString(response.status()), QString("OK"));
+    QCOMPARE(response.x_size(), 0);
+
+    const BulkColumn* yColumn = findBulkColumn(columns, "y");
+    QVERIFY(yColumn != nullptr);
+    QCOMPARE(yColumn->offset % PACKED_COLUMN_ALIGNMENT, uint64_t(0));
+    QCOMPARE(yColumn->elementCount(), y.size());
+
+    // Aligned little-endian data is read in place
+    const QuantizationMap noQuantization;
+    std::vector<double> scratch;
+    const double* values = columnDoubles(parsed.payload().data() + yColumn->offset, *yColumn, noQuantization,
+                                         scratch);
+    if (Q_BYTE_ORDER == Q_LITTLE_ENDIAN) {
+        QVERIFY(scratch.empty());
+        QCOMPARE(reinterpret_cast<const char*>(values), parsed.payload().data() + yColumn->offset);
+    }
+    for (size_t i = 0; i < y.size(); ++i) {
+        QCOMPARE(values[i], y[i]);
+    }
+
+    std::vector<double> decoded(x.size());
+    const BulkColumn* xColumn = findBulkColumn(columns, "x");
+    QVERIFY(decodeColumn(parsed.payload().data() + xColumn->offset, *xColumn, noQuantization, decoded.data()));
+    QCOMPARE(decoded, x);
+}
+
+void PackedColumnsTest::testVersionNegotiationPath()
+{
+    QString error;
+    QVERIFY(validateEnvelopeHeader(PROTOCOL_VERSION, palantir::MessageType::XY_SINE_RESPONSE, &error));
+    QVERIFY(validateEnvelopeHeader(PROTOCOL_VERSION_V2, palantir::MessageType::XY_SINE_RESPONSE, &error));
+    QVERIFY(!validateEnvelopeHeader(MAX_PROTOCOL_VERSION + 1, palantir::MessageType::XY_SINE_RESPONSE, &error));
+    QVERIFY(error.contains("Invalid protocol version"));
+
+    // v1 envelopes without packed columns unpack to the whole payload
+    palantir::XYSineResponse response;
+    response.add_x(1.0);
+    auto plain = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response);
+    QVERIFY(plain.has_value());
+    std::string_view message;
+    std::vector<BulkColumn> columns;
+    QVERIFY(unpackPayload(*plain, message, columns));
+    QVERIFY(columns.empty());
+    QCOMPARE(message.size(), plain->payload().size());
+}
+
+void PackedColumnsTest::testRejectsMalformedPackedPayloads()
+{
+    const std::vector<double> x = {1.0, 2.0};
+    const std::vector<double> y = {3.0, 4.0};
+    std::string_view message;
+    std::vector<BulkColumn> columns;
+    QString error;
+
+    // Packed columns in a v1 envelope
+    palantir::MessageEnvelope envelope = makePackedResponse(x, y);
+    envelope.set_version(PROTOCOL_VERSION);
+    QVERIFY(!unpackPayload(envelope, message, columns, &error));
+    QVERIFY(error.contains("protocol version"));
+
+    // Column past the end of the payload
+    envelope = makePackedResponse(x, y);
+    (*envelope.mutable_metadata())[kPackedColumnsKey] = "x:f64:8:16;y:f64:4096:16";
+    QVERIFY(!unpackPayload(envelope, message, columns, &error));
+    QVERIFY(columns.empty());
+
+    // Column overlapping the inner message
+    envelope = makePackedResponse(x, y);
+    (*envelope.mutable_metadata())[kPackedColumnsKey] = "x:f64:0:16";
+    QVERIFY(!unpackPayload(envelope, message, columns, &error));
+    QVERIFY(error.contains("overlaps"));
+
+    // Message length beyond the payload
+    envelope = makePackedResponse(x, y);
+    (*envelope.mutable_metadata())[kPackedMessageBytesKey] = "100000";
+    QVERIFY(!unpackPayload(envelope, message, columns, &error));
+
+    // Packing twice is a caller bug
+    envelope = makePackedResponse(x, y);
+    QVERIFY(!packFloat64Columns(envelope, {{"x", x.data(), x.size()}}, &error));
+}
+
+void PackedColumnsTest::testStreamingDecodesPackedColumns()
+{
+    VersionedAnswers answers(3000);
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    channel.setProtocolVersion(PROTOCOL_VERSION_V2);
+
+    std::vector<double> x;
+    std::vector<double> y;
+    QString error;
+    auto status = callOffThread([&]() {
+        palantir::XYSineRequest request;
+        return channel.streamXYSineRequest(
+            request,
+            [&](const LocalSocketChannel::XYSineSlice& slice) {
+                x.assign(slice.x, slice.x + slice.count);
+                y.assign(slice.y, slice.y + slice.count);
+            },
+            &error);
+    });
+    QVERIFY2(status.has_value(), qPrintable(error));
+    QCOMPARE(answers.lastRequestVersion, PROTOCOL_VERSION_V2);
+    QCOMPARE(x.size(), size_t(3000));
+    QCOMPARE(x[2999], 2999.0);
+    QCOMPARE(y[2999], -1499.5);
+
+    // The blocking RPC fills the repeated fields from the packed columns
+    palantir::XYSineRequest request;
+    auto response = callOffThread([&]() { return channel.sendXYSineRequest(request, &error); });
+    QVERIFY2(response.has_value(), qPrintable(error));
+    QCOMPARE(response->x_size(), 3000);
+    QCOMPARE(response->y(10), -5.0);
+}
+
+void PackedColumnsTest::testV1ServerStillWorks()
+{
+    VersionedAnswers answers(100);
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    QCOMPARE(channel.protocolVersion(), PROTOCOL_VERSION);
+
+    palantir::XYSineRequest request;
+    QString error;
+    auto response = callOffThread([&]() { return channel.sendXYSineRequest(request, &error); });
+    QVERIFY2(response.has_value(), qPrintable(error));
+    QCOMPARE(answers.lastRequestVersion, PROTOCOL_VERSION);
+    QCOMPARE(response->x_size(), 100);
+    QCOMPARE(response->y(99), -49.5);
+}
+#else
+void PackedColumnsTest::testPackUnpackRoundTrip() { QSKIP("Transport deps not enabled"); }
+void PackedColumnsTest::testVersionNegotiationPath() { QSKIP("Transport deps not enabled"); }
+void PackedColumnsTest::testRejectsMalformedPackedPayloads() { QSKIP("Transport deps not enabled"); }
+void PackedColumnsTest::testStreamingDecodesPackedColumns() { QSKIP("Transport deps not enabled"); }
+void PackedColumnsTest::testV1ServerStillWorks() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(PackedColumnsTest)
+#include "PackedColumns_test.moc"
@@ -0,0 +1,193 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/PooledTransport.hpp"
+#include "transport/TransportFactory.hpp"
+#include "analysis/RemoteExecutor.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include "FrameTestUtils.hpp"
+#include <QTimer>
+#include <QUuid>
+
+using namespace phoenix::transport;
+
+// Socket name nobody listens on
+static QString deadSocketName()
+{
+    return QStringLiteral("phx_pool_dead_%1").arg(QUuid::createUuid().toString(QUuid::Id128));
+}
+#endif
+
+class PooledTransportTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRoutesToLeastLoadedEndpoint();
+    void testPrefersLowerLatencyOnTies();
+    void testSkipsDeadEndpoint();
+    void testExecutorRetriesWhenEndpointDies();
+    void testSocketPathsFromEnvironment();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void PooledTransportTest::testRoutesToLeastLoadedEndpoint()
+{
+    MockBedrockServer first;
+    MockBedrockServer second;
+    QVERIFY(first.listen());
+    QVERIFY(second.listen());
+    PooledTransport pool({first.socketName(), second.socketName()});
+
+    // Leases in flight spread across the endpoints
+    QString error;
+    auto a = callOffThread([&]() { return pool.acquire(&error); });
+    QVERIFY2(a.has_value(), qPrintable(error));
+    auto b = callOffThread([&]() { return pool.acquire(&error); });
+    QVERIFY2(b.has_value(), qPrintable(error));
+    QVERIFY(a->endpoint != b->endpoint);
+    QVERIFY(a->capabilities->supports("xy_sine"));
+
+    auto stats = pool.stats();
+    QCOMPARE(stats[0].inFlight, 1);
+    QCOMPARE(stats[1].inFlight, 1);
+
+    // The endpoint freed first takes the next request
+    pool.release(*b, PooledTransport::Outcome::Success, std::chrono::microseconds(1000));
+    auto c = callOffThread([&]() { return pool.acquire(&error); });
+    QVERIFY(c.has_value());
+    QCOMPARE(c->endpoint, b->endpoint);
+
+    pool.release(*a, PooledTransport::Outcome::Failed, std::chrono::microseconds(0));
+    pool.release(*c, PooledTransport::Outcome::Success, std::chrono::microseconds(1000));
+    stats = pool.stats();
+    QCOMPARE(stats[a->endpoint].failures, uint64_t(1));
+    QVERIFY(stats[a->endpoint].healthy);  // Request errors do not take an endpoint out
+    QCOMPARE(stats[b->endpoint].requests, uint64_t(2));
+    QCOMPARE(stats[0].inFlight + stats[1].inFlight, 0);
+}
+
+void PooledTransportTest::testPrefersLowerLatencyOnTies()
+{
+    MockBedrockServer first;
+    MockBedrockServer second;
+    QVERIFY(first.listen());
+    QVERIFY(second.listen());
+    PooledTransport pool({first.socketName(), second.socketName()});
+
+    QString error;
+    auto slow = callOffThread([&]() { return pool.acquire(&error, {1}); });
+    auto fast = callOffThread([&]() { return pool.acquire(&error, {0}); });
+    QVERIFY(slow.has_value() && fast.has_value());
+    pool.release(*slow, PooledTransport::Outcome::Success, std::chrono::microseconds(50000));
+    pool.release(*fast, PooledTransport::Outcome::Success, std::chrono::microseconds(500));
+    QVERIFY(pool.stats()[0].latencyMs > pool.stats()[1].latencyMs);
+
+    // Both idle: the faster endpoint wins
+    auto next = callOffThread([&]() { return pool.acquire(&error); });
+    QVERIFY(next.has_value());
+    QCOMPARE(next->endpoint, size_t(1));
+    pool.release(*next, PooledTransport::Outcome::Success, std::chrono::microseconds(500));
+}
+
+void PooledTransportTest::testSkipsDeadEndpoint()
+{
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+    PooledTransport pool({deadSocketName(), server.socketName()});
+
+    QString error;
+    auto lease = callOffThread([&]() { return pool.acquire(&error); });
+    QVERIFY2(lease.has_value(), qPrintable(error));
+    QCOMPARE(lease->endpoint, size_t(1));
+    QCOMPARE(lease->socketPath, server.socketName());
+    pool.release(*lease, PooledTransport::Outcome::Success, std::chrono::microseconds(100));
+
+    auto stats = pool.stats();
+    QVERIFY(!stats[0].healthy);
+    QCOMPARE(stats[0].inFlight, 0);
+    QVERIFY(stats[1].healthy);
+    QVERIFY(pool.isConnected());
+
+    // Nothing left once the live endpoint is excluded
+    error.clear();
+    QVERIFY(!callOffThread([&]() { return pool.acquire(&error, {1}); }).has_value());
+    QVERIFY(!error.isEmpty());
+}
+
+void PooledTransportTest::testExecutorRetriesWhenEndpointDies()
+{
+    MockServerConfig slowConfig;
+    slowConfig.responseDelayMs = 300;
+    MockBedrockServer dying(slowConfig);
+    MockBedrockServer healthy;
+    QVERIFY(dying.listen());
+    QVERIFY(healthy.listen());
+
+    auto pool = std::make_shared<PooledTransport>(QStringList{dying.socketName(), healthy.socketName()});
+    RemoteExecutor executor(pool);
+    executor.setResultStore(nullptr);  // Runs from earlier test sessions must not answer
+
+    // Endpoint 0 (first on ties) takes the run, then dies before answering
+    QTimer killer;
+    killer.setInterval(5);
+    QObject::connect(&killer, &QTimer::timeout, &dying, [&]() {
+        if (dying.requestsReceived() >= 2) {  // Capabilities, then the XY Sine request
+            dying.close();
+            killer.stop();
+        }
+    });
+    killer.start();
+
+    QString error;
+    int samples = 0;
+    callOffThread([&]() {
+        executor.execute(QStringLiteral("xy_sine"), {{QStringLiteral("samples"), 250}}, nullptr,
+                         [&](const XYSineResult& result) { samples = static_cast<int>(result.x.size()); },
+                         [&](const QString& message) { error = message; });
+        return true;
+    });
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(samples, 250);
+    QCOMPARE(dying.requestsReceived(), uint64_t(2));  // Capabilities + the lost run
+
+    const auto stats = pool->stats();
+    QVERIFY(!stats[0].healthy);
+    QCOMPARE(stats[0].failures, uint64_t(1));
+    QVERIFY(stats[1].healthy);
+    QCOMPARE(stats[1].requests, uint64_t(1));
+}
+
+void PooledTransportTest::testSocketPathsFromEnvironment()
+{
+    const QByteArray savedPaths = qgetenv("PALANTIR_SOCKET_PATHS");
+    const QByteArray savedPath = qgetenv("PALANTIR_SOCKET_PATH");
+
+    qputenv("PALANTIR_SOCKET_PATHS", " bedrock_a, bedrock_b ,bedrock_a,, ");
+    QCOMPARE(PooledTransport::socketPathsFromEnvironment(), (QStringList{"bedrock_a", "bedrock_b"}));
+    auto client = TransportFactory::makeTransportClient(TransportBackend::Auto);
+    QVERIFY(dynamic_cast<PooledTransport*>(client.get()) != nullptr);
+    client.reset();
+
+    qunsetenv("PALANTIR_SOCKET_PATHS");
+    qputenv("PALANTIR_SOCKET_PATH", "bedrock_single");
+    QCOMPARE(PooledTransport::socketPathsFromEnvironment(), QStringList{"bedrock_single"});
+    client = TransportFactory::makeTransportClient(TransportBackend::Auto);
+    QVERIFY(dynamic_cast<PooledTransport*>(client.get()) == nullptr);
+    client = TransportFactory::makeTransportClient(TransportBackend::Pooled);
+    QVERIFY(dynamic_cast<PooledTransport*>(client.get()) != nullptr);
+    client.reset();
+
+    savedPaths.isNull() ? qunsetenv("PALANTIR_SOCKET_PATHS") : qputenv("PALANTIR_SOCKET_PATHS", savedPaths);
+    savedPath.isNull() ? qunsetenv("PALANTIR_SOCKET_PATH") : qputenv("PALANTIR_SOCKET_PATH", savedPath);
+}
+#else
+void PooledTransportTest::testRoutesToLeastLoadedEndpoint() { QSKIP("Transport deps not enabled"); }
+void PooledTransportTest::testPrefersLowerLatencyOnTies() { QSKIP("Transport deps not enabled"); }
+void PooledTransportTest::testSkipsDeadEndpoint() { QSKIP("Transport deps not enabled"); }
+void PooledTransportTest::testExecutorRetriesWhenEndpointDies() { QSKIP("Transport deps not enabled"); }
+void PooledTransportTest::testSocketPathsFromEnvironment() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(PooledTransportTest)
+#include "PooledTransport_test.moc"
@@ -0,0 +1,198 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "transport/RangeQuery.hpp"
+#include "analysis/Decimation.hpp"
+#include "palantir/envelope.pb.h"
+#include "palantir/xysine.pb.h"
+#include "FrameTestUtils.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace phoenix::transport;
+
+// Bedrock answers for XY Sine range queries: computes the full result and,
+// for a range query, answers with the decimated visible range only.
+struct RangeAnswers {
+    std::optional<ViewportRange> lastRange;
+
+    MockServerConfig config()
+    {
+        MockServerConfig config;
+        config.onRequest = [this](MockReply& reply) {
+            if (reply.request().type() != palantir::MessageType::XY_SINE_REQUEST) {
+                return false;
+            }
+            answer(reply);
+            return true;
+        };
+        return config;
+    }
+
+    void answer(const MockReply& reply)
+    {
+        palantir::XYSineRequest sineRequest;
+        sineRequest.ParseFromString(reply.request().payload());
+        QMap<QString, QVariant> params;
+        params["samples"] = sineRequest.samples();
+        params["frequency"] = 20.0;
+        XYSineResult full;
+        XYSineDemo::compute(params, full);
+
+        std::map<std::string, std::string> metadata;
+        XYSineResult result = full;
+        lastRange = rangeFromEnvelope(reply.request());
+        if (lastRange) {
+            Decimation::Viewport viewport;
+            viewport.xMin = lastRange->xMin;
+            viewport.xMax = lastRange->xMax;
+            viewport.pixelWidth = static_cast<int>(lastRange->pixelWidth);
+            viewport.method = Decimation::parseMethod(QString::fromStdString(lastRange->decimation))
+                                  .value_or(Decimation::Method::MinMax);
+            Decimation::decimate(full, viewport, result);
+            const auto inRange = std::upper_bound(full.x.begin(), full.x.end(), viewport.xMax)
+                                 - std::lower_bound(full.x.begin(), full.x.end(), viewport.xMin);
+            metadata[kRangeSourceSamplesKey] = std::to_string(inRange);
+        }
+
+        palantir::XYSineResponse response;
+        response.set_status("OK");
+        for (size_t i = 0; i < result.x.size(); ++i) {
+            response.add_x(result.x[i]);
+            response.add_y(result.y[i]);
+        }
+        reply.send(palantir::MessageType::XY_SINE_RESPONSE, response, std::move(metadata));
+    }
+};
+#endif
+
+class RangeQueryTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRangeMetadataRoundTrip();
+    void testRejectsMalformedRange();
+    void testRangeQueryReturnsDecimatedViewport();
+    void testTransferSizeIndependentOfResultSize();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void RangeQueryTest::testRangeMetadataRoundTrip()
+{
+    ViewportRange range;
+    range.xMin = 0.1;
+    range.xMax = 2.0 / 3.0;
+    range.pixelWidth = 1280;
+    range.decimation = "lttb";
+
+    std::map<std::string, std::string> metadata;
+    setRangeMetadata(metadata, range);
+    palantir::XYSineRequest request;
+    auto envelope = makeEnvelope(palantir::MessageType::XY_SINE_REQUEST, request, metadata);
+    QVERIFY(envelope.has_value());
+
+    QString error;
+    auto parsed = rangeFromEnvelope(*envelope, &error);
+    QVERIFY2(parsed.has_value(), qPrintable(error));
+    QCOMPARE(parsed->xMin, range.xMin);
+    QCOMPARE(parsed->xMax, range.xMax);
+    QCOMPARE(parsed->pixelWidth, uint32_t(1280));
+    QCOMPARE(parsed->decimation, std::string("lttb"));
+
+    // Plain requests are not range queries
+    auto plain = makeEnvelope(palantir::MessageType::XY_SINE_REQUEST, request);
+    QVERIFY(!rangeFromEnvelope(*plain, &error).has_value());
+}
+
+void RangeQueryTest::testRejectsMalformedRange()
+{
+    palantir::MessageEnvelope envelope;
+    auto& metadata = *envelope.mutable_metadata();
+    metadata[kRangePixelsKey] = "800";
+    metadata[kRangeXMinKey] = "2.0";
+    metadata[kRangeXMaxKey] = "1.0";  // Empty range
+
+    QString error;
+    QVERIFY(!rangeFromEnvelope(envelope, &error).has_value());
+    QVERIFY(error.contains("Malformed range query"));
+
+    metadata[kRangeXMaxKey] = "3.0";
+    metadata[kRangePixelsKey] = "wide";
+    QVERIFY(!rangeFromEnvelope(envelope, &error).has_value());
+}
+
+void RangeQueryTest::testRangeQueryReturnsDecimatedViewport()
+{
+    RangeAnswers answers;
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    ViewportRange range;
+    range.xMin = 1.0;
+    range.xMax = 1.5;
+    range.pixelWidth = 300;
+
+    std::vector<double> x;
+    QString error;
+    auto status = callOffThread([&]() {
+        palantir::XYSineRequest request;
+        request.set_samples(200000);
+        return channel.streamXYSineRequest(
+            request,
+            [&](const LocalSocketChannel::XYSineSlice& slice) { x.assign(slice.x, slice.x + slice.count); },
+            &error, {}, range);
+    });
+    QVERIFY2(status.has_value(), qPrintable(error));
+    QVERIFY(answers.lastRange.has_value());
+    QCOMPARE(answers.lastRange->pixelWidth, uint32_t(300));
+
+    // Visible range only (plus one edge sample per side), about two points per pixel
+    QVERIFY(x.size() <= 2 * 300 + 2);
+    QVERIFY(x.front() < 1.0 && x[1] >= 1.0);
+    QVERIFY(x.back() > 1.5 && x[x.size() - 2] <= 1.5);
+}
+
+void RangeQueryTest::testTransferSizeIndependentOfResultSize()
+{
+    RangeAnswers answers;
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    ViewportRange range;
+    range.xMin = 0.0;
+    range.xMax = 2.0 * M_PI;
+    range.pixelWidth = 800;
+
+    size_t counts[2] = {0, 0};
+    const int samples[2] = {100000, 1000000};
+    for (int i = 0; i < 2; ++i) {
+        QString error;
+        auto status = callOffThread([&]() {
+            palantir::XYSineRequest request;
+            request.set_samples(samples[i]);
+            return channel.streamXYSineRequest(
+                request,
+                [&](const LocalSocketChannel::XYSineSlice& slice) { counts[i] = slice.count; },
+                &error, {}, range);
+        });
+        QVERIFY2(status.has_value(), qPrintable(error));
+    }
+    QVERIFY(counts[0] <= 2 * 800 + 2);
+    QCOMPARE(counts[1], counts[0]);
+}
+#else
+void RangeQueryTest::testRangeMetadataRoundTrip() { QSKIP("Transport deps not enabled"); }
+void RangeQueryTest::testRejectsMalformedRange() { QSKIP("Transport deps not enabled"); }
+void RangeQueryTest::testRangeQueryReturnsDecimatedViewport() { QSKIP("Transport deps not enabled"); }
+void RangeQueryTest::testTransferSizeIndependentOfResultSize() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(RangeQueryTest)
+#include "RangeQuery_test.moc"
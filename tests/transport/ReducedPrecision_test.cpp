@@ -0,0 +1,252 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/BulkData.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "transport/PackedColumns.hpp"
+#include "palantir/envelope.pb.h"
+#include "palantir/xysine.pb.h"
+#include "FrameTestUtils.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace phoenix::transport;
+
+static std::vector<double> sineSamples(size_t count, double amplitude)
+{
+    std::vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = amplitude * std::sin(2.0 * M_PI * 3.0 * static_cast<double>(i) / count);
+    }
+    return values;
+}
+
+// Largest absolute difference between two equally sized sample sets
+static double maxError(const std::vector<double>& a, const std::vector<double>& b)
+{
+    double error = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        error = std::max(error, std::abs(a[i] - b[i]));
+    }
+    return error;
+}
+
+// Bedrock answers for XY Sine in protocol v2, honouring the requested
+// transfer precision. Records the packed column bytes of the last response.
+struct PrecisionAnswers {
+    int samples;
+    std::string lastRequestedPrecision;
+    size_t lastColumnBytes = 0;
+
+    explicit PrecisionAnswers(int samples)
+        : samples(samples)
+    {
+    }
+
+    MockServerConfig config()
+    {
+        MockServerConfig config;
+        config.onRequest = [this](MockReply& reply) {
+            if (reply.request().type() != palantir::MessageType::XY_SINE_REQUEST) {
+                return false;
+            }
+            answer(reply);
+            return true;
+        };
+        return config;
+    }
+
+    void answer(const MockReply& reply)
+    {
+        const auto& metadata = reply.request().metadata();
+        ReducedPrecision precision;
+        auto precisionIt = metadata.find(kPrecisionKey);
+        lastRequestedPrecision = precisionIt == metadata.end() ? std::string() : precisionIt->second;
+        if (auto mode = parsePrecision(lastRequestedPrecision)) {
+            precision.mode = *mode;
+        }
+        auto boundIt = metadata.find(kErrorBoundKey);
+        if (boundIt != metadata.end()) {
+            precision.errorBound = std::stod(boundIt->second);
+        }
+
+        std::vector<double> x(samples);
+        for (int i = 0; i < samples; ++i) {
+            x[i] = static_cast<double>(i) / samples;
+        }
+        const std::vector<double> y = sineSamples(samples, 2.0);
+
+        palantir::XYSineResponse response;
+        response.set_status("OK");
+        auto envelope = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response,
+                                     {{kCorrelationIdKey, reply.correlationId()}});
+        const size_t messageBytes = envelope->payload().size();
+        packColumns(*envelope, {{"x", x.data(), x.size()}, {"y", y.data(), y.size()}}, precision);
+        lastColumnBytes = envelope->payload().size() - messageBytes;
+        reply.sendEnvelope(*envelope);
+    }
+};
+#endif
+
+class ReducedPrecisionTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testFloat32WithinBound();
+    void testDeltaInt16WithinBound();
+    void testLargeJumpFallsBackToFloat64();
+    void testRejectsMalformedQuantization();
+    void testChannelRequestsReducedPrecision();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void ReducedPrecisionTest::testFloat32WithinBound()
+{
+    const std::vector<double> values = sineSamples(1000, 3.0);
+    std::string bytes;
+    QVERIFY(encodeColumn(values.data(), values.size(), BulkDType::Float32, 1e-6, bytes));
+    QCOMPARE(bytes.size(), values.size() * sizeof(float));
+
+    const BulkColumn column{"y", BulkDType::Float32, 0, bytes.size()};
+    std::vector<double> scratch;
+    const double* decoded = columnDoubles(bytes.data(), column, {}, scratch);
+    QVERIFY(decoded != nullptr);
+    QVERIFY(maxError(values, std::vector<double>(decoded, decoded + values.size())) <= 1e-6);
+
+    // float cannot hold 1 + 1e-9 exactly: a tighter bound refuses
+    const double precise = 1.0 + 1e-9;
+    QVERIFY(!encodeColumn(&precise, 1, BulkDType::Float32, 1e-12, bytes));
+}
+
+void ReducedPrecisionTest::testDeltaInt16WithinBound()
+{
+    const double bound = 1e-4;
+    const std::vector<double> values = sineSamples(20000, 2.0);
+    std::string bytes;
+    Quantization quantization;
+    QVERIFY(encodeColumn(values.data(), values.size(), BulkDType::DeltaInt16, bound, bytes, &quantization));
+    QCOMPARE(bytes.size(), values.size() * sizeof(int16_t));
+    QCOMPARE(quantization.base, values[0]);
+
+    // Quantization metadata round-trips the parameters exactly
+    QuantizationMap parsed;
+    QVERIFY(parseQuantization(formatQuantization({{"y", quantization}}), parsed));
+    QCOMPARE(parsed.at("y").scale, quantization.scale);
+
+    std::vector<double> decoded(values.size());
+    const BulkColumn column{"y", BulkDType::DeltaInt16, 0, bytes.size()};
+    QString error;
+    QVERIFY2(decodeColumn(bytes.data(), column, parsed, decoded.data(), &error), qPrintable(error));
+    QVERIFY(maxError(values, decoded) <= bound * (1.0 + 1e-9));
+
+    // No bound, no quantization step
+    QVERIFY(!encodeColumn(values.data(), values.size(), BulkDType::DeltaInt16, 0.0, bytes, &quantization));
+}
+
+void ReducedPrecisionTest::testLargeJumpFallsBackToFloat64()
+{
+    // One step far beyond int16 range at this bound
+    const std::vector<double> x = {0.0, 1.0, 2.0, 3.0};
+    const std::vector<double> y = {0.0, 0.001, 1000.0, 1000.001};
+    palantir::XYSineResponse response;
+    auto envelope = makeEnvelope(palantir::MessageType::XY_SINE_RESPONSE, response);
+    QVERIFY(envelope.has_value());
+
+    ReducedPrecision precision;
+    precision.mode = TransferPrecision::DeltaInt16;
+    precision.errorBound = 1e-3;
+    QString error;
+    QVERIFY2(packColumns(*envelope, {{"x", x.data(), x.size()}, {"y", y.data(), y.size()}}, precision, &error),
+             qPrintable(error));
+
+    std::string_view message;
+    std::vector<BulkColumn> columns;
+    QVERIFY2(unpackPayload(*envelope, message, columns, &error), qPrintable(error));
+    QCOMPARE(findBulkColumn(columns, "x")->dtype, BulkDType::DeltaInt16);
+    QCOMPARE(findBulkColumn(columns, "y")->dtype, BulkDType::Float64);
+
+    // Only the reduced column is listed
+    QuantizationMap quantization;
+    QVERIFY(readQuantization(*envelope, quantization));
+    QCOMPARE(quantization.size(), size_t(1));
+    QCOMPARE(quantization.count("x"), size_t(1));
+
+    std::vector<double> decoded(y.size());
+    const BulkColumn* yColumn = findBulkColumn(columns, "y");
+    QVERIFY(decodeColumn(envelope->payload().data() + yColumn->offset, *yColumn, quantization, decoded.data()));
+    QCOMPARE(decoded, y);
+}
+
+void ReducedPrecisionTest::testRejectsMalformedQuantization()
+{
+    QuantizationMap quantization;
+    QString error;
+    QVERIFY(!parseQuantization("y:0.5", quantization, &error));
+    QVERIFY(!parseQuantization("y:0.5:abc", quantization, &error));
+    QVERIFY(!parseQuantization("y:0.5:0", quantization, &error));
+    QVERIFY(quantization.empty());
+
+    // DeltaInt16 column without its parameters
+    const int16_t steps[2] = {0, 1};
+    const BulkColumn column{"y", BulkDType::DeltaInt16, 0, sizeof(steps)};
+    std::vector<double> scratch;
+    QVERIFY(columnDoubles(reinterpret_cast<const char*>(steps), column, {}, scratch, &error) == nullptr);
+    QVERIFY(!error.isEmpty());
+}
+
+void ReducedPrecisionTest::testChannelRequestsReducedPrecision()
+{
+    constexpr int samples = 4000;
+    PrecisionAnswers answers(samples);
+    MockBedrockServer server(answers.config());
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    channel.setProtocolVersion(PROTOCOL_VERSION_V2);
+
+    auto stream = [&](const ReducedPrecision& precision, std::vector<double>& y) {
+        QString error;
+        auto status = callOffThread([&]() {
+            palantir::XYSineRequest request;
+            return channel.streamXYSineRequest(
+                request,
+                [&](const LocalSocketChannel::XYSineSlice& slice) { y.assign(slice.y, slice.y + slice.count); },
+                &error, precision);
+        });
+        if (!status.has_value()) {
+            qWarning() << error;
+        }
+        return status.has_value();
+    };
+
+    // Full precision by default: nothing requested, exact samples
+    std::vector<double> full;
+    QVERIFY(stream({}, full));
+    QVERIFY(answers.lastRequestedPrecision.empty());
+    const size_t fullBytes = answers.lastColumnBytes;
+    QCOMPARE(full, sineSamples(samples, 2.0));
+
+    std::vector<double> reduced;
+    QVERIFY(stream({TransferPrecision::Float32, 1e-6}, reduced));
+    QCOMPARE(answers.lastRequestedPrecision, std::string("f32"));
+    QVERIFY(answers.lastColumnBytes * 2 <= fullBytes + PACKED_COLUMN_ALIGNMENT);
+    QVERIFY(maxError(full, reduced) <= 1e-6);
+
+    QVERIFY(stream({TransferPrecision::DeltaInt16, 1e-4}, reduced));
+    QCOMPARE(answers.lastRequestedPrecision, std::string("dq16"));
+    QVERIFY(answers.lastColumnBytes * 4 <= fullBytes + 3 * PACKED_COLUMN_ALIGNMENT);
+    QVERIFY(maxError(full, reduced) <= 1e-4 * (1.0 + 1e-9));
+}
+#else
+void ReducedPrecisionTest::testFloat32WithinBound() { QSKIP("Transport deps not enabled"); }
+void ReducedPrecisionTest::testDeltaInt16WithinBound() { QSKIP("Transport deps not enabled"); }
+void ReducedPrecisionTest::testLargeJumpFallsBackToFloat64() { QSKIP("Transport deps not enabled"); }
+void ReducedPrecisionTest::testRejectsMalformedQuantization() { QSKIP("Transport deps not enabled"); }
+void ReducedPrecisionTest::testChannelRequestsReducedPrecision() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(ReducedPrecisionTest)
+#include "ReducedPrecision_test.moc"
@@ -0,0 +1,244 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/ConnectionManager.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "analysis/RemoteExecutor.hpp"
+#include "analysis/RequestCoalescer.hpp"
+#include "analysis/ResultCache.hpp"
+#include "analysis/demo/XYSineDemo.hpp"
+#include <chrono>
+#include <future>
+
+using namespace phoenix::transport;
+
+namespace {
+
+constexpr int kQuietKeepaliveMs = 60000;
+
+// What one execute() call delivered
+struct RunResult {
+    const XYSineResult* result = nullptr;  // Address of the delivered result object
+    size_t samples = 0;
+    QString error;
+};
+
+std::future<RunResult> executeAsync(RemoteExecutor& executor, int samples)
+{
+    return std::async(std::launch::async, [&executor, samples]() {
+        RunResult run;
+        executor.execute(QStringLiteral("xy_sine"), {{QStringLiteral("samples"), samples}}, nullptr,
+                         [&run](const XYSineResult& result) {
+                             run.result = &result;
+                             run.samples = result.x.size();
+                         },
+                         [&run](const QString& error) { run.error = error; });
+        return run;
+    });
+}
+
+// Keeps the (main thread) mock server serving while waiting
+template <typename Predicate>
+bool pumpUntil(Predicate predicate, int timeoutMs = 5000)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+    return true;
+}
+
+RunResult wait(std::future<RunResult>& future)
+{
+    pumpUntil([&future]() { return future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready; });
+    return future.get();
+}
+
+} // namespace
+#endif
+
+class RequestCoalescingTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testKeyIsCanonical();
+    void testIdenticalRequestsShareOneRoundTrip();
+    void testDifferentRequestsRunSeparately();
+    void testCancelledLeaderHandsOver();
+    void testServerTotalIsCapped();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void RequestCoalescingTest::testKeyIsCanonical()
+{
+    QMap<QString, QVariant> a;
+    a.insert("samples", 250);
+    a.insert("frequency", 2.0);
+    QMap<QString, QVariant> b;
+    b.insert("frequency", 2);
+    b.insert("samples", 250.0);
+    QCOMPARE(RequestCoalescer::key("xy_sine", a), RequestCoalescer::key("xy_sine", b));
+
+    b.insert("samples", 251);
+    QVERIFY(RequestCoalescer::key("xy_sine", a) != RequestCoalescer::key("xy_sine", b));
+    QVERIFY(RequestCoalescer::key("xy_sine", a) != RequestCoalescer::key("other", a));
+
+    // A number and its text are different requests
+    QMap<QString, QVariant> text;
+    text.insert("samples", QStringLiteral("250"));
+    text.insert("frequency", 2.0);
+    QVERIFY(RequestCoalescer::key("xy_sine", a) != RequestCoalescer::key("xy_sine", text));
+
+    // One canonical form for coalescing and caching
+    QCOMPARE(RequestCoalescer::key("xy_sine", a), ResultCache::key("xy_sine", a, QString()));
+}
+
+void RequestCoalescingTest::testIdenticalRequestsShareOneRoundTrip()
+{
+    MockServerConfig config;
+    config.responseDelayMs = 200;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+    const QString name = server.socketName();
+    ConnectionManager connections([name]() { return std::make_unique<LocalSocketChannel>(name); },
+                                  kQuietKeepaliveMs);
+
+    RequestCoalescer coalescer;
+    RemoteExecutor first(&connections);
+    RemoteExecutor second(&connections);
+    first.setCoalescer(&coalescer);
+    second.setCoalescer(&coalescer);
+    first.setResultCache(nullptr);
+    second.setResultCache(nullptr);
+    first.setResultStore(nullptr);
+    second.setResultStore(nullptr);
+
+    auto leader = executeAsync(first, 300);
+    QVERIFY(pumpUntil([&coalescer]() { return coalescer.inFlight() == 1; }));
+    auto follower = executeAsync(second, 300);
+
+    const RunResult a = wait(leader);
+    const RunResult b = wait(follower);
+    QVERIFY2(a.error.isEmpty(), qPrintable(a.error));
+    QVERIFY2(b.error.isEmpty(), qPrintable(b.error));
+    QCOMPARE(a.samples, size_t(300));
+    QCOMPARE(b.samples, size_t(300));
+    QCOMPARE(a.result, b.result);  // Both saw the same result object
+
+    QCOMPARE(coalescer.computations(), uint64_t(1));
+    QCOMPARE(coalescer.coalesced(), uint64_t(1));
+    QCOMPARE(coalescer.inFlight(), size_t(0));
+    QCOMPARE(server.requestsReceived(), uint64_t(2));  // Capabilities + one XY Sine
+
+    // Finished requests are not kept by the coalescer
+    auto again = executeAsync(first, 300);
+    QCOMPARE(wait(again).samples, size_t(300));
+    QCOMPARE(server.requestsReceived(), uint64_t(3));
+}
+
+void RequestCoalescingTest::testDifferentRequestsRunSeparately()
+{
+    MockServerConfig config;
+    config.responseDelayMs = 100;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+    const QString name = server.socketName();
+    ConnectionManager connections([name]() { return std::make_unique<LocalSocketChannel>(name); },
+                                  kQuietKeepaliveMs);
+
+    RequestCoalescer coalescer;
+    RemoteExecutor first(&connections);
+    RemoteExecutor second(&connections);
+    first.setCoalescer(&coalescer);
+    second.setCoalescer(&coalescer);
+    first.setResultCache(nullptr);
+    second.setResultCache(nullptr);
+    first.setResultStore(nullptr);
+    second.setResultStore(nullptr);
+
+    auto small = executeAsync(first, 100);
+    auto large = executeAsync(second, 400);
+    QCOMPARE(wait(small).samples, size_t(100));
+    QCOMPARE(wait(large).samples, size_t(400));
+    QCOMPARE(coalescer.computations(), uint64_t(2));
+    QCOMPARE(coalescer.coalesced(), uint64_t(0));
+}
+
+void RequestCoalescingTest::testCancelledLeaderHandsOver()
+{
+    MockServerConfig config;
+    config.responseDelayMs = 300;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+    const QString name = server.socketName();
+    ConnectionManager connections([name]() { return std::make_unique<LocalSocketChannel>(name); },
+                                  kQuietKeepaliveMs);
+
+    RequestCoalescer coalescer;
+    RemoteExecutor first(&connections);
+    RemoteExecutor second(&connections);
+    first.setCoalescer(&coalescer);
+    second.setCoalescer(&coalescer);
+    first.setResultCache(nullptr);
+    second.setResultCache(nullptr);
+    first.setResultStore(nullptr);
+    second.setResultStore(nullptr);
+
+    auto leader = executeAsync(first, 200);
+    QVERIFY(pumpUntil([&server]() { return server.requestsReceived() >= 2; }));
+    auto follower = executeAsync(second, 200);
+    QVERIFY(pumpUntil([&coalescer]() { return coalescer.coalesced() == 1; }));
+
+    // The leader's window gives up; the other window still gets its result
+    first.cancel();
+    const RunResult cancelled = wait(leader);
+    QCOMPARE(cancelled.error, QString("Computation cancelled"));
+
+    const RunResult handedOver = wait(follower);
+    QVERIFY2(handedOver.error.isEmpty(), qPrintable(handedOver.error));
+    QCOMPARE(handedOver.samples, size_t(200));
+    QCOMPARE(coalescer.computations(), uint64_t(2));
+}
+
+void RequestCoalescingTest::testServerTotalIsCapped()
+{
+    // A server announcing more samples than asked for is refused, not obeyed
+    MockServerConfig config;
+    config.fixedSamples = 5000;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+    const QString name = server.socketName();
+    ConnectionManager connections([name]() { return std::make_unique<LocalSocketChannel>(name); },
+                                  kQuietKeepaliveMs);
+
+    RequestCoalescer coalescer;
+    RemoteExecutor executor(&connections);
+    executor.setCoalescer(&coalescer);
+    executor.setResultCache(nullptr);
+    executor.setResultStore(nullptr);
+
+    auto oversized = executeAsync(executor, 300);
+    const RunResult refused = wait(oversized);
+    QVERIFY(refused.result == nullptr);
+    QVERIFY2(refused.error.contains("5000"), qPrintable(refused.error));
+
+    // Fewer samples than asked for is a complete (if short) answer
+    auto undersized = executeAsync(executor, 6000);
+    const RunResult shorter = wait(undersized);
+    QVERIFY2(shorter.error.isEmpty(), qPrintable(shorter.error));
+    QCOMPARE(shorter.samples, size_t(5000));
+}
+#else
+void RequestCoalescingTest::testKeyIsCanonical() { QSKIP("Transport deps not enabled"); }
+void RequestCoalescingTest::testIdenticalRequestsShareOneRoundTrip() { QSKIP("Transport deps not enabled"); }
+void RequestCoalescingTest::testDifferentRequestsRunSeparately() { QSKIP("Transport deps not enabled"); }
+void RequestCoalescingTest::testCancelledLeaderHandsOver() { QSKIP("Transport deps not enabled"); }
+void RequestCoalescingTest::testServerTotalIsCapped() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(RequestCoalescingTest)
+#include "RequestCoalescing_test.moc"
@@ -0,0 +1,263 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/SessionAuth.hpp"
+#include "FrameTestUtils.hpp"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace phoenix::transport;
+
+namespace {
+
+// Encoded [length][envelope] frame, as encodeFrame() lays it out
+std::string encodeTestFrame(palantir::MessageType type, const std::string& payload)
+{
+    palantir::MessageEnvelope envelope;
+    envelope.set_version(PROTOCOL_VERSION);
+    envelope.set_type(type);
+    envelope.set_payload(payload);
+    std::string serialized;
+    envelope.SerializeToString(&serialized);
+    const uint32_t length = static_cast<uint32_t>(serialized.size());
+    std::string frame(reinterpret_cast<const char*>(&length), FRAME_HEADER_SIZE);
+    return frame + serialized;
+}
+
+} // namespace
+#endif
+
+class SessionAuthTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testKeyHex();
+    void testFrameMac();
+    void testAuthenticatedRoundTrip();
+    void testWrongServerIdentity();
+    void testServerWithoutIdentity();
+    void testUnauthenticatedClientRefused();
+    void testServerKeyFromEnvironment();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void SessionAuthTest::testKeyHex()
+{
+    IdentityPublicKey key;
+    for (size_t i = 0; i < key.size(); ++i) {
+        key[i] = static_cast<unsigned char>(i * 7);
+    }
+    const std::string hex = keyToHex(key);
+    QCOMPARE(hex.size(), size_t(64));
+
+    IdentityPublicKey parsed{};
+    QVERIFY(keyFromHex(hex, parsed.data(), parsed.size()));
+    QVERIFY(parsed == key);
+
+    // Upper case is fine; short, long and non-hex keys are not
+    QString error;
+    QVERIFY(keyFromHex(QByteArray::fromStdString(hex).toUpper().toStdString(), parsed.data(), parsed.size()));
+    QVERIFY(!keyFromHex(hex.substr(2), parsed.data(), parsed.size(), &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!keyFromHex(hex + "00", parsed.data(), parsed.size()));
+    QVERIFY(!keyFromHex(hex.substr(1) + "g", parsed.data(), parsed.size()));
+}
+
+void SessionAuthTest::testFrameMac()
+{
+    if (!sessionAuthAvailable()) {
+        QSKIP("Built without libsodium");
+    }
+    SessionKey key;
+    key.fill(0x11);
+    FrameMac sender(key);
+    FrameMac receiver(key);
+
+    // Sign in place: the prefix now counts the tag; the body is [envelope][tag]
+    std::string frame = encodeTestFrame(palantir::MessageType::CAPABILITIES_REQUEST, "payload");
+    const size_t envelopeSize = frame.size() - FRAME_HEADER_SIZE;
+    unsigned char tag[FRAME_MAC_BYTES];
+    sender.sign(frame.data(), frame.size(), tag);
+    uint32_t prefix = 0;
+    std::memcpy(&prefix, frame.data(), FRAME_HEADER_SIZE);
+    QCOMPARE(prefix, static_cast<uint32_t>(envelopeSize + FRAME_MAC_BYTES));
+    std::string body = frame.substr(FRAME_HEADER_SIZE) + std::string(reinterpret_cast<const char*>(tag), sizeof(tag));
+    QVERIFY(receiver.verify(body.data(), body.size()));
+    QCOMPARE(receiver.sequence(), uint64_t(1));
+
+    // Replayed: the receiver has moved on to the next sequence number
+    QVERIFY(!receiver.verify(body.data(), body.size()));
+
+    // Tampered envelope or tag
+    FrameMac freshReceiver(key);
+    std::string tampered = body;
+    tampered[2] ^= 0x01;
+    QVERIFY(!freshReceiver.verify(tampered.data(), tampered.size()));
+    FrameMac otherReceiver(key);
+    tampered = body;
+    tampered.back() ^= 0x80;
+    QVERIFY(!otherReceiver.verify(tampered.data(), tampered.size()));
+
+    // Another session key
+    SessionKey otherKey;
+    otherKey.fill(0x22);
+    FrameMac stranger(otherKey);
+    QVERIFY(!stranger.verify(body.data(), body.size()));
+
+    // Shorter than a tag
+    FrameMac shortReceiver(key);
+    QVERIFY(!shortReceiver.verify(body.data(), FRAME_MAC_BYTES - 1));
+}
+
+void SessionAuthTest::testAuthenticatedRoundTrip()
+{
+    IdentityPublicKey identity;
+    IdentitySecretKey secret;
+    if (!generateIdentity(identity, secret)) {
+        QSKIP("Built without libsodium");
+    }
+    MockServerConfig config;
+    config.identity = secret;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+
+    LocalSocketChannel channel(server.socketName());
+    channel.setServerIdentity(identity);
+    QVERIFY(callOffThread([&]() { return channel.connect(); }));
+    QVERIFY(channel.isAuthenticated());
+
+    QString error;
+    auto capabilities = callOffThread([&]() { return channel.getCapabilities(&error); });
+    QVERIFY2(capabilities.has_value(), qPrintable(error));
+
+    // Chunked response: every chunk is tagged and checked in order
+    palantir::XYSineRequest request;
+    request.set_samples(600000);
+    request.set_frequency(1.0);
+    std::vector<double> y;
+    int chunks = 0;
+    auto status = callOffThread([&]() {
+        return channel.streamXYSineRequest(
+            request,
+            [&](const LocalSocketChannel::XYSineSlice& slice) {
+                y.resize(slice.info.totalSamples);
+                std::copy(slice.y, slice.y + slice.count, y.begin() + slice.info.offset);
+                ++chunks;
+            },
+            &error);
+    });
+    QVERIFY2(status.has_value(), qPrintable(error));
+    QVERIFY(chunks > 1);
+    QCOMPARE(y.size(), size_t(600000));
+    QVERIFY(std::abs(y[150000] - std::sin(2.0 * M_PI * 150000.0 / 599999.0)) < 1e-9);
+
+    // Handshake, capabilities, XY Sine
+    QCOMPARE(server.requestsReceived(), uint64_t(3));
+}
+
+void SessionAuthTest::testWrongServerIdentity()
+{
+    IdentityPublicKey identity;
+    IdentitySecretKey secret;
+    IdentityPublicKey otherIdentity;
+    IdentitySecretKey otherSecret;
+    if (!generateIdentity(identity, secret) || !generateIdentity(otherIdentity, otherSecret)) {
+        QSKIP("Built without libsodium");
+    }
+    MockServerConfig config;
+    config.identity = otherSecret;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+
+    // A server that cannot prove the pinned identity is never talked to
+    LocalSocketChannel channel(server.socketName());
+    channel.setServerIdentity(identity);
+    QVERIFY(!callOffThread([&]() { return channel.connect(); }));
+    QVERIFY(!channel.isConnected());
+    QVERIFY(!channel.isAuthenticated());
+    QCOMPARE(server.requestsReceived(), uint64_t(1));
+}
+
+void SessionAuthTest::testServerWithoutIdentity()
+{
+    IdentityPublicKey identity;
+    IdentitySecretKey secret;
+    if (!generateIdentity(identity, secret)) {
+        QSKIP("Built without libsodium");
+    }
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+
+    // AUTH_HELLO is an unknown message type here
+    LocalSocketChannel channel(server.socketName());
+    channel.setServerIdentity(identity);
+    QVERIFY(!callOffThread([&]() { return channel.connect(); }));
+    QVERIFY(!channel.isAuthenticated());
+
+    // Without a pinned identity the same server is fine
+    channel.setServerIdentity(std::nullopt);
+    QVERIFY(callOffThread([&]() { return channel.connect(); }));
+    QVERIFY(!channel.isAuthenticated());
+}
+
+void SessionAuthTest::testUnauthenticatedClientRefused()
+{
+    IdentityPublicKey identity;
+    IdentitySecretKey secret;
+    if (!generateIdentity(identity, secret)) {
+        QSKIP("Built without libsodium");
+    }
+    MockServerConfig config;
+    config.identity = secret;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+    QString error;
+    QVERIFY(!callOffThread([&]() { return channel.getCapabilities(&error); }).has_value());
+    QVERIFY2(error.contains(QStringLiteral("Authentication required")), qPrintable(error));
+}
+
+void SessionAuthTest::testServerKeyFromEnvironment()
+{
+    IdentityPublicKey identity;
+    IdentitySecretKey secret;
+    if (!generateIdentity(identity, secret)) {
+        QSKIP("Built without libsodium");
+    }
+    MockServerConfig config;
+    config.identity = secret;
+    MockBedrockServer server(config);
+    QVERIFY(server.listen());
+
+    qputenv("PALANTIR_SERVER_KEY", QByteArray::fromStdString(keyToHex(identity)));
+    {
+        LocalSocketChannel channel(server.socketName());
+        QVERIFY(callOffThread([&]() { return channel.connect(); }));
+        QVERIFY(channel.isAuthenticated());
+    }
+
+    // A malformed key refuses to connect rather than falling back to plain frames
+    qputenv("PALANTIR_SERVER_KEY", "not-a-key");
+    {
+        LocalSocketChannel channel(server.socketName());
+        QVERIFY(!callOffThread([&]() { return channel.connect(); }));
+    }
+    qunsetenv("PALANTIR_SERVER_KEY");
+}
+#else
+void SessionAuthTest::testKeyHex() { QSKIP("Transport deps not enabled"); }
+void SessionAuthTest::testFrameMac() { QSKIP("Transport deps not enabled"); }
+void SessionAuthTest::testAuthenticatedRoundTrip() { QSKIP("Transport deps not enabled"); }
+void SessionAuthTest::testWrongServerIdentity() { QSKIP("Transport deps not enabled"); }
+void SessionAuthTest::testServerWithoutIdentity() { QSKIP("Transport deps not enabled"); }
+void SessionAuthTest::testUnauthenticatedClientRefused() { QSKIP("Transport deps not enabled"); }
+void SessionAuthTest::testServerKeyFromEnvironment() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(SessionAuthTest)
+#include "SessionAuth_test.moc"
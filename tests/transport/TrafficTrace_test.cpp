@@ -0,0 +1,159 @@
+#include <QtTest/QtTest>
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "transport/TrafficTrace.hpp"
+#include "palantir/xysine.pb.h"
+#include "FrameTestUtils.hpp"
+#include <QTemporaryDir>
+#include <vector>
+
+using namespace phoenix::transport;
+
+static std::vector<TraceRecord> readAll(const QString& path, QString* outError)
+{
+    std::vector<TraceRecord> records;
+    TraceReader reader;
+    if (!reader.open(path, outError)) {
+        return records;
+    }
+    TraceRecord record;
+    while (reader.next(record, outError)) {
+        records.push_back(record);
+    }
+    return records;
+}
+#endif
+
+class TrafficTraceTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRecordReadRoundTrip();
+    void testRejectsForeignAndTruncatedFiles();
+    void testChannelRecordsBothDirections();
+};
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+void TrafficTraceTest::testRecordReadRoundTrip()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("roundtrip.trace");
+
+    TrafficRecorder recorder;
+    QVERIFY(recorder.open(path));
+    recorder.record(TraceDirection::Sent, "request", 7);
+    recorder.record(TraceDirection::Received, "", 0);
+    recorder.record(TraceDirection::Received, "response", 8);
+    QCOMPARE(recorder.recordCount(), uint64_t(3));
+    recorder.close();
+    recorder.record(TraceDirection::Sent, "late", 4);  // Ignored once closed
+
+    QString error;
+    const auto records = readAll(path, &error);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(records.size(), size_t(3));
+    QCOMPARE(records[0].direction, TraceDirection::Sent);
+    QCOMPARE(records[0].envelope, std::string("request"));
+    QVERIFY(records[1].envelope.empty());
+    QCOMPARE(records[2].direction, TraceDirection::Received);
+    QCOMPARE(records[2].envelope, std::string("response"));
+    QVERIFY(records[0].timestampNs <= records[1].timestampNs);
+    QVERIFY(records[1].timestampNs <= records[2].timestampNs);
+
+    // Exact layout: magic, then [direction][timestamp][length][bytes]
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.size(), qint64(sizeof(kTraceMagic) + 3 * TRACE_RECORD_HEADER_SIZE + 7 + 8));
+}
+
+void TrafficTraceTest::testRejectsForeignAndTruncatedFiles()
+{
+    QTemporaryDir dir;
+    QString error;
+
+    TraceReader reader;
+    QVERIFY(!reader.open(dir.filePath("missing.trace"), &error));
+
+    const QString foreign = dir.filePath("foreign.trace");
+    QFile file(foreign);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a trace at all");
+    file.close();
+    error.clear();
+    QVERIFY(!reader.open(foreign, &error));
+    QVERIFY(error.contains("not a Phoenix traffic trace"));
+
+    // A record cut short (e.g. the recording process crashed) ends the
+    // trace with an error; complete records before it are still returned
+    const QString truncated = dir.filePath("truncated.trace");
+    TrafficRecorder recorder;
+    QVERIFY(recorder.open(truncated));
+    recorder.record(TraceDirection::Sent, "complete", 8);
+    recorder.record(TraceDirection::Received, "cut short", 9);
+    recorder.close();
+    QFile cut(truncated);
+    QVERIFY(cut.resize(cut.size() - 4));
+
+    error.clear();
+    const auto records = readAll(truncated, &error);
+    QCOMPARE(records.size(), size_t(1));
+    QVERIFY(error.contains("Truncated"));
+}
+
+void TrafficTraceTest::testChannelRecordsBothDirections()
+{
+    MockBedrockServer server;
+    QVERIFY(server.listen());
+    LocalSocketChannel channel(server.socketName());
+    QVERIFY(channel.connect());
+
+    QTemporaryDir dir;
+    const QString path = dir.filePath("session.trace");
+    auto recorder = std::make_shared<TrafficRecorder>();
+    QVERIFY(recorder->open(path));
+    channel.setTrafficRecorder(recorder);
+
+    QString error;
+    palantir::XYSineRequest request;
+    request.set_samples(50);
+    QVERIFY(callOffThread([&]() { return channel.getCapabilities(&error); }).has_value());
+    QVERIFY(callOffThread([&]() { return channel.sendXYSineRequest(request, &error); }).has_value());
+
+    // Recording stops when the recorder is detached
+    channel.setTrafficRecorder(nullptr);
+    QVERIFY(callOffThread([&]() { return channel.getCapabilities(&error); }).has_value());
+    recorder->close();
+
+    const auto records = readAll(path, &error);
+    QCOMPARE(records.size(), size_t(4));
+
+    const std::vector<TraceDirection> directions = {TraceDirection::Sent, TraceDirection::Received,
+                                                    TraceDirection::Sent, TraceDirection::Received};
+    const std::vector<palantir::MessageType> types = {
+        palantir::MessageType::CAPABILITIES_REQUEST, palantir::MessageType::CAPABILITIES_RESPONSE,
+        palantir::MessageType::XY_SINE_REQUEST, palantir::MessageType::XY_SINE_RESPONSE};
+    for (size_t i = 0; i < records.size(); ++i) {
+        QCOMPARE(records[i].direction, directions[i]);
+        palantir::MessageEnvelope envelope;
+        QVERIFY(parseEnvelope(records[i].envelope.data(), records[i].envelope.size(), envelope));
+        QCOMPARE(envelope.type(), types[i]);
+    }
+
+    // Responses carry the correlation ID of the request they answer
+    palantir::MessageEnvelope sent, received;
+    QVERIFY(parseEnvelope(records[2].envelope.data(), records[2].envelope.size(), sent));
+    QVERIFY(parseEnvelope(records[3].envelope.data(), records[3].envelope.size(), received));
+    QCOMPARE(correlationId(received), correlationId(sent));
+    QVERIFY(records[3].timestampNs >= records[2].timestampNs);
+}
+#else
+void TrafficTraceTest::testRecordReadRoundTrip() { QSKIP("Transport deps not enabled"); }
+void TrafficTraceTest::testRejectsForeignAndTruncatedFiles() { QSKIP("Transport deps not enabled"); }
+void TrafficTraceTest::testChannelRecordsBothDirections() { QSKIP("Transport deps not enabled"); }
+#endif
+
+QTEST_MAIN(TrafficTraceTest)
+#include "TrafficTrace_test.moc"
@@ -0,0 +1,132 @@
+#include <QtTest/QtTest>
+#include "analysis/demo/XYSineDemo.hpp"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+
+class XYSineKernelBench : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testAccuracy_data();
+    void testAccuracy();
+    void testMapParams();
+    void testThroughput();
+};
+
+namespace {
+
+// Largest |a[i] - b[i]|, or infinity if the sizes differ
+double maxError(const std::vector<double>& a, const std::vector<double>& b)
+{
+    if (a.size() != b.size()) {
+        return INFINITY;
+    }
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        worst = std::max(worst, std::fabs(a[i] - b[i]));
+    }
+    return worst;
+}
+
+double nsPerSample(qint64 elapsedNs, int samples)
+{
+    return static_cast<double>(elapsedNs) / samples;
+}
+
+} // namespace
+
+void XYSineKernelBench::testAccuracy_data()
+{
+    QTest::addColumn<int>("samples");
+    QTest::addColumn<double>("frequency");
+    QTest::addColumn<double>("amplitude");
+    QTest::addColumn<double>("phase");
+
+    QTest::newRow("minimum") << 2 << 1.0 << 1.0 << 0.0;
+    QTest::newRow("scalar tail") << 5 << 3.0 << 2.0 << 0.5;
+    QTest::newRow("default") << 1000 << 1.0 << 1.0 << 0.0;
+    QTest::newRow("odd size") << 1001 << 7.5 << 0.25 << -1.0;
+    QTest::newRow("max frequency") << 100000 << 100.0 << 10.0 << 6.28318;
+    QTest::newRow("low frequency") << 4096 << 0.1 << 3.0 << -6.28318;
+    // Large enough to be split across the scheduler's workers
+    QTest::newRow("parallel") << (1 << 20) + 3 << 42.0 << 1.5 << 1.0;
+}
+
+void XYSineKernelBench::testAccuracy()
+{
+    QFETCH(int, samples);
+    QFETCH(double, frequency);
+    QFETCH(double, amplitude);
+    QFETCH(double, phase);
+    const XYSineDemo::Params params{frequency, amplitude, phase, samples};
+
+    XYSineResult kernel;
+    QVERIFY(XYSineDemo::compute(params, kernel));
+    XYSineResult reference;
+    XYSineDemo::computeReference(params, reference);
+
+    QCOMPARE(kernel.x.size(), size_t(samples));
+    QCOMPARE(kernel.y.size(), size_t(samples));
+    QVERIFY(maxError(kernel.x, reference.x) <= 1e-15);
+
+    // A few ulp of the amplitude: the sine itself is within 1 ulp, the
+    // rest is rounding of the argument (FMA contraction differs per build)
+    const double yError = maxError(kernel.y, reference.y);
+    qDebug() << "[ACCURACY]" << QTest::currentDataTag() << "max |y - reference|:" << yError;
+    QVERIFY2(yError <= 2e-15 * amplitude, qPrintable(QString::number(yError)));
+}
+
+void XYSineKernelBench::testMapParams()
+{
+    // Same parsing as before the kernel: alias, defaults, clamping
+    QMap<QString, QVariant> params;
+    params.insert("n_samples", 1);
+    params.insert("frequency", 2.0);
+    XYSineDemo::Params parsed = XYSineDemo::parseParams(params);
+    QCOMPARE(parsed.samples, 2);
+    QCOMPARE(parsed.frequency, 2.0);
+    QCOMPARE(parsed.amplitude, 1.0);
+
+    params.insert("samples", 500);
+    parsed = XYSineDemo::parseParams(params);
+    QCOMPARE(parsed.samples, 500);
+
+    XYSineResult result;
+    QVERIFY(XYSineDemo::compute(params, result));
+    QCOMPARE(result.x.size(), size_t(500));
+    QCOMPARE(result.x.front(), 0.0);
+    QCOMPARE(result.x.back(), 2.0 * M_PI);
+}
+
+void XYSineKernelBench::testThroughput()
+{
+    constexpr int samples = 10000000;
+    const XYSineDemo::Params params{5.0, 1.0, 0.25, samples};
+    XYSineResult kernel;
+    XYSineResult reference;
+
+    // Warm-up: page in the columns and start the scheduler's workers
+    QVERIFY(XYSineDemo::compute(params, kernel));
+    XYSineDemo::computeReference(params, reference);
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(XYSineDemo::compute(params, kernel));
+    const qint64 kernelNs = timer.nsecsElapsed();
+
+    timer.restart();
+    XYSineDemo::computeReference(params, reference);
+    const qint64 referenceNs = timer.nsecsElapsed();
+
+    qDebug() << "[PERF] XY Sine kernel," << samples << "samples:"
+             << nsPerSample(kernelNs, samples) << "ns/sample";
+    qDebug() << "[PERF] XY Sine scalar reference," << samples << "samples:"
+             << nsPerSample(referenceNs, samples) << "ns/sample";
+
+    // No speed assertion (shared CI machines); correctness still holds
+    QVERIFY(maxError(kernel.y, reference.y) <= 2e-15);
+}
+
+QTEST_MAIN(XYSineKernelBench)
+#include "xysine_kernel_bench.moc"
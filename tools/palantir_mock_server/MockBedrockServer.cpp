@@ -0,0 +1,547 @@
+#include "MockBedrockServer.hpp"
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+
+#include "palantir/capabilities.pb.h"
+#include "palantir/error.pb.h"
+#include "palantir/xysine.pb.h"
+#include "transport/BatchRpc.hpp"
+#include "transport/DeltaResponse.hpp"
+#include <google/protobuf/empty.pb.h>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMetaObject>
+#include <QThread>
+#include <QTimer>
+#include <QUuid>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace phoenix::transport {
+
+// Same limit as Bedrock and LocalSocketChannel
+static constexpr uint32_t MOCK_MAX_MESSAGE_SIZE = 10 * 1024 * 1024;
+// Two doubles per sample in the repeated x/y fields
+static constexpr size_t BYTES_PER_SAMPLE = 2 * sizeof(double);
+
+struct MockBedrockServer::Connection {
+    QLocalSocket* socket = nullptr;
+    FrameDecoder decoder{MOCK_MAX_MESSAGE_SIZE + FRAME_MAC_BYTES};
+    std::string frame;  // Reused write buffer
+    std::unique_ptr<AuthSession> session;  // Set once authenticated
+};
+
+MockBedrockServer::MockBedrockServer(MockServerConfig config, QObject* parent)
+    : QObject(parent)
+    , m_config(std::move(config))
+    , m_server(new QLocalServer(this))
+    , m_random(m_config.seed)
+    , m_requestsReceived(0)
+    , m_errorsInjected(0)
+    , m_batchItems(0)
+    , m_columnsReused(0)
+{
+    QObject::connect(m_server, &QLocalServer::newConnection, this, [this]() { onNewConnection(); });
+}
+
+MockBedrockServer::~MockBedrockServer()
+{
+    close();
+}
+
+bool MockBedrockServer::listen(const QString& name, QString* outError)
+{
+    const QString socketName = name.isEmpty()
+        ? QStringLiteral("palantir_mock_%1").arg(QUuid::createUuid().toString(QUuid::Id128))
+        : name;
+    QLocalServer::removeServer(socketName);  // Stale socket file of a crashed run
+    if (!m_server->listen(socketName)) {
+        if (outError) {
+            *outError = QString("Failed to listen on %1: %2").arg(socketName, m_server->errorString());
+        }
+        return false;
+    }
+    m_socketName = socketName;
+    return true;
+}
+
+void MockBedrockServer::close()
+{
+    disconnectClients();
+    m_server->close();
+}
+
+void MockBedrockServer::disconnectClients()
+{
+    // abort() emits disconnected(), which edits m_connections
+    std::vector<std::shared_ptr<Connection>> connections;
+    connections.swap(m_connections);
+    for (const auto& connection : connections) {
+        connection->socket->abort();
+    }
+}
+
+void MockBedrockServer::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        auto connection = std::make_shared<Connection>();
+        connection->socket = socket;
+        m_connections.push_back(connection);
+
+        std::weak_ptr<Connection> weak = connection;
+        QObject::connect(socket, &QLocalSocket::readyRead, this, [this, weak]() {
+            if (auto connection = weak.lock()) {
+                onReadyRead(connection);
+            }
+        });
+        QObject::connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            m_connections.erase(std::remove_if(m_connections.begin(), m_connections.end(),
+                                               [socket](const auto& c) { return c->socket == socket; }),
+                                m_connections.end());
+            socket->deleteLater();
+        });
+    }
+}
+
+void MockBedrockServer::onReadyRead(const std::shared_ptr<Connection>& connection)
+{
+    RingBuffer& buffer = connection->decoder.buffer();
+    qint64 available = 0;
+    while ((available = connection->socket->bytesAvailable()) > 0) {
+        char* target = buffer.prepareWrite(static_cast<size_t>(available));
+        const qint64 bytesRead = connection->socket->read(target, available);
+        if (bytesRead <= 0) {
+            break;
+        }
+        buffer.commitWrite(static_cast<size_t>(bytesRead));
+    }
+
+    for (;;) {
+        const char* body = nullptr;
+        uint32_t length = 0;
+        const auto status = connection->decoder.nextFrame(&body, &length);
+        if (status == FrameDecoder::Status::NeedMoreData) {
+            return;
+        }
+        if (status == FrameDecoder::Status::FrameTooLarge) {
+            qWarning() << "MockBedrockServer: Frame length" << length << "exceeds limit, dropping client";
+            connection->socket->abort();
+            return;
+        }
+
+        uint32_t envelopeSize = length;
+        if (connection->session) {
+            if (!connection->session->receive.verify(body, length)) {
+                qWarning() << "MockBedrockServer: Frame failed authentication, dropping client";
+                connection->socket->abort();
+                return;
+            }
+            envelopeSize = length - static_cast<uint32_t>(FRAME_MAC_BYTES);
+        }
+
+        palantir::MessageEnvelope request;
+        QString parseError;
+        const bool parsed = parseEnvelope(body, envelopeSize, request, &parseError);
+        connection->decoder.consumeFrame(length);
+        if (!parsed) {
+            qWarning() << "MockBedrockServer: Dropping malformed frame:" << parseError;
+            continue;
+        }
+        handleRequest(connection, request);
+    }
+}
+
+void MockBedrockServer::handleRequest(const std::shared_ptr<Connection>& connection,
+                                      const palantir::MessageEnvelope& request)
+{
+    m_requestsReceived.fetch_add(1);
+
+    // The handshake is answered at once, ahead of any delayed responses
+    if (m_config.identity.has_value()) {
+        if (request.type() == AUTH_HELLO && !connection->session) {
+            answerHandshake(*connection, request);
+            return;
+        }
+        if (!connection->session) {
+            answerError(*connection, request, palantir::ErrorCode::INVALID_ARGUMENT, "Authentication required");
+            return;
+        }
+    }
+
+    if (m_config.onRequest) {
+        MockReply reply(this, connection, request);
+        if (m_config.onRequest(reply)) {
+            return;
+        }
+    }
+
+    auto respond = [this](Connection& target, const palantir::MessageEnvelope& envelope) {
+        switch (envelope.type()) {
+            case palantir::MessageType::CAPABILITIES_REQUEST:
+                answerCapabilities(target, envelope);
+                break;
+            case palantir::MessageType::XY_SINE_REQUEST:
+                answerXYSine(target, envelope);
+                break;
+            case XY_SINE_BATCH_REQUEST:
+                answerXYSineBatch(target, envelope);
+                break;
+            default:
+                answerError(target, envelope, palantir::ErrorCode::UNKNOWN_MESSAGE_TYPE,
+                            "Unknown message type " + std::to_string(static_cast<int>(envelope.type())));
+                break;
+        }
+    };
+
+    if (m_config.responseDelayMs <= 0) {
+        respond(*connection, request);
+        return;
+    }
+
+    // A timer per request: delayed responses overlap like real computations
+    std::weak_ptr<Connection> weak = connection;
+    QTimer::singleShot(m_config.responseDelayMs, this, [weak, request, respond]() {
+        if (auto target = weak.lock()) {
+            respond(*target, request);
+        }
+    });
+}
+
+void MockBedrockServer::answerHandshake(Connection& connection, const palantir::MessageEnvelope& request)
+{
+    std::map<std::string, std::string> metadata;
+    QString error;
+    auto session = acceptHandshake(request, *m_config.identity, metadata, &error);
+    if (!session) {
+        answerError(connection, request, palantir::ErrorCode::INVALID_ARGUMENT, error.toStdString());
+        return;
+    }
+    // The response itself travels untagged; everything after it is tagged
+    send(connection, AUTH_RESPONSE, google::protobuf::Empty(), request, std::move(metadata));
+    connection.session = std::move(session);
+}
+
+void MockBedrockServer::answerCapabilities(Connection& connection, const palantir::MessageEnvelope& request)
+{
+    palantir::CapabilitiesResponse response;
+    response.mutable_capabilities()->set_server_version(m_config.serverVersion);
+    for (const std::string& feature : m_config.features) {
+        response.mutable_capabilities()->add_supported_features(feature);
+    }
+    send(connection, palantir::MessageType::CAPABILITIES_RESPONSE, response, request);
+}
+
+void MockBedrockServer::answerXYSine(Connection& connection, const palantir::MessageEnvelope& request)
+{
+    palantir::XYSineRequest sineRequest;
+    if (!sineRequest.ParseFromString(request.payload())) {
+        answerError(connection, request, palantir::ErrorCode::PROTOBUF_PARSE_ERROR, "Malformed XYSineRequest");
+        return;
+    }
+    ++m_sineRequests;
+    if (injectError()) {
+        m_errorsInjected.fetch_add(1);
+        answerError(connection, request, palantir::ErrorCode::INTERNAL_ERROR, "Injected error");
+        return;
+    }
+
+    const int samples = computeSine(sineRequest);
+    const size_t total = static_cast<size_t>(samples);
+
+    // Delta requests: leave out the columns the client already holds
+    bool reuseX = false;
+    bool reuseY = false;
+    QString baseError;
+    if (auto base = baseColumnsFromEnvelope(request, &baseError)) {
+        auto matches = [&](const char* name, const std::vector<double>& column) {
+            auto it = base->find(name);
+            return it != base->end() && it->second == columnHash(column.data(), total);
+        };
+        reuseX = matches("x", m_x);
+        reuseY = matches("y", m_y);
+        m_columnsReused.fetch_add(static_cast<uint64_t>(reuseX) + static_cast<uint64_t>(reuseY));
+    } else if (!baseError.isEmpty()) {
+        answerError(connection, request, palantir::ErrorCode::INVALID_ARGUMENT, baseError.toStdString());
+        return;
+    }
+    std::string reusedNames;
+    if (reuseX || reuseY) {
+        reusedNames = reuseX && reuseY ? "x,y" : reuseX ? "x" : "y";
+    }
+    const size_t bytesPerSample = (reuseX ? 0 : sizeof(double)) + (reuseY ? 0 : sizeof(double));
+
+    // Chunk when the client accepts chunks and the result exceeds its chunk size
+    const auto& metadata = request.metadata();
+    size_t maxChunkBytes = 0;
+    if (metadata.count(kAcceptChunkedKey) && bytesPerSample > 0) {
+        maxChunkBytes = DEFAULT_MAX_CHUNK_BYTES;
+        auto it = metadata.find(kMaxChunkBytesKey);
+        if (it != metadata.end()) {
+            maxChunkBytes = std::max<size_t>(std::strtoull(it->second.c_str(), nullptr, 10), bytesPerSample);
+        }
+    }
+    if (maxChunkBytes == 0 && total * bytesPerSample > MOCK_MAX_MESSAGE_SIZE) {
+        answerError(connection, request, palantir::ErrorCode::MESSAGE_TOO_LARGE,
+                    "Result of " + std::to_string(samples) + " samples exceeds the message size limit");
+        return;
+    }
+    const size_t perChunk = maxChunkBytes == 0 ? total : std::max<size_t>(maxChunkBytes / bytesPerSample, 1);
+    const uint32_t chunkCount = static_cast<uint32_t>((total + perChunk - 1) / perChunk);
+
+    palantir::XYSineResponse response;
+    response.set_status("OK");
+    for (uint32_t index = 0; index < chunkCount; ++index) {
+        const size_t offset = index * perChunk;
+        const int count = static_cast<int>(std::min(perChunk, total - offset));
+        response.mutable_x()->Resize(reuseX ? 0 : count, 0.0);
+        response.mutable_y()->Resize(reuseY ? 0 : count, 0.0);
+        if (!reuseX) {
+            std::copy_n(m_x.data() + offset, count, response.mutable_x()->mutable_data());
+        }
+        if (!reuseY) {
+            std::copy_n(m_y.data() + offset, count, response.mutable_y()->mutable_data());
+        }
+
+        std::map<std::string, std::string> chunkMetadata;
+        if (!reusedNames.empty()) {
+            chunkMetadata[kReusedColumnsKey] = reusedNames;
+        }
+        if (chunkCount > 1) {
+            chunkMetadata[kChunkIndexKey] = std::to_string(index);
+            chunkMetadata[kChunkCountKey] = std::to_string(chunkCount);
+            chunkMetadata[kChunkOffsetKey] = std::to_string(offset);
+            chunkMetadata[kTotalSamplesKey] = std::to_string(total);
+        }
+        send(connection, palantir::MessageType::XY_SINE_RESPONSE, response, request, std::move(chunkMetadata));
+    }
+}
+
+void MockBedrockServer::answerXYSineBatch(Connection& connection, const palantir::MessageEnvelope& request)
+{
+    std::vector<palantir::XYSineRequest> items;
+    QString parseError;
+    if (!parseXYSineBatch(request.payload(), items, &parseError)) {
+        answerError(connection, request, palantir::ErrorCode::PROTOBUF_PARSE_ERROR, parseError.toStdString());
+        return;
+    }
+    m_batchItems.fetch_add(items.size());
+
+    // One envelope per item (never chunked), then the end-of-batch marker
+    palantir::XYSineResponse response;
+    response.set_status("OK");
+    for (size_t index = 0; index < items.size(); ++index) {
+        std::map<std::string, std::string> itemMetadata{{kBatchIndexKey, std::to_string(index)}};
+        ++m_sineRequests;
+        if (injectError()) {
+            m_errorsInjected.fetch_add(1);
+            palantir::ErrorResponse error;
+            error.set_error_code(palantir::ErrorCode::INTERNAL_ERROR);
+            error.set_message("Injected error");
+            send(connection, palantir::MessageType::ERROR_RESPONSE, error, request, std::move(itemMetadata));
+            continue;
+        }
+        const int samples = computeSine(items[index]);
+        if (static_cast<size_t>(samples) * BYTES_PER_SAMPLE > MOCK_MAX_MESSAGE_SIZE) {
+            palantir::ErrorResponse error;
+            error.set_error_code(palantir::ErrorCode::MESSAGE_TOO_LARGE);
+            error.set_message("Batch item of " + std::to_string(samples) + " samples exceeds the message size limit");
+            send(connection, palantir::MessageType::ERROR_RESPONSE, error, request, std::move(itemMetadata));
+            continue;
+        }
+        response.mutable_x()->Assign(m_x.begin(), m_x.end());
+        response.mutable_y()->Assign(m_y.begin(), m_y.end());
+        send(connection, palantir::MessageType::XY_SINE_RESPONSE, response, request, std::move(itemMetadata));
+    }
+    send(connection, XY_SINE_BATCH_RESPONSE, google::protobuf::Empty(), request,
+         {{kBatchCountKey, std::to_string(items.size())}});
+}
+
+int MockBedrockServer::computeSine(const palantir::XYSineRequest& request)
+{
+    // Same algorithm as XYSineDemo (and Bedrock)
+    const int samples = std::max(2, m_config.fixedSamples > 0 ? m_config.fixedSamples : request.samples());
+    const double frequency = request.frequency() != 0.0 ? request.frequency() : 1.0;
+    const double amplitude = request.amplitude() != 0.0 ? request.amplitude() : 1.0;
+    const std::string key = std::to_string(samples) + ':' + std::to_string(frequency) + ':'
+                            + std::to_string(amplitude) + ':' + std::to_string(request.phase());
+    if (key != m_sineKey) {
+        m_x.resize(samples);
+        m_y.resize(samples);
+        for (int i = 0; i < samples; ++i) {
+            const double t = static_cast<double>(i) / (samples - 1.0);
+            m_x[i] = t * 2.0 * M_PI;
+            m_y[i] = amplitude * std::sin(2.0 * M_PI * frequency * t + request.phase());
+        }
+        m_sineKey = key;
+    }
+    return samples;
+}
+
+void MockBedrockServer::answerError(Connection& connection, const palantir::MessageEnvelope& request,
+                                    palantir::ErrorCode errorCode, const std::string& message)
+{
+    palantir::ErrorResponse error;
+    error.set_error_code(errorCode);
+    error.set_message(message);
+    send(connection, palantir::MessageType::ERROR_RESPONSE, error, request);
+}
+
+void MockBedrockServer::send(Connection& connection, palantir::MessageType type,
+                             const google::protobuf::Message& message,
+                             const palantir::MessageEnvelope& request,
+                             std::map<std::string, std::string> metadata)
+{
+    auto correlation = request.metadata().find(kCorrelationIdKey);
+    if (correlation != request.metadata().end()) {
+        metadata[kCorrelationIdKey] = correlation->second;
+    }
+
+    // Answer in the version of the request; the payload layout is v1 either way
+    QString error;
+    if (!encodeFrame(type, message, metadata, connection.frame, &error, request.version())) {
+        qWarning() << "MockBedrockServer: Failed to encode response:" << error;
+        return;
+    }
+    writeFrame(connection);
+}
+
+void MockBedrockServer::sendEnvelope(Connection& connection, const palantir::MessageEnvelope& envelope)
+{
+    const size_t bodySize = envelope.ByteSizeLong();
+    if (bodySize > MOCK_MAX_MESSAGE_SIZE) {
+        qWarning() << "MockBedrockServer: Envelope of" << bodySize << "bytes exceeds the frame limit";
+        return;
+    }
+    const uint32_t length = static_cast<uint32_t>(bodySize);
+    connection.frame.resize(FRAME_HEADER_SIZE + bodySize);
+    std::memcpy(connection.frame.data(), &length, FRAME_HEADER_SIZE);
+    auto* body = reinterpret_cast<uint8_t*>(connection.frame.data() + FRAME_HEADER_SIZE);
+    envelope.SerializeWithCachedSizesToArray(body);  // Sizes cached by ByteSizeLong()
+    writeFrame(connection);
+}
+
+void MockBedrockServer::writeFrame(Connection& connection)
+{
+    unsigned char tag[FRAME_MAC_BYTES];
+    if (connection.session) {
+        connection.session->send.sign(connection.frame.data(), connection.frame.size(), tag);
+    }
+    connection.socket->write(connection.frame.data(), static_cast<qint64>(connection.frame.size()));
+    if (connection.session) {
+        connection.socket->write(reinterpret_cast<const char*>(tag), sizeof(tag));
+    }
+}
+
+bool MockBedrockServer::injectError()
+{
+    if (m_config.errorEvery > 0 && m_sineRequests % static_cast<uint64_t>(m_config.errorEvery) == 0) {
+        return true;
+    }
+    if (m_config.errorRate > 0.0) {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < m_config.errorRate;
+    }
+    return false;
+}
+
+MockReply::MockReply(MockBedrockServer* server, std::weak_ptr<MockBedrockServer::Connection> connection,
+                     palantir::MessageEnvelope request)
+    : m_server(server)
+    , m_connection(std::move(connection))
+    , m_request(std::move(request))
+{
+}
+
+std::string MockReply::correlationId() const
+{
+    auto it = m_request.metadata().find(kCorrelationIdKey);
+    return it == m_request.metadata().end() ? std::string() : it->second;
+}
+
+void MockReply::send(palantir::MessageType type, const google::protobuf::Message& message,
+                     std::map<std::string, std::string> metadata) const
+{
+    if (auto connection = m_connection.lock()) {
+        m_server->send(*connection, type, message, m_request, std::move(metadata));
+    }
+}
+
+void MockReply::sendError(palantir::ErrorCode errorCode, const std::string& message) const
+{
+    if (auto connection = m_connection.lock()) {
+        m_server->answerError(*connection, m_request, errorCode, message);
+    }
+}
+
+void MockReply::sendEnvelope(const palantir::MessageEnvelope& envelope) const
+{
+    if (auto connection = m_connection.lock()) {
+        m_server->sendEnvelope(*connection, envelope);
+    }
+}
+
+MockServerThread::MockServerThread(MockServerConfig config)
+    : m_config(std::move(config))
+    , m_thread(nullptr)
+    , m_server(nullptr)
+{
+}
+
+MockServerThread::~MockServerThread()
+{
+    stop();
+}
+
+bool MockServerThread::start(const QString& name, QString* outError)
+{
+    if (m_thread) {
+        return true;
+    }
+    m_thread = new QThread();
+    m_thread->setObjectName(QStringLiteral("MockBedrock"));
+    m_thread->start();
+
+    // Hand the server to its thread, then listen there and wait for the outcome
+    bool ok = false;
+    QString error;
+    m_server = new MockBedrockServer(m_config);
+    m_server->moveToThread(m_thread);
+    QMetaObject::invokeMethod(m_server, [this, &name, &ok, &error]() {
+        ok = m_server->listen(name, &error);
+        if (ok) {
+            m_socketName = m_server->socketName();
+        }
+    }, Qt::BlockingQueuedConnection);
+
+    if (!ok) {
+        if (outError) {
+            *outError = error;
+        }
+        stop();
+    }
+    return ok;
+}
+
+void MockServerThread::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+    if (m_server) {
+        // Sockets must be torn down on the thread that owns them
+        QMetaObject::invokeMethod(m_server, [server = m_server]() { delete server; },
+                                  Qt::BlockingQueuedConnection);
+        m_server = nullptr;
+    }
+    m_thread->quit();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_socketName.clear();
+}
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,192 @@
+#pragma once
+
+#ifdef PHX_WITH_TRANSPORT_DEPS
+#include "transport/FrameCodec.hpp"
+#include "transport/SessionAuth.hpp"
+#include "palantir/envelope.pb.h"
+#include "palantir/error.pb.h"
+#include "palantir/xysine.pb.h"
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+class QLocalServer;
+class QLocalSocket;
+class QThread;
+
+namespace phoenix::transport {
+
+class MockReply;
+
+// Per-test answer hook: sees each request ahead of the built-in handling
+// (after the handshake, before responseDelayMs). Returns true once it has
+// dealt with the request (answered it, kept the reply for later, or chose
+// to stay silent); false falls through to the built-in answer.
+using MockRequestHook = std::function<bool(MockReply& reply)>;
+
+// Behaviour of a MockBedrockServer
+struct MockServerConfig {
+    std::string serverVersion = "mock-1.0";
+    std::vector<std::string> features = {"xy_sine"};
+
+    // Payload size: >0 answers every XY Sine request with this many samples
+    // instead of the requested count
+    int fixedSamples = 0;
+    // Added before every response (timers, so concurrent requests overlap)
+    int responseDelayMs = 0;
+    // Error injection: every Nth XY Sine request (0 = never) and/or a random
+    // fraction of them are answered with ERROR_RESPONSE (INTERNAL_ERROR)
+    int errorEvery = 0;
+    double errorRate = 0.0;
+    uint32_t seed = 1;  // For errorRate
+    // Set: answer AUTH_HELLO with this identity and refuse every other
+    // request until the connection is authenticated (see SessionAuth.hpp)
+    std::optional<IdentitySecretKey> identity;
+    // Set: consulted for every request first (see MockRequestHook)
+    MockRequestHook onRequest;
+};
+
+/**
+ * Local stand-in for Bedrock (tests and benchmarks).
+ *
+ * Speaks the length-prefixed envelope protocol on a QLocalServer: answers
+ * CAPABILITIES_REQUEST with the configured version and features and
+ * XY_SINE_REQUEST with a computed sine, echoing correlation IDs and the
+ * request's protocol version. Results are chunked when the request accepts
+ * chunks and exceeds its max_chunk_bytes; columns matching the base of a
+ * delta request are left out (whether or not kDeltaFeature is configured).
+ * XY_SINE_BATCH_REQUEST is answered item by item (whether or not
+ * kBatchFeature is configured); other message types get an
+ * UNKNOWN_MESSAGE_TYPE error. With an identity configured, AUTH_HELLO starts
+ * an authenticated session and nothing else is answered before it.
+ * Tests that need other answers install MockServerConfig::onRequest.
+ *
+ * Lives on the thread that creates it and needs that thread's event loop;
+ * use MockServerThread from code that blocks.
+ */
+class MockBedrockServer : public QObject {
+public:
+    explicit MockBedrockServer(MockServerConfig config = {}, QObject* parent = nullptr);
+    ~MockBedrockServer() override;
+
+    /**
+     * Start listening.
+     *
+     * @param name Socket name; empty picks a unique one
+     * @return false if the socket cannot be created (outError says why)
+     */
+    bool listen(const QString& name = QString(), QString* outError = nullptr);
+    void close();
+    // Drop every client but keep listening (a server restart, as seen by clients)
+    void disconnectClients();
+    QString socketName() const { return m_socketName; }
+
+    // Counters (readable from any thread)
+    uint64_t requestsReceived() const { return m_requestsReceived.load(); }
+    uint64_t errorsInjected() const { return m_errorsInjected.load(); }
+    uint64_t batchItemsReceived() const { return m_batchItems.load(); }
+    // Columns left out of XY Sine responses because the client held them
+    uint64_t columnsReused() const { return m_columnsReused.load(); }
+
+private:
+    friend class MockReply;
+    struct Connection;
+
+    void onNewConnection();
+    void onReadyRead(const std::shared_ptr<Connection>& connection);
+    void handleRequest(const std::shared_ptr<Connection>& connection, const palantir::MessageEnvelope& request);
+    void answerHandshake(Connection& connection, const palantir::MessageEnvelope& request);
+    void answerCapabilities(Connection& connection, const palantir::MessageEnvelope& request);
+    void answerXYSine(Connection& connection, const palantir::MessageEnvelope& request);
+    void answerXYSineBatch(Connection& connection, const palantir::MessageEnvelope& request);
+    // Fill m_x/m_y for request (cached while the parameters repeat); returns the sample count
+    int computeSine(const palantir::XYSineRequest& request);
+    void answerError(Connection& connection, const palantir::MessageEnvelope& request,
+                     palantir::ErrorCode errorCode, const std::string& message);
+    void send(Connection& connection, palantir::MessageType type, const google::protobuf::Message& message,
+              const palantir::MessageEnvelope& request, std::map<std::string, std::string> metadata = {});
+    // Send a prebuilt envelope unchanged
+    void sendEnvelope(Connection& connection, const palantir::MessageEnvelope& envelope);
+    // Write connection.frame, tagged once the connection is authenticated
+    void writeFrame(Connection& connection);
+    bool injectError();
+
+    MockServerConfig m_config;
+    QLocalServer* m_server;
+    QString m_socketName;
+    std::vector<std::shared_ptr<Connection>> m_connections;
+    std::mt19937 m_random;
+    std::atomic<uint64_t> m_requestsReceived;
+    std::atomic<uint64_t> m_errorsInjected;
+    std::atomic<uint64_t> m_batchItems;
+    std::atomic<uint64_t> m_columnsReused;
+    uint64_t m_sineRequests = 0;
+
+    // Last computed sine, reused while the parameters repeat (benchmarks
+    // measure the transport, not std::sin)
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::string m_sineKey;
+};
+
+// One request as seen by a MockRequestHook, and the way to answer it.
+// Copies may be kept to answer later (e.g. from a timer) on the server's
+// thread; once the client is gone, sending does nothing.
+class MockReply {
+public:
+    const palantir::MessageEnvelope& request() const { return m_request; }
+    // Correlation ID of the request (empty if it carried none)
+    std::string correlationId() const;
+    bool isConnected() const { return !m_connection.expired(); }
+
+    // Send message in the request's protocol version, with its correlation ID
+    void send(palantir::MessageType type, const google::protobuf::Message& message,
+              std::map<std::string, std::string> metadata = {}) const;
+    void sendError(palantir::ErrorCode errorCode, const std::string& message) const;
+    // Send a prebuilt envelope as-is (compressed or packed payloads, progress
+    // updates); its metadata must carry the correlation ID itself
+    void sendEnvelope(const palantir::MessageEnvelope& envelope) const;
+
+private:
+    friend class MockBedrockServer;
+    MockReply(MockBedrockServer* server, std::weak_ptr<MockBedrockServer::Connection> connection,
+              palantir::MessageEnvelope request);
+
+    MockBedrockServer* m_server;
+    std::weak_ptr<MockBedrockServer::Connection> m_connection;
+    palantir::MessageEnvelope m_request;
+};
+
+// Runs a MockBedrockServer on a thread of its own, for in-process use by
+// code that blocks (benchmarks, synchronous clients)
+class MockServerThread {
+public:
+    explicit MockServerThread(MockServerConfig config = {});
+    ~MockServerThread();
+
+    MockServerThread(const MockServerThread&) = delete;
+    MockServerThread& operator=(const MockServerThread&) = delete;
+
+    bool start(const QString& name = QString(), QString* outError = nullptr);
+    void stop();
+    QString socketName() const { return m_socketName; }
+    const MockBedrockServer* server() const { return m_server; }
+
+private:
+    MockServerConfig m_config;
+    QThread* m_thread;
+    MockBedrockServer* m_server;  // Lives on m_thread
+    QString m_socketName;
+};
+
+} // namespace phoenix::transport
+
+#endif // PHX_WITH_TRANSPORT_DEPS
@@ -0,0 +1,73 @@
+// palantir_mock_server: stand-alone stand-in for Bedrock
+//
+// Listens on a local socket and answers like MockBedrockServer (see
+// MockBedrockServer.hpp). Prints "LISTENING <socket name>" on stdout once
+// ready, so a parent process (e.g. transport_bench --spawn) can connect.
+
+#include "MockBedrockServer.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("palantir_mock_server"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Local Bedrock stand-in speaking the Palantir envelope protocol"));
+    parser.addHelpOption();
+    QCommandLineOption socketOption(QStringLiteral("socket"),
+        QStringLiteral("Socket name (default: unique name)"), QStringLiteral("name"));
+    QCommandLineOption samplesOption(QStringLiteral("samples"),
+        QStringLiteral("Answer every XY Sine request with this many samples"), QStringLiteral("n"), QStringLiteral("0"));
+    QCommandLineOption delayOption(QStringLiteral("delay-ms"),
+        QStringLiteral("Delay before every response"), QStringLiteral("ms"), QStringLiteral("0"));
+    QCommandLineOption errorEveryOption(QStringLiteral("error-every"),
+        QStringLiteral("Fail every Nth XY Sine request"), QStringLiteral("n"), QStringLiteral("0"));
+    QCommandLineOption errorRateOption(QStringLiteral("error-rate"),
+        QStringLiteral("Fail this fraction of XY Sine requests"), QStringLiteral("fraction"), QStringLiteral("0"));
+    QCommandLineOption featuresOption(QStringLiteral("features"),
+        QStringLiteral("Comma-separated capability features"), QStringLiteral("list"), QStringLiteral("xy_sine"));
+    QCommandLineOption versionOption(QStringLiteral("server-version"),
+        QStringLiteral("Version reported in capabilities"), QStringLiteral("version"), QStringLiteral("mock-1.0"));
+    QCommandLineOption seedOption(QStringLiteral("seed"),
+        QStringLiteral("Seed for --error-rate"), QStringLiteral("n"), QStringLiteral("1"));
+    QCommandLineOption identityOption(QStringLiteral("identity-key"),
+        QStringLiteral("Require authenticated sessions, proving this Ed25519 secret key"), QStringLiteral("hex"));
+    parser.addOptions({socketOption, samplesOption, delayOption, errorEveryOption, errorRateOption, featuresOption,
+                       versionOption, seedOption, identityOption});
+    parser.process(app);
+
+    phoenix::transport::MockServerConfig config;
+    config.serverVersion = parser.value(versionOption).toStdString();
+    config.seed = parser.value(seedOption).toUInt();
+    config.fixedSamples = parser.value(samplesOption).toInt();
+    config.responseDelayMs = parser.value(delayOption).toInt();
+    config.errorEvery = parser.value(errorEveryOption).toInt();
+    config.errorRate = parser.value(errorRateOption).toDouble();
+    config.features.clear();
+    for (const QString& feature : parser.value(featuresOption).split(',', Qt::SkipEmptyParts)) {
+        config.features.push_back(feature.trimmed().toStdString());
+    }
+
+    QString error;
+    if (parser.isSet(identityOption)) {
+        phoenix::transport::IdentitySecretKey identity;
+        if (!phoenix::transport::keyFromHex(parser.value(identityOption).toStdString(), identity.data(),
+                                            identity.size(), &error)) {
+            QTextStream(stderr) << "--identity-key: " << error << Qt::endl;
+            return 1;
+        }
+        config.identity = identity;
+    }
+
+    phoenix::transport::MockBedrockServer server(config);
+    if (!server.listen(parser.value(socketOption), &error)) {
+        QTextStream(stderr) << error << Qt::endl;
+        return 1;
+    }
+
+    QTextStream(stdout) << "LISTENING " << server.socketName() << Qt::endl;
+    return app.exec();
+}
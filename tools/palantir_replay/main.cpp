@@ -0,0 +1,577 @@
+// palantir_replay: replays a recorded IPC trace (see TrafficTrace.hpp)
+//
+// Modes:
+//   decode   Offline: parse, re-serialize and dispatch every recorded
+//            envelope (--iterations times) and report the cost per envelope.
+//            Deterministic; compare the numbers between builds.
+//   client   Drives Phoenix's client path: the recorded requests go through
+//            a LocalSocketChannel to an in-process server that answers with
+//            the recorded responses.
+//   bedrock  Sends the recorded request frames verbatim to a running
+//            endpoint (--socket) and times its responses.
+//
+// client and bedrock replay at recorded speed (scaled by --speed) or, with
+// --fast, as fast as possible. Shared-memory bulk responses cannot be
+// replayed in client mode (their regions are gone).
+
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "transport/FrameCodec.hpp"
+#include "transport/MessageDispatcher.hpp"
+#include "transport/TrafficTrace.hpp"
+#include "palantir/capabilities.pb.h"
+#include "palantir/xysine.pb.h"
+#include <google/protobuf/empty.pb.h>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTextStream>
+#include <QTimer>
+#include <QUuid>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace phoenix::transport;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+static constexpr uint32_t REPLAY_MAX_FRAME_SIZE = 64 * 1024 * 1024;
+
+std::optional<uint64_t> viewCorrelationId(const EnvelopeView& view)
+{
+    const auto value = view.metadataValue(kCorrelationIdKey);
+    if (!value.has_value() || value->empty()) {
+        return std::nullopt;
+    }
+    return std::strtoull(std::string(*value).c_str(), nullptr, 10);
+}
+
+// Last envelope of a response: not a progress update, not an inner chunk
+bool isFinalResponse(const EnvelopeView& view)
+{
+    if (view.type == PROGRESS_UPDATE) {
+        return false;
+    }
+    const auto index = view.metadataValue(kChunkIndexKey);
+    const auto count = view.metadataValue(kChunkCountKey);
+    if (!index.has_value() || !count.has_value()) {
+        return true;
+    }
+    return std::strtoull(std::string(*index).c_str(), nullptr, 10) + 1
+           >= std::strtoull(std::string(*count).c_str(), nullptr, 10);
+}
+
+std::string frameOf(const std::string& envelope)
+{
+    std::string frame(FRAME_HEADER_SIZE, '\0');
+    const uint32_t length = static_cast<uint32_t>(envelope.size());
+    for (size_t i = 0; i < FRAME_HEADER_SIZE; ++i) {
+        frame[i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+    return frame + envelope;
+}
+
+// A recorded request and what the trace says about it
+struct ReplayRequest {
+    uint64_t recordedId = 0;
+    uint64_t sentNs = 0;
+    uint64_t recordedLatencyNs = 0;           // 0 if the trace has no final response
+    const TraceRecord* request = nullptr;
+    std::vector<const TraceRecord*> responses;  // In recorded order
+};
+
+// Requests of the trace in send order (CANCEL_REQUEST frames excluded)
+std::vector<ReplayRequest> collectRequests(const std::vector<TraceRecord>& records)
+{
+    std::vector<ReplayRequest> requests;
+    std::map<uint64_t, size_t> byId;
+    EnvelopeView view;
+    for (const TraceRecord& record : records) {
+        if (!decodeEnvelopeView(record.envelope.data(), record.envelope.size(), view)) {
+            continue;
+        }
+        const auto id = viewCorrelationId(view);
+        if (!id.has_value()) {
+            continue;
+        }
+        if (record.direction == TraceDirection::Sent) {
+            if (view.type != CANCEL_REQUEST) {
+                byId[*id] = requests.size();
+                requests.push_back(ReplayRequest{*id, record.timestampNs, 0, &record, {}});
+            }
+            continue;
+        }
+        auto it = byId.find(*id);
+        if (it == byId.end()) {
+            continue;
+        }
+        ReplayRequest& request = requests[it->second];
+        request.responses.push_back(&record);
+        if (isFinalResponse(view)) {
+            request.recordedLatencyNs = record.timestampNs - request.sentNs;
+        }
+    }
+    return requests;
+}
+
+QJsonObject latencyJson(std::vector<double> latenciesUs)
+{
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+    auto rank = [&latenciesUs](double p) {
+        if (latenciesUs.empty()) {
+            return 0.0;
+        }
+        const size_t index = static_cast<size_t>(std::ceil(p * static_cast<double>(latenciesUs.size())));
+        return latenciesUs[std::min(std::max<size_t>(index, 1), latenciesUs.size()) - 1];
+    };
+    QJsonObject object;
+    object["p50"] = rank(0.50);
+    object["p99"] = rank(0.99);
+    object["max"] = latenciesUs.empty() ? 0.0 : latenciesUs.back();
+    return object;
+}
+
+// ---- decode ----------------------------------------------------------------
+
+QJsonObject runDecode(const std::vector<TraceRecord>& records, int iterations)
+{
+    MessageDispatcher dispatcher;
+    uint64_t handled = 0;
+    dispatcher.setFallbackHandler([&handled](const palantir::MessageEnvelope&) { ++handled; });
+
+    std::vector<palantir::MessageEnvelope> envelopes(records.size());
+    std::string scratch;
+    uint64_t bytes = 0;
+    Clock::duration parse{}, serialize{}, dispatch{};
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < records.size(); ++i) {
+            parseEnvelope(records[i].envelope.data(), records[i].envelope.size(), envelopes[i]);
+        }
+        parse += Clock::now() - start;
+
+        start = Clock::now();
+        for (const auto& envelope : envelopes) {
+            envelope.SerializeToString(&scratch);
+            bytes += scratch.size();
+        }
+        serialize += Clock::now() - start;
+
+        start = Clock::now();
+        for (const auto& envelope : envelopes) {
+            dispatcher.dispatch(envelope);
+        }
+        dispatch += Clock::now() - start;
+    }
+
+    const double count = std::max<double>(1.0, static_cast<double>(records.size()) * iterations);
+    auto perEnvelope = [count](Clock::duration total) {
+        return std::chrono::duration<double, std::nano>(total).count() / count;
+    };
+    QJsonObject object;
+    object["envelopes"] = static_cast<double>(records.size());
+    object["iterations"] = iterations;
+    object["serialized_bytes"] = static_cast<double>(bytes / std::max(iterations, 1));
+    object["parse_ns_per_envelope"] = perEnvelope(parse);
+    object["serialize_ns_per_envelope"] = perEnvelope(serialize);
+    object["dispatch_ns_per_envelope"] = perEnvelope(dispatch);
+    return object;
+}
+
+// ---- client ----------------------------------------------------------------
+
+// Answers the k-th request with the recorded responses of the k-th recorded
+// request. Frames are prepared up front with correlation ID k (what a fresh
+// channel assigns), so answering costs no parsing.
+class ReplayServer : public QObject {
+public:
+    ReplayServer(const std::vector<ReplayRequest>& requests, double speed, bool fast)
+        : m_speed(speed)
+        , m_fast(fast)
+        , m_decoder(REPLAY_MAX_FRAME_SIZE)
+    {
+        for (size_t k = 0; k < requests.size(); ++k) {
+            Answer answer;
+            for (const TraceRecord* record : requests[k].responses) {
+                palantir::MessageEnvelope envelope;
+                envelope.ParseFromString(record->envelope);  // Raw: keep payload encoding
+                setCorrelationId(envelope, k + 1);
+                answer.frames.push_back(frameOf(envelope.SerializeAsString()));
+                answer.delaysNs.push_back(record->timestampNs - requests[k].sentNs);
+            }
+            m_answers.emplace(k + 1, std::move(answer));
+        }
+
+        m_name = QStringLiteral("palantir_replay_%1").arg(QUuid::createUuid().toString(QUuid::Id128));
+        m_server.listen(m_name);
+        QObject::connect(&m_server, &QLocalServer::newConnection, this, [this]() {
+            m_socket = m_server.nextPendingConnection();
+            QObject::connect(m_socket, &QLocalSocket::readyRead, this, [this]() { onReadyRead(); });
+        });
+    }
+
+    QString name() const { return m_name; }
+
+private:
+    struct Answer {
+        std::vector<std::string> frames;
+        std::vector<uint64_t> delaysNs;
+    };
+
+    void onReadyRead()
+    {
+        RingBuffer& buffer = m_decoder.buffer();
+        const QByteArray bytes = m_socket->readAll();
+        std::copy(bytes.begin(), bytes.end(), buffer.prepareWrite(static_cast<size_t>(bytes.size())));
+        buffer.commitWrite(static_cast<size_t>(bytes.size()));
+
+        const char* body = nullptr;
+        uint32_t length = 0;
+        while (m_decoder.nextFrame(&body, &length) == FrameDecoder::Status::FrameReady) {
+            EnvelopeView view;
+            if (decodeEnvelopeView(body, length, view)) {
+                if (const auto id = viewCorrelationId(view)) {
+                    answer(*id);
+                }
+            }
+            m_decoder.consumeFrame(length);
+        }
+    }
+
+    void answer(uint64_t id)
+    {
+        auto it = m_answers.find(id);
+        if (it == m_answers.end()) {
+            return;
+        }
+        const Answer& answer = it->second;
+        for (size_t i = 0; i < answer.frames.size(); ++i) {
+            const std::string* frame = &answer.frames[i];
+            const int delayMs = m_fast ? 0 : static_cast<int>(answer.delaysNs[i] / 1e6 / m_speed);
+            if (delayMs == 0) {
+                m_socket->write(frame->data(), static_cast<qint64>(frame->size()));
+                continue;
+            }
+            QTimer::singleShot(delayMs, this, [this, frame]() {
+                m_socket->write(frame->data(), static_cast<qint64>(frame->size()));
+            });
+        }
+    }
+
+    double m_speed;
+    bool m_fast;
+    QLocalServer m_server;
+    QLocalSocket* m_socket = nullptr;
+    QString m_name;
+    FrameDecoder m_decoder;
+    std::map<uint64_t, Answer> m_answers;
+};
+
+// Inner message of a recorded request, typed where Phoenix has the type
+// (so re-serializing costs what it did); unknown types keep their bytes as
+// unknown fields of an Empty
+std::unique_ptr<google::protobuf::Message> requestMessage(const palantir::MessageEnvelope& envelope)
+{
+    std::unique_ptr<google::protobuf::Message> message;
+    switch (envelope.type()) {
+        case palantir::MessageType::CAPABILITIES_REQUEST:
+            message = std::make_unique<palantir::CapabilitiesRequest>();
+            break;
+        case palantir::MessageType::XY_SINE_REQUEST:
+            message = std::make_unique<palantir::XYSineRequest>();
+            break;
+        default:
+            message = std::make_unique<google::protobuf::Empty>();
+            break;
+    }
+    message->ParseFromString(envelope.payload());
+    return message;
+}
+
+QJsonObject runClient(QCoreApplication& app, const std::vector<ReplayRequest>& requests, double speed, bool fast,
+                      int timeoutMs, QString* outError)
+{
+    // Declared before the channel: reply callbacks use them until it is gone
+    std::mutex mutex;
+    std::vector<double> latenciesUs;
+    int failures = 0;
+    int completed = 0;
+
+    ReplayServer server(requests, speed, fast);
+    LocalSocketChannel channel(server.name());
+    if (!channel.connect()) {
+        *outError = QStringLiteral("Replay channel failed to connect");
+        return {};
+    }
+
+    const uint64_t firstNs = requests.empty() ? 0 : requests.front().sentNs;
+    for (const ReplayRequest& request : requests) {
+        const int delayMs = fast ? 0 : static_cast<int>((request.sentNs - firstNs) / 1e6 / speed);
+        QTimer::singleShot(delayMs, &app, [&, record = request.request]() {
+            palantir::MessageEnvelope envelope;
+            envelope.ParseFromString(record->envelope);
+            std::map<std::string, std::string> metadata(envelope.metadata().begin(), envelope.metadata().end());
+            metadata.erase(kCorrelationIdKey);
+            channel.setProtocolVersion(envelope.version());
+
+            const auto start = Clock::now();
+            auto onReply = [&, start](LocalSocketChannel::Reply reply) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (reply.envelope.has_value()) {
+                    latenciesUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                } else {
+                    ++failures;
+                }
+                if (++completed == static_cast<int>(requests.size())) {
+                    QMetaObject::invokeMethod(&app, &QCoreApplication::quit, Qt::QueuedConnection);
+                }
+            };
+            const auto message = requestMessage(envelope);
+            if (metadata.count(kAcceptChunkedKey) || metadata.count(kAcceptProgressKey)) {
+                LocalSocketChannel::ProgressCallback onProgress;
+                if (metadata.count(kAcceptProgressKey)) {
+                    onProgress = [](double) {};
+                }
+                channel.sendStreamingRequest(envelope.type(), *message, [](const palantir::MessageEnvelope&) {},
+                                             onReply, metadata, timeoutMs, onProgress);
+            } else {
+                channel.sendRequest(envelope.type(), *message, onReply, metadata, timeoutMs);
+            }
+        });
+    }
+
+    const auto start = Clock::now();
+    if (!requests.empty()) {
+        app.exec();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    QJsonObject object;
+    object["requests"] = static_cast<int>(requests.size());
+    object["failed"] = failures;
+    object["seconds"] = seconds;
+    object["latency_us"] = latencyJson(latenciesUs);
+    return object;
+}
+
+// ---- bedrock ---------------------------------------------------------------
+
+QJsonObject runBedrock(QCoreApplication& app, const std::vector<TraceRecord>& records, const QString& socketName,
+                       double speed, bool fast, int timeoutMs, QString* outError)
+{
+    QLocalSocket socket;
+    socket.connectToServer(socketName);
+    if (!socket.waitForConnected(3000)) {
+        *outError = QString("Cannot connect to %1: %2").arg(socketName, socket.errorString());
+        return {};
+    }
+
+    std::map<uint64_t, Clock::time_point> sentAt;
+    std::vector<double> latenciesUs;
+    int errors = 0;
+    int outstanding = 0;
+    EnvelopeView view;
+    std::vector<std::pair<uint64_t, const TraceRecord*>> sends;
+    for (const TraceRecord& record : records) {
+        if (record.direction != TraceDirection::Sent
+            || !decodeEnvelopeView(record.envelope.data(), record.envelope.size(), view)) {
+            continue;
+        }
+        sends.emplace_back(record.timestampNs, &record);
+        if (view.type != CANCEL_REQUEST) {
+            ++outstanding;
+        }
+    }
+
+    FrameDecoder decoder(REPLAY_MAX_FRAME_SIZE);
+    QObject::connect(&socket, &QLocalSocket::readyRead, &app, [&]() {
+        const QByteArray bytes = socket.readAll();
+        RingBuffer& buffer = decoder.buffer();
+        std::copy(bytes.begin(), bytes.end(), buffer.prepareWrite(static_cast<size_t>(bytes.size())));
+        buffer.commitWrite(static_cast<size_t>(bytes.size()));
+
+        const char* body = nullptr;
+        uint32_t length = 0;
+        EnvelopeView response;
+        while (decoder.nextFrame(&body, &length) == FrameDecoder::Status::FrameReady) {
+            if (decodeEnvelopeView(body, length, response) && isFinalResponse(response)) {
+                const auto id = viewCorrelationId(response);
+                auto it = id.has_value() ? sentAt.find(*id) : sentAt.end();
+                if (it != sentAt.end()) {
+                    latenciesUs.push_back(
+                        std::chrono::duration<double, std::micro>(Clock::now() - it->second).count());
+                    errors += response.type == palantir::MessageType::ERROR_RESPONSE ? 1 : 0;
+                    sentAt.erase(it);
+                    if (--outstanding == 0) {
+                        app.quit();
+                    }
+                }
+            }
+            decoder.consumeFrame(length);
+        }
+    });
+
+    const uint64_t firstNs = sends.empty() ? 0 : sends.front().first;
+    int lastDelayMs = 0;
+    for (const auto& send : sends) {
+        const int delayMs = fast ? 0 : static_cast<int>((send.first - firstNs) / 1e6 / speed);
+        lastDelayMs = std::max(lastDelayMs, delayMs);
+        QTimer::singleShot(delayMs, &app, [&, record = send.second]() {
+            EnvelopeView request;
+            decodeEnvelopeView(record->envelope.data(), record->envelope.size(), request);
+            if (request.type != CANCEL_REQUEST) {
+                if (const auto id = viewCorrelationId(request)) {
+                    sentAt[*id] = Clock::now();
+                }
+            }
+            const std::string frame = frameOf(record->envelope);
+            socket.write(frame.data(), static_cast<qint64>(frame.size()));
+        });
+    }
+
+    // Give up on whatever is still unanswered timeoutMs after the last send
+    QTimer::singleShot(lastDelayMs + timeoutMs, &app, &QCoreApplication::quit);
+    const auto start = Clock::now();
+    if (outstanding > 0) {
+        app.exec();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    QJsonObject object;
+    object["requests"] = static_cast<int>(latenciesUs.size()) + outstanding;
+    object["unanswered"] = outstanding;
+    object["error_responses"] = errors;
+    object["seconds"] = seconds;
+    object["latency_us"] = latencyJson(latenciesUs);
+    return object;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("palantir_replay"));
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replay a recorded Palantir IPC trace"));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("trace"), QStringLiteral("Trace file to replay"));
+    QCommandLineOption modeOption(QStringLiteral("mode"),
+        QStringLiteral("decode, client or bedrock"), QStringLiteral("mode"), QStringLiteral("decode"));
+    QCommandLineOption socketOption(QStringLiteral("socket"),
+        QStringLiteral("Endpoint for --mode bedrock"), QStringLiteral("name"), QStringLiteral("palantir_bedrock"));
+    QCommandLineOption fastOption(QStringLiteral("fast"), QStringLiteral("Ignore recorded timing"));
+    QCommandLineOption speedOption(QStringLiteral("speed"),
+        QStringLiteral("Replay speed factor (recorded timing)"), QStringLiteral("factor"), QStringLiteral("1"));
+    QCommandLineOption iterationsOption(QStringLiteral("iterations"),
+        QStringLiteral("Passes over the trace (--mode decode)"), QStringLiteral("n"), QStringLiteral("10"));
+    QCommandLineOption timeoutOption(QStringLiteral("timeout-ms"),
+        QStringLiteral("Per-request timeout"), QStringLiteral("ms"), QStringLiteral("30000"));
+    QCommandLineOption jsonOption(QStringLiteral("json"),
+        QStringLiteral("Write the report as JSON to file ('-' for stdout)"), QStringLiteral("file"));
+    parser.addOptions({modeOption, socketOption, fastOption, speedOption, iterationsOption, timeoutOption,
+                       jsonOption});
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(2);
+    }
+    const QString tracePath = parser.positionalArguments().front();
+    const QString mode = parser.value(modeOption);
+    const bool fast = parser.isSet(fastOption);
+    const double speed = std::max(parser.value(speedOption).toDouble(), 1e-3);
+    const int timeoutMs = std::max(parser.value(timeoutOption).toInt(), 1);
+
+    // Load the whole trace: replay must not read the disk while timing
+    TraceReader reader;
+    QString error;
+    if (!reader.open(tracePath, &error)) {
+        err << "palantir_replay: " << error << Qt::endl;
+        return 1;
+    }
+    std::vector<TraceRecord> records;
+    TraceRecord record;
+    while (reader.next(record, &error)) {
+        records.push_back(std::move(record));
+    }
+    if (!error.isEmpty()) {
+        err << "palantir_replay: " << error << " (replaying " << records.size() << " complete records)" << Qt::endl;
+        error.clear();
+    }
+
+    QJsonObject report;
+    if (mode == QStringLiteral("decode")) {
+        report = runDecode(records, std::max(parser.value(iterationsOption).toInt(), 1));
+    } else if (mode == QStringLiteral("client")) {
+        const std::vector<ReplayRequest> requests = collectRequests(records);
+        report = runClient(app, requests, speed, fast, timeoutMs, &error);
+        std::vector<double> recorded;
+        for (const ReplayRequest& request : requests) {
+            if (request.recordedLatencyNs > 0) {
+                recorded.push_back(request.recordedLatencyNs / 1e3);
+            }
+        }
+        report["recorded_latency_us"] = latencyJson(recorded);
+    } else if (mode == QStringLiteral("bedrock")) {
+        report = runBedrock(app, records, parser.value(socketOption), speed, fast, timeoutMs, &error);
+        std::vector<double> recorded;
+        for (const ReplayRequest& request : collectRequests(records)) {
+            if (request.recordedLatencyNs > 0) {
+                recorded.push_back(request.recordedLatencyNs / 1e3);
+            }
+        }
+        report["recorded_latency_us"] = latencyJson(recorded);
+    } else {
+        err << "palantir_replay: Unknown mode " << mode << Qt::endl;
+        return 2;
+    }
+    if (!error.isEmpty()) {
+        err << "palantir_replay: " << error << Qt::endl;
+        return 1;
+    }
+    report["mode"] = mode;
+    report["trace"] = tracePath;
+    report["records"] = static_cast<double>(records.size());
+    if (mode != QStringLiteral("decode")) {
+        report["speed"] = fast ? 0.0 : speed;  // 0 = as fast as possible
+    }
+
+    const QString jsonPath = parser.value(jsonOption);
+    QTextStream& text = jsonPath == QStringLiteral("-") ? err : out;
+    for (auto it = report.begin(); it != report.end(); ++it) {
+        text << it.key() << ": "
+             << (it.value().isObject() ? QJsonDocument(it.value().toObject()).toJson(QJsonDocument::Compact)
+                                       : it.value().toVariant().toString().toUtf8())
+             << "\n";
+    }
+    text.flush();
+
+    if (!jsonPath.isEmpty()) {
+        const QByteArray bytes = QJsonDocument(report).toJson(QJsonDocument::Indented);
+        if (jsonPath == QStringLiteral("-")) {
+            out << bytes;
+        } else {
+            QFile file(jsonPath);
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(bytes) != bytes.size()) {
+                err << "palantir_replay: Cannot write " << jsonPath << Qt::endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
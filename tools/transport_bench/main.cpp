@@ -0,0 +1,455 @@
+// transport_bench: round-trip latency and throughput of the Palantir transport
+//
+// Drives LocalSocketChannel (or, with --backend epoll, EpollChannel) against
+// a MockBedrockServer (in-process by default, or a spawned/running
+// palantir_mock_server) with XY Sine requests across payload sizes and
+// concurrency levels (requests in flight on one connection). Reports p50/p99/p999 latency and MB/s as a table and,
+// with --json, as a machine-readable document. --auth runs the same levels
+// over an authenticated session and adds the cost of the frame MAC alone.
+
+#include "MockBedrockServer.hpp"
+#include "transport/LocalSocketChannel.hpp"
+#include "transport/EpollChannel.hpp"
+#include "transport/EnvelopeHelpers.hpp"
+#include "palantir/xysine.pb.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTextStream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace phoenix::transport;
+
+namespace {
+
+struct RunResult {
+    int samples = 0;
+    int concurrency = 0;
+    int requests = 0;
+    int errors = 0;
+    uint64_t payloadBytes = 0;  // Per successful request (last one seen)
+    uint64_t totalBytes = 0;
+    double seconds = 0.0;
+    std::vector<double> latenciesUs;  // Successful requests only, sorted
+};
+
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+struct Outcome {
+    bool ok = false;
+    uint64_t bytes = 0;
+    double latencyUs = 0.0;
+};
+
+// One XY Sine round trip; payload bytes of every chunk are counted
+Outcome roundTrip(LocalSocketChannel& channel, int samples)
+{
+    palantir::XYSineRequest request;
+    request.set_samples(samples);
+    request.set_frequency(1.0);
+    request.set_amplitude(1.0);
+
+    auto bytes = std::make_shared<std::atomic<uint64_t>>(0);
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto done = promise->get_future();
+
+    const auto start = std::chrono::steady_clock::now();
+    channel.sendStreamingRequest(
+        palantir::MessageType::XY_SINE_REQUEST, request,
+        [bytes](const palantir::MessageEnvelope& chunk) { bytes->fetch_add(chunk.payload().size()); },
+        [bytes, promise](LocalSocketChannel::Reply reply) {
+            const bool ok = reply.envelope.has_value()
+                            && reply.envelope->type() == palantir::MessageType::XY_SINE_RESPONSE;
+            if (ok) {
+                bytes->fetch_add(reply.envelope->payload().size());
+            }
+            promise->set_value(ok);
+        });
+    Outcome outcome;
+    outcome.ok = done.get();
+    outcome.latencyUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    outcome.bytes = bytes->load();
+    return outcome;
+}
+
+#ifdef __linux__
+// Same round trip on the epoll backend
+Outcome roundTrip(EpollChannel& channel, int samples)
+{
+    palantir::XYSineRequest request;
+    request.set_samples(samples);
+    request.set_frequency(1.0);
+    request.set_amplitude(1.0);
+
+    auto bytes = std::make_shared<std::atomic<uint64_t>>(0);
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto done = promise->get_future();
+
+    const auto start = std::chrono::steady_clock::now();
+    channel.sendRequest(
+        palantir::MessageType::XY_SINE_REQUEST, request,
+        [bytes, promise](EpollChannel::Reply reply) {
+            const bool ok = reply.envelope.has_value()
+                            && reply.envelope->type() == palantir::MessageType::XY_SINE_RESPONSE;
+            if (ok) {
+                bytes->fetch_add(reply.envelope->payload().size());
+            }
+            promise->set_value(ok);
+        },
+        [bytes](const palantir::MessageEnvelope& chunk) { bytes->fetch_add(chunk.payload().size()); });
+    Outcome outcome;
+    outcome.ok = done.get();
+    outcome.latencyUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    outcome.bytes = bytes->load();
+    return outcome;
+}
+#endif
+
+template <typename Channel>
+RunResult runLevel(Channel& channel, int samples, int concurrency, int requests, int warmup)
+{
+    for (int i = 0; i < warmup; ++i) {
+        roundTrip(channel, samples);
+    }
+
+    RunResult result;
+    result.samples = samples;
+    result.concurrency = concurrency;
+    result.requests = requests;
+
+    // Each worker keeps one request in flight; together they keep
+    // `concurrency` requests outstanding on the connection
+    std::atomic<int> next{0};
+    std::vector<std::vector<Outcome>> perWorker(concurrency);
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int w = 0; w < concurrency; ++w) {
+        workers.emplace_back([&, w]() {
+            while (next.fetch_add(1) < requests) {
+                perWorker[w].push_back(roundTrip(channel, samples));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const auto& outcomes : perWorker) {
+        for (const Outcome& outcome : outcomes) {
+            if (!outcome.ok) {
+                ++result.errors;
+                continue;
+            }
+            result.latenciesUs.push_back(outcome.latencyUs);
+            result.totalBytes += outcome.bytes;
+            result.payloadBytes = outcome.bytes;
+        }
+    }
+    std::sort(result.latenciesUs.begin(), result.latenciesUs.end());
+    return result;
+}
+
+QJsonObject toJson(const RunResult& result)
+{
+    const auto& latencies = result.latenciesUs;
+    const double mean = latencies.empty()
+        ? 0.0
+        : std::accumulate(latencies.begin(), latencies.end(), 0.0) / static_cast<double>(latencies.size());
+
+    QJsonObject latency;
+    latency["min"] = latencies.empty() ? 0.0 : latencies.front();
+    latency["mean"] = mean;
+    latency["p50"] = percentile(latencies, 0.50);
+    latency["p99"] = percentile(latencies, 0.99);
+    latency["p999"] = percentile(latencies, 0.999);
+    latency["max"] = latencies.empty() ? 0.0 : latencies.back();
+
+    QJsonObject object;
+    object["samples"] = result.samples;
+    object["payload_bytes"] = static_cast<double>(result.payloadBytes);
+    object["concurrency"] = result.concurrency;
+    object["requests"] = result.requests;
+    object["errors"] = result.errors;
+    object["seconds"] = result.seconds;
+    object["latency_us"] = latency;
+    object["throughput_mbps"] = result.seconds > 0.0 ? result.totalBytes / result.seconds / 1e6 : 0.0;
+    object["requests_per_second"] = result.seconds > 0.0 ? latencies.size() / result.seconds : 0.0;
+    return object;
+}
+
+// Cost of tagging one frame of an authenticated session, without the socket
+QJsonObject measureFrameMac(int samples)
+{
+    // Same size as the repeated x/y payload of `samples` samples
+    const size_t envelopeBytes = static_cast<size_t>(samples) * 2 * sizeof(double);
+    std::string frame(FRAME_HEADER_SIZE + envelopeBytes, '\x5a');
+    const int iterations = static_cast<int>(std::clamp<size_t>((size_t(256) << 20) / envelopeBytes, 100, 100000));
+
+    SessionKey key;
+    key.fill(0x42);
+    FrameMac mac(key);
+    unsigned char tag[FRAME_MAC_BYTES];
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        mac.sign(frame.data(), frame.size(), tag);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    QJsonObject object;
+    object["samples"] = samples;
+    object["frame_bytes"] = static_cast<double>(frame.size() + FRAME_MAC_BYTES);
+    object["us_per_frame"] = seconds * 1e6 / iterations;
+    object["gbps"] = seconds > 0.0 ? static_cast<double>(envelopeBytes) * iterations / seconds / 1e9 : 0.0;
+    return object;
+}
+
+std::vector<int> parseIntList(const QString& text)
+{
+    std::vector<int> values;
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const int value = part.trimmed().toInt(&ok);
+        if (ok && value > 0) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("transport_bench"));
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Palantir transport latency/throughput benchmark"));
+    parser.addHelpOption();
+    QCommandLineOption socketOption(QStringLiteral("socket"),
+        QStringLiteral("Benchmark an already running server"), QStringLiteral("name"));
+    QCommandLineOption spawnOption(QStringLiteral("spawn"),
+        QStringLiteral("Start this palantir_mock_server binary as a subprocess"), QStringLiteral("path"));
+    QCommandLineOption sizesOption(QStringLiteral("sizes"),
+        QStringLiteral("Comma-separated sample counts"), QStringLiteral("list"),
+        QStringLiteral("1000,10000,100000,1000000"));
+    QCommandLineOption concurrencyOption(QStringLiteral("concurrency"),
+        QStringLiteral("Comma-separated in-flight request counts"), QStringLiteral("list"), QStringLiteral("1,4,16"));
+    QCommandLineOption requestsOption(QStringLiteral("requests"),
+        QStringLiteral("Measured requests per level"), QStringLiteral("n"), QStringLiteral("200"));
+    QCommandLineOption warmupOption(QStringLiteral("warmup"),
+        QStringLiteral("Unmeasured requests per level"), QStringLiteral("n"), QStringLiteral("10"));
+    QCommandLineOption delayOption(QStringLiteral("delay-ms"),
+        QStringLiteral("Server response delay (in-process/spawned server)"), QStringLiteral("ms"), QStringLiteral("0"));
+    QCommandLineOption errorRateOption(QStringLiteral("error-rate"),
+        QStringLiteral("Server error fraction (in-process/spawned server)"), QStringLiteral("fraction"),
+        QStringLiteral("0"));
+    QCommandLineOption backendOption(QStringLiteral("backend"),
+        QStringLiteral("Client transport: qt (LocalSocketChannel) or epoll (EpollChannel, Linux)"),
+        QStringLiteral("name"), QStringLiteral("qt"));
+    QCommandLineOption authOption(QStringLiteral("auth"),
+        QStringLiteral("Authenticated session with a fresh server identity (qt backend; with --socket, "
+                       "pin PALANTIR_SERVER_KEY instead)"));
+    QCommandLineOption jsonOption(QStringLiteral("json"),
+        QStringLiteral("Write results as JSON to file ('-' for stdout)"), QStringLiteral("file"));
+    parser.addOptions({socketOption, spawnOption, sizesOption, concurrencyOption, requestsOption, warmupOption,
+                       delayOption, errorRateOption, backendOption, authOption, jsonOption});
+    parser.process(app);
+
+    const std::vector<int> sizes = parseIntList(parser.value(sizesOption));
+    const std::vector<int> levels = parseIntList(parser.value(concurrencyOption));
+    const int requests = std::max(1, parser.value(requestsOption).toInt());
+    const int warmup = std::max(0, parser.value(warmupOption).toInt());
+    if (sizes.empty() || levels.empty()) {
+        err << "transport_bench: --sizes and --concurrency need positive integers" << Qt::endl;
+        return 2;
+    }
+    const QString backend = parser.value(backendOption);
+#ifdef __linux__
+    const bool useEpoll = backend == QStringLiteral("epoll");
+    if (!useEpoll && backend != QStringLiteral("qt")) {
+#else
+    const bool useEpoll = false;
+    if (backend != QStringLiteral("qt")) {
+#endif
+        err << "transport_bench: Unknown --backend " << backend << Qt::endl;
+        return 2;
+    }
+    const bool auth = parser.isSet(authOption);
+    if (auth && (useEpoll || parser.isSet(socketOption))) {
+        err << "transport_bench: --auth needs the qt backend and an in-process or spawned server" << Qt::endl;
+        return 2;
+    }
+
+    MockServerConfig config;
+    config.responseDelayMs = parser.value(delayOption).toInt();
+    config.errorRate = parser.value(errorRateOption).toDouble();
+    IdentityPublicKey identity;
+    if (auth) {
+        IdentitySecretKey secret;
+        if (!generateIdentity(identity, secret)) {
+            err << "transport_bench: --auth needs libsodium (PHX_WITH_LIBSODIUM=ON)" << Qt::endl;
+            return 2;
+        }
+        config.identity = secret;
+    }
+
+    // Server: existing socket, subprocess, or in-process thread
+    QString serverMode;
+    QString socketName;
+    MockServerThread inProcess(config);
+    QProcess process;
+    if (parser.isSet(socketOption)) {
+        serverMode = QStringLiteral("external");
+        socketName = parser.value(socketOption);
+    } else if (parser.isSet(spawnOption)) {
+        serverMode = QStringLiteral("subprocess");
+        process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        QStringList arguments = {QStringLiteral("--delay-ms"), QString::number(config.responseDelayMs),
+                                 QStringLiteral("--error-rate"), QString::number(config.errorRate)};
+        if (auth) {
+            arguments << QStringLiteral("--identity-key") << QString::fromStdString(keyToHex(*config.identity));
+        }
+        process.start(parser.value(spawnOption), arguments);
+        // The server announces its socket on the first stdout line
+        while (process.state() != QProcess::NotRunning && !process.canReadLine()) {
+            process.waitForReadyRead(5000);
+        }
+        const QString line = QString::fromUtf8(process.readLine()).trimmed();
+        if (!line.startsWith(QStringLiteral("LISTENING "))) {
+            err << "transport_bench: " << parser.value(spawnOption) << " did not start" << Qt::endl;
+            return 1;
+        }
+        socketName = line.mid(10);
+    } else {
+        serverMode = QStringLiteral("in-process");
+        QString error;
+        if (!inProcess.start(QString(), &error)) {
+            err << "transport_bench: " << error << Qt::endl;
+            return 1;
+        }
+        socketName = inProcess.socketName();
+    }
+
+    LocalSocketChannel channel(socketName);
+    if (auth) {
+        channel.setServerIdentity(identity);
+    }
+#ifdef __linux__
+    EpollChannel epollChannel(socketName);
+    const bool connected = useEpoll ? epollChannel.connect() : channel.connect();
+#else
+    const bool connected = channel.connect();
+#endif
+    if (!connected) {
+        err << "transport_bench: Failed to connect to " << socketName << Qt::endl;
+        return 1;
+    }
+
+    // Keep stdout clean for the JSON document when it goes there
+    QTextStream& table = parser.value(jsonOption) == QStringLiteral("-") ? err : out;
+    QJsonArray results;
+    table << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                 .arg("samples", 9).arg("conc", 5).arg("ok", 6).arg("err", 5)
+                 .arg("p50_us", 10).arg("p99_us", 10).arg("p999_us", 10).arg("MB/s", 9);
+    for (int samples : sizes) {
+        for (int concurrency : levels) {
+#ifdef __linux__
+            const RunResult result = useEpoll ? runLevel(epollChannel, samples, concurrency, requests, warmup)
+                                              : runLevel(channel, samples, concurrency, requests, warmup);
+#else
+            const RunResult result = runLevel(channel, samples, concurrency, requests, warmup);
+#endif
+            const QJsonObject json = toJson(result);
+            results.append(json);
+
+            const QJsonObject latency = json["latency_us"].toObject();
+            table << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                         .arg(samples, 9).arg(concurrency, 5)
+                         .arg(static_cast<int>(result.latenciesUs.size()), 6).arg(result.errors, 5)
+                         .arg(latency["p50"].toDouble(), 10, 'f', 1)
+                         .arg(latency["p99"].toDouble(), 10, 'f', 1)
+                         .arg(latency["p999"].toDouble(), 10, 'f', 1)
+                         .arg(json["throughput_mbps"].toDouble(), 9, 'f', 1);
+            table.flush();
+        }
+    }
+    channel.disconnect();
+#ifdef __linux__
+    epollChannel.disconnect();
+#endif
+
+    QJsonArray frameMac;
+    if (auth) {
+        table << QString("\n%1 %2 %3 %4\n").arg("samples", 9).arg("frame_B", 10).arg("mac_us", 10).arg("GB/s", 7);
+        for (int samples : sizes) {
+            const QJsonObject json = measureFrameMac(samples);
+            frameMac.append(json);
+            table << QString("%1 %2 %3 %4\n")
+                         .arg(samples, 9)
+                         .arg(json["frame_bytes"].toDouble(), 10, 'f', 0)
+                         .arg(json["us_per_frame"].toDouble(), 10, 'f', 2)
+                         .arg(json["gbps"].toDouble(), 7, 'f', 2);
+        }
+        table.flush();
+    }
+
+    if (process.state() != QProcess::NotRunning) {
+        process.terminate();
+        if (!process.waitForFinished(2000)) {
+            process.kill();
+            process.waitForFinished();
+        }
+    }
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject document;
+        document["benchmark"] = QStringLiteral("transport_roundtrip");
+        document["server"] = serverMode;
+        document["backend"] = backend;
+        document["auth"] = auth;
+        document["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        document["warmup"] = warmup;
+        document["results"] = results;
+        if (auth) {
+            document["frame_mac"] = frameMac;
+        }
+        const QByteArray bytes = QJsonDocument(document).toJson(QJsonDocument::Indented);
+
+        const QString path = parser.value(jsonOption);
+        if (path == QStringLiteral("-")) {
+            out << bytes;
+        } else {
+            QFile file(path);
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(bytes) != bytes.size()) {
+                err << "transport_bench: Cannot write " << path << Qt::endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}